@@ -0,0 +1,208 @@
+import sys
+import struct
+from pathlib import Path
+
+# Sound bank layout (little endian), read by Starshine::Audio::ParseSoundBank():
+#   Header (16 bytes):     char[4] signature ("SSB" + revision), u32 entry count, u32 entry record size, u32 reserved
+#   Entry record (72 bytes): char[32] null-terminated name, u8 encoding, u8 channel count, u16 reserved, u32 sample rate,
+#                          u64 data offset, u64 data size, u64 loop start (frames), u64 loop end (frames)
+#   Entry data, each aligned to 16 bytes
+FileSignature = b"SSB\x00"
+HeaderFormat = "<4sIII"
+EntryFormat = "<32sBBHIQQQQ"
+DataAlignment = 16
+MaxNameLength = 31
+
+EncodingPCM16 = 0
+EncodingEncoded = 1
+
+SupportedExtensions = [".ogg", ".wav"]
+
+def AlignUp(value, alignment):
+    return (value + alignment - 1) & ~(alignment - 1)
+
+def ReadWavChunks(data):
+    chunks = dict()
+    if len(data) < 12 or data[0:4] != b"RIFF" or data[8:12] != b"WAVE":
+        return chunks
+
+    offset = 12
+    while offset + 8 <= len(data):
+        chunkId = data[offset:offset + 4]
+        chunkSize = struct.unpack_from("<I", data, offset + 4)[0]
+        chunks[chunkId] = data[offset + 8:offset + 8 + chunkSize]
+        offset += 8 + chunkSize + (chunkSize & 1)
+
+    return chunks
+
+# NOTE: Same convention as the engine's WavDecoder: an "id3 " chunk with TXXX frames named "LoopStart" and "LoopEnd"
+def ReadWavLoopPoints(chunks):
+    loopPoints = dict()
+    id3 = chunks.get(b"id3 ")
+    if id3 is None or len(id3) < 10 or id3[0:4] != b"ID3\x03":
+        return loopPoints
+
+    offset = 10
+    while offset + 10 <= len(id3):
+        frameId = id3[offset:offset + 4]
+        frameSize = struct.unpack_from(">I", id3, offset + 4)[0]
+        frameData = id3[offset + 10:offset + 10 + frameSize]
+        offset += 10 + frameSize
+
+        if frameSize == 0:
+            break
+
+        if frameId == b"TXXX":
+            fields = frameData[1:].split(b"\x00")
+            if len(fields) >= 2:
+                loopPoints[fields[0].decode("latin-1")] = fields[1].decode("latin-1")
+
+    return loopPoints
+
+# NOTE: Same convention as the engine's OggVorbisDecoder: "LoopStart=<frame>" and "LoopEnd=<frame>" comments
+def ReadOggLoopPoints(data):
+    loopPoints = dict()
+    packets = []
+    packet = b""
+    offset = 0
+
+    # Only the first two packets (identification and comment header) are needed
+    while offset + 27 <= len(data) and len(packets) < 2:
+        if data[offset:offset + 4] != b"OggS":
+            break
+
+        segmentCount = data[offset + 26]
+        segmentTable = data[offset + 27:offset + 27 + segmentCount]
+        offset += 27 + segmentCount
+
+        for segmentSize in segmentTable:
+            packet += data[offset:offset + segmentSize]
+            offset += segmentSize
+
+            if segmentSize < 255:
+                packets.append(packet)
+                packet = b""
+
+    if len(packets) < 2 or packets[1][0:7] != b"\x03vorbis":
+        return loopPoints
+
+    comments = packets[1]
+    vendorLength = struct.unpack_from("<I", comments, 7)[0]
+    position = 11 + vendorLength
+    commentCount = struct.unpack_from("<I", comments, position)[0]
+    position += 4
+
+    for i in range(commentCount):
+        commentLength = struct.unpack_from("<I", comments, position)[0]
+        comment = comments[position + 4:position + 4 + commentLength].decode("utf-8", errors="replace")
+        position += 4 + commentLength
+
+        if "=" in comment:
+            name, value = comment.split("=", 1)
+            loopPoints[name] = value
+
+    return loopPoints
+
+def GetLoopRange(loopPoints):
+    try:
+        return int(loopPoints["LoopStart"]), int(loopPoints["LoopEnd"])
+    except (KeyError, ValueError):
+        return 0, 0
+
+def DecodeToPCM(filePath):
+    try:
+        import soundfile
+    except ImportError:
+        return None
+
+    samples, sampleRate = soundfile.read(str(filePath), dtype="int16", always_2d=True)
+    return samples.shape[1], sampleRate, samples.tobytes()
+
+def CreateEntry(filePath, convertToPCM):
+    data = filePath.read_bytes()
+    entry = {
+        "Name": filePath.name,
+        "Encoding": EncodingEncoded,
+        "Channels": 0,
+        "SampleRate": 0,
+        "Data": data,
+        "LoopStart": 0,
+        "LoopEnd": 0
+    }
+
+    if filePath.suffix.lower() == ".wav":
+        chunks = ReadWavChunks(data)
+        entry["LoopStart"], entry["LoopEnd"] = GetLoopRange(ReadWavLoopPoints(chunks))
+
+        if convertToPCM and b"fmt " in chunks and b"data" in chunks:
+            formatTag, channels, sampleRate = struct.unpack_from("<HHI", chunks[b"fmt "], 0)
+            bitsPerSample = struct.unpack_from("<H", chunks[b"fmt "], 14)[0]
+
+            if formatTag == 1 and bitsPerSample == 16 and channels in (1, 2):
+                entry.update(Encoding=EncodingPCM16, Channels=channels, SampleRate=sampleRate, Data=chunks[b"data"])
+            else:
+                print(f"{filePath.name}: only 16-bit PCM files can be stored uncompressed, keeping the original file")
+    else:
+        entry["LoopStart"], entry["LoopEnd"] = GetLoopRange(ReadOggLoopPoints(data))
+
+        if convertToPCM:
+            decoded = DecodeToPCM(filePath)
+            if decoded is None:
+                print(f"{filePath.name}: the \"soundfile\" module is required to decode Ogg files, keeping the original file")
+            elif decoded[0] not in (1, 2):
+                print(f"{filePath.name}: only mono and stereo files can be stored uncompressed, keeping the original file")
+            else:
+                entry.update(Encoding=EncodingPCM16, Channels=decoded[0], SampleRate=decoded[1], Data=decoded[2])
+
+    return entry
+
+def main():
+    if len(sys.argv) < 3:
+        print(f"Usage: {sys.argv[0]} <sound directory> <output file> [--pcm]")
+        print()
+        print("Packs every .ogg and .wav file of the directory into a single sound bank.")
+        print("\t--pcm - Store decoded 16-bit PCM instead of the original files (larger, but nothing has to be decoded when loading)")
+        return 1
+
+    inputDirectory = Path(sys.argv[1])
+    outputFile = Path(sys.argv[2])
+    convertToPCM = "--pcm" in sys.argv[3:]
+
+    filePaths = sorted(path for path in inputDirectory.iterdir() if path.is_file() and path.suffix.lower() in SupportedExtensions)
+    if len(filePaths) == 0:
+        print(f"No sound files found in \"{inputDirectory}\"")
+        return 1
+
+    entries = []
+    for filePath in filePaths:
+        if len(filePath.name.encode("utf-8")) > MaxNameLength:
+            print(f"{filePath.name}: file names can't be longer than {MaxNameLength} bytes")
+            return 1
+
+        entries.append(CreateEntry(filePath, convertToPCM))
+
+    entryRecordSize = struct.calcsize(EntryFormat)
+    dataOffset = AlignUp(struct.calcsize(HeaderFormat) + len(entries) * entryRecordSize, DataAlignment)
+
+    with open(outputFile, "wb") as bankFile:
+        bankFile.write(struct.pack(HeaderFormat, FileSignature, len(entries), entryRecordSize, 0))
+
+        for entry in entries:
+            bankFile.write(struct.pack(EntryFormat, entry["Name"].encode("utf-8"), entry["Encoding"], entry["Channels"], 0, entry["SampleRate"],
+                dataOffset, len(entry["Data"]), entry["LoopStart"], entry["LoopEnd"]))
+            entry["Offset"] = dataOffset
+            dataOffset = AlignUp(dataOffset + len(entry["Data"]), DataAlignment)
+
+        for entry in entries:
+            bankFile.write(b"\x00" * (entry["Offset"] - bankFile.tell()))
+            bankFile.write(entry["Data"])
+
+    for entry in entries:
+        encodingName = "PCM16" if entry["Encoding"] == EncodingPCM16 else "Encoded"
+        print(f"{entry['Name']}: {encodingName}, {len(entry['Data'])} bytes")
+
+    print(f"Wrote {len(entries)} sounds to \"{outputFile}\"")
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -3,6 +3,7 @@
 #include "GameContext.h"
 #include "Definitions.h"
 #include "Settings.h"
+#include "MainGame/ChartAudioRenderer.h"
 #include <Common/Logging/Logging.h>
 #include <IO/Path/File.h>
 
@@ -25,7 +26,17 @@ bool ConvertFont(std::string_view inputFilePath, std::string_view outputFilePath
 
 int SDL_main(int argc, char* argv[])
 {
-	if (argc >= 2)
+	// NOTE: "--device <Name>" runs the game on another rendering device, e.g. "--device Null" to count its draw calls without a GPU
+	Rendering::DeviceType deviceType = Rendering::DeviceType::D3D11;
+	if (argc >= 3 && !SDL_strncmp(argv[1], "--device", 32))
+	{
+		for (size_t i = 0; i < Rendering::DeviceTypeNames.size(); i++)
+		{
+			if (!SDL_strncmp(argv[2], Rendering::DeviceTypeNames[i], 32))
+				deviceType = static_cast<Rendering::DeviceType>(i);
+		}
+	}
+	else if (argc >= 2)
 	{
 		if (!SDL_strncmp(argv[1], "--convert_font", 32))
 		{
@@ -48,18 +59,28 @@ int SDL_main(int argc, char* argv[])
 			ConvertFont(argv[2], argv[3], targetFormat);
 			return 0;
 		}
+		if (!SDL_strncmp(argv[1], "--render_chart_audio", 32))
+		{
+			if (argc < 5)
+				return 1;
+
+			return MainGame::RenderChartAudio(argv[2], argv[3], argv[4]) ? 0 : 1;
+		}
 		return 0;
 	}
 
 	GameInstance game;
 	
-	if (game.Initialize(false))
+	if (game.Initialize(false, deviceType))
 	{
 		if (!GameContext::CreateInstance()) { return 1; }
 
 		if (!SettingsData.LoadFromFile())
 			SettingsData.SetDefaultValues();
 
+		SettingsData.ApplyAudioVolumes();
+		SettingsData.ApplyAudioDevice();
+
 		auto window = game.GetWindow();
 		window->SetTitle("Even More Cursed DIVA");
 		window->SetMode(SettingsData.Window.Mode);
@@ -0,0 +1,195 @@
+#include "ChartAudioRenderer.h"
+#include "Chart.h"
+#include "GameAudio.h"
+#include <Audio/AudioEngine.h>
+#include <Audio/Encoding/WavEncoder.h>
+#include <Common/Logging/Logging.h>
+#include <IO/Path/File.h>
+#include <SDL2/SDL_timer.h>
+#include <algorithm>
+#include <vector>
+
+namespace DIVA::MainGame
+{
+	using namespace Starshine;
+	using namespace Starshine::Audio;
+
+	constexpr const char* LogName = "DIVA::ChartAudioRenderer";
+
+	struct AutoplayEvent
+	{
+		TimeSpan HitTime{};
+		NoteShape Shape{};
+		NoteType Type{};
+	};
+
+	struct AutoplaySounds
+	{
+		SourceHandle Normal{};
+		SourceHandle Double{};
+		SourceHandle StarNormal{};
+		SourceHandle StarDouble{};
+		SourceHandle HoldLoop{};
+		SourceHandle HoldLoopEnd{};
+		SourceHandle StarHoldLoop{};
+		SourceHandle StarHoldLoopEnd{};
+
+		Voice HoldLoopVoice{};
+	};
+
+	static std::vector<AutoplayEvent> CreateAutoplayEvents(Chart& chart)
+	{
+		std::vector<AutoplayEvent> events;
+		events.reserve(chart.Notes.size());
+
+		// NOTE: A note is hit once its fly time has passed after it appeared, the same moment MainGame's autoplay hits it
+		for (const auto& note : chart.Notes)
+		{
+			events.push_back(AutoplayEvent { note.AppearTime + chart.GetNoteTime(note.AppearTime), note.Shape, note.Type });
+		}
+
+		std::stable_sort(events.begin(), events.end(), [](const AutoplayEvent& a, const AutoplayEvent& b) { return a.HitTime < b.HitTime; });
+		return events;
+	}
+
+	static bool IsHoldEvent(const AutoplayEvent& event)
+	{
+		return (event.Type == NoteType::HoldStart || event.Type == NoteType::HoldEnd);
+	}
+
+	static void PlayAutoplayEvent(AudioEngine& audioEngine, AutoplaySounds& sounds, const AutoplayEvent& event, u64 eventFrame)
+	{
+		const bool star = (event.Shape == NoteShape::Star);
+
+		switch (event.Type)
+		{
+		case NoteType::Normal:
+			audioEngine.PlaySoundAt(eventFrame, star ? sounds.StarNormal : sounds.Normal, GameAudio::NormalVolume);
+			break;
+		case NoteType::Double:
+			audioEngine.PlaySoundAt(eventFrame, star ? sounds.StarDouble : sounds.Double, GameAudio::NormalVolume);
+			break;
+		case NoteType::HoldStart:
+			sounds.HoldLoopVoice.SetSource(star ? sounds.StarHoldLoop : sounds.HoldLoop);
+			sounds.HoldLoopVoice.SetFramePosition(0);
+			sounds.HoldLoopVoice.SetLoopState(true);
+			sounds.HoldLoopVoice.PlayAt(eventFrame);
+			break;
+		case NoteType::HoldEnd:
+			sounds.HoldLoopVoice.StopAt(eventFrame);
+			audioEngine.PlaySoundAt(eventFrame, star ? sounds.StarHoldLoopEnd : sounds.HoldLoopEnd, GameAudio::HoldVolume);
+			break;
+		default:
+			break;
+		}
+	}
+
+	static size_t TimeToFrame(TimeSpan time)
+	{
+		return (time.Microseconds > 0) ? static_cast<size_t>(time.GetSeconds() * static_cast<f64>(AudioEngine::DefaultSampleRate) + 0.5) : 0;
+	}
+
+	bool RenderChartAudio(std::string_view chartPath, std::string_view musicPath, std::string_view outputPath)
+	{
+		Chart chart;
+		if (!chart.LoadXml(chartPath))
+		{
+			LogError(LogName, "Failed to load chart \"%s\"", chartPath.data());
+			return false;
+		}
+
+		IO::FileStream outputStream = IO::File::CreateWrite(outputPath);
+		if (!outputStream.IsOpen())
+		{
+			LogError(LogName, "Failed to create \"%s\"", outputPath.data());
+			return false;
+		}
+
+		AudioEngine::CreateInstance(AudioOutputMode::Null);
+		AudioEngine& audioEngine = *AudioEngine::GetInstance();
+
+		const auto hitSounds = GameAudio::LoadHitSounds(audioEngine);
+		const auto hitSound = [&hitSounds](GameAudio::HitSound sound) { return hitSounds[static_cast<size_t>(sound)]; };
+
+		AutoplaySounds sounds{};
+		sounds.Normal = hitSound(GameAudio::HitSound::Normal);
+		sounds.Double = hitSound(GameAudio::HitSound::Double);
+		sounds.StarNormal = hitSound(GameAudio::HitSound::StarNormal);
+		sounds.StarDouble = hitSound(GameAudio::HitSound::StarDouble);
+		sounds.HoldLoop = hitSound(GameAudio::HitSound::HoldLoop);
+		sounds.HoldLoopEnd = hitSound(GameAudio::HitSound::HoldLoopEnd);
+		sounds.StarHoldLoop = hitSound(GameAudio::HitSound::StarHoldLoop);
+		sounds.StarHoldLoopEnd = hitSound(GameAudio::HitSound::StarHoldLoopEnd);
+
+		sounds.HoldLoopVoice = audioEngine.AllocateVoice(sounds.HoldLoop);
+		sounds.HoldLoopVoice.SetLoopState(true);
+		sounds.HoldLoopVoice.SetVolume(GameAudio::HoldVolume);
+
+		SourceHandle musicSource = audioEngine.LoadStreamingSource(musicPath);
+		Voice musicVoice = audioEngine.AllocateVoice(musicSource);
+		if (musicSource != SourceHandle::Invalid)
+		{
+			musicVoice.SetBus(AudioBus::Music);
+			musicVoice.SetVolume(GameAudio::MusicVolume);
+			musicVoice.SetPlaying(true);
+		}
+		else
+		{
+			LogWarn(LogName, "Failed to load music \"%s\", only hit sounds will be rendered", musicPath.data());
+		}
+
+		WavEncoder encoder(outputStream, AudioEngine::DefaultChannelCount, AudioEngine::DefaultSampleRate);
+		std::vector<f32> renderBuffer(AudioEngine::DefaultSampleBufferSize);
+
+		const size_t bufferFrames = renderBuffer.size() / AudioEngine::DefaultChannelCount;
+		size_t renderedFrames = 0;
+
+		const auto renderUntil = [&](size_t targetFrame)
+		{
+			while (renderedFrames < targetFrame)
+			{
+				size_t frameCount = std::min(targetFrame - renderedFrames, bufferFrames);
+				audioEngine.RenderFrames(renderBuffer.data(), frameCount);
+				encoder.WriteFrames(renderBuffer.data(), frameCount);
+				renderedFrames += frameCount;
+			}
+		};
+
+		const u64 startTicks = SDL_GetPerformanceCounter();
+
+		// NOTE: Events are scheduled at their exact frame, so whole buffers can be rendered up to the one that contains the next event.
+		//		 The hold loop voice only keeps the latest start or stop though, so a second hold event within a buffer splits it
+		bool holdVoiceScheduled = false;
+
+		for (const auto& event : CreateAutoplayEvents(chart))
+		{
+			const size_t eventFrame = TimeToFrame(event.HitTime);
+			if (eventFrame >= renderedFrames + bufferFrames)
+			{
+				renderUntil(eventFrame - (eventFrame - renderedFrames) % bufferFrames);
+				holdVoiceScheduled = false;
+			}
+
+			if (IsHoldEvent(event) && holdVoiceScheduled)
+			{
+				renderUntil(eventFrame);
+				holdVoiceScheduled = false;
+			}
+
+			PlayAutoplayEvent(audioEngine, sounds, event, eventFrame);
+			holdVoiceScheduled |= IsHoldEvent(event);
+		}
+
+		renderUntil(TimeToFrame(chart.Duration));
+		encoder.Finish();
+
+		const f64 renderSeconds = static_cast<f64>(SDL_GetPerformanceCounter() - startTicks) / static_cast<f64>(SDL_GetPerformanceFrequency());
+		const f64 audioSeconds = static_cast<f64>(renderedFrames) / static_cast<f64>(AudioEngine::DefaultSampleRate);
+
+		LogInfo(LogName, "Rendered %.2f seconds of audio to \"%s\" in %.2f seconds (%.1fx real time)",
+			audioSeconds, outputPath.data(), renderSeconds, (renderSeconds > 0.0) ? (audioSeconds / renderSeconds) : 0.0);
+
+		AudioEngine::DestroyInstance();
+		return true;
+	}
+}
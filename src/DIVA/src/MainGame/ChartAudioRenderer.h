@@ -0,0 +1,9 @@
+#pragma once
+#include "Common/Types.h"
+
+namespace DIVA::MainGame
+{
+	// NOTE: Renders a chart's music and the hit sounds autoplay would trigger into a WAV file, using the audio engine's null device.
+	//		 Runs as fast as the mixer allows and produces the same output on every run.
+	bool RenderChartAudio(std::string_view chartPath, std::string_view musicPath, std::string_view outputPath);
+}
@@ -0,0 +1,25 @@
+#include "GameAudio.h"
+#include "IO/Path/File.h"
+#include "IO/Path/Path.h"
+
+using namespace Starshine;
+using namespace Starshine::Audio;
+
+namespace DIVA::MainGame::GameAudio
+{
+	std::array<SourceHandle, EnumCount<HitSound>()> LoadHitSounds(AudioEngine& audioEngine)
+	{
+		if (!IO::File::Exists(HitSoundBankPath))
+		{
+			return audioEngine.LoadSources(HitSoundPaths);
+		}
+
+		std::array<std::string_view, EnumCount<HitSound>()> entryNames{};
+		for (size_t i = 0; i < entryNames.size(); i++)
+		{
+			entryNames[i] = IO::Path::GetFileName(HitSoundPaths[i]);
+		}
+
+		return audioEngine.LoadSoundBank(HitSoundBankPath, entryNames);
+	}
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "Common/Types.h"
+#include "Audio/AudioEngine.h"
+#include <array>
+
+namespace DIVA::MainGame::GameAudio
+{
+	// NOTE: Shared by MainGame and the offline chart renderer so that both sound the same
+	constexpr std::string_view NormalPath = "diva/sounds/mg_notes/Normal_Normal01.ogg";
+	constexpr std::string_view DoublePath = "diva/sounds/mg_notes/Normal_Double01.ogg";
+
+	constexpr std::string_view StarNormalPath = "diva/sounds/mg_notes/Star_Normal01.ogg";
+	constexpr std::string_view StarDoublePath = "diva/sounds/mg_notes/Star_Double01.ogg";
+
+	constexpr std::string_view HoldLoopPath = "diva/sounds/mg_notes/Normal_Hold01_Loop.ogg";
+	constexpr std::string_view HoldLoopEndPath = "diva/sounds/mg_notes/Normal_Hold01_LoopEnd.ogg";
+
+	constexpr std::string_view StarHoldLoopPath = "diva/sounds/mg_notes/Star_Hold01_Loop.ogg";
+	constexpr std::string_view StarHoldLoopEndPath = "diva/sounds/mg_notes/Star_Hold01_LoopEnd.ogg";
+
+	enum class HitSound : u8
+	{
+		Normal,
+		Double,
+		StarNormal,
+		StarDouble,
+		HoldLoop,
+		HoldLoopEnd,
+		StarHoldLoop,
+		StarHoldLoopEnd,
+
+		Count
+	};
+
+	// NOTE: Indexed by HitSound, so that all hit sounds can be loaded as one batch
+	constexpr std::array<std::string_view, Starshine::EnumCount<HitSound>()> HitSoundPaths
+	{
+		NormalPath,
+		DoublePath,
+		StarNormalPath,
+		StarDoublePath,
+		HoldLoopPath,
+		HoldLoopEndPath,
+		StarHoldLoopPath,
+		StarHoldLoopEndPath
+	};
+
+	// NOTE: Built from "diva/sounds/mg_notes" by python/build_sound_bank.py, entries are named after the file names of the paths above
+	constexpr std::string_view HitSoundBankPath = "diva/sounds/mg_notes.ssb";
+
+	// NOTE: Loads every hit sound from the sound bank, or from the individual files if no bank has been built
+	std::array<Starshine::Audio::SourceHandle, Starshine::EnumCount<HitSound>()> LoadHitSounds(Starshine::Audio::AudioEngine& audioEngine);
+
+	constexpr f32 NormalVolume = 0.125f;
+	constexpr f32 HoldVolume = 0.135f;
+	constexpr f32 MusicVolume = 0.5f;
+}
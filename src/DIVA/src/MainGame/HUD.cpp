@@ -432,10 +432,12 @@ namespace DIVA::MainGame
 			const vec2 viewportSize = mainGameContext->SpriteRenderer->GetRenderingDevice()->GetViewportSize().Size();
 			//const vec2 baseScale = vec2(viewportSize.x / 1280.0f, viewportSize.y / 720.0f);
 
+			mainGameContext->SpriteRenderer->SetLayer(static_cast<u8>(MainGameLayer::HUD));
 			DrawComboDisplay();
 			DrawScoreBonusDisplay();
 			DrawFrame();
 
+			mainGameContext->SpriteRenderer->SetLayer(static_cast<u8>(MainGameLayer::Text));
 			fontRenderer.DrawString(font, mainGameContext->SongName, animCache.SongNameTextPosition, vec2(1.0f), DefaultColors::White);
 			DrawLyricsText(vec2(1.0f));
 		}
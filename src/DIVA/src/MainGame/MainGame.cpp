@@ -7,6 +7,7 @@
 #include "GameNote.h"
 #include "HitEvaluation.h"
 #include "HUD.h"
+#include "GameAudio.h"
 #include <Input/Keyboard.h>
 #include <Input/Gamepad.h>
 #include "Graphics/SpritePacker.h"
@@ -131,6 +132,7 @@ namespace DIVA::MainGame
 		std::unique_ptr<SpritePacker> sprPacker;
 
 		char debugText[512] = {};
+		SpriteRendererStats spriteStats{};
 
 		Impl(MainGame::MainGameContext& context) : MainGameContext{ context }
 		{
@@ -148,7 +150,7 @@ namespace DIVA::MainGame
 			ActiveNotes.clear();
 
 			MusicVoice.SetFramePosition(0);
-			MusicVoice.SetVolume(0.5f);
+			MusicVoice.SetVolume(GameAudio::MusicVolume);
 
 			ElapsedTime = { 0 };
 
@@ -290,30 +292,36 @@ namespace DIVA::MainGame
 			debugFont = GameContext::GetInstance()->DebugFont.get();
 			MainGameContext.DebugFont = debugFont;
 
+			spriteRenderer->SetLayerOrder(static_cast<u8>(MainGameLayer::Text), SpriteLayerOrder::State);
+			spriteRenderer->SetLayerOrder(static_cast<u8>(MainGameLayer::PauseMenuText), SpriteLayerOrder::State);
+
 			CreateIconSetSpriteSheet();
 			LoadAnimations();
 
 			hud->LoadSprites(*sprPacker);
 			
-			HitSound_Normal = AudioEngine::GetInstance()->LoadSource("diva/sounds/mg_notes/Normal_Normal01.ogg");
-			HitSound_Double = AudioEngine::GetInstance()->LoadSource("diva/sounds/mg_notes/Normal_Double01.ogg");
+			const auto hitSounds = GameAudio::LoadHitSounds(*AudioEngine::GetInstance());
+			const auto hitSound = [&hitSounds](GameAudio::HitSound sound) { return hitSounds[static_cast<size_t>(sound)]; };
+
+			HitSound_Normal = hitSound(GameAudio::HitSound::Normal);
+			HitSound_Double = hitSound(GameAudio::HitSound::Double);
 
-			HitSound_Star_Normal = AudioEngine::GetInstance()->LoadSource("diva/sounds/mg_notes/Star_Normal01.ogg");
-			HitSound_Star_Double = AudioEngine::GetInstance()->LoadSource("diva/sounds/mg_notes/Star_Double01.ogg");
+			HitSound_Star_Normal = hitSound(GameAudio::HitSound::StarNormal);
+			HitSound_Star_Double = hitSound(GameAudio::HitSound::StarDouble);
 
-			HitSound_Hold_Loop = AudioEngine::GetInstance()->LoadSource("diva/sounds/mg_notes/Normal_Hold01_Loop.ogg");
-			HitSound_Hold_LoopEnd = AudioEngine::GetInstance()->LoadSource("diva/sounds/mg_notes/Normal_Hold01_LoopEnd.ogg");
+			HitSound_Hold_Loop = hitSound(GameAudio::HitSound::HoldLoop);
+			HitSound_Hold_LoopEnd = hitSound(GameAudio::HitSound::HoldLoopEnd);
 
-			HitSound_StarHold_Loop = AudioEngine::GetInstance()->LoadSource("diva/sounds/mg_notes/Star_Hold01_Loop.ogg");
-			HitSound_StarHold_LoopEnd = AudioEngine::GetInstance()->LoadSource("diva/sounds/mg_notes/Star_Hold01_LoopEnd.ogg");
+			HitSound_StarHold_Loop = hitSound(GameAudio::HitSound::StarHoldLoop);
+			HitSound_StarHold_LoopEnd = hitSound(GameAudio::HitSound::StarHoldLoopEnd);
 
 			HitSound_Hold_LoopVoice = AudioEngine::GetInstance()->AllocateVoice(HitSound_Hold_Loop);
 			HitSound_Hold_LoopVoice.SetLoopState(true);
-			HitSound_Hold_LoopVoice.SetVolume(0.135f);
+			HitSound_Hold_LoopVoice.SetVolume(GameAudio::HoldVolume);
 			
 			if (MusicSource != SourceHandle::Invalid)
 			{
-				MusicVoice.SetVolume(0.5f);
+				MusicVoice.SetVolume(GameAudio::MusicVolume);
 				MusicVoice.SetPlaying(true);
 			}
 
@@ -341,6 +349,7 @@ namespace DIVA::MainGame
 			if (MusicSource != SourceHandle::Invalid)
 			{
 				MusicVoice = AudioEngine::GetInstance()->AllocateVoice(MusicSource);
+				MusicVoice.SetBus(AudioBus::Music);
 				return true;
 			}
 			return false;
@@ -372,6 +381,9 @@ namespace DIVA::MainGame
 
 			hud->Destroy();
 			hud = nullptr;
+
+			spriteRenderer->SetLayerOrder(static_cast<u8>(MainGameLayer::Text), SpriteLayerOrder::Submission);
+			spriteRenderer->SetLayerOrder(static_cast<u8>(MainGameLayer::PauseMenuText), SpriteLayerOrder::Submission);
 		}
 
 		void Destroy()
@@ -495,12 +507,12 @@ namespace DIVA::MainGame
 				switch (note->Type)
 				{
 				case NoteType::Normal:
-					AudioEngine::GetInstance()->PlaySound(note->Shape == NoteShape::Star ? HitSound_Star_Normal : HitSound_Normal, 0.125f);
+					AudioEngine::GetInstance()->PlaySound(note->Shape == NoteShape::Star ? HitSound_Star_Normal : HitSound_Normal, GameAudio::NormalVolume);
 					break;
 				case NoteType::Double:
 					note->DoubleTap.Primary = true;
 					note->DoubleTap.Alternative = true;
-					AudioEngine::GetInstance()->PlaySound(note->Shape == NoteShape::Star ? HitSound_Star_Double : HitSound_Double, 0.125f);
+					AudioEngine::GetInstance()->PlaySound(note->Shape == NoteShape::Star ? HitSound_Star_Double : HitSound_Double, GameAudio::NormalVolume);
 					break;
 				case NoteType::HoldStart:
 					note->Hold.PrimaryHeld = true;
@@ -517,7 +529,7 @@ namespace DIVA::MainGame
 					note->Hold.PrimaryHeld = false;
 					hud->ReleaseScoreBonus(false);
 					HitSound_Hold_LoopVoice.SetPlaying(false);
-					AudioEngine::GetInstance()->PlaySound(note->Shape == NoteShape::Star ? HitSound_StarHold_LoopEnd : HitSound_Hold_LoopEnd, 0.135f);
+					AudioEngine::GetInstance()->PlaySound(note->Shape == NoteShape::Star ? HitSound_StarHold_LoopEnd : HitSound_Hold_LoopEnd, GameAudio::HoldVolume);
 					break;
 				}
 
@@ -551,7 +563,7 @@ namespace DIVA::MainGame
 			if (note == nullptr)
 			{
 				if (tapped)
-					AudioEngine::GetInstance()->PlaySound(shape == NoteShape::Star ? HitSound_Star_Normal : HitSound_Normal, 0.125f);
+					AudioEngine::GetInstance()->PlaySound(shape == NoteShape::Star ? HitSound_Star_Normal : HitSound_Normal, GameAudio::NormalVolume);
 				return;
 			}
 
@@ -591,7 +603,7 @@ namespace DIVA::MainGame
 			if (!evaluated)
 			{
 				if (tapped) 
-					AudioEngine::GetInstance()->PlaySound(shape == NoteShape::Star ? HitSound_Star_Normal : HitSound_Normal, 0.125f);
+					AudioEngine::GetInstance()->PlaySound(shape == NoteShape::Star ? HitSound_Star_Normal : HitSound_Normal, GameAudio::NormalVolume);
 				return;
 			}
 
@@ -635,7 +647,7 @@ namespace DIVA::MainGame
 					MainGameContext.Score.Score += 200;
 					hud->SetScoreBonusDisplayState(200 + (IsChanceTime ? noteScore : 0), note->TargetPosition);
 				}
-				AudioEngine::GetInstance()->PlaySound(shape == NoteShape::Star ? HitSound_Star_Double : HitSound_Double, 0.125f);
+				AudioEngine::GetInstance()->PlaySound(shape == NoteShape::Star ? HitSound_Star_Double : HitSound_Double, GameAudio::NormalVolume);
 			}
 			else if (note->Type == NoteType::HoldStart)
 			{
@@ -656,11 +668,11 @@ namespace DIVA::MainGame
 
 				HitSound_Hold_LoopVoice.SetPlaying(false);
 				if (!drop)
-					AudioEngine::GetInstance()->PlaySound(shape == NoteShape::Star ? HitSound_StarHold_LoopEnd : HitSound_Hold_LoopEnd, 0.135f);
+					AudioEngine::GetInstance()->PlaySound(shape == NoteShape::Star ? HitSound_StarHold_LoopEnd : HitSound_Hold_LoopEnd, GameAudio::HoldVolume);
 			}
 			else
 			{
-				AudioEngine::GetInstance()->PlaySound(shape == NoteShape::Star ? HitSound_Star_Normal : HitSound_Normal, 0.125f);
+				AudioEngine::GetInstance()->PlaySound(shape == NoteShape::Star ? HitSound_Star_Normal : HitSound_Normal, GameAudio::NormalVolume);
 				if (IsChanceTime)
 				{
 					hud->SetScoreBonusDisplayState(noteScore, note->TargetPosition);
@@ -820,14 +832,20 @@ namespace DIVA::MainGame
 
 			if (!Paused)
 			{	
+				TimeSpan previousElapsedTime = ElapsedTime;
+
 				if (MusicSource != SourceHandle::Invalid && MusicVoice.IsPlaying())
-					ElapsedTime = TimeSpanConversion::FromSeconds(static_cast<f64>(MusicVoice.GetFramePosition() / 44100.0));
+					ElapsedTime = MusicVoice.GetPlaybackTime();
 				else
 					ElapsedTime += gameTime.ElapsedFrameTime;
 
+				// NOTE: Notes advance with the chart clock instead of the frame time, so that hit timing matches the audible music
+				GameTime chartTime = gameTime;
+				chartTime.ElapsedFrameTime = ElapsedTime - previousElapsedTime;
+
 				UpdateChart();
 				UpdateLyrics();
-				UpdateActiveNotes(gameTime);
+				UpdateActiveNotes(chartTime);
 
 				for (size_t i = 0; i < EnumCount<NoteShape>(); i++)
 				{
@@ -853,6 +871,8 @@ namespace DIVA::MainGame
 			lastPos += SDL_snprintf(debugText + lastPos, sizeof(debugText) - 1, "Elapsed Time: %.03f\n", ElapsedTime.GetSeconds());
 			lastPos += SDL_snprintf(debugText + lastPos, sizeof(debugText) - 1, "Chart Notes: %llu/%llu\n", chartNoteOffset, songChart.Notes.size());
 			lastPos += SDL_snprintf(debugText + lastPos, sizeof(debugText) - 1, "Active Notes: %llu\n", ActiveNotes.size());
+			lastPos += SDL_snprintf(debugText + lastPos, sizeof(debugText) - 1, "Sprite Draw Calls: %u (%u commands, %u flushes, %u texture binds)\n",
+				spriteStats.DrawCalls, spriteStats.Commands, spriteStats.Flushes, spriteStats.TextureBinds);
 		}
 
 		void UpdatePauseMenu()
@@ -935,6 +955,8 @@ namespace DIVA::MainGame
 
 		void Draw(GameTime& gameTime)
 		{
+			spriteRenderer->ResetStats();
+
 			if (CurrentSubState == SubState::Results)
 			{
 				spriteRenderer->SetBasePositionAndScale({}, vec2(1.0f));
@@ -948,6 +970,7 @@ namespace DIVA::MainGame
 			GFXDevice->Clear(ClearFlags::ClearFlags_Color, Color{ 0, 24, 24, 255 }, 1.0f, 0);
 			spriteRenderer->SetBlendMode(BlendMode::Normal);
 			spriteRenderer->SetBasePositionAndScale({}, baseScale);
+			spriteRenderer->SetLayer(static_cast<u8>(MainGameLayer::Notes));
 
 			for (auto& note : ActiveNotes)
 			{
@@ -962,15 +985,15 @@ namespace DIVA::MainGame
 
 			hud->Draw(gameTime);
 
-			spriteRenderer->RenderSprites(nullptr);
 			spriteRenderer->SetBasePositionAndScale({}, vec2(1.0f));
-
+			spriteRenderer->SetLayer(static_cast<u8>(MainGameLayer::Text));
 			spriteRenderer->Font().DrawString(debugFont, std::string_view(debugText), vec2(0.0f, 0.0f), vec2(1.0f), DefaultColors::White);
 
 			if (Paused)
 				DrawPauseMenu();
 
 			spriteRenderer->RenderSprites(nullptr);
+			spriteStats = spriteRenderer->GetStats();
 		}
 
 		void DrawPauseMenu()
@@ -978,11 +1001,14 @@ namespace DIVA::MainGame
 			const RectangleF viewportSize = GFXDevice->GetViewportSize();
 			const vec2 menuPosition = { viewportSize.Width / 2.0f, (viewportSize.Height / 2.0f) - debugFont->LineHeight * 3.0f };
 
+			spriteRenderer->SetLayer(static_cast<u8>(MainGameLayer::PauseMenu));
 			spriteRenderer->SetSpriteColor({ 0, 0, 0, 128 });
 			spriteRenderer->SetSpritePosition(viewportSize.Position());
 			spriteRenderer->SetSpriteSize(viewportSize.Size());
 			spriteRenderer->PushSprite(nullptr);
 
+			spriteRenderer->SetLayer(static_cast<u8>(MainGameLayer::PauseMenuText));
+
 			for (i32 i = 0; i < pauseMenu_OptionLabels.size(); i++)
 			{
 				spriteRenderer->Font().DrawString(debugFont, pauseMenu_OptionLabels[i],
@@ -8,6 +8,19 @@
 
 namespace DIVA::MainGame
 {
+	// NOTE: Sprite renderer layers of the main game, drawn in this order
+	enum class MainGameLayer : u8
+	{
+		Notes,
+		HUD,
+		// NOTE: Strings don't overlap each other, so their glyphs are grouped by font and shader state
+		Text,
+		PauseMenu,
+		PauseMenuText,
+
+		Count
+	};
+
 	struct MainGameContext
 	{
 		Starshine::Rendering::Render2D::SpriteRenderer* SpriteRenderer{};
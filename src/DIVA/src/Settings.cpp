@@ -1,6 +1,8 @@
 #include "Settings.h"
 #include <IO/Xml.h>
 #include <IO/Path/File.h>
+#include <Audio/AudioEngine.h>
+#include <algorithm>
 
 using namespace Starshine;
 using namespace Starshine::Input;
@@ -22,6 +24,8 @@ namespace DIVA
 
 		static constexpr const char* Audio_MusicVolume = "MusicVolume";
 		static constexpr const char* Audio_SoundVolume = "SoundVolume";
+		static constexpr const char* Audio_SampleBufferSize = "SampleBufferSize";
+		static constexpr const char* Audio_OutputLatency = "OutputLatency";
 	}
 
 	bool Settings::LoadFromFile(std::string_view filePath)
@@ -65,6 +69,10 @@ namespace DIVA
 		parseResult = Xml::TryGetValue(Audio.MusicVolume, audioElement->FindAttribute(ElementNames::Audio_MusicVolume));
 		parseResult = Xml::TryGetValue(Audio.SoundVolume, audioElement->FindAttribute(ElementNames::Audio_SoundVolume));
 
+		// NOTE: Optional, settings written before these existed keep the engine's defaults
+		Xml::TryGetValue(Audio.SampleBufferSize, audioElement->FindAttribute(ElementNames::Audio_SampleBufferSize));
+		Xml::TryGetValue(Audio.OutputLatency, audioElement->FindAttribute(ElementNames::Audio_OutputLatency));
+
 		// -----------------
 		
 		Xml::Element* inputElement = rootElement->FirstChildElement(ElementNames::Input);
@@ -113,6 +121,8 @@ namespace DIVA
 		Xml::Element* audioElement = rootElement->InsertNewChildElement(ElementNames::Audio);
 		audioElement->SetAttribute(ElementNames::Audio_MusicVolume, Audio.MusicVolume);
 		audioElement->SetAttribute(ElementNames::Audio_SoundVolume, Audio.SoundVolume);
+		audioElement->SetAttribute(ElementNames::Audio_SampleBufferSize, Audio.SampleBufferSize);
+		audioElement->SetAttribute(ElementNames::Audio_OutputLatency, Audio.OutputLatency);
 
 		Xml::Element* inputElement = rootElement->InsertNewChildElement(ElementNames::Input);
 	
@@ -143,6 +153,8 @@ namespace DIVA
 
 		Audio.MusicVolume = 70;
 		Audio.SoundVolume = 70;
+		Audio.SampleBufferSize = 0;
+		Audio.OutputLatency = 0;
 
 		Input.MainGame_Triangle = KeyBind(SDLK_i, SDLK_w);
 		Input.MainGame_Circle = KeyBind(SDLK_l, SDLK_d);
@@ -150,4 +162,31 @@ namespace DIVA
 		Input.MainGame_Square = KeyBind(SDLK_j, SDLK_a);
 		Input.MainGame_Star = KeyBind(SDLK_f, SDLK_h);
 	}
+
+	void Settings::ApplyAudioVolumes() const
+	{
+		Starshine::Audio::AudioEngine* audioEngine = Starshine::Audio::AudioEngine::GetInstance();
+		if (audioEngine == nullptr)
+		{
+			return;
+		}
+
+		audioEngine->SetBusVolume(Starshine::Audio::AudioBus::Music, static_cast<f32>(std::clamp(Audio.MusicVolume, 0, 100)) / 100.0f);
+		audioEngine->SetBusVolume(Starshine::Audio::AudioBus::SFX, static_cast<f32>(std::clamp(Audio.SoundVolume, 0, 100)) / 100.0f);
+	}
+
+	void Settings::ApplyAudioDevice() const
+	{
+		Starshine::Audio::AudioEngine* audioEngine = Starshine::Audio::AudioEngine::GetInstance();
+		if (audioEngine == nullptr)
+		{
+			return;
+		}
+
+		if (Audio.SampleBufferSize > 0)
+			audioEngine->SetSampleBufferSize(static_cast<u32>(Audio.SampleBufferSize));
+
+		if (Audio.OutputLatency > 0)
+			audioEngine->SetOutputLatency(TimeSpan(Audio.OutputLatency));
+	}
 }
@@ -13,6 +13,12 @@ namespace DIVA
 		void SaveToFile(std::string_view filePath = SettingsFilePath);
 		void SetDefaultValues();
 
+		// NOTE: Sets the volumes of the audio engine's music and sound effect buses
+		void ApplyAudioVolumes() const;
+
+		// NOTE: Sets the audio engine's buffer size and output latency, values of 0 keep the engine's defaults
+		void ApplyAudioDevice() const;
+
 		struct
 		{
 			Starshine::WindowMode Mode{};
@@ -21,11 +27,14 @@ namespace DIVA
 			bool Maximized{};
 		} Window;
 		
-		// TOOD: Implement
+		// NOTE: Volumes in percent [0; 100]. The buffer size is in interleaved samples and the output latency in microseconds,
+		//		 both are measured per machine (see AudioEngine::StartBufferCalibration() and the Sandbox's AudioLatency state)
 		struct
 		{
 			i32 MusicVolume{};
 			i32 SoundVolume{};
+			i32 SampleBufferSize{};
+			i32 OutputLatency{};
 		} Audio;
 
 		struct
@@ -0,0 +1,416 @@
+#include "AudioBenchmarkState.h"
+#include "GameContext.h"
+#include <Audio/AudioEngine.h>
+#include <Audio/Mixing/AdpcmCodec.h>
+#include <Audio/Mixing/MixKernels.h>
+#include <Audio/Mixing/Resampler.h>
+#include <Common/Logging/Logging.h>
+#include <Input/Keyboard.h>
+#include <SDL2/SDL_timer.h>
+#include <random>
+#include <vector>
+
+using namespace Starshine;
+using namespace Starshine::Audio;
+using namespace Starshine::Input;
+using namespace Starshine::Rendering::Render2D;
+
+namespace Sandbox::AudioBenchmark
+{
+	struct AudioBenchmarkState::Impl
+	{
+		static constexpr const char* LogName = "Sandbox::AudioBenchmark";
+
+		// NOTE: A single SDL callback worth of data (1024 stereo frames)
+		static constexpr size_t BufferSampleCount = AudioEngine::DefaultSampleBufferSize;
+		static constexpr size_t BufferFrameCount = BufferSampleCount / AudioEngine::DefaultChannelCount;
+
+		static constexpr size_t VoiceCount = 128;
+
+		// NOTE: Music, SFX and UI, mixed into the master bus the same way the engine does
+		static constexpr size_t SubmixBusCount = 3;
+		static constexpr size_t CallbackIterations = 2000;
+
+		// NOTE: The most common conversion, a 48 kHz file played on a 44.1 kHz device
+		static constexpr f64 ResampleStep = 48000.0 / 44100.0;
+		static constexpr size_t ResampleSourceFrameCount = static_cast<size_t>(BufferFrameCount * ResampleStep) + Mixing::MaxTapCount + 1;
+
+		static constexpr size_t AdpcmFrameBlockCount = Mixing::GetAdpcmFrameBlockCount(BufferFrameCount);
+
+		struct BenchmarkVoice
+		{
+			u32 Channels{};
+			f32 Volume{};
+			std::vector<i16> Samples;
+
+			// NOTE: The first buffer worth of 'Samples' as IMA-ADPCM blocks
+			std::vector<u8> AdpcmBlocks;
+		};
+
+		AudioBenchmarkState& Parent;
+
+		std::vector<BenchmarkVoice> voices;
+		std::array<f32, BufferSampleCount> mixingBuffer{};
+		std::array<f32, BufferSampleCount> outputBuffer{};
+		std::array<std::array<f32, BufferSampleCount>, SubmixBusCount + 1> busBuffers{};
+		std::array<i16, AdpcmFrameBlockCount * Mixing::AdpcmBlockFrames * 2> adpcmDecodeBuffer{};
+
+		// NOTE: Planar input with a zeroed history in front, the same layout the engine uses
+		std::array<std::vector<f32>, 2> resampleBuffer;
+
+		std::string resultText;
+
+		Impl(AudioBenchmarkState& parent) : Parent(parent) {}
+		~Impl() {}
+
+		void CreateVoices()
+		{
+			std::mt19937 random(0x4D495855);
+			std::uniform_int_distribution<i32> sampleDistribution(std::numeric_limits<i16>::min(), std::numeric_limits<i16>::max());
+			std::uniform_real_distribution<f32> volumeDistribution(0.05f, 0.5f);
+
+			voices.resize(VoiceCount);
+			for (size_t i = 0; i < VoiceCount; i++)
+			{
+				// NOTE: Hit sounds are mono, music is stereo. Mix both to exercise every kernel
+				BenchmarkVoice& voice = voices[i];
+				voice.Channels = (i % 4 == 0) ? 2 : 1;
+				voice.Volume = volumeDistribution(random);
+				voice.Samples.resize(ResampleSourceFrameCount * voice.Channels);
+
+				for (auto& sample : voice.Samples)
+				{
+					sample = static_cast<i16>(sampleDistribution(random));
+				}
+
+				std::array<Mixing::AdpcmChannelState, 2> adpcmStates{};
+				voice.AdpcmBlocks.resize(AdpcmFrameBlockCount * voice.Channels * Mixing::AdpcmBlockSize);
+				Mixing::EncodeAdpcm(voice.AdpcmBlocks.data(), voice.Samples.data(), BufferFrameCount, voice.Channels, adpcmStates.data());
+			}
+
+			for (auto& channel : resampleBuffer)
+			{
+				channel.assign(Mixing::MaxTapCount + ResampleSourceFrameCount, 0.0f);
+			}
+		}
+
+		// NOTE: Per-sample conversion with a clamp after every voice (the mixing loop used before the SIMD kernels)
+		void MixLegacy()
+		{
+			SDL_memset(mixingBuffer.data(), 0, mixingBuffer.size() * sizeof(f32));
+
+			for (const auto& voice : voices)
+			{
+				for (size_t pos = 0; pos < BufferFrameCount * voice.Channels; pos += voice.Channels)
+				{
+					if (voice.Channels == 1)
+					{
+						f32 sample = static_cast<f32>(voice.Samples[pos]) / static_cast<f32>(std::numeric_limits<i16>::max()) * voice.Volume;
+						mixingBuffer[pos * 2 + 0] += sample;
+						mixingBuffer[pos * 2 + 1] += sample;
+
+						mixingBuffer[pos * 2 + 0] = SDL_clamp(mixingBuffer[pos * 2 + 0], -1.0f, 1.0f);
+						mixingBuffer[pos * 2 + 1] = SDL_clamp(mixingBuffer[pos * 2 + 1], -1.0f, 1.0f);
+					}
+					else
+					{
+						mixingBuffer[pos + 0] += static_cast<f32>(voice.Samples[pos + 0]) / static_cast<f32>(std::numeric_limits<i16>::max()) * voice.Volume;
+						mixingBuffer[pos + 1] += static_cast<f32>(voice.Samples[pos + 1]) / static_cast<f32>(std::numeric_limits<i16>::max()) * voice.Volume;
+
+						mixingBuffer[pos + 0] = SDL_clamp(mixingBuffer[pos + 0], -1.0f, 1.0f);
+						mixingBuffer[pos + 1] = SDL_clamp(mixingBuffer[pos + 1], -1.0f, 1.0f);
+					}
+				}
+			}
+
+			SDL_memcpy(outputBuffer.data(), mixingBuffer.data(), mixingBuffer.size() * sizeof(f32));
+		}
+
+		void MixKernels(const Mixing::MixKernelTable& kernels)
+		{
+			SDL_memset(mixingBuffer.data(), 0, mixingBuffer.size() * sizeof(f32));
+
+			for (const auto& voice : voices)
+			{
+				if (voice.Channels == 1)
+				{
+					kernels.AccumulateMono(mixingBuffer.data(), voice.Samples.data(), BufferFrameCount, voice.Volume);
+				}
+				else
+				{
+					kernels.AccumulateStereo(mixingBuffer.data(), voice.Samples.data(), BufferFrameCount, voice.Volume);
+				}
+			}
+
+			kernels.ClampCopy(outputBuffer.data(), mixingBuffer.data(), mixingBuffer.size());
+		}
+
+		void MixBuses(const Mixing::MixKernelTable& kernels)
+		{
+			for (auto& busBuffer : busBuffers)
+			{
+				SDL_memset(busBuffer.data(), 0, busBuffer.size() * sizeof(f32));
+			}
+
+			for (size_t i = 0; i < voices.size(); i++)
+			{
+				const BenchmarkVoice& voice = voices[i];
+				f32* busBuffer = busBuffers[1 + i % SubmixBusCount].data();
+
+				if (voice.Channels == 1)
+				{
+					kernels.AccumulateMono(busBuffer, voice.Samples.data(), BufferFrameCount, voice.Volume);
+				}
+				else
+				{
+					kernels.AccumulateStereo(busBuffer, voice.Samples.data(), BufferFrameCount, voice.Volume);
+				}
+			}
+
+			// NOTE: Every bus ramps its gain for the whole buffer, the most expensive case
+			constexpr f32 gainStep = -0.5f / static_cast<f32>(BufferFrameCount);
+
+			Mixing::BusLevels levels{};
+			for (size_t bus = 1; bus <= SubmixBusCount; bus++)
+			{
+				kernels.AccumulateBus(busBuffers[0].data(), busBuffers[bus].data(), BufferFrameCount, 1.0f, gainStep, levels);
+			}
+
+			SDL_memset(mixingBuffer.data(), 0, mixingBuffer.size() * sizeof(f32));
+			kernels.AccumulateBus(mixingBuffer.data(), busBuffers[0].data(), BufferFrameCount, 1.0f, gainStep, levels);
+
+			kernels.ClampCopy(outputBuffer.data(), mixingBuffer.data(), mixingBuffer.size());
+		}
+
+		// NOTE: Same as MixKernels(), but every voice is decoded from IMA-ADPCM first like the engine does for compressed sources
+		void MixAdpcm(const Mixing::MixKernelTable& kernels, const Mixing::AdpcmKernelTable& adpcmKernels)
+		{
+			SDL_memset(mixingBuffer.data(), 0, mixingBuffer.size() * sizeof(f32));
+
+			for (const auto& voice : voices)
+			{
+				adpcmKernels.DecodeFrameBlocks(adpcmDecodeBuffer.data(), voice.AdpcmBlocks.data(), AdpcmFrameBlockCount, voice.Channels);
+
+				if (voice.Channels == 1)
+				{
+					kernels.AccumulateMono(mixingBuffer.data(), adpcmDecodeBuffer.data(), BufferFrameCount, voice.Volume);
+				}
+				else
+				{
+					kernels.AccumulateStereo(mixingBuffer.data(), adpcmDecodeBuffer.data(), BufferFrameCount, voice.Volume);
+				}
+			}
+
+			kernels.ClampCopy(outputBuffer.data(), mixingBuffer.data(), mixingBuffer.size());
+		}
+
+		void MixResampled(const Mixing::ResampleKernelTable& kernels, const Mixing::FilterBank& filterBank)
+		{
+			SDL_memset(mixingBuffer.data(), 0, mixingBuffer.size() * sizeof(f32));
+
+			for (const auto& voice : voices)
+			{
+				for (size_t channel = 0; channel < voice.Channels; channel++)
+				{
+					f32* input = &resampleBuffer[channel][Mixing::MaxTapCount];
+					for (size_t frame = 0; frame < ResampleSourceFrameCount; frame++)
+					{
+						input[frame] = static_cast<f32>(voice.Samples[frame * voice.Channels + channel]) * Mixing::I16ToF32Scale;
+					}
+				}
+
+				if (voice.Channels == 1)
+				{
+					kernels.ResampleMono(mixingBuffer.data(), &resampleBuffer[0][Mixing::MaxTapCount], filterBank, 0.0, ResampleStep, BufferFrameCount, voice.Volume);
+				}
+				else
+				{
+					kernels.ResampleStereo(mixingBuffer.data(), &resampleBuffer[0][Mixing::MaxTapCount], &resampleBuffer[1][Mixing::MaxTapCount],
+						filterBank, 0.0, ResampleStep, BufferFrameCount, voice.Volume);
+				}
+			}
+
+			Mixing::GetMixKernels().ClampCopy(outputBuffer.data(), mixingBuffer.data(), mixingBuffer.size());
+		}
+
+		template <typename MixFunction>
+		f64 MeasureCallbackTime(MixFunction mixFunction)
+		{
+			// NOTE: Warm up caches before measuring
+			for (size_t i = 0; i < CallbackIterations / 10; i++) { mixFunction(); }
+
+			u64 startTicks = SDL_GetPerformanceCounter();
+			for (size_t i = 0; i < CallbackIterations; i++) { mixFunction(); }
+			u64 endTicks = SDL_GetPerformanceCounter();
+
+			f64 totalMicroseconds = static_cast<f64>(endTicks - startTicks) * 1000000.0 / static_cast<f64>(SDL_GetPerformanceFrequency());
+			return totalMicroseconds / static_cast<f64>(CallbackIterations);
+		}
+
+		void AppendResult(std::string_view name, f64 microseconds, f64 baselineMicroseconds)
+		{
+			char line[128] = {};
+			SDL_snprintf(line, sizeof(line) - 1, "%-14s %9.2f us/callback (%5.2fx)\n", name.data(), microseconds, baselineMicroseconds / microseconds);
+
+			LogInfo(LogName, "%s", line);
+			resultText += line;
+		}
+
+		void RunBenchmark()
+		{
+			resultText.clear();
+
+			char header[128] = {};
+			SDL_snprintf(header, sizeof(header) - 1, "Mixing %zu voices into a %zu-sample buffer, %zu callbacks\n\n", VoiceCount, BufferSampleCount, CallbackIterations);
+			resultText += header;
+
+			f64 legacyTime = MeasureCallbackTime([this]() { MixLegacy(); });
+			AppendResult("Legacy", legacyTime, legacyTime);
+
+			for (size_t i = 0; i < EnumCount<Mixing::InstructionSet>(); i++)
+			{
+				Mixing::InstructionSet set = static_cast<Mixing::InstructionSet>(i);
+				if (!Mixing::IsInstructionSetSupported(set))
+				{
+					continue;
+				}
+
+				const Mixing::MixKernelTable& kernels = Mixing::GetMixKernels(set);
+				f64 kernelTime = MeasureCallbackTime([this, &kernels]() { MixKernels(kernels); });
+				AppendResult(EnumToString(Mixing::InstructionSetStringTable, set), kernelTime, legacyTime);
+			}
+
+			SDL_snprintf(header, sizeof(header) - 1, "\nMixing %zu voices through %zu buses into the master bus\n\n", VoiceCount, SubmixBusCount);
+			resultText += header;
+
+			AppendResult("Legacy", legacyTime, legacyTime);
+
+			for (size_t i = 0; i < EnumCount<Mixing::InstructionSet>(); i++)
+			{
+				Mixing::InstructionSet set = static_cast<Mixing::InstructionSet>(i);
+				if (!Mixing::IsInstructionSetSupported(set))
+				{
+					continue;
+				}
+
+				const Mixing::MixKernelTable& kernels = Mixing::GetMixKernels(set);
+				f64 busTime = MeasureCallbackTime([this, &kernels]() { MixBuses(kernels); });
+				AppendResult(EnumToString(Mixing::InstructionSetStringTable, set), busTime, legacyTime);
+			}
+
+			SDL_snprintf(header, sizeof(header) - 1, "\nResampling %zu voices from 48000 Hz to 44100 Hz\n\n", VoiceCount);
+			resultText += header;
+
+			AppendResult("Legacy", legacyTime, legacyTime);
+
+			const Mixing::InstructionSet bestSet = Mixing::GetBestInstructionSet();
+			for (size_t i = 0; i < EnumCount<Mixing::ResamplerQuality>(); i++)
+			{
+				Mixing::ResamplerQuality quality = static_cast<Mixing::ResamplerQuality>(i);
+				Mixing::FilterBankSet filterBanks(quality);
+				const Mixing::FilterBank& filterBank = filterBanks.GetFilterBank(ResampleStep);
+
+				for (Mixing::InstructionSet set : { Mixing::InstructionSet::Scalar, bestSet })
+				{
+					const Mixing::ResampleKernelTable& kernels = Mixing::GetResampleKernels(set);
+					f64 resampleTime = MeasureCallbackTime([this, &kernels, &filterBank]() { MixResampled(kernels, filterBank); });
+
+					char name[32] = {};
+					SDL_snprintf(name, sizeof(name) - 1, "%s/%s",
+						EnumToString(Mixing::ResamplerQualityStringTable, quality).data(), EnumToString(Mixing::InstructionSetStringTable, set).data());
+					AppendResult(name, resampleTime, legacyTime);
+
+					if (set == bestSet)
+					{
+						break;
+					}
+				}
+			}
+
+			size_t pcmSize = 0;
+			size_t adpcmSize = 0;
+			for (const auto& voice : voices)
+			{
+				pcmSize += BufferFrameCount * voice.Channels * sizeof(i16);
+				adpcmSize += voice.AdpcmBlocks.size();
+			}
+
+			SDL_snprintf(header, sizeof(header) - 1, "\nMixing %zu voices from ADPCM sources (%zu KiB instead of %zu KiB of PCM16)\n\n", VoiceCount, adpcmSize / 1024, pcmSize / 1024);
+			resultText += header;
+
+			const Mixing::MixKernelTable& bestKernels = Mixing::GetMixKernels(bestSet);
+			f64 pcmTime = MeasureCallbackTime([this, &bestKernels]() { MixKernels(bestKernels); });
+			AppendResult("PCM16", pcmTime, pcmTime);
+
+			for (size_t i = 0; i < EnumCount<Mixing::InstructionSet>(); i++)
+			{
+				Mixing::InstructionSet set = static_cast<Mixing::InstructionSet>(i);
+				if (!Mixing::IsInstructionSetSupported(set))
+				{
+					continue;
+				}
+
+				const Mixing::AdpcmKernelTable& adpcmKernels = Mixing::GetAdpcmKernels(set);
+				f64 adpcmTime = MeasureCallbackTime([this, &bestKernels, &adpcmKernels]() { MixAdpcm(bestKernels, adpcmKernels); });
+
+				char name[32] = {};
+				SDL_snprintf(name, sizeof(name) - 1, "ADPCM/%s", EnumToString(Mixing::InstructionSetStringTable, set).data());
+				AppendResult(name, adpcmTime, pcmTime);
+			}
+
+			resultText += "\nPress F5 to run again";
+		}
+
+		void Draw()
+		{
+			SpriteRenderer* sprRenderer = GameContext::GetInstance()->SpriteRenderer.get();
+			auto& debugFont = GameContext::GetInstance()->DebugFont;
+
+			sprRenderer->GetRenderingDevice()->Clear(Rendering::ClearFlags_Color, DefaultColors::ClearColor_InGame, 1.0f, 0);
+			sprRenderer->Font().DrawString(debugFont.get(), resultText, vec2(0.0f), vec2(1.0f), DefaultColors::White);
+			sprRenderer->RenderSprites(nullptr);
+		}
+	};
+
+	AudioBenchmarkState::AudioBenchmarkState() : impl(std::make_unique<Impl>(*this))
+	{
+	}
+
+	AudioBenchmarkState::~AudioBenchmarkState()
+	{
+	}
+
+	bool AudioBenchmarkState::Initialize()
+	{
+		impl->CreateVoices();
+		return true;
+	}
+
+	bool AudioBenchmarkState::LoadContent()
+	{
+		impl->RunBenchmark();
+		return true;
+	}
+
+	void AudioBenchmarkState::UnloadContent()
+	{
+	}
+
+	void AudioBenchmarkState::Destroy()
+	{
+		impl->voices.clear();
+	}
+
+	void AudioBenchmarkState::Update(Starshine::GameTime& gameTime)
+	{
+		if (Keyboard::IsKeyTapped(SDLK_F5))
+		{
+			impl->RunBenchmark();
+		}
+	}
+
+	void AudioBenchmarkState::Draw(Starshine::GameTime& gameTime)
+	{
+		impl->Draw();
+	}
+}
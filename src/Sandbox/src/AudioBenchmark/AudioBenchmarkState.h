@@ -0,0 +1,29 @@
+#pragma once
+#include "Common/Types.h"
+#include <GameInstance.h>
+
+namespace Sandbox::AudioBenchmark
+{
+	class AudioBenchmarkState : public Starshine::GameState
+	{
+	public:
+		AudioBenchmarkState();
+		~AudioBenchmarkState();
+
+	public:
+		bool Initialize();
+		bool LoadContent();
+
+		void UnloadContent();
+		void Destroy();
+
+		void Update(Starshine::GameTime& gameTime);
+		void Draw(Starshine::GameTime& gameTime);
+
+		inline std::string_view GetStateName() { return "AudioBenchmark"; };
+
+	private:
+		struct Impl;
+		std::unique_ptr<Impl> impl{};
+	};
+}
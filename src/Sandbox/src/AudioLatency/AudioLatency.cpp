@@ -0,0 +1,476 @@
+#include "AudioLatencyState.h"
+#include "GameContext.h"
+#include <Audio/AudioEngine.h>
+#include <Common/Logging/Logging.h>
+#include <Common/MathExt.h>
+#include <ImGui/Extensions/AudioEngineStatsWindow.h>
+#include <Input/Keyboard.h>
+#include <SDL2/SDL_audio.h>
+#include <SDL2/SDL_events.h>
+#include <SDL2/SDL_timer.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <vector>
+
+using namespace Starshine;
+using namespace Starshine::Audio;
+using namespace Starshine::Input;
+using namespace Starshine::Rendering::Render2D;
+
+namespace Sandbox::AudioLatency
+{
+	struct AudioLatencyState::Impl
+	{
+		static constexpr const char* LogName = "Sandbox::AudioLatency";
+
+		static constexpr i32 CaptureSampleRate = 44100;
+		static constexpr u16 CaptureBufferFrames = 128;
+
+		// NOTE: A short decaying 2 kHz burst followed by silence, so the voice is still playing when the onset has been detected
+		static constexpr f64 ClickDuration = 0.005;
+		static constexpr f64 ClickSourceDuration = 1.0;
+		static constexpr f64 ClickFrequency = 2000.0;
+
+		static constexpr TimeSpan TapInterval = TimeSpanConversion::FromMilliseconds(750.0);
+		static constexpr TimeSpan OnsetTimeout = TimeSpanConversion::FromMilliseconds(600.0);
+		static constexpr size_t TrialCount = 20;
+
+		// NOTE: An onset is a sample louder than both the minimum level and a multiple of the (slowly adapting) background noise level
+		static constexpr f32 MinOnsetLevel = 0.02f;
+		static constexpr f32 OnsetNoiseRatio = 8.0f;
+		static constexpr f32 NoiseFloorAdaptRate = 0.001f;
+
+		enum class TrialState : u8
+		{
+			Idle,
+			WaitingForTap,
+			WaitingForOnset,
+		};
+
+		// NOTE: Milliseconds, one entry per detected click
+		struct Results
+		{
+			std::vector<f64> InputToUpdate;
+			std::vector<f64> UpdateToAudible;
+			std::vector<f64> RoundTrip;
+			std::vector<f64> LatencyError;
+			size_t MissedClicks{};
+		};
+
+		AudioLatencyState& Parent;
+
+		SourceHandle clickSource{ SourceHandle::Invalid };
+		Voice clickVoice{};
+
+		SDL_AudioDeviceID captureDevice{};
+		SDL_AudioSpec captureSpec{};
+		f32 noiseFloor{};
+		std::atomic<bool> captureArmed{};
+		std::atomic<u64> onsetTicks{};
+
+		bool measuring{};
+		TrialState trialState{};
+		u64 pushTicks{};
+		u64 tapTicks{};
+		u64 lastTrialTicks{};
+		Results results;
+
+		std::string resultText;
+		ImGuiExtensions::AudioEngineStatsWindow statsWindow;
+
+		Impl(AudioLatencyState& parent) : Parent(parent) {}
+		~Impl() {}
+
+		static f64 TicksToMilliseconds(i64 ticks)
+		{
+			return static_cast<f64>(ticks) * 1000.0 / static_cast<f64>(SDL_GetPerformanceFrequency());
+		}
+
+		static f64 GetMedian(std::vector<f64> values)
+		{
+			if (values.empty())
+			{
+				return 0.0;
+			}
+
+			auto middle = values.begin() + values.size() / 2;
+			std::nth_element(values.begin(), middle, values.end());
+			return *middle;
+		}
+
+		// NOTE: 16-bit mono PCM wrapped in a minimal WAV header, so it takes the same LoadSource() path as the game's hit sounds
+		static std::vector<u8> CreateClickWav()
+		{
+			const u32 sampleRate = static_cast<u32>(AudioEngine::DefaultSampleRate);
+			const u32 sampleCount = static_cast<u32>(ClickSourceDuration * sampleRate);
+			const u32 clickSampleCount = static_cast<u32>(ClickDuration * sampleRate);
+			const u32 dataSize = sampleCount * sizeof(i16);
+
+			std::vector<u8> wav(44 + dataSize);
+			auto writeU32 = [&wav](size_t offset, u32 value) { SDL_memcpy(&wav[offset], &value, sizeof(value)); };
+			auto writeU16 = [&wav](size_t offset, u16 value) { SDL_memcpy(&wav[offset], &value, sizeof(value)); };
+
+			SDL_memcpy(&wav[0], "RIFF", 4);
+			writeU32(4, static_cast<u32>(wav.size() - 8));
+			SDL_memcpy(&wav[8], "WAVEfmt ", 8);
+			writeU32(16, 16);
+			writeU16(20, 1);
+			writeU16(22, 1);
+			writeU32(24, sampleRate);
+			writeU32(28, sampleRate * sizeof(i16));
+			writeU16(32, sizeof(i16));
+			writeU16(34, 16);
+			SDL_memcpy(&wav[36], "data", 4);
+			writeU32(40, dataSize);
+
+			i16* samples = reinterpret_cast<i16*>(&wav[44]);
+			for (u32 i = 0; i < clickSampleCount; i++)
+			{
+				const f64 time = static_cast<f64>(i) / static_cast<f64>(sampleRate);
+				const f64 envelope = 1.0 - static_cast<f64>(i) / static_cast<f64>(clickSampleCount);
+				samples[i] = static_cast<i16>(std::sin(time * ClickFrequency * MathExtensions::TwoPi) * envelope * 32000.0);
+			}
+
+			return wav;
+		}
+
+		static void SDLCALL CaptureCallback(void* userData, Uint8* stream, int len)
+		{
+			const u64 callbackTicks = SDL_GetPerformanceCounter();
+			Impl* impl = static_cast<Impl*>(userData);
+
+			const f32* samples = reinterpret_cast<const f32*>(stream);
+			const size_t sampleCount = static_cast<size_t>(len) / sizeof(f32);
+			const bool armed = impl->captureArmed.load(std::memory_order_acquire);
+
+			for (size_t i = 0; i < sampleCount; i++)
+			{
+				const f32 level = std::abs(samples[i]);
+				if (armed && level > std::max(MinOnsetLevel, impl->noiseFloor * OnsetNoiseRatio))
+				{
+					// NOTE: The callback runs once the last sample has been captured, so earlier samples are back-dated by their distance to the end
+					const u64 sampleAgeTicks = (sampleCount - i) * SDL_GetPerformanceFrequency() / static_cast<u64>(impl->captureSpec.freq);
+					impl->onsetTicks.store(callbackTicks - sampleAgeTicks, std::memory_order_release);
+					impl->captureArmed.store(false, std::memory_order_release);
+					return;
+				}
+
+				impl->noiseFloor += (level - impl->noiseFloor) * NoiseFloorAdaptRate;
+			}
+		}
+
+		bool Initialize()
+		{
+			AudioEngine& audioEngine = *AudioEngine::GetInstance();
+
+			const std::vector<u8> clickWav = CreateClickWav();
+			clickSource = audioEngine.LoadSource(clickWav.data(), clickWav.size());
+			clickVoice = audioEngine.AllocateVoice(clickSource);
+
+			SDL_AudioSpec desiredSpec{};
+			desiredSpec.freq = CaptureSampleRate;
+			desiredSpec.format = AUDIO_F32SYS;
+			desiredSpec.channels = 1;
+			desiredSpec.samples = CaptureBufferFrames;
+			desiredSpec.callback = CaptureCallback;
+			desiredSpec.userdata = this;
+
+			if ((captureDevice = SDL_OpenAudioDevice(nullptr, 1, &desiredSpec, &captureSpec, SDL_AUDIO_ALLOW_FREQUENCY_CHANGE)) == 0)
+			{
+				LogError(LogName, "Failed to open a capture device. Error: %s", SDL_GetError());
+			}
+			else
+			{
+				LogInfo(LogName, "Capture device opened: %d Hz, %u frames per buffer", captureSpec.freq, captureSpec.samples);
+				SDL_PauseAudioDevice(captureDevice, 0);
+			}
+
+			UpdateResultText();
+			return true;
+		}
+
+		void Destroy()
+		{
+			if (captureDevice != 0)
+			{
+				SDL_CloseAudioDevice(captureDevice);
+				captureDevice = 0;
+			}
+
+			AudioEngine& audioEngine = *AudioEngine::GetInstance();
+			audioEngine.FreeVoice(clickVoice);
+			audioEngine.UnloadSource(clickSource);
+			clickVoice = {};
+			clickSource = SourceHandle::Invalid;
+		}
+
+		void StartMeasuring()
+		{
+			if (captureDevice == 0)
+			{
+				LogError(LogName, "Can't measure the latency without a capture device");
+				return;
+			}
+
+			results = {};
+			measuring = true;
+			trialState = TrialState::Idle;
+			lastTrialTicks = SDL_GetPerformanceCounter();
+			LogInfo(LogName, "Measuring %zu clicks, keep the microphone close to the speakers", TrialCount);
+		}
+
+		void StopMeasuring()
+		{
+			measuring = false;
+			trialState = TrialState::Idle;
+			captureArmed.store(false, std::memory_order_release);
+			LogResults();
+		}
+
+		void PushSpaceEvent(bool pressed)
+		{
+			SDL_Event event{};
+			event.type = pressed ? SDL_KEYDOWN : SDL_KEYUP;
+			event.key.timestamp = SDL_GetTicks();
+			event.key.state = pressed ? SDL_PRESSED : SDL_RELEASED;
+			event.key.keysym.scancode = SDL_SCANCODE_SPACE;
+			event.key.keysym.sym = SDLK_SPACE;
+			SDL_PushEvent(&event);
+		}
+
+		void UpdateTrial()
+		{
+			const u64 nowTicks = SDL_GetPerformanceCounter();
+
+			// NOTE: The tap goes through the SDL event queue and the Keyboard state like a real key press would.
+			//		 Pressing space by hand works too and additionally includes the keyboard's own latency, it's just not part of 'InputToUpdate'
+			if (Keyboard::IsKeyTapped(SDLK_SPACE) && trialState != TrialState::WaitingForOnset)
+			{
+				const bool synthetic = (trialState == TrialState::WaitingForTap);
+				if (synthetic)
+				{
+					PushSpaceEvent(false);
+				}
+
+				tapTicks = nowTicks;
+				if (!synthetic)
+				{
+					pushTicks = nowTicks;
+				}
+
+				onsetTicks.store(0, std::memory_order_release);
+				captureArmed.store(true, std::memory_order_release);
+
+				clickVoice.SetFramePosition(0);
+				clickVoice.SetPlaying(true);
+
+				trialState = TrialState::WaitingForOnset;
+				lastTrialTicks = nowTicks;
+				return;
+			}
+
+			if (trialState == TrialState::WaitingForOnset)
+			{
+				const u64 onset = onsetTicks.load(std::memory_order_acquire);
+				if (onset != 0)
+				{
+					// NOTE: Where the engine thinks playback is right now versus how long ago the click actually became audible
+					const f64 engineAudibleTime = clickVoice.GetPlaybackTime().GetMilliseconds();
+					const f64 actualAudibleTime = TicksToMilliseconds(static_cast<i64>(nowTicks - onset));
+
+					results.InputToUpdate.push_back(TicksToMilliseconds(static_cast<i64>(tapTicks - pushTicks)));
+					results.UpdateToAudible.push_back(TicksToMilliseconds(static_cast<i64>(onset - tapTicks)));
+					results.RoundTrip.push_back(TicksToMilliseconds(static_cast<i64>(onset - pushTicks)));
+					results.LatencyError.push_back(engineAudibleTime - actualAudibleTime);
+
+					trialState = TrialState::Idle;
+					clickVoice.SetPlaying(false);
+				}
+				else if (TicksToMilliseconds(static_cast<i64>(nowTicks - tapTicks)) > OnsetTimeout.GetMilliseconds())
+				{
+					results.MissedClicks++;
+					captureArmed.store(false, std::memory_order_release);
+
+					trialState = TrialState::Idle;
+					clickVoice.SetPlaying(false);
+				}
+			}
+
+			if (measuring && results.RoundTrip.size() >= TrialCount && trialState == TrialState::Idle)
+			{
+				StopMeasuring();
+				return;
+			}
+
+			if (measuring && trialState == TrialState::Idle && TicksToMilliseconds(static_cast<i64>(nowTicks - lastTrialTicks)) > TapInterval.GetMilliseconds())
+			{
+				pushTicks = nowTicks;
+				PushSpaceEvent(true);
+
+				trialState = TrialState::WaitingForTap;
+				lastTrialTicks = nowTicks;
+			}
+		}
+
+		TimeSpan GetSuggestedOutputLatency() const
+		{
+			const AudioEngine& audioEngine = *AudioEngine::GetInstance();
+			const f64 latency = audioEngine.GetOutputLatency().GetMilliseconds() + GetMedian(results.LatencyError);
+			return TimeSpanConversion::FromMilliseconds(std::max(latency, 0.0));
+		}
+
+		void ApplySuggestedOutputLatency()
+		{
+			if (results.LatencyError.empty())
+			{
+				return;
+			}
+
+			const TimeSpan latency = GetSuggestedOutputLatency();
+			AudioEngine::GetInstance()->SetOutputLatency(latency);
+			results.LatencyError.clear();
+
+			LogInfo(LogName, "Output latency set to %.2f ms, measure again to verify it", latency.GetMilliseconds());
+		}
+
+		void LogResults()
+		{
+			if (results.RoundTrip.empty())
+			{
+				LogWarn(LogName, "No clicks were detected (%zu missed)", results.MissedClicks);
+				return;
+			}
+
+			LogInfo(LogName, "%zu clicks (%zu missed) at %u samples per buffer", results.RoundTrip.size(), results.MissedClicks, AudioEngine::GetInstance()->GetSampleBufferSize());
+			LogInfo(LogName, "Median input to update: %.2f ms", GetMedian(results.InputToUpdate));
+			LogInfo(LogName, "Median update to audible: %.2f ms", GetMedian(results.UpdateToAudible));
+			LogInfo(LogName, "Median round trip: %.2f ms", GetMedian(results.RoundTrip));
+			LogInfo(LogName, "Median output latency error: %.2f ms, suggested output latency: %.2f ms", GetMedian(results.LatencyError), GetSuggestedOutputLatency().GetMilliseconds());
+		}
+
+		void UpdateResultText()
+		{
+			const AudioEngine& audioEngine = *AudioEngine::GetInstance();
+			const BufferCalibrationStatus calibration = audioEngine.GetBufferCalibrationStatus();
+
+			char line[192] = {};
+			resultText.clear();
+
+			SDL_snprintf(line, sizeof(line) - 1, "Buffer: %u samples, output latency: %.2f ms\n", audioEngine.GetSampleBufferSize(), audioEngine.GetOutputLatency().GetMilliseconds());
+			resultText += line;
+
+			SDL_snprintf(line, sizeof(line) - 1, "Buffer calibration: %s\n", EnumToString(BufferCalibrationStateStringTable, calibration.State).data());
+			resultText += line;
+
+			for (const BufferCalibrationStep& step : calibration.Steps)
+			{
+				SDL_snprintf(line, sizeof(line) - 1, "  %5u: %4llu callbacks, %llu underruns, %llu misses, %6.2f ms jitter, %6.2f ms max  %s\n",
+					step.SampleBufferSize, step.Callbacks, step.Underruns, step.DeadlineMisses,
+					step.MaxCallbackJitter.GetMilliseconds(), step.MaxCallbackDuration.GetMilliseconds(), step.Stable ? "stable" : "");
+				resultText += line;
+			}
+
+			SDL_snprintf(line, sizeof(line) - 1, "\nClicks: %zu / %zu (%zu missed)%s\n", results.RoundTrip.size(), TrialCount, results.MissedClicks, measuring ? ", measuring..." : "");
+			resultText += line;
+
+			if (!results.RoundTrip.empty())
+			{
+				SDL_snprintf(line, sizeof(line) - 1, "Input to update:    %7.2f ms\nUpdate to audible:  %7.2f ms\nRound trip:         %7.2f ms\n",
+					GetMedian(results.InputToUpdate), GetMedian(results.UpdateToAudible), GetMedian(results.RoundTrip));
+				resultText += line;
+			}
+
+			if (!results.LatencyError.empty())
+			{
+				SDL_snprintf(line, sizeof(line) - 1, "Output latency error: %.2f ms, suggested: %.2f ms\n", GetMedian(results.LatencyError), GetSuggestedOutputLatency().GetMilliseconds());
+				resultText += line;
+			}
+
+			resultText += "\nF1: Calibrate buffer size\nF2: Measure latency (space plays a click by hand)\nF3: Audio engine stats\nF6: Apply suggested output latency";
+		}
+
+		void Update()
+		{
+			AudioEngine& audioEngine = *AudioEngine::GetInstance();
+
+			if (Keyboard::IsKeyTapped(SDLK_F1))
+			{
+				if (audioEngine.GetBufferCalibrationStatus().State == BufferCalibrationState::Running)
+					audioEngine.CancelBufferCalibration();
+				else
+					audioEngine.StartBufferCalibration();
+			}
+
+			if (Keyboard::IsKeyTapped(SDLK_F2))
+			{
+				if (measuring)
+					StopMeasuring();
+				else
+					StartMeasuring();
+			}
+
+			if (Keyboard::IsKeyTapped(SDLK_F3))
+			{
+				statsWindow.DrawWindow = !statsWindow.DrawWindow;
+			}
+
+			if (Keyboard::IsKeyTapped(SDLK_F6))
+			{
+				ApplySuggestedOutputLatency();
+			}
+
+			UpdateTrial();
+			UpdateResultText();
+		}
+
+		void Draw()
+		{
+			SpriteRenderer* sprRenderer = GameContext::GetInstance()->SpriteRenderer.get();
+			auto& debugFont = GameContext::GetInstance()->DebugFont;
+
+			sprRenderer->GetRenderingDevice()->Clear(Rendering::ClearFlags_Color, DefaultColors::ClearColor_InGame, 1.0f, 0);
+			sprRenderer->Font().DrawString(debugFont.get(), resultText, vec2(0.0f), vec2(1.0f), DefaultColors::White);
+			sprRenderer->RenderSprites(nullptr);
+
+			statsWindow.OnGUI();
+		}
+	};
+
+	AudioLatencyState::AudioLatencyState() : impl(std::make_unique<Impl>(*this))
+	{
+	}
+
+	AudioLatencyState::~AudioLatencyState()
+	{
+	}
+
+	bool AudioLatencyState::Initialize()
+	{
+		return impl->Initialize();
+	}
+
+	bool AudioLatencyState::LoadContent()
+	{
+		return true;
+	}
+
+	void AudioLatencyState::UnloadContent()
+	{
+	}
+
+	void AudioLatencyState::Destroy()
+	{
+		impl->Destroy();
+	}
+
+	void AudioLatencyState::Update(Starshine::GameTime& gameTime)
+	{
+		impl->Update();
+	}
+
+	void AudioLatencyState::Draw(Starshine::GameTime& gameTime)
+	{
+		impl->Draw();
+	}
+}
@@ -4,6 +4,11 @@
 #include <type_traits>
 
 #include "VideoTest/VideoTestState.h"
+#include "AudioBenchmark/AudioBenchmarkState.h"
+#include "AudioLatency/AudioLatencyState.h"
+#include "DrawReplay/DrawReplayState.h"
+#include "SpriteBenchmark/SpriteBenchmarkState.h"
+#include "GoldenImage/GoldenImageState.h"
 
 namespace Sandbox
 {
@@ -12,13 +17,34 @@ namespace Sandbox
 		NotSet = -1,
 
 		VideoTest,
+		AudioBenchmark,
+		AudioLatency,
+		DrawReplay,
+		SpriteBenchmark,
+		GoldenImage,
 
 		Count
 	};
 
+	constexpr Starshine::EnumStringMappingTable<StateID> StateIDStringTable
+	{
+		Starshine::EnumStringMapping<StateID>
+		{ StateID::VideoTest, "VideoTest" },
+		{ StateID::AudioBenchmark, "AudioBenchmark" },
+		{ StateID::AudioLatency, "AudioLatency" },
+		{ StateID::DrawReplay, "DrawReplay" },
+		{ StateID::SpriteBenchmark, "SpriteBenchmark" },
+		{ StateID::GoldenImage, "GoldenImage" }
+	};
+
 	static std::unique_ptr<Starshine::GameState> StateInstances[Starshine::EnumCount<StateID>()]
 	{
-		std::make_unique<VideoTest::VideoTestState>()
+		std::make_unique<VideoTest::VideoTestState>(),
+		std::make_unique<AudioBenchmark::AudioBenchmarkState>(),
+		std::make_unique<AudioLatency::AudioLatencyState>(),
+		std::make_unique<DrawReplay::DrawReplayState>(),
+		std::make_unique<SpriteBenchmark::SpriteBenchmarkState>(),
+		std::make_unique<GoldenImage::GoldenImageState>()
 	};
 
 	template <typename StateType>
@@ -0,0 +1,106 @@
+#include "DrawReplayState.h"
+#include "GameContext.h"
+#include <Common/Logging/Logging.h>
+#include <Rendering/Device.h>
+#include <Rendering/Null/CommandRecording.h>
+#include <SDL2/SDL_timer.h>
+
+using namespace Starshine;
+using namespace Starshine::Rendering;
+
+namespace Sandbox::DrawReplay
+{
+	struct DrawReplayState::Impl
+	{
+		static constexpr const char* LogName = "Sandbox::DrawReplay";
+
+		DrawReplayState& Parent;
+
+		Null::CommandRecording recording;
+		std::unique_ptr<Null::CommandReplayer> replayer;
+
+		u64 passStartTicks{};
+		u32 passCount{};
+
+		Impl(DrawReplayState& parent) : Parent(parent) {}
+		~Impl() {}
+
+		bool Initialize()
+		{
+			const std::string& recordingPath = GameContext::GetInstance()->RecordingPath;
+			if (recordingPath.empty() || !recording.LoadFromFile(recordingPath))
+			{
+				LogError(LogName, "Nothing to replay, pass a recording made with the Null device as the third argument");
+				return true;
+			}
+
+			LogInfo(LogName, "Replaying %s: %u frames, %zu bytes", recordingPath.c_str(), recording.GetFrameCount(), recording.GetSize());
+
+			replayer = std::make_unique<Null::CommandReplayer>(recording, *Rendering::GetDevice());
+			passStartTicks = SDL_GetPerformanceCounter();
+			return true;
+		}
+
+		void Destroy()
+		{
+			replayer = nullptr;
+			recording.Clear();
+		}
+
+		void Draw()
+		{
+			if (replayer == nullptr)
+			{
+				Rendering::GetDevice()->Clear(Rendering::ClearFlags_Color, DefaultColors::ClearColor_InGame, 1.0f, 0);
+				return;
+			}
+
+			// NOTE: The recorded frames are played in a loop, one per game frame
+			if (!replayer->ReplayFrame())
+			{
+				const f64 elapsed_ms = static_cast<f64>(SDL_GetPerformanceCounter() - passStartTicks) * 1000.0 / static_cast<f64>(SDL_GetPerformanceFrequency());
+				LogInfo(LogName, "Pass %u: %u frames in %.2f ms", ++passCount, replayer->GetReplayedFrameCount(), elapsed_ms);
+
+				replayer->Restart();
+				passStartTicks = SDL_GetPerformanceCounter();
+				replayer->ReplayFrame();
+			}
+		}
+	};
+
+	DrawReplayState::DrawReplayState() : impl(std::make_unique<Impl>(*this))
+	{
+	}
+
+	DrawReplayState::~DrawReplayState()
+	{
+	}
+
+	bool DrawReplayState::Initialize()
+	{
+		return impl->Initialize();
+	}
+
+	bool DrawReplayState::LoadContent()
+	{
+		return true;
+	}
+
+	void DrawReplayState::UnloadContent()
+	{
+	}
+
+	void DrawReplayState::Destroy()
+	{
+		impl->Destroy();
+	}
+
+	void DrawReplayState::Update(Starshine::GameTime& gameTime)
+	{
+	}
+
+	void DrawReplayState::Draw(Starshine::GameTime& gameTime)
+	{
+		impl->Draw();
+	}
+}
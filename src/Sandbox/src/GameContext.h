@@ -20,6 +20,13 @@ namespace Sandbox
 		std::unique_ptr<Starshine::Graphics::Font> DebugFont;
 		std::unique_ptr<Starshine::Rendering::Render2D::SpriteRenderer> SpriteRenderer;
 
+		// NOTE: Written to when running on the Null device, read by the DrawReplay state
+		std::string RecordingPath;
+
+		// NOTE: Read by the GoldenImage state, which sets the exit code depending on whether its frame matches
+		std::string ReferenceImagePath;
+		i32 ExitCode{};
+
 	public:
 		static bool CreateInstance();
 		static void DestroyInstance();
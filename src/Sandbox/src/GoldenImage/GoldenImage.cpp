@@ -0,0 +1,307 @@
+#include "GoldenImageState.h"
+#include "GameContext.h"
+#include <Common/Logging/Logging.h>
+#include <Misc/ImageHelper.h>
+#include <Rendering/Device.h>
+#include <Rendering/Software/SoftwareDevice.h>
+#include <vector>
+
+using namespace Starshine;
+using namespace Starshine::Rendering;
+using namespace Starshine::Rendering::Render2D;
+
+namespace Sandbox::GoldenImage
+{
+	struct GoldenImageState::Impl
+	{
+		static constexpr const char* LogName = "Sandbox::GoldenImage";
+		static constexpr const char* OutputPath = "GoldenImage_Output.png";
+
+		// NOTE: Pixels may differ by this much per channel, so rounding differences between the SSE2 and the scalar path don't count as failures
+		static constexpr i32 MaxChannelDifference = 2;
+		// NOTE: Vertices transformed by another compiler can round differently, which may move a few pixels along triangle edges
+		static constexpr size_t MaxMismatchedPixels = 64;
+
+		// NOTE: More textures than a single draw call can bind, so the scene covers running out of texture slots
+		static constexpr size_t SolidTextureCount = SpriteTextureSlots + 4;
+
+		GoldenImageState& Parent;
+
+		std::unique_ptr<Graphics::Texture> checkerTexture;
+		std::unique_ptr<Graphics::Texture> gradientTexture;
+		std::unique_ptr<Graphics::Texture> circleTexture;
+		std::vector<std::unique_ptr<Graphics::Texture>> solidTextures;
+
+		bool frameChecked{};
+
+		Impl(GoldenImageState& parent) : Parent(parent) {}
+		~Impl() {}
+
+		// NOTE: The scene only uses generated textures, so the result doesn't depend on any content files
+		void CreateTextures()
+		{
+			constexpr i32 checkerSize = 16;
+			std::vector<u32> checkerPixels(checkerSize * checkerSize);
+			for (i32 y = 0; y < checkerSize; y++)
+			{
+				for (i32 x = 0; x < checkerSize; x++)
+				{
+					checkerPixels[y * checkerSize + x] = (((x / 4) + (y / 4)) % 2 == 0) ? 0xFFFFFFFF : 0xFF404040;
+				}
+			}
+
+			Graphics::TextureFlags nearestFlags{};
+			nearestFlags.NearestFiltering = true;
+			checkerTexture = std::make_unique<Graphics::Texture>(ivec2(checkerSize), Graphics::TextureFormat::RGBA8, nearestFlags, checkerPixels.data());
+
+			constexpr i32 gradientSize = 64;
+			std::vector<Color> gradientPixels(gradientSize * gradientSize);
+			for (i32 y = 0; y < gradientSize; y++)
+			{
+				for (i32 x = 0; x < gradientSize; x++)
+				{
+					gradientPixels[y * gradientSize + x] = Color(static_cast<u8>(x * 4), static_cast<u8>(y * 4), static_cast<u8>(255 - x * 2), 255);
+				}
+			}
+
+			gradientTexture = std::make_unique<Graphics::Texture>(ivec2(gradientSize), Graphics::TextureFormat::RGBA8, Graphics::TextureFlags{}, gradientPixels.data());
+
+			constexpr i32 circleSize = 32;
+			std::vector<Color> circlePixels(circleSize * circleSize);
+			for (i32 y = 0; y < circleSize; y++)
+			{
+				for (i32 x = 0; x < circleSize; x++)
+				{
+					const vec2 offset = vec2(static_cast<f32>(x), static_cast<f32>(y)) - vec2(circleSize / 2.0f - 0.5f);
+					const f32 alpha = MathExtensions::Clamp(circleSize / 2.0f - glm::length(offset), 0.0f, 1.0f);
+					circlePixels[y * circleSize + x] = Color(255, 255, 255, static_cast<u8>(alpha * 255.0f));
+				}
+			}
+
+			circleTexture = std::make_unique<Graphics::Texture>(ivec2(circleSize), Graphics::TextureFormat::RGBA8, Graphics::TextureFlags{}, circlePixels.data());
+
+			for (size_t i = 0; i < SolidTextureCount; i++)
+			{
+				const u32 pixel = 0xFF000000 | static_cast<u32>((i * 0x3F1D47) & 0x00FFFFFF);
+				solidTextures.push_back(std::make_unique<Graphics::Texture>(ivec2(1), Graphics::TextureFormat::RGBA8, nearestFlags, &pixel));
+			}
+		}
+
+		void Destroy()
+		{
+			checkerTexture = nullptr;
+			gradientTexture = nullptr;
+			circleTexture = nullptr;
+			solidTextures.clear();
+		}
+
+		void DrawScene()
+		{
+			SpriteRenderer* sprRenderer = GameContext::GetInstance()->SpriteRenderer.get();
+			sprRenderer->GetRenderingDevice()->Clear(ClearFlags_Color, DefaultColors::ClearColor_InGame, 1.0f, 0);
+
+			// NOTE: Rotated and flipped sprites with sources of both filtering modes
+			for (i32 i = 0; i < 8; i++)
+			{
+				Graphics::Texture* texture = (i % 2 == 0) ? checkerTexture.get() : gradientTexture.get();
+
+				sprRenderer->ResetSprite();
+				sprRenderer->SetSpritePosition(vec2(96.0f + i * 144.0f, 96.0f));
+				sprRenderer->SetSpriteSize(vec2(112.0f, 80.0f));
+				sprRenderer->SetSpriteOrigin(vec2(56.0f, 40.0f));
+				sprRenderer->SetSpriteRotation(MathExtensions::ToRadians(i * 22.5f));
+				sprRenderer->SetSpriteSource(texture, RectangleF(0.0f, 0.0f, static_cast<f32>(texture->GetSize().x) / (1 + i % 3), static_cast<f32>(texture->GetSize().y)));
+				sprRenderer->SetSpriteFlip(i % 4 >= 2, i % 3 == 1);
+				sprRenderer->SetSpriteColor(Color(255, static_cast<u8>(255 - i * 16), static_cast<u8>(128 + i * 16), 255));
+				sprRenderer->PushSprite(texture);
+			}
+
+			// NOTE: Overlapping circles in every blend mode on top of a striped background
+			for (i32 i = 0; i < 6; i++)
+			{
+				sprRenderer->ResetSprite();
+				sprRenderer->SetSpritePosition(vec2(64.0f, 192.0f + i * 32.0f));
+				sprRenderer->SetSpriteSize(vec2(1152.0f, 16.0f));
+				sprRenderer->SetSpriteColor(Color(static_cast<u8>(64 + i * 32), 96, static_cast<u8>(224 - i * 32), 255));
+				sprRenderer->PushSprite(nullptr);
+			}
+
+			constexpr std::array<Graphics::BlendMode, 3> blendModes { Graphics::BlendMode::Normal, Graphics::BlendMode::Add, Graphics::BlendMode::Mulitply };
+			for (size_t mode = 0; mode < blendModes.size(); mode++)
+			{
+				sprRenderer->SetBlendMode(blendModes[mode]);
+				for (i32 i = 0; i < 5; i++)
+				{
+					sprRenderer->ResetSprite();
+					sprRenderer->SetSpritePosition(vec2(160.0f + mode * 384.0f + i * 48.0f, 288.0f));
+					sprRenderer->SetSpriteSize(vec2(128.0f));
+					sprRenderer->SetSpriteOrigin(vec2(64.0f));
+					sprRenderer->SetSpriteColor(Color(static_cast<u8>(255 - i * 48), static_cast<u8>(i * 60), 192, static_cast<u8>(96 + i * 32)));
+					sprRenderer->PushSprite(circleTexture.get());
+				}
+			}
+			sprRenderer->SetBlendMode(Graphics::BlendMode::Normal);
+
+			// NOTE: Interleaved textures, more of them than fit into the texture slots of one draw call
+			for (i32 i = 0; i < 48; i++)
+			{
+				sprRenderer->ResetSprite();
+				sprRenderer->SetSpritePosition(vec2(64.0f + i * 24.0f, 400.0f + (i % 3) * 12.0f));
+				sprRenderer->SetSpriteSize(vec2(20.0f, 40.0f));
+				sprRenderer->PushSprite(solidTextures[(i * 5) % solidTextures.size()].get());
+			}
+
+			// NOTE: Shapes, a textured strip and a triangle list with per vertex colors
+			std::array<SpriteVertex, 16> stripVertices{};
+			for (size_t i = 0; i < stripVertices.size(); i++)
+			{
+				const f32 x = 64.0f + (i / 2) * 80.0f;
+				const f32 y = 496.0f + (i % 2) * 96.0f + ((i / 2) % 2) * 24.0f;
+				stripVertices[i].Position = vec2(x, y);
+				stripVertices[i].TexCoord = vec2((i / 2) / 7.0f, static_cast<f32>(i % 2));
+				stripVertices[i].Color = Color(255, 255, static_cast<u8>(i * 16), 255);
+			}
+			sprRenderer->PushShape(stripVertices.data(), stripVertices.size(), PrimitiveType::TriangleStrip, gradientTexture.get());
+
+			const std::array<SpriteVertex, 6> triangleVertices
+			{
+				SpriteVertex { vec2(736.0f, 592.0f), vec2(0.0f, 0.0f), Color(255, 0, 0, 255) },
+				SpriteVertex { vec2(816.0f, 480.0f), vec2(0.0f, 0.0f), Color(0, 255, 0, 255) },
+				SpriteVertex { vec2(896.0f, 592.0f), vec2(0.0f, 0.0f), Color(0, 0, 255, 255) },
+				SpriteVertex { vec2(912.0f, 480.0f), vec2(0.0f, 0.0f), Color(255, 255, 0, 128) },
+				SpriteVertex { vec2(1072.0f, 496.0f), vec2(1.0f, 0.0f), Color(0, 255, 255, 128) },
+				SpriteVertex { vec2(992.0f, 640.0f), vec2(1.0f, 1.0f), Color(255, 0, 255, 128) }
+			};
+			sprRenderer->PushShape(triangleVertices.data(), triangleVertices.size(), PrimitiveType::Triangles, nullptr);
+
+			for (i32 i = 0; i < 12; i++)
+			{
+				sprRenderer->PushLine(vec2(1136.0f, 560.0f), MathExtensions::ToRadians(i * 30.0f), 72.0f, Color(255, 255, 255, 200), 1.0f + (i % 3));
+			}
+
+			sprRenderer->PushOutlineRect(vec2(32.0f, 32.0f), vec2(1216.0f, 656.0f), vec2(0.0f), Color(255, 128, 0, 255), 4.0f);
+			sprRenderer->RenderSprites(nullptr);
+		}
+
+		// NOTE: Compares the framebuffer against the reference and saves it as OutputPath, the exit code tells whether they match.
+		//		 Without a reference the frame is only saved, so a new reference can be created by copying the output
+		void CheckFrame(Software::SoftwareDevice& device, const std::string& referencePath)
+		{
+			GameContext& context = *GameContext::GetInstance();
+			context.ExitCode = 1;
+
+			if (!device.SaveFramebuffer(OutputPath))
+			{
+				return;
+			}
+
+			ivec2 referenceSize{};
+			i32 referenceChannels{};
+			std::unique_ptr<u8[]> referencePixels{};
+			if (referencePath.empty() || !Misc::ImageHelper::ReadImageFile(referencePath, referenceSize, referenceChannels, referencePixels))
+			{
+				LogError(LogName, "Failed to read the reference image \"%s\", the frame has been saved to %s", referencePath.c_str(), OutputPath);
+				return;
+			}
+
+			const ivec2 size = device.GetFramebufferSize();
+			if (referenceSize != size)
+			{
+				LogError(LogName, "The reference image is %dx%d, the framebuffer is %dx%d", referenceSize.x, referenceSize.y, size.x, size.y);
+				return;
+			}
+
+			size_t pitch = 0;
+			const u32* pixels = device.GetFramebufferData(pitch);
+
+			size_t mismatchedPixels = 0;
+			i32 maxDifference = 0;
+			for (i32 y = 0; y < size.y; y++)
+			{
+				const u8* row = reinterpret_cast<const u8*>(&pixels[y * pitch]);
+				const u8* referenceRow = &referencePixels[static_cast<size_t>(y) * size.x * 4];
+
+				for (i32 x = 0; x < size.x; x++)
+				{
+					i32 pixelDifference = 0;
+					for (i32 channel = 0; channel < 4; channel++)
+					{
+						pixelDifference = MathExtensions::Max(pixelDifference, SDL_abs(row[x * 4 + channel] - referenceRow[x * 4 + channel]));
+					}
+
+					maxDifference = MathExtensions::Max(maxDifference, pixelDifference);
+					if (pixelDifference > MaxChannelDifference)
+					{
+						mismatchedPixels++;
+					}
+				}
+			}
+
+			if (mismatchedPixels > MaxMismatchedPixels)
+			{
+				LogError(LogName, "%zu pixels differ from %s (largest difference: %d), the frame has been saved to %s", mismatchedPixels, referencePath.c_str(), maxDifference, OutputPath);
+				return;
+			}
+
+			LogInfo(LogName, "The frame matches %s (%zu pixels differ, largest difference: %d)", referencePath.c_str(), mismatchedPixels, maxDifference);
+			context.ExitCode = 0;
+		}
+
+		void Draw()
+		{
+			DrawScene();
+
+			if (frameChecked)
+			{
+				return;
+			}
+
+			frameChecked = true;
+			if (Rendering::GetDeviceType() != DeviceType::Software)
+			{
+				LogWarn(LogName, "Only frames of the Software device can be compared, pass \"Software\" as the second argument");
+				return;
+			}
+
+			CheckFrame(*static_cast<Software::SoftwareDevice*>(Rendering::GetDevice()), GameContext::GetInstance()->ReferenceImagePath);
+			Parent.GameInstance->Quit();
+		}
+	};
+
+	GoldenImageState::GoldenImageState() : impl(std::make_unique<Impl>(*this))
+	{
+	}
+
+	GoldenImageState::~GoldenImageState()
+	{
+	}
+
+	bool GoldenImageState::Initialize()
+	{
+		impl->CreateTextures();
+		return true;
+	}
+
+	bool GoldenImageState::LoadContent()
+	{
+		return true;
+	}
+
+	void GoldenImageState::UnloadContent()
+	{
+	}
+
+	void GoldenImageState::Destroy()
+	{
+		impl->Destroy();
+	}
+
+	void GoldenImageState::Update(Starshine::GameTime& gameTime)
+	{
+	}
+
+	void GoldenImageState::Draw(Starshine::GameTime& gameTime)
+	{
+		impl->Draw();
+	}
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include "Common/Types.h"
+#include <GameInstance.h>
+
+namespace Sandbox::GoldenImage
+{
+	class GoldenImageState : public Starshine::GameState
+	{
+	public:
+		GoldenImageState();
+		~GoldenImageState();
+
+	public:
+		bool Initialize();
+		bool LoadContent();
+
+		void UnloadContent();
+		void Destroy();
+
+		void Update(Starshine::GameTime& gameTime);
+		void Draw(Starshine::GameTime& gameTime);
+
+		inline std::string_view GetStateName() { return "GoldenImage"; };
+
+	private:
+		struct Impl;
+		std::unique_ptr<Impl> impl{};
+	};
+}
@@ -1,6 +1,7 @@
 #include <SDL2/SDL_main.h>
 #include "GameInstance.h"
 #include "GameContext.h"
+#include <Rendering/Null/NullDevice.h>
 
 #include "Definitions.h"
 
@@ -10,8 +11,17 @@ using namespace Sandbox;
 int SDL_main(int argc, char* argv[])
 {
 	Starshine::GameInstance game;
+
+	// NOTE: The second argument selects the rendering device by name (e.g. "Sandbox.exe VideoTest Software")
+	Rendering::DeviceType deviceType = Rendering::DeviceType::D3D11;
+	for (size_t i = 0; argc > 2 && i < Rendering::DeviceTypeNames.size(); i++)
+	{
+		if (std::string_view(argv[2]) == Rendering::DeviceTypeNames[i])
+			deviceType = static_cast<Rendering::DeviceType>(i);
+	}
 	
-	if (game.Initialize(false))
+	// NOTE: ImGui is only used for debug windows (e.g. the audio engine stats in the AudioLatency state) and only works with D3D11
+	if (game.Initialize(deviceType == Rendering::DeviceType::D3D11, deviceType))
 	{
 		game.GetWindow()->SetTitle("Sandbox");
 		//game.GetWindow()->SetSize(ivec2(1600, 900));
@@ -20,11 +30,38 @@ int SDL_main(int argc, char* argv[])
 
 		Sandbox::GameContext::CreateInstance();
 
-		game.SetState(GetStatePointer<GameState>(StateID::VideoTest));
+		// NOTE: The first argument selects the initial state by name (e.g. "Sandbox.exe AudioBenchmark")
+		StateID initialState = (argc > 1) ? EnumFromString(StateIDStringTable, argv[1]) : StateID::VideoTest;
+
+		// NOTE: The third argument is a recording of the device commands. The Null device writes every frame to it on exit,
+		//		 the DrawReplay state plays it back on any device (e.g. "Sandbox.exe VideoTest Null frames.scr" and then "Sandbox.exe DrawReplay D3D11 frames.scr").
+		//		 For the GoldenImage state it's the reference its first frame is compared against (e.g. "Sandbox.exe GoldenImage Software ..\src\Sandbox\golden\GoldenImage.png")
+		Rendering::Null::NullDevice* nullDevice = (deviceType == Rendering::DeviceType::Null) ? static_cast<Rendering::Null::NullDevice*>(Rendering::GetDevice()) : nullptr;
+		if (argc > 3)
+		{
+			if (initialState == StateID::GoldenImage)
+				Sandbox::GameContext::GetInstance()->ReferenceImagePath = argv[3];
+			else
+				Sandbox::GameContext::GetInstance()->RecordingPath = argv[3];
+		}
+
+		const bool recordFrames = (nullDevice != nullptr && argc > 3 && initialState != StateID::DrawReplay);
+		if (recordFrames)
+		{
+			nullDevice->StartRecording();
+		}
+
+		game.SetState(GetStatePointer<GameState>(initialState));
 		game.EnterLoop();
 
+		if (recordFrames)
+		{
+			nullDevice->StopRecording().SaveToFile(argv[3]);
+		}
+
+		const i32 exitCode = Sandbox::GameContext::GetInstance()->ExitCode;
 		Sandbox::GameContext::DestroyInstance();
-		return 0;
+		return exitCode;
 	}
 
 	return 1;
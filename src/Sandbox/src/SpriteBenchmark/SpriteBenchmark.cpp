@@ -0,0 +1,258 @@
+#include "SpriteBenchmarkState.h"
+#include "GameContext.h"
+#include <Rendering/Render2D/SpriteVertexKernels.h>
+#include <Common/Logging/Logging.h>
+#include <Common/ThreadPool.h>
+#include <Input/Keyboard.h>
+#include <SDL2/SDL_timer.h>
+#include <random>
+#include <vector>
+
+using namespace Starshine;
+using namespace Starshine::Input;
+using namespace Starshine::Rendering::Render2D;
+
+namespace Sandbox::SpriteBenchmark
+{
+	struct SpriteBenchmarkState::Impl
+	{
+		static constexpr const char* LogName = "Sandbox::SpriteBenchmark";
+
+		static constexpr std::array<size_t, 3> SpriteCounts{ 1024, 4096, 16384 };
+		static constexpr size_t Iterations = 500;
+
+		// NOTE: Same layout as the sprite states the renderer used to keep for every pushed sprite
+		struct LegacySprite
+		{
+			vec2 Position{};
+			vec2 Origin{};
+			vec2 Size{};
+			std::array<Color, 4> VertexColors{};
+
+			f32 RotationCos{};
+			f32 RotationSin{};
+
+			RectangleF SourceRect_TexSpace{};
+		};
+
+		SpriteBenchmarkState& Parent;
+
+		std::vector<LegacySprite> legacySprites;
+		SpriteBatch batch;
+		std::vector<SpriteVertex> vertices;
+
+		std::unique_ptr<ThreadPool> pool;
+
+		std::string resultText;
+
+		Impl(SpriteBenchmarkState& parent) : Parent(parent) {}
+		~Impl() {}
+
+		void CreateSprites()
+		{
+			const size_t maxSpriteCount = SpriteCounts.back();
+
+			std::mt19937 random(0x53505254);
+			std::uniform_real_distribution<f32> positionDistribution(0.0f, 1280.0f);
+			std::uniform_real_distribution<f32> sizeDistribution(8.0f, 128.0f);
+			std::uniform_real_distribution<f32> angleDistribution(0.0f, MathExtensions::ToRadians(360.0f));
+			std::uniform_int_distribution<i32> colorDistribution(0, 255);
+
+			legacySprites.resize(maxSpriteCount);
+			for (auto& sprite : legacySprites)
+			{
+				const f32 angle = angleDistribution(random);
+
+				sprite.Position = vec2(positionDistribution(random), positionDistribution(random));
+				sprite.Size = vec2(sizeDistribution(random), sizeDistribution(random));
+				sprite.Origin = sprite.Size / 2.0f;
+				sprite.RotationCos = SDL_cosf(angle);
+				sprite.RotationSin = SDL_sinf(angle);
+				sprite.SourceRect_TexSpace = RectangleF(0.25f, 0.25f, 0.75f, 0.75f);
+
+				for (auto& color : sprite.VertexColors)
+				{
+					color = Color(static_cast<u8>(colorDistribution(random)), static_cast<u8>(colorDistribution(random)), static_cast<u8>(colorDistribution(random)));
+				}
+			}
+
+			batch.Reserve(maxSpriteCount);
+			vertices.resize(maxSpriteCount * 4);
+			pool = std::make_unique<ThreadPool>();
+		}
+
+		void FillBatch(size_t spriteCount)
+		{
+			batch.Clear();
+			for (size_t i = 0; i < spriteCount; i++)
+			{
+				const LegacySprite& sprite = legacySprites[i];
+				batch.Push(sprite.Position, sprite.Origin, sprite.Size, sprite.RotationCos, sprite.RotationSin, sprite.SourceRect_TexSpace,
+					sprite.VertexColors[0], sprite.VertexColors[1], sprite.VertexColors[2], sprite.VertexColors[3]);
+			}
+		}
+
+		// NOTE: One RotateVector() per vertex, the loop RenderSprites() used before the vertex kernels
+		void GenerateLegacy(size_t spriteCount)
+		{
+			for (size_t i = 0; i < spriteCount; i++)
+			{
+				const LegacySprite& sprite = legacySprites[i];
+				SpriteVertex* vertex = &vertices[i * 4];
+
+				vertex[0].Position = MathExtensions::RotateVector(vec2(0.0f, 0.0f), sprite.Origin, sprite.RotationCos, sprite.RotationSin) + sprite.Position;
+				vertex[0].TexCoord = { sprite.SourceRect_TexSpace.X, sprite.SourceRect_TexSpace.Y };
+				vertex[0].Color = sprite.VertexColors[0];
+
+				vertex[1].Position = MathExtensions::RotateVector(vec2(sprite.Size.x, sprite.Size.y), sprite.Origin, sprite.RotationCos, sprite.RotationSin) + sprite.Position;
+				vertex[1].TexCoord = { sprite.SourceRect_TexSpace.Width, sprite.SourceRect_TexSpace.Height };
+				vertex[1].Color = sprite.VertexColors[3];
+
+				vertex[2].Position = MathExtensions::RotateVector(vec2(sprite.Size.x, 0.0f), sprite.Origin, sprite.RotationCos, sprite.RotationSin) + sprite.Position;
+				vertex[2].TexCoord = { sprite.SourceRect_TexSpace.Width, sprite.SourceRect_TexSpace.Y };
+				vertex[2].Color = sprite.VertexColors[1];
+
+				vertex[3].Position = MathExtensions::RotateVector(vec2(0.0f, sprite.Size.y), sprite.Origin, sprite.RotationCos, sprite.RotationSin) + sprite.Position;
+				vertex[3].TexCoord = { sprite.SourceRect_TexSpace.X, sprite.SourceRect_TexSpace.Height };
+				vertex[3].Color = sprite.VertexColors[2];
+			}
+		}
+
+		// NOTE: Pushing and rendering through the sprite renderer itself, including the buffer upload and the draw calls
+		void RenderThroughRenderer(size_t spriteCount)
+		{
+			SpriteRenderer* sprRenderer = GameContext::GetInstance()->SpriteRenderer.get();
+
+			for (size_t i = 0; i < spriteCount; i++)
+			{
+				const LegacySprite& sprite = legacySprites[i];
+				sprRenderer->SetSpritePosition(sprite.Position);
+				sprRenderer->SetSpriteSize(sprite.Size);
+				sprRenderer->SetSpriteOrigin(sprite.Origin);
+				sprRenderer->SetSpriteColor(sprite.VertexColors[0]);
+				sprRenderer->PushSprite(nullptr);
+			}
+
+			sprRenderer->RenderSprites(nullptr);
+		}
+
+		template <typename GenerateFunction>
+		f64 MeasureTime(GenerateFunction generateFunction)
+		{
+			// NOTE: Warm up caches before measuring
+			for (size_t i = 0; i < Iterations / 10; i++) { generateFunction(); }
+
+			u64 startTicks = SDL_GetPerformanceCounter();
+			for (size_t i = 0; i < Iterations; i++) { generateFunction(); }
+			u64 endTicks = SDL_GetPerformanceCounter();
+
+			f64 totalMicroseconds = static_cast<f64>(endTicks - startTicks) * 1000000.0 / static_cast<f64>(SDL_GetPerformanceFrequency());
+			return totalMicroseconds / static_cast<f64>(Iterations);
+		}
+
+		void AppendResult(std::string_view name, f64 microseconds, f64 baselineMicroseconds)
+		{
+			char line[128] = {};
+			SDL_snprintf(line, sizeof(line) - 1, "%-14s %9.2f us/batch (%5.2fx)\n", name.data(), microseconds, baselineMicroseconds / microseconds);
+
+			LogInfo(LogName, "%s", line);
+			resultText += line;
+		}
+
+		// NOTE: Makes sure the kernels write exactly what the legacy loop does, the results are only worth something if they match
+		bool VerifyKernels(size_t spriteCount)
+		{
+			GenerateLegacy(spriteCount);
+			const std::vector<SpriteVertex> legacyVertices(vertices.begin(), vertices.begin() + spriteCount * 4);
+
+			FillBatch(spriteCount);
+			GenerateSpriteVertices(vertices.data(), batch, pool.get());
+
+			return SDL_memcmp(legacyVertices.data(), vertices.data(), legacyVertices.size() * sizeof(SpriteVertex)) == 0;
+		}
+
+		void RunBenchmark()
+		{
+			resultText.clear();
+
+			char header[128] = {};
+			SDL_snprintf(header, sizeof(header) - 1, "Generating sprite vertices, %zu batches each, %zu worker threads\n", Iterations, pool->GetWorkerCount());
+			resultText += header;
+
+			for (size_t spriteCount : SpriteCounts)
+			{
+				SDL_snprintf(header, sizeof(header) - 1, "\n%zu sprites%s\n\n", spriteCount, VerifyKernels(spriteCount) ? "" : " (MISMATCH)");
+				resultText += header;
+
+				f64 legacyTime = MeasureTime([this, spriteCount]() { GenerateLegacy(spriteCount); });
+				AppendResult("Legacy", legacyTime, legacyTime);
+
+				f64 pushTime = MeasureTime([this, spriteCount]() { FillBatch(spriteCount); });
+				AppendResult("Push", pushTime, legacyTime);
+
+				f64 kernelTime = MeasureTime([this, spriteCount]() { GenerateSpriteVertices(vertices.data(), batch, 0, spriteCount); });
+				AppendResult("Kernel", kernelTime, legacyTime);
+
+				f64 parallelTime = MeasureTime([this]() { GenerateSpriteVertices(vertices.data(), batch, pool.get()); });
+				AppendResult("Kernel/Threads", parallelTime, legacyTime);
+
+				f64 rendererTime = MeasureTime([this, spriteCount]() { RenderThroughRenderer(spriteCount); });
+				AppendResult("SpriteRenderer", rendererTime, legacyTime);
+			}
+
+			resultText += "\nPress F5 to run again";
+		}
+
+		void Draw()
+		{
+			SpriteRenderer* sprRenderer = GameContext::GetInstance()->SpriteRenderer.get();
+			auto& debugFont = GameContext::GetInstance()->DebugFont;
+
+			sprRenderer->GetRenderingDevice()->Clear(Rendering::ClearFlags_Color, DefaultColors::ClearColor_InGame, 1.0f, 0);
+			sprRenderer->Font().DrawString(debugFont.get(), resultText, vec2(0.0f), vec2(1.0f), DefaultColors::White);
+			sprRenderer->RenderSprites(nullptr);
+		}
+	};
+
+	SpriteBenchmarkState::SpriteBenchmarkState() : impl(std::make_unique<Impl>(*this))
+	{
+	}
+
+	SpriteBenchmarkState::~SpriteBenchmarkState()
+	{
+	}
+
+	bool SpriteBenchmarkState::Initialize()
+	{
+		impl->CreateSprites();
+		return true;
+	}
+
+	bool SpriteBenchmarkState::LoadContent()
+	{
+		impl->RunBenchmark();
+		return true;
+	}
+
+	void SpriteBenchmarkState::UnloadContent()
+	{
+	}
+
+	void SpriteBenchmarkState::Destroy()
+	{
+		impl->pool = nullptr;
+	}
+
+	void SpriteBenchmarkState::Update(Starshine::GameTime& gameTime)
+	{
+		if (Keyboard::IsKeyTapped(SDLK_F5))
+		{
+			impl->RunBenchmark();
+		}
+	}
+
+	void SpriteBenchmarkState::Draw(Starshine::GameTime& gameTime)
+	{
+		impl->Draw();
+	}
+}
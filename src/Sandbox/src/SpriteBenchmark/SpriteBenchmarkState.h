@@ -0,0 +1,29 @@
+#pragma once
+#include "Common/Types.h"
+#include <GameInstance.h>
+
+namespace Sandbox::SpriteBenchmark
+{
+	class SpriteBenchmarkState : public Starshine::GameState
+	{
+	public:
+		SpriteBenchmarkState();
+		~SpriteBenchmarkState();
+
+	public:
+		bool Initialize();
+		bool LoadContent();
+
+		void UnloadContent();
+		void Destroy();
+
+		void Update(Starshine::GameTime& gameTime);
+		void Draw(Starshine::GameTime& gameTime);
+
+		inline std::string_view GetStateName() { return "SpriteBenchmark"; };
+
+	private:
+		struct Impl;
+		std::unique_ptr<Impl> impl{};
+	};
+}
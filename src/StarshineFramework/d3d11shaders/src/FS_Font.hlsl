@@ -1,4 +1,5 @@
 #include "Font.hlsl"
+#include "SpriteTextures.hlsl"
 
 #define FONTTYPE_PLAINRGBA 0
 #define FONTTYPE_SINGLECHANNEL 1
@@ -9,11 +10,9 @@ struct FSInput
 	float4 Position : SV_POSITION;
 	float2 TexCoord : TEXCOORD0;
 	float4 Color : COLOR0;
+	nointerpolation uint TextureSlot : TEXCOORD1;
 };
 
-Texture2D Texture : register(t0);
-sampler TextureSampler : register(s0);
-
 cbuffer FontUniforms : register(b0)
 {
 	int U_FontType = FONTTYPE_PLAINRGBA;
@@ -22,7 +21,7 @@ cbuffer FontUniforms : register(b0)
 
 float4 main(FSInput input) : SV_Target0
 {
-	float4 texel = Texture.Sample(TextureSampler, input.TexCoord);
+	float4 texel = SampleSpriteTexture(input.TextureSlot, input.TexCoord);
 
 	switch (U_FontType)
 	{
@@ -1,14 +1,14 @@
+#include "SpriteTextures.hlsl"
+
 struct FSInput
 {
 	float4 Position : SV_POSITION;
 	float2 TexCoord : TEXCOORD0;
 	float4 Color : COLOR0;
+	nointerpolation uint TextureSlot : TEXCOORD1;
 };
 
-Texture2D Texture : register(t0);
-sampler TextureSampler : register(s0);
-
 float4 main(FSInput input) : SV_Target0
 {
-	return Texture.Sample(TextureSampler, input.TexCoord) * input.Color;
+	return SampleSpriteTexture(input.TextureSlot, input.TexCoord) * input.Color;
 }
\ No newline at end of file
@@ -0,0 +1,30 @@
+#ifndef SPRITETEXTURES_HLSL
+#define SPRITETEXTURES_HLSL
+
+// NOTE: Same as SpriteTextureSlots in SpriteRenderer.h
+#define SPRITE_TEXTURE_SLOTS 8
+
+Texture2D Textures[SPRITE_TEXTURE_SLOTS] : register(t0);
+sampler TextureSamplers[SPRITE_TEXTURE_SLOTS] : register(s0);
+
+// NOTE: Shader model 5.0 only indexes resource arrays with literals, hence the switch.
+//		 Gradients are taken outside of it since neighbouring pixels can belong to sprites with different slots
+float4 SampleSpriteTexture(uint slot, float2 texCoord)
+{
+	float2 dx = ddx(texCoord);
+	float2 dy = ddy(texCoord);
+
+	switch (slot)
+	{
+	case 1: return Textures[1].SampleGrad(TextureSamplers[1], texCoord, dx, dy);
+	case 2: return Textures[2].SampleGrad(TextureSamplers[2], texCoord, dx, dy);
+	case 3: return Textures[3].SampleGrad(TextureSamplers[3], texCoord, dx, dy);
+	case 4: return Textures[4].SampleGrad(TextureSamplers[4], texCoord, dx, dy);
+	case 5: return Textures[5].SampleGrad(TextureSamplers[5], texCoord, dx, dy);
+	case 6: return Textures[6].SampleGrad(TextureSamplers[6], texCoord, dx, dy);
+	case 7: return Textures[7].SampleGrad(TextureSamplers[7], texCoord, dx, dy);
+	default: return Textures[0].SampleGrad(TextureSamplers[0], texCoord, dx, dy);
+	}
+}
+
+#endif
@@ -3,6 +3,7 @@ struct VSInput
 	float2 Position : POSITION;
 	float2 TexCoord : TEXCOORD0;
 	float4 Color : COLOR0;
+	float TextureSlot : TEXCOORD1;
 };
 
 struct VSOutput
@@ -10,6 +11,7 @@ struct VSOutput
 	float4 Position : SV_POSITION;
 	float2 TexCoord : TEXCOORD0;
 	float4 Color : COLOR0;
+	nointerpolation uint TextureSlot : TEXCOORD1;
 };
 
 float4x4 vs_TransformMatrix : register(vs, c[0]);
@@ -22,6 +24,7 @@ VSOutput main(VSInput input)
 	output.Position = mul(pos, vs_TransformMatrix);
 	output.TexCoord = input.TexCoord;
 	output.Color = input.Color;
+	output.TextureSlot = (uint)input.TextureSlot;
 
 	return output;
 }
\ No newline at end of file
@@ -0,0 +1,44 @@
+#version 430 core
+
+#define FONTTYPE_PLAINRGBA 0
+#define FONTTYPE_SINGLECHANNEL 1
+#define FONTTYPE_OUTLINE_RG 2
+
+layout(location = 0) in vec2 in_TexCoord;
+layout(location = 1) in vec4 in_Color;
+layout(location = 2) flat in uint in_TextureSlot;
+
+layout(location = 0) out vec4 out_FragColor;
+
+// NOTE: Fragment uniform buffer 0 (FragmentUniformBufferBase + 0)
+layout(std140, binding = 8) uniform FontUniforms
+{
+	int U_FontType;
+	vec4 U_OutlineColor;
+};
+
+vec4 GetSolidColor(float alpha, vec4 fragColor)
+{
+	return vec4(fragColor.rgb, fragColor.a * alpha);
+}
+
+void main()
+{
+	vec4 texel = SampleSpriteTexture(in_TextureSlot, in_TexCoord);
+
+	switch (U_FontType)
+	{
+	case FONTTYPE_PLAINRGBA:
+		out_FragColor = texel * in_Color;
+		return;
+	case FONTTYPE_SINGLECHANNEL:
+		out_FragColor = GetSolidColor(texel.r, in_Color);
+		return;
+	case FONTTYPE_OUTLINE_RG:
+		vec4 fill = GetSolidColor(texel.r, in_Color) * texel.r;
+		vec4 outline = vec4(U_OutlineColor.rgb, texel.g);
+		out_FragColor = outline + fill;
+		return;
+	}
+	out_FragColor = vec4(0.0, 0.0, 0.0, 0.0);
+}
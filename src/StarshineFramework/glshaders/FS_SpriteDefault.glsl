@@ -0,0 +1,12 @@
+#version 430 core
+
+layout(location = 0) in vec2 in_TexCoord;
+layout(location = 1) in vec4 in_Color;
+layout(location = 2) flat in uint in_TextureSlot;
+
+layout(location = 0) out vec4 out_FragColor;
+
+void main()
+{
+	out_FragColor = SampleSpriteTexture(in_TextureSlot, in_TexCoord) * in_Color;
+}
@@ -0,0 +1,10 @@
+#version 430 core
+
+layout(location = 1) in vec4 in_Color;
+
+layout(location = 0) out vec4 out_FragColor;
+
+void main()
+{
+	out_FragColor = in_Color;
+}
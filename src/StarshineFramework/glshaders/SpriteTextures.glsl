@@ -0,0 +1,26 @@
+// NOTE: Shared by every fragment shader, the GL shader loader inserts this file right after their #version line (see Rendering::Utilities::LoadShader)
+
+// NOTE: Same as SpriteTextureSlots in SpriteRenderer.h
+#define SPRITE_TEXTURE_SLOTS 8
+
+layout(binding = 0) uniform sampler2D Textures[SPRITE_TEXTURE_SLOTS];
+
+// NOTE: Sampler arrays can only be indexed with dynamically uniform expressions, the slot is flat but differs between sprites.
+//		 Gradients are taken outside of the switch since neighbouring pixels can belong to sprites with different slots
+vec4 SampleSpriteTexture(uint slot, vec2 texCoord)
+{
+	vec2 dx = dFdx(texCoord);
+	vec2 dy = dFdy(texCoord);
+
+	switch (slot)
+	{
+	case 1u: return textureGrad(Textures[1], texCoord, dx, dy);
+	case 2u: return textureGrad(Textures[2], texCoord, dx, dy);
+	case 3u: return textureGrad(Textures[3], texCoord, dx, dy);
+	case 4u: return textureGrad(Textures[4], texCoord, dx, dy);
+	case 5u: return textureGrad(Textures[5], texCoord, dx, dy);
+	case 6u: return textureGrad(Textures[6], texCoord, dx, dy);
+	case 7u: return textureGrad(Textures[7], texCoord, dx, dy);
+	default: return textureGrad(Textures[0], texCoord, dx, dy);
+	}
+}
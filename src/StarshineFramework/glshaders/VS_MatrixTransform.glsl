@@ -0,0 +1,18 @@
+#version 430 core
+
+layout(location = 0) in vec2 in_Position;
+layout(location = 4) in vec4 in_Color;
+
+layout(location = 1) out vec4 out_Color;
+
+layout(std140, binding = 0) uniform UniformBuffer
+{
+	mat4 TransformMatrix;
+};
+
+void main()
+{
+	vec4 pos = vec4(in_Position.xy, 0.0, 1.0);
+	gl_Position = pos * TransformMatrix;
+	out_Color = in_Color;
+}
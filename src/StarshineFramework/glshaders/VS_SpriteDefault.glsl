@@ -0,0 +1,24 @@
+#version 430 core
+
+layout(location = 0) in vec2 in_Position;
+layout(location = 8) in vec2 in_TexCoord;
+layout(location = 4) in vec4 in_Color;
+layout(location = 9) in float in_TextureSlot;
+
+layout(location = 0) out vec2 out_TexCoord;
+layout(location = 1) out vec4 out_Color;
+layout(location = 2) flat out uint out_TextureSlot;
+
+layout(std140, binding = 0) uniform VertexUniforms
+{
+	mat4 vs_TransformMatrix;
+};
+
+void main()
+{
+	vec4 pos = vec4(in_Position.xy, 0.0, 1.0);
+	gl_Position = pos * vs_TransformMatrix;
+	out_TexCoord = in_TexCoord;
+	out_Color = in_Color;
+	out_TextureSlot = uint(in_TextureSlot);
+}
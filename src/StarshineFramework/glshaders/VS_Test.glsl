@@ -0,0 +1,12 @@
+#version 430 core
+
+layout(location = 0) in vec2 in_Position;
+layout(location = 4) in vec4 in_Color;
+
+layout(location = 1) out vec4 out_Color;
+
+void main()
+{
+	gl_Position = vec4(in_Position.xy, 0.0, 1.0);
+	out_Color = in_Color;
+}
@@ -1,9 +1,26 @@
 #include <array>
 #include <vector>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <math.h>
 #include "AudioEngine.h"
 #include "Decoding/DecoderFactory.h"
+#include "Decoding/SoundBank.h"
+#include "Mixing/MixKernels.h"
+#include "Mixing/Resampler.h"
+#include "SampleProvider/AdpcmSampleProvider.h"
+#include "SampleProvider/MemorySampleProvider.h"
 #include "SampleProvider/StreamingSampleProvider.h"
+#include "SampleProvider/WavStreamingSampleProvider.h"
 #include "IO/Path/File.h"
+#include "IO/Path/Path.h"
+#include "IO/MemoryMappedFile.h"
+#include "Common/Hash.h"
+#include "Common/SPSCQueue.h"
+#include "Common/ThreadPool.h"
 #include "Common/Logging/Logging.h"
 
 namespace Starshine::Audio
@@ -13,6 +30,7 @@ namespace Starshine::Audio
 	std::unique_ptr<AudioEngine> Instance{};
 	void AudioEngine_SDLCallback(void* userdata, Uint8* stream, int size);
 
+	// NOTE: Owned by the game thread
 	struct SourceData
 	{
 		ISampleProvider* SampleProvider{};
@@ -22,398 +40,2435 @@ namespace Starshine::Audio
 
 		// NOTE: Only one voice at a time can play audio from a streaming source
 		VoiceHandle BoundVoice{ VoiceHandle::Invalid };
+
+		// NOTE: Incremented every time the slot is freed, handles carry the generation of the source they were created for
+		u16 Generation{};
+
+		// NOTE: Cached sources only. Every path (or bank entry) that resolves to this source and a hash of the file contents
+		std::vector<std::string> CacheKeys;
+		u64 ContentHash{};
+		size_t MemorySize{};
+
+		// NOTE: Loads that haven't been matched by an UnloadSource() call yet and the use counter value of the last load or unload
+		u32 ReferenceCount{};
+		u64 LastUsed{};
 	};
 
-	struct VoiceContext
+	// NOTE: The highest index is left unused, so that no valid handle can be equal to SourceHandle::Invalid
+	constexpr size_t MaxRegisteredSources = 0xFFFF;
+
+	constexpr SourceHandle MakeSourceHandle(size_t index, u16 generation)
+	{
+		return static_cast<SourceHandle>((static_cast<u32>(generation) << 16) | static_cast<u32>(index));
+	}
+
+	constexpr size_t GetSourceIndex(SourceHandle handle)
+	{
+		return static_cast<size_t>(static_cast<u32>(handle) & 0xFFFF);
+	}
+
+	constexpr u16 GetSourceGeneration(SourceHandle handle)
+	{
+		return static_cast<u16>(static_cast<u32>(handle) >> 16);
+	}
+
+	// NOTE: Owned by the game thread. Mirrors the values that were sent to the audio thread,
+	//		 so that getters return what the game has set even before the next buffer boundary.
+	struct VoiceState
 	{
 		SourceHandle Source{ SourceHandle::Invalid };
 		f32 Volume{ 1.0f };
+		f32 PlaybackRate{ 1.0f };
+		AudioBus Bus{ AudioBus::SFX };
 
 		bool Allocated{};
 		bool DeallocateOnEnd{};
+		VoicePriority Priority{ VoicePriority::Protected };
+
+		bool Playing{};
+		bool Looped{};
+
+		size_t FramePosition{};
+
+		// NOTE: Serial of the latest command sent to this voice and of the latest command that changed its playback state or position
+		u32 Serial{};
+		u32 PlaybackSerial{};
+
+		// NOTE: Serial of the latest command that moved the voice to a different position and the last playback time that has been returned since.
+		//		 Used to keep the interpolated playback time from going backwards between two buffers.
+		u32 PositionSerial{};
+		TimeSpan LastPlaybackTime{};
+
+		// NOTE: Neighbours in the list of sounds played through PlaySound(), which is ordered from oldest to newest
+		VoiceHandle PreviousSound{ VoiceHandle::Invalid };
+		VoiceHandle NextSound{ VoiceHandle::Invalid };
+	};
+
+	constexpr u64 NoScheduledFrame = UINT64_MAX;
 
+	// NOTE: Owned by the audio thread, only modified through commands
+	struct VoiceContext
+	{
+		ISampleProvider* SampleProvider{};
+		size_t LoopStart{};
+
+		f32 Volume{ 1.0f };
+		f32 PlaybackRate{ 1.0f };
+		AudioBus Bus{ AudioBus::SFX };
+
+		bool DeallocateOnEnd{};
 		bool Playing{};
 		bool Looped{};
 
+		// NOTE: Device frames at which a playing voice becomes audible and starts to fade out.
+		//		 The voice pauses 'FadeFrames' after 'StopFrame'
+		u64 StartFrame{};
+		u64 StopFrame{ NoScheduledFrame };
+		u32 FadeFrames{};
+
+		// NOTE: Read position in the source, runs ahead of the audible position by the resampler's lookahead
+		size_t FramePosition{};
+		u32 AppliedSerial{};
+
+		Mixing::ResamplerState Resampler{};
+
+		// NOTE: Source position of the first frame of the last mixed buffer, the amount of device frames mixed into it
+		//		 and the amount of source frames per device frame
+		f64 BufferStartPosition{};
+		size_t BufferFrames{};
+		f64 FrameStep{ 1.0 };
+	};
+
+	// NOTE: Written by the audio thread at the end of each buffer, read by the game thread
+	struct VoiceSnapshot
+	{
+		std::atomic<u64> FramePosition{};
+		std::atomic<bool> Playing{};
+		std::atomic<u32> AppliedSerial{};
+
+		std::atomic<f64> BufferStartPosition{};
+		std::atomic<u32> BufferFrames{};
+		std::atomic<f64> FrameStep{ 1.0 };
+	};
+
+	// NOTE: Owned by the game thread
+	struct BusState
+	{
+		f32 Volume{ 1.0f };
+		bool Muted{};
+	};
+
+	// NOTE: Owned by the audio thread. The gain moves linearly towards its target over 'BusGainRampFrames' frames
+	struct BusContext
+	{
+		f32 Gain{ 1.0f };
+		f32 TargetGain{ 1.0f };
+		f32 GainStep{};
+		size_t RampFrames{};
+
+		// NOTE: Set once something has been mixed into the bus during the current buffer, the bus buffer is only cleared then
+		bool HasInput{};
+	};
+
+	// NOTE: Written by the audio thread at the end of each buffer, read by the game thread
+	struct BusMeterSnapshot
+	{
+		std::array<std::atomic<f32>, 2> Peak{};
+		std::array<std::atomic<f32>, 2> RMS{};
+	};
+
+	// NOTE: Written by the audio thread only, so every counter is updated with a plain load and store instead of a read-modify-write
+	struct MixerStats
+	{
+		std::atomic<u64> CallbackCount{};
+		std::atomic<u64> TotalCallbackTicks{};
+		std::atomic<u64> MinCallbackTicks{ UINT64_MAX };
+		std::atomic<u64> MaxCallbackTicks{};
+		std::atomic<u64> LastCallbackTicks{};
+		std::array<std::atomic<u64>, AudioEngineStats::CallbackHistogramBucketCount> CallbackHistogram{};
+
+		std::atomic<u64> BufferPeriodTicks{};
+		std::atomic<i64> MinDeadlineMarginTicks{ INT64_MAX };
+		std::atomic<u64> DeadlineMisses{};
+		std::atomic<u64> Underruns{};
+		std::atomic<u64> MaxCallbackJitterTicks{};
+
+		std::atomic<u32> ActiveVoices{};
+		std::atomic<u32> PlayingVoices{};
+		std::atomic<u32> PeakPlayingVoices{};
+
+		std::atomic<u32> StreamingVoices{};
+		std::atomic<f32> MinStreamingBufferFill{ 1.0f };
+		std::atomic<u64> StreamingStarvations{};
+
+		static void Increment(std::atomic<u64>& counter)
+		{
+			counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		}
+
+		void Reset()
+		{
+			CallbackCount.store(0, std::memory_order_relaxed);
+			TotalCallbackTicks.store(0, std::memory_order_relaxed);
+			MinCallbackTicks.store(UINT64_MAX, std::memory_order_relaxed);
+			MaxCallbackTicks.store(0, std::memory_order_relaxed);
+			for (auto& bucket : CallbackHistogram)
+			{
+				bucket.store(0, std::memory_order_relaxed);
+			}
+
+			MinDeadlineMarginTicks.store(INT64_MAX, std::memory_order_relaxed);
+			DeadlineMisses.store(0, std::memory_order_relaxed);
+			Underruns.store(0, std::memory_order_relaxed);
+			MaxCallbackJitterTicks.store(0, std::memory_order_relaxed);
+			PeakPlayingVoices.store(0, std::memory_order_relaxed);
+			StreamingStarvations.store(0, std::memory_order_relaxed);
+		}
+	};
+
+	// NOTE: Consistent copy of the audio clock and optionally of a single voice, taken by the game thread
+	struct ClockReading
+	{
+		u64 CallbackTicks{};
+		u64 DeviceFramePosition{};
+
+		u32 AppliedSerial{};
+		f64 BufferStartPosition{};
+		u32 BufferFrames{};
+		f64 FrameStep{ 1.0 };
+	};
+
+	enum class AudioCommandType : u8
+	{
+		StartVoice,
+		StopVoice,
+		SetSource,
+		SetPlaying,
+		ScheduleStop,
+		SetLoopState,
+		SetFramePosition,
+		SetVolume,
+		SetPlaybackRate,
+		SetBus,
+		SetBusGain,
+		SetResamplerQuality,
+		ReleaseSource,
+
+		Count
+	};
+
+	struct AudioCommand
+	{
+		AudioCommandType Type{};
+		VoiceHandle Voice{ VoiceHandle::Invalid };
+		u32 Serial{};
+
+		ISampleProvider* SampleProvider{};
+		size_t LoopStart{};
 		size_t FramePosition{};
+
+		// NOTE: Start frame of StartVoice and SetPlaying, stop frame of ScheduleStop
+		u64 DeviceFrame{};
+		u32 FadeFrames{};
+
+		f32 Volume{};
+		f32 PlaybackRate{ 1.0f };
+		AudioBus Bus{ AudioBus::SFX };
+		bool Playing{};
+		bool Looped{};
+		bool DeallocateOnEnd{};
+
+		const Mixing::FilterBankSet* FilterBanks{};
+	};
+
+	enum class MixerEventType : u8
+	{
+		VoiceFinished,
+		SourceReleased,
+
+		Count
+	};
+
+	struct MixerEvent
+	{
+		MixerEventType Type{};
+		VoiceHandle Voice{ VoiceHandle::Invalid };
+		u32 Serial{};
+
+		ISampleProvider* SampleProvider{};
 	};
 
-	constexpr f32 ConvertSampleFromI16ToF32(i16 s) { return static_cast<f32>(s) / static_cast<f32>(std::numeric_limits<i16>::max()); };
-	constexpr i16 ConvertSampleFromF32ToI16(f32 s) { return static_cast<i16>(s * static_cast<f32>(std::numeric_limits<i16>::max())); };
+	// NOTE: Handles serial number wrap-around
+	constexpr bool HasSerialBeenApplied(u32 appliedSerial, u32 serial) { return static_cast<i32>(appliedSerial - serial) >= 0; }
 
 	struct AudioEngine::Impl
 	{
+		static constexpr size_t CommandQueueCapacity = 1024;
+		static constexpr size_t BusCount = EnumCount<AudioBus>();
+
+		// NOTE: Enough source frames to resample a full buffer at the highest step, including the filter's lookahead
+		static constexpr size_t MaxBufferFrames = MaxSampleBufferSize / DefaultChannelCount;
+		static constexpr size_t MaxSourceFramesPerBuffer = MaxBufferFrames * Mixing::MaxResampleStep + Mixing::MaxTapCount + 1;
+
+		AudioOutputMode outputMode{ AudioOutputMode::Device };
+
 		SDL_AudioSpec sdlSpec = {};
 		SDL_AudioDeviceID sdlDevID = 0;
 
-		std::array<VoiceContext, MaxSimultaneousVoices> voiceContexts;
+		// NOTE: Game thread state
+		std::array<VoiceState, MaxSimultaneousVoices> voiceStates;
 		std::vector<SourceData> registeredSources;
+		std::vector<u16> freeSourceSlots;
+
+		// NOTE: Cache key (the file path or "<bank path>/<entry name>") and content hash -> cached source
+		std::unordered_map<std::string, SourceHandle> sourceCacheKeys;
+		std::unordered_map<u64, SourceHandle> sourceCacheHashes;
+		size_t sourceCacheBudget{ DefaultSourceCacheBudget };
+		size_t cachedSourceMemory{};
+		SourceStorage sourceStorage{ SourceStorage::PCM16 };
+		u64 sourceUseCounter{};
+
+		u64 sourceCacheHits{};
+		u64 sourceCacheMisses{};
+		u64 sourceCacheEvictions{};
+
+		// NOTE: Unallocated voices (used as a stack) and the sounds that can be stolen once none are left
+		std::array<VoiceHandle, MaxSimultaneousVoices> freeVoices;
+		size_t freeVoiceCount{};
+		VoiceHandle oldestSound{ VoiceHandle::Invalid };
+		VoiceHandle newestSound{ VoiceHandle::Invalid };
+
+		std::array<BusState, BusCount> busStates;
+
+		u64 droppedSounds{};
+		u64 deferredCommands{};
+
+		// NOTE: Created on the first batch load
+		std::unique_ptr<ThreadPool> loadingPool;
+
+		// NOTE: Game thread -> audio thread
+		SPSCQueue<AudioCommand, CommandQueueCapacity> commandQueue;
+
+		// NOTE: Commands that didn't fit into the command queue yet, in the order they were issued.
+		//		 No command may ever be dropped (a ReleaseSource owns its sample provider), so they're pushed again by every Update()
+		std::vector<AudioCommand> pendingCommands;
+
+		// NOTE: Audio thread -> game thread
+		SPSCQueue<MixerEvent, CommandQueueCapacity> eventQueue;
+		std::array<VoiceSnapshot, MaxSimultaneousVoices> voiceSnapshots;
+		std::array<BusMeterSnapshot, BusCount> busMeters;
+
+		// NOTE: The audio clock is published together with the voice snapshots.
+		//		 The sequence number is odd while the audio thread is writing, so readers can detect torn reads and retry.
+		std::atomic<u32> clockSequence{};
+		std::atomic<u64> callbackTicks{};
+		std::atomic<u64> deviceFramePosition{};
+
+		MixerStats mixerStats;
+		std::atomic<bool> mixerStatsResetRequested{};
+
+		// NOTE: Game thread clock settings
+		f64 performanceFrequency{};
+		TimeSpan outputLatency{};
+
+		// NOTE: Game thread buffer size calibration. The current step is measured once 'calibrationSettling' is false
+		BufferCalibrationSettings calibrationSettings;
+		BufferCalibrationStatus calibrationStatus;
+		u32 calibrationPreviousSize{};
+		u64 calibrationStepStartTicks{};
+		bool calibrationSettling{};
+
+		// NOTE: Audio thread state
+		std::array<VoiceContext, MaxSimultaneousVoices> voiceContexts;
+		u64 mixedDeviceFrames{};
+		u64 lastCallbackStartTicks{};
+
+		// NOTE: Voices that have a source or received a command since the last buffer, all other voices are skipped entirely
+		std::array<u16, MaxSimultaneousVoices> activeVoices;
+		std::array<bool, MaxSimultaneousVoices> activeVoiceFlags{};
+		size_t activeVoiceCount{};
 
-		std::array<i16, DefaultSampleBufferSize> workingBuffer;
-		std::array<f32, DefaultSampleBufferSize> mixingBuffer;
+		std::array<i16, MaxSourceFramesPerBuffer * DefaultChannelCount> workingBuffer;
+		std::array<f32, MaxSampleBufferSize> mixingBuffer;
 
-		bool Initialize()
+		// NOTE: Voices that fade out are mixed in here first, so that the fade can be applied on the way into their bus
+		std::array<f32, MaxSampleBufferSize> fadeBuffer;
+
+		std::array<BusContext, BusCount> busContexts;
+		std::array<std::array<f32, MaxSampleBufferSize>, BusCount> busBuffers;
+
+		// NOTE: Planar resampler input per channel, the voice's history followed by the newly read frames
+		std::array<std::array<f32, Mixing::MaxTapCount + MaxSourceFramesPerBuffer>, DefaultChannelCount> resampleBuffer;
+
+		const Mixing::MixKernelTable* mixKernels{};
+		const Mixing::ResampleKernelTable* resampleKernels{};
+		const Mixing::FilterBankSet* filterBanks{};
+
+		// NOTE: Game thread, filter banks are built on demand and kept alive until the engine is destroyed
+		Mixing::ResamplerQuality resamplerQuality{ Mixing::ResamplerQuality::Medium };
+		std::array<std::unique_ptr<Mixing::FilterBankSet>, EnumCount<Mixing::ResamplerQuality>()> filterBankSets;
+
+		bool OpenDevice(u16 bufferFrames)
 		{
 			SDL_AudioSpec desiredSpec = {};
 			desiredSpec.channels = DefaultChannelCount;
 			desiredSpec.freq = DefaultSampleRate;
 			desiredSpec.format = AUDIO_F32SYS;
-			desiredSpec.samples = DefaultSampleBufferSize / DefaultChannelCount;
+			desiredSpec.samples = bufferFrames;
 			desiredSpec.callback = AudioEngine_SDLCallback;
 			desiredSpec.userdata = NULL;
 
-			int result = 0;
-			if ((result = SDL_OpenAudioDevice(NULL, 0, &desiredSpec, &sdlSpec, 0)) == 0)
+			if (outputMode == AudioOutputMode::Device)
 			{
-				LogError(LogName, "Failed to open SDL Audio device. Error: %s", SDL_GetError());
-				return false;
+				// NOTE: No changes are allowed, so SDL converts and rebuffers internally if the device can't use the exact spec.
+				//		 The callback is therefore always asked for 'bufferFrames' frames
+				int result = 0;
+				if ((result = SDL_OpenAudioDevice(NULL, 0, &desiredSpec, &sdlSpec, 0)) == 0)
+				{
+					LogError(LogName, "Failed to open SDL Audio device. Error: %s", SDL_GetError());
+					return false;
+				}
+
+				sdlDevID = result;
+			}
+			else
+			{
+				// NOTE: Null device, nothing calls QueueAudioCallback() except the owner of the engine
+				sdlSpec = desiredSpec;
 			}
 
-			sdlDevID = result;
+			// NOTE: SDL hands a buffer to the device when the previous one starts playing,
+			//		 so by default a mixed frame becomes audible about one buffer after the callback
+			outputLatency = (outputMode == AudioOutputMode::Device) ?
+				TimeSpanConversion::FromSeconds(static_cast<f64>(sdlSpec.samples) / static_cast<f64>(sdlSpec.freq)) : TimeSpan { 0 };
 
-			LogInfo(LogName, 
+			LogInfo(LogName,
 				"SDL Audio Device (ID %u, Driver: %s) spec:\n"
-				"\tsdlSpec.channels: %u\n" 
+				"\tsdlSpec.channels: %u\n"
 				"\tsdlSpec.freq: %d\n"
-				"\tsdlSpec.samples: %u\n" 
-				"\tsdlSpec.format: 0x%x\n", 
-				sdlDevID, SDL_GetCurrentAudioDriver(), sdlSpec.channels, sdlSpec.freq, sdlSpec.samples, sdlSpec.format);
+				"\tsdlSpec.samples: %u\n"
+				"\tsdlSpec.format: 0x%x\n",
+				sdlDevID, (outputMode == AudioOutputMode::Device) ? SDL_GetCurrentAudioDriver() : "Null", sdlSpec.channels, sdlSpec.freq, sdlSpec.samples, sdlSpec.format);
+
+			return true;
+		}
+
+		bool Initialize(AudioOutputMode mode)
+		{
+			outputMode = mode;
+			performanceFrequency = static_cast<f64>(SDL_GetPerformanceFrequency());
+
+			if (!OpenDevice(DefaultSampleBufferSize / DefaultChannelCount))
+			{
+				return false;
+			}
+
+			mixKernels = &Mixing::GetMixKernels();
+			resampleKernels = &Mixing::GetResampleKernels();
+			filterBanks = GetFilterBankSet(resamplerQuality);
+
+			LogInfo(LogName, "Mixing instruction set: %s, resampler quality: %s",
+				EnumToString(Mixing::InstructionSetStringTable, Mixing::GetBestInstructionSet()).data(),
+				EnumToString(Mixing::ResamplerQualityStringTable, resamplerQuality).data());
 
 			constexpr size_t initialSourceCapacity = 64;
 			registeredSources.reserve(initialSourceCapacity);
 
-			SDL_PauseAudioDevice(sdlDevID, 0);
+			ResetVoiceAllocator();
+
+			if (outputMode == AudioOutputMode::Device)
+			{
+				SDL_PauseAudioDevice(sdlDevID, 0);
+			}
 
 			return true;
 		}
 
 		void Destroy()
 		{
-			SDL_PauseAudioDevice(sdlDevID, 1);
+			// NOTE: Once the device is paused the callback is guaranteed not to run,
+			//		 so the remaining commands and events can be processed on this thread
+			if (outputMode == AudioOutputMode::Device)
+			{
+				SDL_PauseAudioDevice(sdlDevID, 1);
+			}
+
+			do
+			{
+				PushPendingCommands();
+				ProcessCommands();
+				ProcessMixerEvents();
+			} while (!pendingCommands.empty() || !commandQueue.IsEmpty());
+
+			freeSourceSlots.clear();
+			for (size_t i = registeredSources.size(); i > 0; i--)
+			{
+				SourceData& source = registeredSources[i - 1];
+				DeleteSampleProvider(source.SampleProvider);
+
+				const u16 generation = static_cast<u16>(source.Generation + 1);
+				source = SourceData {};
+				source.Generation = generation;
+				freeSourceSlots.push_back(static_cast<u16>(i - 1));
+			}
+
+			sourceCacheKeys.clear();
+			sourceCacheHashes.clear();
+			cachedSourceMemory = 0;
+
+			for (auto it = voiceStates.begin(); it != voiceStates.end(); it++)
+			{
+				*it = VoiceState {};
+			}
+
+			for (auto it = voiceContexts.begin(); it != voiceContexts.end(); it++)
+			{
+				*it = VoiceContext {};
+			}
+
+			ResetVoiceAllocator();
+			loadingPool = nullptr;
+			activeVoiceFlags.fill(false);
+			activeVoiceCount = 0;
+
+			if (outputMode == AudioOutputMode::Device)
+			{
+				SDL_CloseAudioDevice(sdlDevID);
+				sdlDevID = 0;
+			}
+		}
 
-			for (auto it = registeredSources.begin(); it != registeredSources.end(); it++)
+		// --- Audio thread
+
+		void ProcessCommands()
+		{
+			AudioCommand command{};
+			while (commandQueue.Peek(command))
 			{
-				if (it->SampleProvider == nullptr)
+				// NOTE: The released sample provider is only deleted once the game thread receives the event,
+				//		 so the command stays queued until a later buffer if there's no room for the event yet
+				if (command.Type == AudioCommandType::ReleaseSource && eventQueue.IsFull())
+				{
+					break;
+				}
+
+				commandQueue.Pop(command);
+
+				if (command.Type == AudioCommandType::SetResamplerQuality)
+				{
+					filterBanks = command.FilterBanks;
+					continue;
+				}
+
+				if (command.Type == AudioCommandType::SetBusGain)
+				{
+					BusContext& bus = busContexts[static_cast<size_t>(command.Bus)];
+					bus.TargetGain = command.Volume;
+					bus.RampFrames = BusGainRampFrames;
+					bus.GainStep = (bus.TargetGain - bus.Gain) / static_cast<f32>(BusGainRampFrames);
+					continue;
+				}
+
+				if (command.Type == AudioCommandType::ReleaseSource)
+				{
+					for (size_t i = 0; i < activeVoiceCount; i++)
+					{
+						VoiceContext& voice = voiceContexts[activeVoices[i]];
+						if (voice.SampleProvider == command.SampleProvider)
+						{
+							voice.SampleProvider = nullptr;
+							voice.Playing = false;
+						}
+					}
+
+					MixerEvent event { MixerEventType::SourceReleased, VoiceHandle::Invalid, 0, command.SampleProvider };
+					// NOTE: Can't fail, there was room before the command was popped and only this thread pushes events
+					eventQueue.Push(event);
+					continue;
+				}
+
+				if (static_cast<size_t>(command.Voice) >= voiceContexts.size())
 				{
 					continue;
 				}
 
-				it->SampleProvider->Destroy();
-				delete it->SampleProvider;
-				it->SampleProvider = nullptr;
+				ActivateVoice(static_cast<size_t>(command.Voice));
+
+				VoiceContext& voice = voiceContexts[static_cast<size_t>(command.Voice)];
+				voice.AppliedSerial = command.Serial;
+
+				switch (command.Type)
+				{
+				case AudioCommandType::StartVoice:
+					voice.SampleProvider = command.SampleProvider;
+					voice.LoopStart = command.LoopStart;
+					voice.FramePosition = command.FramePosition;
+					voice.Volume = command.Volume;
+					voice.PlaybackRate = command.PlaybackRate;
+					voice.Bus = command.Bus;
+					voice.Playing = command.Playing;
+					voice.Looped = command.Looped;
+					voice.DeallocateOnEnd = command.DeallocateOnEnd;
+					voice.StartFrame = command.DeviceFrame;
+					voice.StopFrame = NoScheduledFrame;
+					voice.Resampler.Reset();
+					SeekStreamingVoice(voice);
+					break;
+				case AudioCommandType::StopVoice:
+					voice = VoiceContext { };
+					voice.AppliedSerial = command.Serial;
+					break;
+				case AudioCommandType::SetSource:
+					voice.SampleProvider = command.SampleProvider;
+					voice.LoopStart = command.LoopStart;
+					voice.Resampler.Reset();
+
+					if (voice.SampleProvider == nullptr)
+					{
+						voice.Playing = false;
+						voice.FramePosition = 0;
+					}
+					break;
+				case AudioCommandType::SetPlaying:
+					// NOTE: Starting or pausing cancels a scheduled stop
+					voice.Playing = command.Playing;
+					voice.StartFrame = command.DeviceFrame;
+					voice.StopFrame = NoScheduledFrame;
+					break;
+				case AudioCommandType::ScheduleStop:
+					voice.StopFrame = command.DeviceFrame;
+					voice.FadeFrames = command.FadeFrames;
+					break;
+				case AudioCommandType::SetLoopState:
+					voice.Looped = command.Looped;
+					break;
+				case AudioCommandType::SetFramePosition:
+					voice.FramePosition = command.FramePosition;
+					voice.Resampler.Reset();
+					SeekStreamingVoice(voice);
+					break;
+				case AudioCommandType::SetVolume:
+					voice.Volume = command.Volume;
+					break;
+				case AudioCommandType::SetPlaybackRate:
+					voice.PlaybackRate = command.PlaybackRate;
+					break;
+				case AudioCommandType::SetBus:
+					voice.Bus = command.Bus;
+					break;
+				default:
+					break;
+				}
 			}
+		}
 
-			for (auto it = voiceContexts.begin(); it != voiceContexts.end(); it++)
+		void ActivateVoice(size_t index)
+		{
+			if (!activeVoiceFlags[index])
 			{
-				if (!it->Allocated)
+				activeVoiceFlags[index] = true;
+				activeVoices[activeVoiceCount++] = static_cast<u16>(index);
+			}
+		}
+
+		void SeekStreamingVoice(VoiceContext& voice)
+		{
+			if (voice.SampleProvider != nullptr && voice.SampleProvider->IsStreamingOnly())
+			{
+				voice.SampleProvider->Seek(voice.FramePosition * voice.SampleProvider->GetChannelCount());
+			}
+		}
+
+		void PublishVoiceSnapshots(u64 startTicks, size_t mixedFrames)
+		{
+			const u32 sequence = clockSequence.load(std::memory_order_relaxed);
+			clockSequence.store(sequence + 1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+
+			callbackTicks.store(startTicks, std::memory_order_relaxed);
+			deviceFramePosition.store(mixedDeviceFrames, std::memory_order_relaxed);
+			mixedDeviceFrames += mixedFrames;
+
+			for (size_t i = 0; i < activeVoiceCount;)
+			{
+				const size_t index = activeVoices[i];
+				const VoiceContext& voice = voiceContexts[index];
+				VoiceSnapshot& snapshot = voiceSnapshots[index];
+
+				snapshot.FramePosition.store(GetMixPosition(voice), std::memory_order_relaxed);
+				snapshot.Playing.store(voice.Playing, std::memory_order_relaxed);
+				snapshot.BufferStartPosition.store(voice.BufferStartPosition, std::memory_order_relaxed);
+				snapshot.BufferFrames.store(static_cast<u32>(voice.BufferFrames), std::memory_order_relaxed);
+				snapshot.FrameStep.store(voice.FrameStep, std::memory_order_relaxed);
+				snapshot.AppliedSerial.store(voice.AppliedSerial, std::memory_order_release);
+
+				// NOTE: A voice without a source has nothing left to mix. Its final state has just been published,
+				//		 so it can leave the list until the next command for it arrives
+				if (voice.SampleProvider == nullptr)
 				{
+					activeVoiceFlags[index] = false;
+					activeVoices[i] = activeVoices[--activeVoiceCount];
 					continue;
 				}
 
-				it->Playing = false;
-				it->Allocated = false;
-				it->Source = SourceHandle::Invalid;
+				i++;
 			}
 
-			SDL_CloseAudioDevice(sdlDevID);
+			clockSequence.store(sequence + 2, std::memory_order_release);
+		}
+
+		// NOTE: Source position of the next frame that will be mixed
+		static size_t GetMixPosition(const VoiceContext& voice)
+		{
+			const f64 position = static_cast<f64>(voice.FramePosition) + voice.Resampler.Position;
+			return (position > 0.0) ? static_cast<size_t>(position) : 0;
+		}
+
+		// NOTE: Amount of source frames per device frame
+		f64 GetFrameStep(const VoiceContext& voice) const
+		{
+			const f64 step = static_cast<f64>(voice.SampleProvider->GetSampleRate()) / static_cast<f64>(sdlSpec.freq) * static_cast<f64>(voice.PlaybackRate);
+			return std::min(step, static_cast<f64>(Mixing::MaxResampleStep));
 		}
 
 		void QueueAudio(f32* stream, size_t length)
 		{
-			SDL_memset(&mixingBuffer[0], 0, length * sizeof(f32));
+			const u64 startTicks = SDL_GetPerformanceCounter();
 
-			int currentVoice = -1;
-			for (auto it = voiceContexts.begin(); it != voiceContexts.end(); it++)
+			if (mixerStatsResetRequested.exchange(false, std::memory_order_acquire))
+			{
+				mixerStats.Reset();
+			}
+
+			ProcessCommands();
+
+			for (auto& bus : busContexts)
+			{
+				bus.HasInput = false;
+			}
+
+			const size_t framesToMix = length / DefaultChannelCount;
+			const u64 bufferStartFrame = mixedDeviceFrames;
+			const u64 bufferEndFrame = bufferStartFrame + framesToMix;
+
+			u32 playingVoices = 0;
+			u32 streamingVoices = 0;
+			f32 minStreamingBufferFill = 1.0f;
+
+			for (size_t i = 0; i < activeVoiceCount; i++)
 			{
-				currentVoice++;
-				if (it->Source != SourceHandle::Invalid && it->Allocated && it->Playing)
+				const size_t index = activeVoices[i];
+				VoiceContext& voice = voiceContexts[index];
+				voice.BufferStartPosition = static_cast<f64>(GetMixPosition(voice));
+				voice.BufferFrames = 0;
+
+				// NOTE: Voices scheduled to start in a later buffer keep waiting
+				if (voice.SampleProvider == nullptr || !voice.Playing || voice.StartFrame >= bufferEndFrame)
 				{
-					const SourceData* source = GetSourceData(it->Source);
+					continue;
+				}
 
-					if (source == nullptr)
-					{
-						continue;
-					}
+				ISampleProvider* sampleProvider = voice.SampleProvider;
 
-					ISampleProvider* sampleProvider = source->SampleProvider;
-					bool streaming = sampleProvider->IsStreamingOnly();
+				size_t channels = sampleProvider->GetChannelCount();
+				size_t endPosition = sampleProvider->GetSampleAmount() / channels;
 
-					if (streaming && (static_cast<int>(source->BoundVoice) != currentVoice))
+				if (voice.FramePosition >= endPosition)
+				{
+					if (!voice.Looped)
 					{
+						FinishVoice(index, voice);
 						continue;
 					}
 
-					size_t channels = sampleProvider->GetChannelCount();
-					size_t endPosition = sampleProvider->GetSampleAmount() / channels;
-				
-					if (it->FramePosition >= endPosition)
-					{
-						if (!it->Looped)
-						{
-							it->Playing = false;
-
-							if (it->DeallocateOnEnd)
-							{
-								it->Allocated = false;
-								it->DeallocateOnEnd = false;
-								it->Source = SourceHandle::Invalid;
-								it->FramePosition = 0;
-								it->Volume = 1.0f;
-							}
-
-							continue;
-						}
+					voice.FramePosition = voice.LoopStart;
+					SeekStreamingVoice(voice);
+				}
 
-						it->FramePosition = source->LoopStart;
-					}
+				playingVoices++;
+				if (sampleProvider->IsStreamingOnly())
+				{
+					streamingVoices++;
+					minStreamingBufferFill = std::min(minStreamingBufferFill, sampleProvider->GetBufferFillLevel());
+				}
 
-					size_t samplesToRead = length / (DefaultChannelCount / channels);
-					size_t readSamples = 0;
+				voice.FrameStep = GetFrameStep(voice);
+				f32* busBuffer = GetBusBuffer(voice.Bus, length);
 
-					if (streaming)
-					{
-						readSamples = sampleProvider->GetNextSamples(&workingBuffer[0], samplesToRead);
-					}
-					else
-					{
-						readSamples = sampleProvider->ReadSamples(&workingBuffer[0], it->FramePosition * channels, samplesToRead);
-					}
+				// NOTE: The buffer is split into the frames before the start (silent), the frames at full volume, the fade and the frames after the stop (silent)
+				const size_t startOffset = (voice.StartFrame > bufferStartFrame) ? static_cast<size_t>(voice.StartFrame - bufferStartFrame) : 0;
+				size_t fadeOffset = framesToMix;
+				size_t endOffset = framesToMix;
 
-					if (it->Looped && readSamples < samplesToRead)
-					{
-						size_t bufferRemainder = samplesToRead - readSamples;
-						if (streaming)
-						{
-							sampleProvider->Seek(source->LoopStart * channels);
-							readSamples = sampleProvider->GetNextSamples(
-								&workingBuffer[bufferRemainder],
-								bufferRemainder / (DefaultChannelCount / channels));
-						}
-						else
-						{
-							readSamples = sampleProvider->ReadSamples(
-								&workingBuffer[bufferRemainder],
-								source->LoopStart * channels,
-								bufferRemainder / (DefaultChannelCount / channels));
-						}
+				if (voice.StopFrame != NoScheduledFrame)
+				{
+					const u64 fadeEndFrame = voice.StopFrame + voice.FadeFrames;
+					fadeOffset = static_cast<size_t>(std::clamp(voice.StopFrame, bufferStartFrame + startOffset, bufferEndFrame) - bufferStartFrame);
+					endOffset = static_cast<size_t>(std::clamp(fadeEndFrame, bufferStartFrame + fadeOffset, bufferEndFrame) - bufferStartFrame);
+				}
 
-						it->FramePosition = source->LoopStart + readSamples;
-						readSamples = samplesToRead;
-					}
+				const f64 startPosition = static_cast<f64>(voice.FramePosition) + voice.Resampler.Position;
+				size_t mixedEndOffset = startOffset;
 
-					for (size_t pos = 0; pos < readSamples; pos += channels)
-					{
-						if (channels == 1)
-						{
-							f32 sample = ConvertSampleFromI16ToF32(workingBuffer[pos]) * it->Volume;
-							mixingBuffer[pos * 2 + 0] += sample;
-							mixingBuffer[pos * 2 + 1] += sample;
+				if (fadeOffset > startOffset)
+				{
+					mixedEndOffset += MixVoiceFrames(&busBuffer[startOffset * DefaultChannelCount], voice, channels, fadeOffset - startOffset);
+				}
 
-							mixingBuffer[pos * 2 + 0] = SDL_clamp(mixingBuffer[pos * 2 + 0], -1.0f, 1.0f);
-							mixingBuffer[pos * 2 + 1] = SDL_clamp(mixingBuffer[pos * 2 + 1], -1.0f, 1.0f);
+				if (endOffset > fadeOffset)
+				{
+					const size_t fadeFrames = endOffset - fadeOffset;
+					const f32 fadeStep = -1.0f / static_cast<f32>(voice.FadeFrames);
+					const f32 fadeGain = 1.0f + fadeStep * static_cast<f32>(bufferStartFrame + fadeOffset - voice.StopFrame);
 
-							it->FramePosition++;
-						}
-						else // 2 channels
-						{
-							mixingBuffer[pos + 0] += ConvertSampleFromI16ToF32(workingBuffer[pos + 0]) * it->Volume;
-							mixingBuffer[pos + 1] += ConvertSampleFromI16ToF32(workingBuffer[pos + 1]) * it->Volume;
+					SDL_memset(&fadeBuffer[0], 0, fadeFrames * DefaultChannelCount * sizeof(f32));
+					const size_t fadedFrames = MixVoiceFrames(&fadeBuffer[0], voice, channels, fadeFrames);
+
+					Mixing::BusLevels unusedLevels{};
+					mixKernels->AccumulateBus(&busBuffer[fadeOffset * DefaultChannelCount], &fadeBuffer[0], fadedFrames, fadeGain, fadeStep, unusedLevels);
+					mixedEndOffset = fadeOffset + fadedFrames;
+				}
 
-							mixingBuffer[pos + 0] = SDL_clamp(mixingBuffer[pos + 0], -1.0f, 1.0f);
-							mixingBuffer[pos + 1] = SDL_clamp(mixingBuffer[pos + 1], -1.0f, 1.0f);
+				// NOTE: The clock extrapolates from the first frame of the buffer, as if the voice had been playing from there on
+				voice.BufferStartPosition = startPosition - static_cast<f64>(startOffset) * voice.FrameStep;
+				voice.BufferFrames = mixedEndOffset;
 
-							it->FramePosition++;
-						}
-					}
+				if (voice.StopFrame != NoScheduledFrame && voice.StopFrame + voice.FadeFrames <= bufferEndFrame)
+				{
+					FinishVoice(index, voice);
+				}
+			}
+
+			// NOTE: Submixes go into the master bus, which is then scaled by its own gain into the output
+			f32* masterBuffer = GetBusBuffer(AudioBus::Master, length);
+			for (size_t i = 0; i < BusCount; i++)
+			{
+				if (static_cast<AudioBus>(i) != AudioBus::Master)
+				{
+					MixBus(static_cast<AudioBus>(i), masterBuffer, framesToMix);
 				}
 			}
 
-			SDL_LockAudioDevice(sdlDevID);
+			SDL_memset(&mixingBuffer[0], 0, length * sizeof(f32));
+			MixBus(AudioBus::Master, &mixingBuffer[0], framesToMix);
+
+			mixKernels->ClampCopy(stream, &mixingBuffer[0], length);
+
+			PublishVoiceSnapshots(startTicks, framesToMix);
 
-			SDL_memcpy(stream, &mixingBuffer[0], length * sizeof(f32));
+			mixerStats.ActiveVoices.store(static_cast<u32>(activeVoiceCount), std::memory_order_relaxed);
+			mixerStats.PlayingVoices.store(playingVoices, std::memory_order_relaxed);
+			mixerStats.PeakPlayingVoices.store(std::max(playingVoices, mixerStats.PeakPlayingVoices.load(std::memory_order_relaxed)), std::memory_order_relaxed);
+			mixerStats.StreamingVoices.store(streamingVoices, std::memory_order_relaxed);
+			mixerStats.MinStreamingBufferFill.store(minStreamingBufferFill, std::memory_order_relaxed);
 
-			SDL_UnlockAudioDevice(sdlDevID);
+			RecordCallbackTiming(startTicks, SDL_GetPerformanceCounter(), framesToMix);
 		}
 
-		VoiceContext* GetVoiceContext(VoiceHandle handle)
+		void RecordCallbackTiming(u64 startTicks, u64 endTicks, size_t frameCount)
 		{
-			if (handle != VoiceHandle::Invalid && static_cast<size_t>(handle) < voiceContexts.size())
+			const u64 durationTicks = endTicks - startTicks;
+			const u64 periodTicks = static_cast<u64>(static_cast<f64>(frameCount) * performanceFrequency / static_cast<f64>(sdlSpec.freq));
+
+			// NOTE: SDL doesn't report underruns, but a callback that arrives late means the device had nothing left to play
+			const u64 previousPeriodTicks = mixerStats.BufferPeriodTicks.load(std::memory_order_relaxed);
+			if (outputMode == AudioOutputMode::Device && lastCallbackStartTicks != 0)
 			{
-				VoiceContext* ctx = &voiceContexts[static_cast<size_t>(handle)];
-				if (ctx->Allocated)
+				const u64 intervalTicks = startTicks - lastCallbackStartTicks;
+				if (intervalTicks * 2 > previousPeriodTicks * 3)
 				{
-					return ctx;
+					MixerStats::Increment(mixerStats.Underruns);
 				}
+
+				const u64 jitterTicks = (intervalTicks > previousPeriodTicks) ? (intervalTicks - previousPeriodTicks) : (previousPeriodTicks - intervalTicks);
+				mixerStats.MaxCallbackJitterTicks.store(std::max(jitterTicks, mixerStats.MaxCallbackJitterTicks.load(std::memory_order_relaxed)), std::memory_order_relaxed);
 			}
-			return nullptr;
-		}
+			lastCallbackStartTicks = startTicks;
+
+			MixerStats::Increment(mixerStats.CallbackCount);
+			mixerStats.TotalCallbackTicks.store(mixerStats.TotalCallbackTicks.load(std::memory_order_relaxed) + durationTicks, std::memory_order_relaxed);
+			mixerStats.MinCallbackTicks.store(std::min(durationTicks, mixerStats.MinCallbackTicks.load(std::memory_order_relaxed)), std::memory_order_relaxed);
+			mixerStats.MaxCallbackTicks.store(std::max(durationTicks, mixerStats.MaxCallbackTicks.load(std::memory_order_relaxed)), std::memory_order_relaxed);
+			mixerStats.LastCallbackTicks.store(durationTicks, std::memory_order_relaxed);
+			mixerStats.BufferPeriodTicks.store(periodTicks, std::memory_order_relaxed);
+
+			if (periodTicks == 0)
+			{
+				return;
+			}
+
+			constexpr size_t bucketCount = AudioEngineStats::CallbackHistogramBucketCount;
+			const size_t bucket = std::min(static_cast<size_t>(durationTicks * bucketCount / periodTicks), bucketCount - 1);
+			MixerStats::Increment(mixerStats.CallbackHistogram[bucket]);
+
+			const i64 marginTicks = static_cast<i64>(periodTicks) - static_cast<i64>(durationTicks);
+			mixerStats.MinDeadlineMarginTicks.store(std::min(marginTicks, mixerStats.MinDeadlineMarginTicks.load(std::memory_order_relaxed)), std::memory_order_relaxed);
+			if (marginTicks < 0)
+			{
+				MixerStats::Increment(mixerStats.DeadlineMisses);
+			}
+		}
+
+		f32* GetBusBuffer(AudioBus bus, size_t length)
+		{
+			BusContext& context = busContexts[static_cast<size_t>(bus)];
+			f32* buffer = &busBuffers[static_cast<size_t>(bus)][0];
+
+			if (!context.HasInput)
+			{
+				SDL_memset(buffer, 0, length * sizeof(f32));
+				context.HasInput = true;
+			}
+
+			return buffer;
+		}
+
+		// NOTE: Adds the bus to 'dst' while advancing its gain ramp and publishes its levels. Silent buses only advance the ramp
+		void MixBus(AudioBus bus, f32* dst, size_t frameCount)
+		{
+			BusContext& context = busContexts[static_cast<size_t>(bus)];
+			const f32* src = &busBuffers[static_cast<size_t>(bus)][0];
+
+			Mixing::BusLevels levels{};
+
+			const size_t rampFrames = std::min(frameCount, context.RampFrames);
+			if (rampFrames > 0)
+			{
+				if (context.HasInput)
+				{
+					mixKernels->AccumulateBus(dst, src, rampFrames, context.Gain, context.GainStep, levels);
+				}
+
+				context.Gain += context.GainStep * static_cast<f32>(rampFrames);
+				context.RampFrames -= rampFrames;
+
+				if (context.RampFrames == 0)
+				{
+					context.Gain = context.TargetGain;
+				}
+			}
+
+			if (context.HasInput && rampFrames < frameCount && context.Gain != 0.0f)
+			{
+				mixKernels->AccumulateBus(&dst[rampFrames * DefaultChannelCount], &src[rampFrames * DefaultChannelCount], frameCount - rampFrames, context.Gain, 0.0f, levels);
+			}
+
+			BusMeterSnapshot& meter = busMeters[static_cast<size_t>(bus)];
+			for (size_t channel = 0; channel < levels.Peak.size(); channel++)
+			{
+				meter.Peak[channel].store(levels.Peak[channel], std::memory_order_relaxed);
+				meter.RMS[channel].store((frameCount > 0) ? sqrtf(levels.SumOfSquares[channel] / static_cast<f32>(frameCount)) : 0.0f, std::memory_order_relaxed);
+			}
+		}
+
+		// NOTE: Mixes the next 'frameCount' frames of the voice into 'dst', returns the amount of frames that have been mixed
+		size_t MixVoiceFrames(f32* dst, VoiceContext& voice, size_t channels, size_t frameCount)
+		{
+			// NOTE: Sources at the device rate that play at normal speed are mixed directly
+			if (voice.FrameStep == 1.0 && !voice.Resampler.Active)
+			{
+				size_t readFrames = ReadVoiceFrames(voice, frameCount);
+
+				if (channels == 1)
+				{
+					mixKernels->AccumulateMono(dst, &workingBuffer[0], readFrames, voice.Volume);
+				}
+				else // 2 channels
+				{
+					mixKernels->AccumulateStereo(dst, &workingBuffer[0], readFrames, voice.Volume);
+				}
+
+				UpdateResamplerHistory(voice, channels, readFrames);
+				return readFrames;
+			}
+
+			MixResampledVoice(dst, voice, channels, frameCount);
+			return frameCount;
+		}
+
+		// NOTE: Pauses a voice that has reached the end of its source or its scheduled stop, sounds played through PlaySound() are freed
+		void FinishVoice(size_t index, VoiceContext& voice)
+		{
+			voice.Playing = false;
+			voice.StopFrame = NoScheduledFrame;
+
+			if (voice.DeallocateOnEnd)
+			{
+				MixerEvent event { MixerEventType::VoiceFinished, static_cast<VoiceHandle>(index), voice.AppliedSerial, nullptr };
+				eventQueue.Push(event);
+
+				u32 appliedSerial = voice.AppliedSerial;
+				voice = VoiceContext {};
+				voice.AppliedSerial = appliedSerial;
+			}
+		}
+
+		void MixResampledVoice(f32* dst, VoiceContext& voice, size_t channels, size_t frameCount)
+		{
+			Mixing::ResamplerState& resampler = voice.Resampler;
+			const Mixing::FilterBank& filterBank = filterBanks->GetFilterBank(voice.FrameStep);
+
+			// NOTE: The last output frame needs the source frames up to TapCount / 2 after its position
+			const f64 lastPosition = resampler.Position + static_cast<f64>(frameCount - 1) * voice.FrameStep;
+			const i64 requiredFrames = static_cast<i64>(floor(lastPosition)) + static_cast<i64>(filterBank.TapCount / 2) + 1;
+			const size_t sourceFrames = static_cast<size_t>(std::clamp<i64>(requiredFrames, 0, static_cast<i64>(MaxSourceFramesPerBuffer)));
+
+			const size_t readFrames = ReadVoiceFrames(voice, sourceFrames);
+
+			for (size_t channel = 0; channel < channels; channel++)
+			{
+				f32* input = &resampleBuffer[channel][0];
+				SDL_memcpy(input, resampler.History[channel].data(), Mixing::MaxTapCount * sizeof(f32));
+
+				for (size_t frame = 0; frame < readFrames; frame++)
+				{
+					input[Mixing::MaxTapCount + frame] = static_cast<f32>(workingBuffer[frame * channels + channel]) * Mixing::I16ToF32Scale;
+				}
+
+				// NOTE: Sources that have ended or are still buffering are padded with silence
+				SDL_memset(&input[Mixing::MaxTapCount + readFrames], 0, (sourceFrames - readFrames) * sizeof(f32));
+			}
+
+			if (channels == 1)
+			{
+				resampleKernels->ResampleMono(dst, &resampleBuffer[0][Mixing::MaxTapCount],
+					filterBank, resampler.Position, voice.FrameStep, frameCount, voice.Volume);
+			}
+			else // 2 channels
+			{
+				resampleKernels->ResampleStereo(dst, &resampleBuffer[0][Mixing::MaxTapCount], &resampleBuffer[1][Mixing::MaxTapCount],
+					filterBank, resampler.Position, voice.FrameStep, frameCount, voice.Volume);
+			}
+
+			for (size_t channel = 0; channel < channels; channel++)
+			{
+				SDL_memcpy(resampler.History[channel].data(), &resampleBuffer[channel][sourceFrames], Mixing::MaxTapCount * sizeof(f32));
+			}
+
+			resampler.Position = lastPosition + voice.FrameStep - static_cast<f64>(sourceFrames);
+			resampler.Active = true;
+		}
+
+		// NOTE: Keeps the history up to date while a voice is mixed directly, so that it can start resampling without a discontinuity
+		void UpdateResamplerHistory(VoiceContext& voice, size_t channels, size_t readFrames)
+		{
+			const size_t keptFrames = (readFrames < Mixing::MaxTapCount) ? Mixing::MaxTapCount - readFrames : 0;
+			const size_t newFrames = Mixing::MaxTapCount - keptFrames;
+
+			for (size_t channel = 0; channel < channels; channel++)
+			{
+				f32* history = voice.Resampler.History[channel].data();
+				SDL_memmove(history, &history[Mixing::MaxTapCount - keptFrames], keptFrames * sizeof(f32));
+
+				const i16* samples = &workingBuffer[(readFrames - newFrames) * channels + channel];
+				for (size_t frame = 0; frame < newFrames; frame++)
+				{
+					history[keptFrames + frame] = static_cast<f32>(samples[frame * channels]) * Mixing::I16ToF32Scale;
+				}
+			}
+		}
+
+		// NOTE: Reads up to 'frameCount' frames of the voice's source into the working buffer, wrapping around the loop start if needed.
+		//		 Returns the amount of frames read.
+		size_t ReadVoiceFrames(VoiceContext& voice, size_t frameCount)
+		{
+			ISampleProvider* sampleProvider = voice.SampleProvider;
+			bool streaming = sampleProvider->IsStreamingOnly();
+			size_t channels = sampleProvider->GetChannelCount();
+
+			size_t readSamples = 0;
+			if (streaming)
+			{
+				readSamples = sampleProvider->GetNextSamples(&workingBuffer[0], frameCount * channels);
+			}
+			else
+			{
+				readSamples = sampleProvider->ReadSamples(&workingBuffer[0], voice.FramePosition * channels, frameCount * channels);
+			}
+
+			size_t readFrames = readSamples / channels;
+			voice.FramePosition += readFrames;
+
+			// NOTE: Streaming sources can return less than requested while they are buffering, only wrap around once the end has been reached.
+			//		 Short loops can wrap around more than once per buffer when the voice is resampled.
+			size_t endPosition = sampleProvider->GetSampleAmount() / channels;
+
+			if (streaming && readFrames < frameCount && voice.FramePosition < endPosition)
+			{
+				MixerStats::Increment(mixerStats.StreamingStarvations);
+			}
+
+			while (voice.Looped && readFrames < frameCount && voice.FramePosition >= endPosition)
+			{
+				size_t remainingSamples = (frameCount - readFrames) * channels;
+				size_t loopedSamples = 0;
+
+				if (streaming)
+				{
+					sampleProvider->Seek(voice.LoopStart * channels);
+					loopedSamples = sampleProvider->GetNextSamples(&workingBuffer[readFrames * channels], remainingSamples);
+				}
+				else
+				{
+					loopedSamples = sampleProvider->ReadSamples(&workingBuffer[readFrames * channels], voice.LoopStart * channels, remainingSamples);
+				}
+
+				voice.FramePosition = voice.LoopStart + loopedSamples / channels;
+				readFrames += loopedSamples / channels;
+
+				if (loopedSamples == 0)
+				{
+					break;
+				}
+			}
+
+			return readFrames;
+		}
+
+		// --- Game thread
+
+		void PushCommand(const AudioCommand& command)
+		{
+			// NOTE: Once a command has been deferred all later ones have to wait behind it to keep their order
+			if (pendingCommands.empty() && commandQueue.Push(command))
+			{
+				return;
+			}
+
+			if (pendingCommands.empty())
+			{
+				LogWarn(LogName, "Audio command queue is full, commands are deferred to the next update");
+			}
+
+			pendingCommands.push_back(command);
+			deferredCommands++;
+		}
+
+		void PushPendingCommands()
+		{
+			size_t pushedCount = 0;
+			for (; pushedCount < pendingCommands.size(); pushedCount++)
+			{
+				if (!commandQueue.Push(pendingCommands[pushedCount]))
+				{
+					break;
+				}
+			}
+
+			pendingCommands.erase(pendingCommands.begin(), pendingCommands.begin() + pushedCount);
+		}
+
+		void Update()
+		{
+			PushPendingCommands();
+			ProcessMixerEvents();
+			UpdateBufferCalibration();
+		}
+
+		AudioCommand CreateVoiceCommand(AudioCommandType type, VoiceHandle handle, VoiceState& state)
+		{
+			AudioCommand command{};
+			command.Type = type;
+			command.Voice = handle;
+			command.Serial = ++state.Serial;
+			return command;
+		}
+
+		void ProcessMixerEvents()
+		{
+			MixerEvent event{};
+			while (eventQueue.Pop(event))
+			{
+				switch (event.Type)
+				{
+				case MixerEventType::VoiceFinished:
+				{
+					VoiceState& state = voiceStates[static_cast<size_t>(event.Voice)];
+
+					// NOTE: The voice might have been reused since the audio thread has sent this event
+					if (state.Allocated && state.DeallocateOnEnd && state.Serial == event.Serial)
+					{
+						FreeVoiceSlot(event.Voice, state);
+					}
+					break;
+				}
+				case MixerEventType::SourceReleased:
+					event.SampleProvider->Destroy();
+					delete event.SampleProvider;
+					break;
+				default:
+					break;
+				}
+			}
+		}
+
+		VoiceState* GetVoiceState(VoiceHandle handle)
+		{
+			if (handle != VoiceHandle::Invalid && static_cast<size_t>(handle) < voiceStates.size())
+			{
+				VoiceState* state = &voiceStates[static_cast<size_t>(handle)];
+				if (state->Allocated)
+				{
+					return state;
+				}
+			}
+			return nullptr;
+		}
+
+		const VoiceSnapshot& GetVoiceSnapshot(VoiceHandle handle) const
+		{
+			return voiceSnapshots[static_cast<size_t>(handle)];
+		}
+
+		bool IsVoicePlaying(VoiceHandle handle, const VoiceState& state) const
+		{
+			const VoiceSnapshot& snapshot = GetVoiceSnapshot(handle);
+			if (HasSerialBeenApplied(snapshot.AppliedSerial.load(std::memory_order_acquire), state.PlaybackSerial))
+			{
+				return snapshot.Playing.load(std::memory_order_relaxed);
+			}
+			return state.Playing;
+		}
+
+		size_t GetVoiceFramePosition(VoiceHandle handle, const VoiceState& state) const
+		{
+			const VoiceSnapshot& snapshot = GetVoiceSnapshot(handle);
+			if (HasSerialBeenApplied(snapshot.AppliedSerial.load(std::memory_order_acquire), state.PlaybackSerial))
+			{
+				return static_cast<size_t>(snapshot.FramePosition.load(std::memory_order_relaxed));
+			}
+			return state.FramePosition;
+		}
+
+		TimeSpan TicksToTimeSpan(f64 ticks) const
+		{
+			return TimeSpanConversion::FromSeconds(ticks / performanceFrequency);
+		}
+
+		AudioEngineStats GetStats() const
+		{
+			AudioEngineStats stats{};
+			stats.CallbackCount = mixerStats.CallbackCount.load(std::memory_order_relaxed);
+
+			if (stats.CallbackCount > 0)
+			{
+				const u64 totalTicks = mixerStats.TotalCallbackTicks.load(std::memory_order_relaxed);
+				stats.MinCallbackDuration = TicksToTimeSpan(static_cast<f64>(mixerStats.MinCallbackTicks.load(std::memory_order_relaxed)));
+				stats.AverageCallbackDuration = TicksToTimeSpan(static_cast<f64>(totalTicks) / static_cast<f64>(stats.CallbackCount));
+				stats.MaxCallbackDuration = TicksToTimeSpan(static_cast<f64>(mixerStats.MaxCallbackTicks.load(std::memory_order_relaxed)));
+			}
+
+			stats.LastCallbackDuration = TicksToTimeSpan(static_cast<f64>(mixerStats.LastCallbackTicks.load(std::memory_order_relaxed)));
+			for (size_t i = 0; i < stats.CallbackHistogram.size(); i++)
+			{
+				stats.CallbackHistogram[i] = mixerStats.CallbackHistogram[i].load(std::memory_order_relaxed);
+			}
+
+			stats.BufferPeriod = TicksToTimeSpan(static_cast<f64>(mixerStats.BufferPeriodTicks.load(std::memory_order_relaxed)));
+			const i64 minMarginTicks = mixerStats.MinDeadlineMarginTicks.load(std::memory_order_relaxed);
+			stats.MinDeadlineMargin = (minMarginTicks != INT64_MAX) ? TicksToTimeSpan(static_cast<f64>(minMarginTicks)) : stats.BufferPeriod;
+			stats.DeadlineMisses = mixerStats.DeadlineMisses.load(std::memory_order_relaxed);
+			stats.Underruns = mixerStats.Underruns.load(std::memory_order_relaxed);
+			stats.MaxCallbackJitter = TicksToTimeSpan(static_cast<f64>(mixerStats.MaxCallbackJitterTicks.load(std::memory_order_relaxed)));
+
+			stats.ActiveVoices = mixerStats.ActiveVoices.load(std::memory_order_relaxed);
+			stats.PlayingVoices = mixerStats.PlayingVoices.load(std::memory_order_relaxed);
+			stats.PeakPlayingVoices = mixerStats.PeakPlayingVoices.load(std::memory_order_relaxed);
+
+			stats.StreamingVoices = mixerStats.StreamingVoices.load(std::memory_order_relaxed);
+			stats.MinStreamingBufferFill = mixerStats.MinStreamingBufferFill.load(std::memory_order_relaxed);
+			stats.StreamingStarvations = mixerStats.StreamingStarvations.load(std::memory_order_relaxed);
+
+			stats.DroppedSounds = droppedSounds;
+			stats.DeferredCommands = deferredCommands;
+
+			for (const SourceData& source : registeredSources)
+			{
+				if (source.SampleProvider != nullptr && !source.CacheKeys.empty())
+				{
+					stats.CachedSources++;
+					stats.UnreferencedCachedSources += (source.ReferenceCount == 0) ? 1 : 0;
+				}
+			}
+
+			stats.CachedSourceMemory = cachedSourceMemory;
+			stats.SourceCacheHits = sourceCacheHits;
+			stats.SourceCacheMisses = sourceCacheMisses;
+			stats.SourceCacheEvictions = sourceCacheEvictions;
+			return stats;
+		}
+
+		ClockReading ReadClock(const VoiceSnapshot* snapshot) const
+		{
+			ClockReading reading{};
+			while (true)
+			{
+				const u32 sequence = clockSequence.load(std::memory_order_acquire);
+				if (sequence & 1)
+				{
+					std::this_thread::yield();
+					continue;
+				}
+
+				reading.CallbackTicks = callbackTicks.load(std::memory_order_relaxed);
+				reading.DeviceFramePosition = deviceFramePosition.load(std::memory_order_relaxed);
+
+				if (snapshot != nullptr)
+				{
+					reading.AppliedSerial = snapshot->AppliedSerial.load(std::memory_order_relaxed);
+					reading.BufferStartPosition = snapshot->BufferStartPosition.load(std::memory_order_relaxed);
+					reading.BufferFrames = snapshot->BufferFrames.load(std::memory_order_relaxed);
+					reading.FrameStep = snapshot->FrameStep.load(std::memory_order_relaxed);
+				}
+
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if (clockSequence.load(std::memory_order_relaxed) == sequence)
+				{
+					return reading;
+				}
+			}
+		}
+
+		// NOTE: Amount of device frames that have become audible since the start of the last mixed buffer.
+		//		 Negative while the output latency and the previous buffers are still playing, the output latency
+		//		 alone can span several device buffers so only the far end is limited to the last buffer.
+		f64 GetAudibleBufferOffset(u64 ticks, size_t bufferFrames) const
+		{
+			// NOTE: Offline rendering has no notion of wall-clock time, everything that has been mixed counts as played
+			if (outputMode == AudioOutputMode::Null)
+			{
+				return static_cast<f64>(bufferFrames);
+			}
+
+			const f64 secondsSinceCallback = static_cast<f64>(static_cast<i64>(SDL_GetPerformanceCounter() - ticks)) / performanceFrequency;
+			const f64 offset = (secondsSinceCallback - outputLatency.GetSeconds()) * static_cast<f64>(sdlSpec.freq);
+
+			const f64 latencyFrames = outputLatency.GetSeconds() * static_cast<f64>(sdlSpec.freq);
+			const f64 deviceBufferFrames = static_cast<f64>(sdlSpec.samples);
+			return std::clamp(offset, -(latencyFrames + deviceBufferFrames), static_cast<f64>(bufferFrames));
+		}
+
+		f64 GetDeviceFramePosition() const
+		{
+			const ClockReading clock = ReadClock(nullptr);
+			const f64 position = static_cast<f64>(clock.DeviceFramePosition) + GetAudibleBufferOffset(clock.CallbackTicks, sdlSpec.samples);
+			return std::max(position, 0.0);
+		}
+
+		TimeSpan GetDeviceTime() const
+		{
+			return TimeSpanConversion::FromSeconds(GetDeviceFramePosition() / static_cast<f64>(sdlSpec.freq));
+		}
+
+		TimeSpan GetVoicePlaybackTime(VoiceHandle handle, VoiceState& state)
+		{
+			const SourceData* sourceData = GetSourceData(state.Source);
+			const f64 sampleRate = static_cast<f64>((sourceData != nullptr) ? sourceData->SampleProvider->GetSampleRate() : sdlSpec.freq);
+
+			const ClockReading clock = ReadClock(&GetVoiceSnapshot(handle));
+
+			f64 position = static_cast<f64>(state.FramePosition);
+			if (HasSerialBeenApplied(clock.AppliedSerial, state.PlaybackSerial))
+			{
+				// NOTE: A voice that didn't mix anything (paused, buffering or finished) stays at its last position
+				position = clock.BufferStartPosition;
+				if (clock.BufferFrames > 0)
+				{
+					position = std::max(position + GetAudibleBufferOffset(clock.CallbackTicks, clock.BufferFrames) * clock.FrameStep, 0.0);
+				}
+			}
+
+			TimeSpan playbackTime = TimeSpanConversion::FromSeconds(position / sampleRate);
+
+			// NOTE: Timing jitter between callbacks can make the estimate go slightly backwards, which is never what the player hears
+			if (HasSerialBeenApplied(clock.AppliedSerial, state.PositionSerial) && playbackTime < state.LastPlaybackTime)
+			{
+				playbackTime = state.LastPlaybackTime;
+			}
+
+			state.LastPlaybackTime = playbackTime;
+			return playbackTime;
+		}
+
+		SourceData* GetSourceData(SourceHandle handle)
+		{
+			const size_t index = GetSourceIndex(handle);
+			if (handle != SourceHandle::Invalid && index < registeredSources.size())
+			{
+				SourceData* data = &registeredSources[index];
+				if (data->SampleProvider != nullptr && data->Generation == GetSourceGeneration(handle))
+				{
+					return data;
+				}
+			}
+			return nullptr;
+		}
+
+		void ResetVoiceAllocator()
+		{
+			// NOTE: Reversed so that the lowest handles are handed out first
+			for (size_t i = 0; i < MaxSimultaneousVoices; i++)
+			{
+				freeVoices[i] = static_cast<VoiceHandle>(MaxSimultaneousVoices - 1 - i);
+			}
+
+			freeVoiceCount = MaxSimultaneousVoices;
+			oldestSound = VoiceHandle::Invalid;
+			newestSound = VoiceHandle::Invalid;
+		}
+
+		VoiceHandle TakeFreeVoice(VoicePriority priority)
+		{
+			ProcessMixerEvents();
+
+			if (freeVoiceCount == 0)
+			{
+				VoiceHandle stolenVoice = FindVoiceToSteal(priority);
+				if (stolenVoice == VoiceHandle::Invalid)
+				{
+					LogWarn(LogName, "All %llu voices are in use, no voice could be allocated", MaxSimultaneousVoices);
+					return VoiceHandle::Invalid;
+				}
+
+				ReleaseVoice(stolenVoice);
+			}
+
+			return freeVoices[--freeVoiceCount];
+		}
+
+		// NOTE: Only sounds played through PlaySound() are considered. Prefers the lowest priority, then the quietest and then the oldest sound
+		VoiceHandle FindVoiceToSteal(VoicePriority priority) const
+		{
+			VoiceHandle stolenVoice = VoiceHandle::Invalid;
+			const VoiceState* stolenState = nullptr;
+
+			for (VoiceHandle handle = oldestSound; handle != VoiceHandle::Invalid; handle = voiceStates[static_cast<size_t>(handle)].NextSound)
+			{
+				const VoiceState& state = voiceStates[static_cast<size_t>(handle)];
+				if (state.Priority == VoicePriority::Protected || state.Priority > priority)
+				{
+					continue;
+				}
+
+				if (stolenState == nullptr || state.Priority < stolenState->Priority || (state.Priority == stolenState->Priority && state.Volume < stolenState->Volume))
+				{
+					stolenVoice = handle;
+					stolenState = &state;
+				}
+			}
+
+			return stolenVoice;
+		}
+
+		void LinkSound(VoiceHandle handle, VoiceState& state)
+		{
+			state.PreviousSound = newestSound;
+			state.NextSound = VoiceHandle::Invalid;
+
+			if (newestSound != VoiceHandle::Invalid)
+			{
+				voiceStates[static_cast<size_t>(newestSound)].NextSound = handle;
+			}
+			else
+			{
+				oldestSound = handle;
+			}
+
+			newestSound = handle;
+		}
+
+		void UnlinkSound(VoiceHandle handle, VoiceState& state)
+		{
+			if (state.PreviousSound != VoiceHandle::Invalid)
+			{
+				voiceStates[static_cast<size_t>(state.PreviousSound)].NextSound = state.NextSound;
+			}
+			else
+			{
+				oldestSound = state.NextSound;
+			}
+
+			if (state.NextSound != VoiceHandle::Invalid)
+			{
+				voiceStates[static_cast<size_t>(state.NextSound)].PreviousSound = state.PreviousSound;
+			}
+			else
+			{
+				newestSound = state.PreviousSound;
+			}
+
+			state.PreviousSound = VoiceHandle::Invalid;
+			state.NextSound = VoiceHandle::Invalid;
+		}
+
+		// NOTE: The serial keeps counting across allocations, so that snapshots of the previous owner are never mistaken for the new one's
+		void FreeVoiceSlot(VoiceHandle handle, VoiceState& state)
+		{
+			if (state.DeallocateOnEnd)
+			{
+				UnlinkSound(handle, state);
+			}
+
+			const u32 serial = state.Serial;
+			state = VoiceState {};
+			state.Serial = serial;
+			state.PlaybackSerial = serial;
+
+			freeVoices[freeVoiceCount++] = handle;
+		}
+
+		VoiceHandle AllocateVoice(SourceHandle source)
+		{
+			SourceData* sourceData = GetSourceData(source);
+			if (sourceData == nullptr)
+			{
+				return VoiceHandle::Invalid;
+			}
+
+			VoiceHandle handle = TakeFreeVoice(VoicePriority::Protected);
+			if (handle == VoiceHandle::Invalid)
+			{
+				return VoiceHandle::Invalid;
+			}
+
+			VoiceState& state = voiceStates[static_cast<size_t>(handle)];
+			state.Allocated = true;
+			state.DeallocateOnEnd = false;
+			state.Priority = VoicePriority::Protected;
+			state.Source = SourceHandle::Invalid;
+			state.Volume = 1.0f;
+			state.PlaybackRate = 1.0f;
+			state.Bus = AudioBus::SFX;
+			state.Playing = false;
+			state.Looped = false;
+			state.FramePosition = 0;
+
+			BindSource(handle, state, source);
+
+			AudioCommand command = CreateVoiceCommand(AudioCommandType::StartVoice, handle, state);
+			command.SampleProvider = sourceData->SampleProvider;
+			command.LoopStart = sourceData->LoopStart;
+			command.Volume = state.Volume;
+			command.Bus = state.Bus;
+			state.PlaybackSerial = command.Serial;
+			state.PositionSerial = command.Serial;
+			state.LastPlaybackTime = {};
+			PushCommand(command);
+
+			return handle;
+		}
+
+		void ReleaseVoice(VoiceHandle handle)
+		{
+			VoiceState* state = GetVoiceState(handle);
+			if (state != nullptr)
+			{
+				UnbindSource(handle, *state);
+
+				AudioCommand command = CreateVoiceCommand(AudioCommandType::StopVoice, handle, *state);
+				PushCommand(command);
+
+				FreeVoiceSlot(handle, *state);
+			}
+		}
+
+		void PlaySound(SourceHandle source, f32 volume, VoicePriority priority, AudioBus bus, u64 deviceFrame)
+		{
+			SourceData* sourceData = GetSourceData(source);
+			if (sourceData == nullptr || sourceData->SampleProvider->IsStreamingOnly())
+			{
+				return;
+			}
+
+			VoiceHandle handle = TakeFreeVoice(priority);
+			if (handle == VoiceHandle::Invalid)
+			{
+				droppedSounds++;
+				return;
+			}
+
+			VoiceState& state = voiceStates[static_cast<size_t>(handle)];
+			state.Allocated = true;
+			state.DeallocateOnEnd = true;
+			state.Priority = priority;
+			state.Bus = (bus < AudioBus::Count) ? bus : AudioBus::SFX;
+			LinkSound(handle, state);
+			state.Source = source;
+			state.Looped = false;
+			state.FramePosition = 0;
+			state.Volume = volume;
+			state.PlaybackRate = 1.0f;
+			state.Playing = true;
+
+			AudioCommand command = CreateVoiceCommand(AudioCommandType::StartVoice, handle, state);
+			command.SampleProvider = sourceData->SampleProvider;
+			command.LoopStart = sourceData->LoopStart;
+			command.Volume = volume;
+			command.Bus = state.Bus;
+			command.Playing = true;
+			command.DeallocateOnEnd = true;
+			command.DeviceFrame = deviceFrame;
+			state.PlaybackSerial = command.Serial;
+			state.PositionSerial = command.Serial;
+			state.LastPlaybackTime = {};
+			PushCommand(command);
+		}
+
+		// NOTE: A streaming source can only be played by one voice at a time, binding it to a new voice stops the old one
+		void BindSource(VoiceHandle handle, VoiceState& state, SourceHandle source)
+		{
+			UnbindSource(handle, state);
+			state.Source = source;
+
+			SourceData* sourceData = GetSourceData(source);
+			if (sourceData == nullptr || !sourceData->SampleProvider->IsStreamingOnly())
+			{
+				return;
+			}
+
+			if (sourceData->BoundVoice != VoiceHandle::Invalid && sourceData->BoundVoice != handle)
+			{
+				VoiceHandle oldHandle = sourceData->BoundVoice;
+				VoiceState* oldState = GetVoiceState(oldHandle);
+
+				if (oldState != nullptr)
+				{
+					AudioCommand command = CreateVoiceCommand(AudioCommandType::SetSource, oldHandle, *oldState);
+					command.SampleProvider = nullptr;
+					oldState->PlaybackSerial = command.Serial;
+					oldState->PositionSerial = command.Serial;
+					oldState->LastPlaybackTime = {};
+					oldState->Playing = false;
+					oldState->FramePosition = 0;
+					oldState->Source = SourceHandle::Invalid;
+					PushCommand(command);
+				}
+			}
+
+			sourceData->BoundVoice = handle;
+		}
+
+		void UnbindSource(VoiceHandle handle, VoiceState& state)
+		{
+			SourceData* sourceData = GetSourceData(state.Source);
+			if (sourceData != nullptr && sourceData->BoundVoice == handle)
+			{
+				sourceData->BoundVoice = VoiceHandle::Invalid;
+			}
+
+			state.Source = SourceHandle::Invalid;
+		}
+
+		void SetVoicePlaying(VoiceHandle handle, VoiceState& state, bool play, u64 deviceFrame)
+		{
+			// NOTE: Carry over the position reported by the audio thread, so that it stays valid until the command is applied
+			state.FramePosition = GetVoiceFramePosition(handle, state);
+			state.Playing = play;
+
+			AudioCommand command = CreateVoiceCommand(AudioCommandType::SetPlaying, handle, state);
+			command.Playing = play;
+			command.DeviceFrame = deviceFrame;
+			state.PlaybackSerial = command.Serial;
+			PushCommand(command);
+		}
+
+		void ScheduleVoiceStop(VoiceHandle handle, VoiceState& state, u64 deviceFrame, u32 fadeFrames)
+		{
+			AudioCommand command = CreateVoiceCommand(AudioCommandType::ScheduleStop, handle, state);
+			command.DeviceFrame = deviceFrame;
+			command.FadeFrames = fadeFrames;
+			state.PlaybackSerial = command.Serial;
+			PushCommand(command);
+		}
+
+		void SetVoiceSource(VoiceHandle handle, VoiceState& state, SourceHandle source)
+		{
+			BindSource(handle, state, source);
+
+			SourceData* sourceData = GetSourceData(source);
+
+			AudioCommand command = CreateVoiceCommand(AudioCommandType::SetSource, handle, state);
+			command.SampleProvider = (sourceData != nullptr) ? sourceData->SampleProvider : nullptr;
+			command.LoopStart = (sourceData != nullptr) ? sourceData->LoopStart : 0;
+			PushCommand(command);
+		}
+
+		const Mixing::FilterBankSet* GetFilterBankSet(Mixing::ResamplerQuality quality)
+		{
+			auto& filterBankSet = filterBankSets[static_cast<size_t>(quality)];
+			if (filterBankSet == nullptr)
+			{
+				filterBankSet = std::make_unique<Mixing::FilterBankSet>(quality);
+			}
+			return filterBankSet.get();
+		}
+
+		void SetBusGain(AudioBus bus)
+		{
+			const BusState& state = busStates[static_cast<size_t>(bus)];
+
+			AudioCommand command{};
+			command.Type = AudioCommandType::SetBusGain;
+			command.Bus = bus;
+			command.Volume = state.Muted ? 0.0f : state.Volume;
+			PushCommand(command);
+		}
+
+		void SetResamplerQuality(Mixing::ResamplerQuality quality)
+		{
+			if (quality >= Mixing::ResamplerQuality::Count || quality == resamplerQuality)
+			{
+				return;
+			}
+
+			resamplerQuality = quality;
+
+			AudioCommand command{};
+			command.Type = AudioCommandType::SetResamplerQuality;
+			command.FilterBanks = GetFilterBankSet(quality);
+			PushCommand(command);
+		}
+
+		u32 GetSampleBufferSize() const
+		{
+			return static_cast<u32>(sdlSpec.samples) * DefaultChannelCount;
+		}
+
+		bool SetSampleBufferSize(u32 sampleBufferSize)
+		{
+			u32 validSize = MinSampleBufferSize;
+			while (validSize < sampleBufferSize && validSize < MaxSampleBufferSize)
+			{
+				validSize *= 2;
+			}
+
+			const u16 bufferFrames = static_cast<u16>(validSize / DefaultChannelCount);
+			const u16 previousBufferFrames = sdlSpec.samples;
+			if (bufferFrames == previousBufferFrames)
+			{
+				return true;
+			}
+
+			if (outputMode == AudioOutputMode::Null)
+			{
+				return OpenDevice(bufferFrames);
+			}
+
+			// NOTE: Closing waits for a running callback and the callback never runs while the device is closed,
+			//		 so the audio thread state can be touched from here until the device has been reopened
+			SDL_CloseAudioDevice(sdlDevID);
+			sdlDevID = 0;
+			lastCallbackStartTicks = 0;
+
+			const bool opened = OpenDevice(bufferFrames);
+			if (!opened && !OpenDevice(previousBufferFrames))
+			{
+				LogError(LogName, "Failed to reopen the audio device with its previous buffer size, there is no audio output until it is changed again");
+				return false;
+			}
+
+			SDL_PauseAudioDevice(sdlDevID, 0);
+			return opened;
+		}
+
+		void StartBufferCalibration(const BufferCalibrationSettings& settings)
+		{
+			if (calibrationStatus.State == BufferCalibrationState::Running)
+			{
+				return;
+			}
+
+			calibrationSettings = settings;
+			calibrationStatus = BufferCalibrationStatus {};
+			calibrationPreviousSize = GetSampleBufferSize();
+
+			if (outputMode != AudioOutputMode::Device)
+			{
+				LogError(LogName, "The buffer size can only be calibrated when using an audio device");
+				calibrationStatus.State = BufferCalibrationState::Failed;
+				calibrationStatus.SampleBufferSize = calibrationPreviousSize;
+				return;
+			}
+
+			LogInfo(LogName, "Calibrating the buffer size (%.1f s per size)", (calibrationSettings.SettleDuration + calibrationSettings.MeasureDuration).GetSeconds());
+
+			calibrationStatus.State = BufferCalibrationState::Running;
+			BeginBufferCalibrationStep(MinSampleBufferSize);
+		}
+
+		void BeginBufferCalibrationStep(u32 sampleBufferSize)
+		{
+			for (; sampleBufferSize <= MaxSampleBufferSize; sampleBufferSize *= 2)
+			{
+				if (SetSampleBufferSize(sampleBufferSize))
+				{
+					calibrationStatus.SampleBufferSize = sampleBufferSize;
+					calibrationStepStartTicks = SDL_GetPerformanceCounter();
+					calibrationSettling = true;
+					return;
+				}
+
+				// NOTE: Sizes the device can't be opened with are skipped and count as unstable
+				BufferCalibrationStep step{};
+				step.SampleBufferSize = sampleBufferSize;
+				calibrationStatus.Steps.push_back(step);
+			}
+
+			FinishBufferCalibration(BufferCalibrationState::Failed);
+		}
+
+		void UpdateBufferCalibration()
+		{
+			if (calibrationStatus.State != BufferCalibrationState::Running)
+			{
+				return;
+			}
+
+			const u64 nowTicks = SDL_GetPerformanceCounter();
+			const TimeSpan elapsed = TicksToTimeSpan(static_cast<f64>(nowTicks - calibrationStepStartTicks));
+
+			if (calibrationSettling)
+			{
+				if (elapsed >= calibrationSettings.SettleDuration)
+				{
+					mixerStatsResetRequested.store(true, std::memory_order_release);
+					calibrationStepStartTicks = nowTicks;
+					calibrationSettling = false;
+				}
+
+				return;
+			}
+
+			if (elapsed < calibrationSettings.MeasureDuration)
+			{
+				return;
+			}
+
+			const AudioEngineStats stats = GetStats();
+			const f64 bufferPeriod = static_cast<f64>(sdlSpec.samples) / static_cast<f64>(sdlSpec.freq);
+
+			BufferCalibrationStep step{};
+			step.SampleBufferSize = calibrationStatus.SampleBufferSize;
+			step.Callbacks = stats.CallbackCount;
+			step.Underruns = stats.Underruns;
+			step.DeadlineMisses = stats.DeadlineMisses;
+			step.MaxCallbackJitter = stats.MaxCallbackJitter;
+			step.MaxCallbackDuration = stats.MaxCallbackDuration;
+			step.Stable = (stats.CallbackCount > 0 && stats.Underruns == 0 && stats.DeadlineMisses == 0 &&
+				stats.MaxCallbackJitter.GetSeconds() <= bufferPeriod * static_cast<f64>(calibrationSettings.MaxJitter));
+			calibrationStatus.Steps.push_back(step);
+
+			LogInfo(LogName, "Buffer size %u: %llu callbacks, %llu underruns, %llu deadline misses, max jitter %.2f ms (%s)",
+				step.SampleBufferSize, step.Callbacks, step.Underruns, step.DeadlineMisses, step.MaxCallbackJitter.GetMilliseconds(), step.Stable ? "stable" : "unstable");
+
+			if (step.Stable)
+			{
+				FinishBufferCalibration(BufferCalibrationState::Succeeded);
+			}
+			else
+			{
+				BeginBufferCalibrationStep(step.SampleBufferSize * 2);
+			}
+		}
+
+		void FinishBufferCalibration(BufferCalibrationState state)
+		{
+			if (state != BufferCalibrationState::Succeeded)
+			{
+				SetSampleBufferSize(calibrationPreviousSize);
+			}
+
+			calibrationStatus.State = state;
+			calibrationStatus.SampleBufferSize = GetSampleBufferSize();
+
+			LogInfo(LogName, "Buffer size calibration %s, using %u samples per buffer",
+				(state == BufferCalibrationState::Succeeded) ? "succeeded" : "failed", calibrationStatus.SampleBufferSize);
+		}
+
+		SourceHandle RegisterSource(ISampleProvider* sampleProvider)
+		{
+			if (sampleProvider == nullptr)
+				return SourceHandle::Invalid;
+
+			size_t index = 0;
+			if (!freeSourceSlots.empty())
+			{
+				index = freeSourceSlots.back();
+				freeSourceSlots.pop_back();
+			}
+			else if (registeredSources.size() < MaxRegisteredSources)
+			{
+				index = registeredSources.size();
+				registeredSources.emplace_back();
+			}
+			else
+			{
+				LogError(LogName, "Failed to register audio source, all %llu source slots are in use", MaxRegisteredSources);
+				return SourceHandle::Invalid;
+			}
+
+			SourceData& source = registeredSources[index];
+			source.SampleProvider = sampleProvider;
+			source.ReferenceCount = 1;
+			source.LastUsed = ++sourceUseCounter;
+
+			LogInfo(LogName, "Audio source with %llu samples has been registered (handle: %u)", sampleProvider->GetSampleAmount(), index);
+			return MakeSourceHandle(index, source.Generation);
+		}
+
+		SourceHandle LoadSource(const void* encodedData, size_t encodedDataSize)
+		{
+			if (encodedData != nullptr && encodedDataSize > 0)
+			{
+				ISampleProvider* sampleProvider = ConvertToSourceStorage(DecoderFactory::GetInstance()->DecodeFileData("", encodedData, encodedDataSize));
+				if (sampleProvider == nullptr)
+				{
+					return SourceHandle::Invalid;
+				}
+
+				return RegisterDecodedSource(sampleProvider);
+			}
+
+			return SourceHandle::Invalid;
+		}
+
+		SourceHandle RegisterDecodedSource(ISampleProvider* sampleProvider)
+		{
+			SourceHandle handle = RegisterSource(sampleProvider);
+			if (handle == SourceHandle::Invalid)
+			{
+				DeleteSampleProvider(sampleProvider);
+				return SourceHandle::Invalid;
+			}
+
+			SourceData* sourceData = GetSourceData(handle);
+			sourceData->LoopStart = sampleProvider->GetLoopStart_Frames();
+			sourceData->LoopEnd = sampleProvider->GetLoopEnd_Frames();
+
+			return handle;
+		}
+
+		static void DeleteSampleProvider(ISampleProvider* sampleProvider)
+		{
+			if (sampleProvider != nullptr)
+			{
+				sampleProvider->Destroy();
+				delete sampleProvider;
+			}
+		}
+
+		// NOTE: Takes ownership of a freshly decoded source and returns it in the current storage format. Only reads game thread state, so workers may call it during a load
+		ISampleProvider* ConvertToSourceStorage(ISampleProvider* sampleProvider) const
+		{
+			if (sampleProvider == nullptr || sampleProvider->IsStreamingOnly() || sourceStorage != SourceStorage::ADPCM)
+			{
+				return sampleProvider;
+			}
+
+			ISampleProvider* compressedProvider = new AdpcmSampleProvider(*sampleProvider);
+			if (compressedProvider->GetSampleAmount() == 0)
+			{
+				// NOTE: Only mono and stereo sources can be compressed, everything else stays as it is
+				DeleteSampleProvider(compressedProvider);
+				return sampleProvider;
+			}
+
+			DeleteSampleProvider(sampleProvider);
+			return compressedProvider;
+		}
+
+		SourceHandle FindCachedSource(const std::string& cacheKey) const
+		{
+			auto it = sourceCacheKeys.find(cacheKey);
+			return (it != sourceCacheKeys.end()) ? it->second : SourceHandle::Invalid;
+		}
+
+		// NOTE: Only reads the cache, so worker threads may call this while the game thread waits for them
+		SourceHandle FindCachedSourceByContent(u64 contentHash) const
+		{
+			auto it = sourceCacheHashes.find(contentHash);
+			return (it != sourceCacheHashes.end()) ? it->second : SourceHandle::Invalid;
+		}
+
+		// NOTE: Adds a reference to a cached source and makes it reachable through 'cacheKey', which may be a different path with the same contents
+		SourceHandle AcquireCachedSource(SourceHandle handle, const std::string& cacheKey)
+		{
+			SourceData* sourceData = GetSourceData(handle);
+			if (sourceData == nullptr)
+			{
+				return SourceHandle::Invalid;
+			}
+
+			if (sourceCacheKeys.emplace(cacheKey, handle).second)
+			{
+				sourceData->CacheKeys.push_back(cacheKey);
+			}
+
+			sourceData->ReferenceCount++;
+			sourceData->LastUsed = ++sourceUseCounter;
+			sourceCacheHits++;
+
+			return handle;
+		}
+
+		SourceHandle RegisterCachedSource(const std::string& cacheKey, u64 contentHash, ISampleProvider* sampleProvider)
+		{
+			SourceHandle handle = RegisterDecodedSource(sampleProvider);
+			if (handle == SourceHandle::Invalid)
+			{
+				return SourceHandle::Invalid;
+			}
+
+			SourceData* sourceData = GetSourceData(handle);
+			sourceData->CacheKeys.push_back(cacheKey);
+			sourceData->ContentHash = contentHash;
+			sourceData->MemorySize = sampleProvider->GetMemorySize();
+
+			sourceCacheKeys[cacheKey] = handle;
+			sourceCacheHashes[contentHash] = handle;
+			cachedSourceMemory += sourceData->MemorySize;
+			sourceCacheMisses++;
+
+			// NOTE: The new source is referenced, so this can only make room by evicting older ones
+			EnforceSourceCacheBudget(sourceCacheBudget);
+			return handle;
+		}
+
+		// NOTE: Evicts unreferenced cached sources, least recently used first, until the cache fits into 'budget'
+		void EnforceSourceCacheBudget(size_t budget)
+		{
+			while (cachedSourceMemory > budget)
+			{
+				size_t evictIndex = registeredSources.size();
+				for (size_t i = 0; i < registeredSources.size(); i++)
+				{
+					const SourceData& source = registeredSources[i];
+					if (source.SampleProvider == nullptr || source.CacheKeys.empty() || source.ReferenceCount > 0)
+					{
+						continue;
+					}
+
+					if (evictIndex == registeredSources.size() || source.LastUsed < registeredSources[evictIndex].LastUsed)
+					{
+						evictIndex = i;
+					}
+				}
+
+				if (evictIndex == registeredSources.size())
+				{
+					break;
+				}
+
+				SourceData& source = registeredSources[evictIndex];
+				LogInfo(LogName, "Evicting cached audio source \"%s\" (%llu bytes)", source.CacheKeys.front().c_str(), source.MemorySize);
+
+				ReleaseSource(MakeSourceHandle(evictIndex, source.Generation), source);
+				sourceCacheEvictions++;
+			}
+		}
+
+		ThreadPool& GetLoadingPool()
+		{
+			if (loadingPool == nullptr)
+			{
+				loadingPool = std::make_unique<ThreadPool>();
+			}
+
+			return *loadingPool;
+		}
+
+		f64 GetElapsedMilliseconds(u64 startTicks) const
+		{
+			return static_cast<f64>(SDL_GetPerformanceCounter() - startTicks) * 1000.0 / performanceFrequency;
+		}
+
+		SourceHandle LoadSource(std::string_view filePath)
+		{
+			const std::string cacheKey = std::string(filePath);
+
+			SourceHandle handle = FindCachedSource(cacheKey);
+			if (handle != SourceHandle::Invalid)
+			{
+				return AcquireCachedSource(handle, cacheKey);
+			}
+
+			std::unique_ptr<u8[]> fileData = nullptr;
+			size_t fileSize = IO::File::ReadAllBytes(filePath, fileData);
+
+			if (fileData == nullptr || fileSize == 0)
+			{
+				return SourceHandle::Invalid;
+			}
+
+			const u64 contentHash = Hashing::FNV1a64(fileData.get(), fileSize);
+			handle = FindCachedSourceByContent(contentHash);
+			if (handle != SourceHandle::Invalid)
+			{
+				return AcquireCachedSource(handle, cacheKey);
+			}
+
+			ISampleProvider* sampleProvider = ConvertToSourceStorage(DecoderFactory::GetInstance()->DecodeFileData(filePath, fileData.get(), fileSize));
+			if (sampleProvider == nullptr)
+			{
+				return SourceHandle::Invalid;
+			}
+
+			return RegisterCachedSource(cacheKey, contentHash, sampleProvider);
+		}
+
+		// NOTE: Registers the result of a batch load. Sources that have been cached in the meantime (e.g. a path that appears twice in the batch) are reused
+		SourceHandle RegisterBatchSource(const std::string& cacheKey, bool hasContentHash, u64 contentHash, ISampleProvider* sampleProvider)
+		{
+			SourceHandle handle = FindCachedSource(cacheKey);
+			if (handle == SourceHandle::Invalid && hasContentHash)
+			{
+				handle = FindCachedSourceByContent(contentHash);
+			}
+
+			if (handle != SourceHandle::Invalid)
+			{
+				DeleteSampleProvider(sampleProvider);
+				return AcquireCachedSource(handle, cacheKey);
+			}
+
+			return (sampleProvider != nullptr) ? RegisterCachedSource(cacheKey, contentHash, sampleProvider) : SourceHandle::Invalid;
+		}
+
+		void LoadSources(const std::string_view* filePaths, size_t count, SourceHandle* outHandles)
+		{
+			ThreadPool& pool = GetLoadingPool();
+			const u64 startTicks = SDL_GetPerformanceCounter();
+
+			std::vector<std::string> cacheKeys(count);
+			std::vector<bool> isCached(count, false);
+			for (size_t i = 0; i < count; i++)
+			{
+				cacheKeys[i] = std::string(filePaths[i]);
+				isCached[i] = (FindCachedSource(cacheKeys[i]) != SourceHandle::Invalid);
+			}
+
+			// NOTE: Workers only read, hash and decode. Registering touches game thread state, so it happens afterwards in one go
+			std::vector<ISampleProvider*> sampleProviders(count, nullptr);
+			std::vector<u64> contentHashes(count, 0);
+			std::vector<u8> hasContentHash(count, false);
+
+			pool.ParallelFor(count, [&](size_t i)
+			{
+				if (isCached[i])
+					return;
+
+				std::unique_ptr<u8[]> fileData = nullptr;
+				size_t fileSize = IO::File::ReadAllBytes(filePaths[i], fileData);
+
+				if (fileData == nullptr || fileSize == 0)
+					return;
+
+				contentHashes[i] = Hashing::FNV1a64(fileData.get(), fileSize);
+				hasContentHash[i] = true;
+
+				if (FindCachedSourceByContent(contentHashes[i]) == SourceHandle::Invalid)
+					sampleProviders[i] = ConvertToSourceStorage(DecoderFactory::GetInstance()->DecodeFileData(filePaths[i], fileData.get(), fileSize));
+			});
+
+			size_t cachedCount = 0;
+			for (size_t i = 0; i < count; i++)
+			{
+				const u64 previousMisses = sourceCacheMisses;
+				outHandles[i] = RegisterBatchSource(cacheKeys[i], hasContentHash[i], contentHashes[i], sampleProviders[i]);
+
+				if (outHandles[i] == SourceHandle::Invalid)
+				{
+					LogError(LogName, "Failed to load file \"%s\"", filePaths[i].data());
+				}
+				else if (sourceCacheMisses == previousMisses)
+				{
+					cachedCount++;
+				}
+			}
+
+			LogInfo(LogName, "Loaded %llu sources (%llu from the cache) in %.2f ms using %llu threads", count, cachedCount, GetElapsedMilliseconds(startTicks), pool.GetWorkerCount() + 1);
+		}
+
+		void LoadSoundBank(std::string_view filePath, const std::string_view* entryNames, size_t count, SourceHandle* outHandles)
+		{
+			std::fill(outHandles, outHandles + count, SourceHandle::Invalid);
+			const u64 startTicks = SDL_GetPerformanceCounter();
+
+			// NOTE: Entries are cached as "<bank path>/<entry name>", the bank isn't even opened if every requested entry is cached already
+			std::vector<std::string> cacheKeys(count);
+			size_t cachedCount = 0;
+
+			for (size_t i = 0; i < count; i++)
+			{
+				cacheKeys[i] = std::string(filePath).append("/").append(entryNames[i]);
+
+				SourceHandle handle = FindCachedSource(cacheKeys[i]);
+				if (handle != SourceHandle::Invalid)
+				{
+					outHandles[i] = AcquireCachedSource(handle, cacheKeys[i]);
+					cachedCount++;
+				}
+			}
+
+			if (cachedCount == count)
+			{
+				LogInfo(LogName, "Loaded %llu sources from sound bank \"%s\" from the cache", count, filePath.data());
+				return;
+			}
+
+			// NOTE: The bank only has to stay around until every requested entry has been copied or decoded
+			IO::MemoryMappedFile mappedFile{};
+			std::unique_ptr<u8[]> fileData = nullptr;
+
+			const u8* bankData = nullptr;
+			size_t bankSize = 0;
+
+			if (mappedFile.OpenRead(filePath))
+			{
+				bankData = mappedFile.GetData();
+				bankSize = mappedFile.GetSize();
+			}
+			else
+			{
+				bankSize = IO::File::ReadAllBytes(filePath, fileData);
+				bankData = fileData.get();
+			}
+
+			std::vector<SoundBankEntry> entries;
+			if (!ParseSoundBank(bankData, bankSize, entries))
+			{
+				LogError(LogName, "Failed to load sound bank \"%s\"", filePath.data());
+				return;
+			}
+
+			std::vector<const SoundBankEntry*> requestedEntries(count, nullptr);
+			for (size_t i = 0; i < count; i++)
+			{
+				if (outHandles[i] != SourceHandle::Invalid)
+				{
+					continue;
+				}
 
-		SourceData* GetSourceData(SourceHandle handle)
-		{
-			if (handle != SourceHandle::Invalid && static_cast<size_t>(handle) < registeredSources.size())
-			{
-				SourceData* data = &registeredSources[static_cast<size_t>(handle)];
-				if (data->SampleProvider != nullptr)
+				requestedEntries[i] = FindSoundBankEntry(entries, entryNames[i]);
+				if (requestedEntries[i] == nullptr)
 				{
-					return data;
+					LogError(LogName, "Sound bank \"%s\" has no entry \"%s\"", filePath.data(), entryNames[i].data());
 				}
 			}
-			return nullptr;
-		}
 
-		VoiceHandle AllocateVoice(SourceHandle source)
-		{
-			if (source == SourceHandle::Invalid)
+			ThreadPool& pool = GetLoadingPool();
+			std::vector<ISampleProvider*> sampleProviders(count, nullptr);
+			std::vector<u64> contentHashes(count, 0);
+
+			pool.ParallelFor(count, [&](size_t i)
 			{
-				return VoiceHandle::Invalid;
-			}
+				if (requestedEntries[i] == nullptr)
+					return;
 
-			SourceData* sourceData = GetSourceData(source);
+				contentHashes[i] = HashSoundBankEntry(*requestedEntries[i]);
+				if (FindCachedSourceByContent(contentHashes[i]) == SourceHandle::Invalid)
+					sampleProviders[i] = ConvertToSourceStorage(CreateSoundBankSampleProvider(*requestedEntries[i]));
+			});
 
-			for (size_t i = 0; i < MaxSimultaneousVoices; i++)
+			size_t loadedCount = cachedCount;
+			for (size_t i = 0; i < count; i++)
 			{
-				VoiceContext& voiceCtx = voiceContexts.at(i);
-
-				if (voiceCtx.Allocated)
+				if (requestedEntries[i] == nullptr)
 				{
 					continue;
 				}
 
-				voiceCtx.Allocated = true;
-				voiceCtx.Source = source;
-				voiceCtx.FramePosition = 0;
-
-				if (sourceData->SampleProvider->IsStreamingOnly())
+				outHandles[i] = RegisterBatchSource(cacheKeys[i], true, contentHashes[i], sampleProviders[i]);
+				if (outHandles[i] == SourceHandle::Invalid)
 				{
-					sourceData->BoundVoice = static_cast<VoiceHandle>(i);
+					LogError(LogName, "Failed to decode sound bank entry \"%s\"", entryNames[i].data());
+					continue;
 				}
 
-				return static_cast<VoiceHandle>(i);
+				loadedCount++;
 			}
 
-			return VoiceHandle::Invalid;
+			LogInfo(LogName, "Loaded %llu of %llu sources from sound bank \"%s\" in %.2f ms", loadedCount, count, filePath.data(), GetElapsedMilliseconds(startTicks));
 		}
 
-		void ReleaseVoice(VoiceHandle handle)
+		// NOTE: The format and loop points are stored outside of the entry data, two entries with the same samples may still play differently
+		static u64 HashSoundBankEntry(const SoundBankEntry& entry)
+		{
+			const std::array<u64, 5> entryInfo { static_cast<u64>(entry.Encoding), entry.ChannelCount, entry.SampleRate, entry.LoopStart, entry.LoopEnd };
+
+			const u64 dataHash = Hashing::FNV1a64(entry.Data, entry.DataSize);
+			return Hashing::FNV1a64(entryInfo.data(), entryInfo.size() * sizeof(u64), dataHash);
+		}
+
+		static ISampleProvider* CreateSoundBankSampleProvider(const SoundBankEntry& entry)
 		{
-			if (handle != VoiceHandle::Invalid)
+			MemorySampleProvider* sampleProvider = nullptr;
+
+			if (entry.Encoding == SoundBankEncoding::Encoded)
 			{
-				VoiceContext* voiceCtx = GetVoiceContext(handle);
-				if (voiceCtx != nullptr)
+				// NOTE: Every decoder produces a MemorySampleProvider
+				sampleProvider = static_cast<MemorySampleProvider*>(DecoderFactory::GetInstance()->DecodeFileData(entry.Name, entry.Data, entry.DataSize));
+				if (sampleProvider == nullptr)
 				{
-					voiceCtx->Allocated = false;
-					voiceCtx->Source = SourceHandle::Invalid;
-
-					voiceCtx->FramePosition = 0;
-					voiceCtx->Playing = false;
-					voiceCtx->Looped = false;
+					return nullptr;
 				}
 			}
+			else
+			{
+				const size_t sampleCount = entry.DataSize / sizeof(i16);
+				if (sampleCount == 0)
+				{
+					return nullptr;
+				}
+
+				sampleProvider = new MemorySampleProvider(reinterpret_cast<const i16*>(entry.Data), sampleCount);
+				sampleProvider->channels = entry.ChannelCount;
+				sampleProvider->sampleRate = entry.SampleRate;
+				sampleProvider->loopStart_frames = 0;
+				sampleProvider->loopEnd_frames = sampleCount / entry.ChannelCount;
+			}
+
+			if (entry.LoopEnd > entry.LoopStart)
+			{
+				sampleProvider->loopStart_frames = entry.LoopStart;
+				sampleProvider->loopEnd_frames = entry.LoopEnd;
+			}
+
+			return sampleProvider;
 		}
 
-		SourceHandle RegisterSource(ISampleProvider* sampleProvider)
+		static bool IsWavFile(const u8* fileData, size_t fileSize)
 		{
-			if (sampleProvider == nullptr)
-				return SourceHandle::Invalid;
+			return fileSize >= 12 && SDL_memcmp(&fileData[0], "RIFF", 4) == 0 && SDL_memcmp(&fileData[8], "WAVE", 4) == 0;
+		}
 
-			for (size_t i = 0; i < registeredSources.size(); i++)
+		StreamingSettings GetEffectiveStreamingSettings(StreamingSettings settings) const
+		{
+			// NOTE: Offline rendering runs faster than real time, decoding has to happen in step with the mixer to stay deterministic
+			if (outputMode == AudioOutputMode::Null)
 			{
-				SourceData& source = registeredSources.at(i);
+				settings.DecodeOnWorkerThread = false;
+			}
+			return settings;
+		}
 
-				if (source.SampleProvider != nullptr)
-					continue;
+		template <typename SampleProviderType>
+		SourceHandle RegisterStreamingSource(SampleProviderType* sampleProvider)
+		{
+			if (!sampleProvider->IsOpen())
+			{
+				delete sampleProvider;
+				return SourceHandle::Invalid;
+			}
 
-				source.SampleProvider = sampleProvider;
-				LogInfo(LogName, "Audio source with %llu samples has been registered (handle: %u)", sampleProvider->GetSampleAmount(), i);
+			SourceHandle handle = RegisterSource(sampleProvider);
 
-				return static_cast<SourceHandle>(i);
-			}
+			SourceData* sourceData = GetSourceData(handle);
+			sourceData->LoopStart = sampleProvider->GetLoopStart_Frames();
+			sourceData->LoopEnd = sampleProvider->GetLoopEnd_Frames();
 
-			registeredSources.push_back(SourceData{ sampleProvider, 0, 0 });
-			LogInfo(LogName, "Audio source with %llu samples has been registered (handle: %u)", sampleProvider->GetSampleAmount(), registeredSources.size() - 1);
-			return static_cast<SourceHandle>(registeredSources.size() - 1);
+			return handle;
 		}
 
-		void BindStreamingSourceToANewVoice(SourceHandle source, VoiceHandle newVoice)
+		SourceHandle LoadStreamingSource(std::string_view filePath, const StreamingSettings& settings)
 		{
-			if (source != SourceHandle::Invalid && newVoice != VoiceHandle::Invalid)
+			// NOTE: The decoder reads the file in place, only the decoder state and the decoded sample buffer stay resident.
+			//		 Falls back to a buffered file stream if the file can't be mapped
+			if (settings.MemoryMapFile)
 			{
-				SourceData* sourceData = GetSourceData(source);
-				if (sourceData != nullptr)
+				IO::MemoryMappedFile mappedFile{};
+				if (mappedFile.OpenRead(filePath))
 				{
-					if (sourceData->SampleProvider->IsStreamingOnly() && sourceData->BoundVoice != VoiceHandle::Invalid)
+					// NOTE: PCM WAV files need no decoding at all, the samples are copied straight out of the mapping
+					if (IsWavFile(mappedFile.GetData(), mappedFile.GetSize()))
 					{
-						VoiceContext* oldVoice = GetVoiceContext(sourceData->BoundVoice);
-						oldVoice->Playing = false;
-						oldVoice->FramePosition = 0;
-						oldVoice->Source = SourceHandle::Invalid;
-
-						sourceData->BoundVoice = newVoice;
+						return RegisterStreamingSource(new WavStreamingSampleProvider(std::move(mappedFile)));
 					}
+
+					return RegisterStreamingSource(new StreamingSampleProvider(std::move(mappedFile), GetEffectiveStreamingSettings(settings)));
 				}
 			}
-		}
 
-		SourceHandle LoadSource(const void* encodedData, size_t encodedDataSize)
-		{
-			if (encodedData != nullptr && encodedDataSize > 0)
+			// NOTE: The WAV provider only plays from a mapping, otherwise the whole file is loaded into memory like a regular source
+			if (IO::Path::GetExtension(filePath) == ".wav")
 			{
-				ISampleProvider* sampleProvider = DecoderFactory::GetInstance()->DecodeFileData("", encodedData, encodedDataSize);
-				if (sampleProvider == nullptr)
-				{
-					return SourceHandle::Invalid;
-				}
+				LogWarn(LogName, "Can't stream \"%s\" without a memory mapping, loading it into memory instead", filePath.data());
 
-				SourceHandle handle = RegisterSource(sampleProvider);
+				std::unique_ptr<u8[]> fileData = nullptr;
+				size_t fileSize = IO::File::ReadAllBytes(filePath, fileData);
 
-				SourceData* sourceData = GetSourceData(handle);
-				sourceData->LoopStart = sampleProvider->GetLoopStart_Frames();
-				sourceData->LoopEnd = sampleProvider->GetLoopEnd_Frames();
+				return (fileData != nullptr) ? LoadSource(fileData.get(), fileSize) : SourceHandle::Invalid;
+			}
 
-				return handle;
+			auto fileStream = std::make_unique<IO::FileStream>(IO::File::OpenRead(filePath));
+			if (!fileStream->IsOpen())
+			{
+				return SourceHandle::Invalid;
 			}
 
-			return SourceHandle::Invalid;
+			return RegisterStreamingSource(new StreamingSampleProvider(std::move(fileStream), GetEffectiveStreamingSettings(settings)));
 		}
 
-		SourceHandle LoadStreamingSource(const void* encodedData, size_t encodedDataSize)
+		void UnloadSource(SourceHandle handle)
 		{
-			if (encodedData != nullptr && encodedDataSize > 0)
+			SourceData* sourceData = GetSourceData(handle);
+			if (sourceData == nullptr)
 			{
-				StreamingSampleProvider* sampleProvider = new StreamingSampleProvider(reinterpret_cast<const u8*>(encodedData), encodedDataSize);
-				if (sampleProvider == nullptr)
-					return SourceHandle::Invalid;
-
-				SourceHandle handle = RegisterSource(sampleProvider);
+				return;
+			}
 
-				SourceData* sourceData = GetSourceData(handle);
-				sourceData->LoopStart = sampleProvider->GetLoopStart_Frames();
-				sourceData->LoopEnd = sampleProvider->GetLoopEnd_Frames();
+			if (sourceData->CacheKeys.empty())
+			{
+				ReleaseSource(handle, *sourceData);
+				return;
+			}
 
-				return handle;
+			// NOTE: Unloading a source that is no longer referenced does nothing, it stays cached until it's evicted
+			if (sourceData->ReferenceCount > 0)
+			{
+				sourceData->ReferenceCount--;
+				sourceData->LastUsed = ++sourceUseCounter;
 			}
 
-			return SourceHandle::Invalid;
+			if (sourceData->ReferenceCount == 0)
+			{
+				EnforceSourceCacheBudget(sourceCacheBudget);
+			}
 		}
 
-		void UnloadSource(SourceHandle handle)
+		void ReleaseSource(SourceHandle handle, SourceData& sourceData)
 		{
-			if (handle != SourceHandle::Invalid && static_cast<size_t>(handle) < registeredSources.size())
+			for (size_t i = 0; i < voiceStates.size(); i++)
 			{
-				SourceData& source = registeredSources.at(static_cast<size_t>(handle));
-				if (source.SampleProvider != nullptr)
+				if (voiceStates[i].Source == handle)
 				{
-					delete source.SampleProvider;
-					source.SampleProvider = nullptr;
-
-					for (size_t i = 0; i < voiceContexts.size(); i++)
-					{
-						VoiceContext* voiceCtx = &voiceContexts[i];
-						if (voiceCtx->Source == handle)
-							voiceCtx->Source = SourceHandle::Invalid;
-					}
+					voiceStates[i].Source = SourceHandle::Invalid;
 				}
 			}
+
+			// NOTE: The sample provider is deleted once the audio thread confirms that no voice uses it anymore
+			AudioCommand command{};
+			command.Type = AudioCommandType::ReleaseSource;
+			command.SampleProvider = sourceData.SampleProvider;
+			PushCommand(command);
+
+			for (const std::string& cacheKey : sourceData.CacheKeys)
+			{
+				sourceCacheKeys.erase(cacheKey);
+			}
+
+			if (!sourceData.CacheKeys.empty())
+			{
+				sourceCacheHashes.erase(sourceData.ContentHash);
+				cachedSourceMemory -= sourceData.MemorySize;
+			}
+
+			const u16 generation = static_cast<u16>(sourceData.Generation + 1);
+			sourceData = SourceData {};
+			sourceData.Generation = generation;
+			freeSourceSlots.push_back(static_cast<u16>(GetSourceIndex(handle)));
+
+			ProcessMixerEvents();
 		}
 	};
 
@@ -430,12 +2485,12 @@ namespace Starshine::Audio
 	{
 	}
 
-	void AudioEngine::CreateInstance()
+	void AudioEngine::CreateInstance(AudioOutputMode mode)
 	{
 		if (Instance == nullptr)
 		{
 			Instance = std::make_unique<AudioEngine>();
-			Instance->Initialize();
+			Instance->Initialize(mode);
 		}
 	}
 
@@ -453,9 +2508,9 @@ namespace Starshine::Audio
 		return Instance.get();
 	}
 
-	bool AudioEngine::Initialize()
+	bool AudioEngine::Initialize(AudioOutputMode mode)
 	{
-		return impl->Initialize();
+		return impl->Initialize(mode);
 	}
 
 	void AudioEngine::Destroy()
@@ -463,11 +2518,41 @@ namespace Starshine::Audio
 		impl->Destroy();
 	}
 
+	void AudioEngine::Update()
+	{
+		impl->Update();
+	}
+
 	void AudioEngine::QueueAudioCallback(f32* stream, size_t length)
 	{
 		impl->QueueAudio(stream, length);
 	}
 
+	AudioOutputMode AudioEngine::GetOutputMode() const
+	{
+		return impl->outputMode;
+	}
+
+	bool AudioEngine::RenderFrames(f32* stream, size_t frameCount)
+	{
+		if (impl->outputMode != AudioOutputMode::Null)
+		{
+			LogError(LogName, "Frames can only be rendered manually when using the null device");
+			return false;
+		}
+
+		while (frameCount > 0)
+		{
+			size_t chunkFrames = std::min(frameCount, static_cast<size_t>(impl->sdlSpec.samples));
+			impl->QueueAudio(stream, chunkFrames * DefaultChannelCount);
+
+			stream += chunkFrames * DefaultChannelCount;
+			frameCount -= chunkFrames;
+		}
+
+		return true;
+	}
+
 	SourceHandle AudioEngine::RegisterSource(ISampleProvider* sampleProvider)
 	{
 		return impl->RegisterSource(sampleProvider);
@@ -480,49 +2565,36 @@ namespace Starshine::Audio
 
 	SourceHandle AudioEngine::LoadSource(std::string_view filePath)
 	{
-		std::unique_ptr<u8[]> fileData = nullptr;
-		size_t fileSize = IO::File::ReadAllBytes(filePath, fileData);
+		SourceHandle handle = impl->LoadSource(filePath);
 
-		if (fileData != nullptr && fileSize > 0)
+		if (handle == SourceHandle::Invalid)
 		{
-			SourceHandle handle = LoadSource(fileData.get(), fileSize);
-			fileData = nullptr;
-
-			if (handle != SourceHandle::Invalid)
-			{
-				return handle;
-			}
-			else
-			{
-				LogError(LogName, "Failed to load file \"%s\"", filePath.data());
-				return SourceHandle::Invalid;
-			}
+			LogError(LogName, "Failed to load file \"%s\"", filePath.data());
 		}
 
-		return SourceHandle::Invalid;
+		return handle;
+	}
+
+	void AudioEngine::LoadSources(const std::string_view* filePaths, size_t count, SourceHandle* outHandles)
+	{
+		impl->LoadSources(filePaths, count, outHandles);
 	}
 
-	SourceHandle AudioEngine::LoadStreamingSource(std::string_view filePath)
+	void AudioEngine::LoadSoundBank(std::string_view filePath, const std::string_view* entryNames, size_t count, SourceHandle* outHandles)
 	{
-		std::unique_ptr<u8[]> fileData = nullptr;
-		size_t fileSize = IO::File::ReadAllBytes(filePath, fileData);
+		impl->LoadSoundBank(filePath, entryNames, count, outHandles);
+	}
 
-		if (fileData != nullptr && fileSize > 0)
-		{
-			SourceHandle handle = impl->LoadStreamingSource(fileData.get(), fileSize);
+	SourceHandle AudioEngine::LoadStreamingSource(std::string_view filePath, const StreamingSettings& settings)
+	{
+		SourceHandle handle = impl->LoadStreamingSource(filePath, settings);
 
-			if (handle != SourceHandle::Invalid)
-			{
-				return handle;
-			}
-			else
-			{
-				LogError(LogName, "Failed to load file \"%s\" for streaming", filePath.data());
-				return SourceHandle::Invalid;
-			}
+		if (handle == SourceHandle::Invalid)
+		{
+			LogError(LogName, "Failed to load file \"%s\" for streaming", filePath.data());
 		}
 
-		return SourceHandle::Invalid;
+		return handle;
 	}
 
 	void AudioEngine::UnloadSource(SourceHandle handle)
@@ -530,6 +2602,35 @@ namespace Starshine::Audio
 		impl->UnloadSource(handle);
 	}
 
+	size_t AudioEngine::GetSourceCacheBudget() const
+	{
+		return impl->sourceCacheBudget;
+	}
+
+	void AudioEngine::SetSourceCacheBudget(size_t budget)
+	{
+		impl->sourceCacheBudget = budget;
+		impl->EnforceSourceCacheBudget(budget);
+	}
+
+	void AudioEngine::PurgeSourceCache()
+	{
+		impl->EnforceSourceCacheBudget(0);
+	}
+
+	SourceStorage AudioEngine::GetSourceStorage() const
+	{
+		return impl->sourceStorage;
+	}
+
+	void AudioEngine::SetSourceStorage(SourceStorage storage)
+	{
+		if (storage < SourceStorage::Count)
+		{
+			impl->sourceStorage = storage;
+		}
+	}
+
 	VoiceHandle AudioEngine::AllocateVoice(SourceHandle source)
 	{
 		return impl->AllocateVoice(source);
@@ -540,130 +2641,330 @@ namespace Starshine::Audio
 		impl->ReleaseVoice(handle);
 	}
 
-	void AudioEngine::PlaySound(SourceHandle source, f32 volume)
+	void AudioEngine::PlaySound(SourceHandle source, f32 volume, VoicePriority priority, AudioBus bus)
+	{
+		impl->PlaySound(source, volume, priority, bus, 0);
+	}
+
+	void AudioEngine::PlaySoundAt(u64 deviceFrame, SourceHandle source, f32 volume, VoicePriority priority, AudioBus bus)
+	{
+		impl->PlaySound(source, volume, priority, bus, deviceFrame);
+	}
+
+	TimeSpan AudioEngine::GetDeviceTime() const
+	{
+		return impl->GetDeviceTime();
+	}
+
+	u64 AudioEngine::GetDeviceFrame() const
+	{
+		return static_cast<u64>(impl->GetDeviceFramePosition());
+	}
+
+	u64 AudioEngine::GetDeviceFrame(TimeSpan deviceTime) const
+	{
+		return static_cast<u64>(std::max(deviceTime.GetSeconds(), 0.0) * static_cast<f64>(impl->sdlSpec.freq) + 0.5);
+	}
+
+	TimeSpan AudioEngine::GetOutputLatency() const
+	{
+		return impl->outputLatency;
+	}
+
+	void AudioEngine::SetOutputLatency(TimeSpan latency)
+	{
+		impl->outputLatency = (latency.Microseconds < 0) ? TimeSpan{ 0 } : latency;
+	}
+
+	f32 AudioEngine::GetBusVolume(AudioBus bus) const
+	{
+		return (bus < AudioBus::Count) ? impl->busStates[static_cast<size_t>(bus)].Volume : 0.0f;
+	}
+
+	void AudioEngine::SetBusVolume(AudioBus bus, f32 volume)
+	{
+		if (bus < AudioBus::Count)
+		{
+			impl->busStates[static_cast<size_t>(bus)].Volume = std::max(volume, 0.0f);
+			impl->SetBusGain(bus);
+		}
+	}
+
+	bool AudioEngine::IsBusMuted(AudioBus bus) const
 	{
-		if (source == SourceHandle::Invalid)
+		return (bus < AudioBus::Count) ? impl->busStates[static_cast<size_t>(bus)].Muted : false;
+	}
+
+	void AudioEngine::SetBusMuted(AudioBus bus, bool muted)
+	{
+		if (bus < AudioBus::Count)
 		{
-			return;
+			impl->busStates[static_cast<size_t>(bus)].Muted = muted;
+			impl->SetBusGain(bus);
 		}
+	}
 
-		for (auto& voiceCtx : impl->voiceContexts)
+	AudioBusMeter AudioEngine::GetBusMeter(AudioBus bus) const
+	{
+		AudioBusMeter result{};
+		if (bus < AudioBus::Count)
 		{
-			if (voiceCtx.Allocated)
+			const BusMeterSnapshot& meter = impl->busMeters[static_cast<size_t>(bus)];
+			for (size_t channel = 0; channel < result.Peak.size(); channel++)
 			{
-				continue;
+				result.Peak[channel] = meter.Peak[channel].load(std::memory_order_relaxed);
+				result.RMS[channel] = meter.RMS[channel].load(std::memory_order_relaxed);
 			}
+		}
+		return result;
+	}
+
+	u32 AudioEngine::GetSampleBufferSize() const
+	{
+		return impl->GetSampleBufferSize();
+	}
+
+	bool AudioEngine::SetSampleBufferSize(u32 sampleBufferSize)
+	{
+		return impl->SetSampleBufferSize(sampleBufferSize);
+	}
+
+	void AudioEngine::StartBufferCalibration(const BufferCalibrationSettings& settings)
+	{
+		impl->StartBufferCalibration(settings);
+	}
 
-			voiceCtx.Allocated = true;
-			voiceCtx.DeallocateOnEnd = true;
-			voiceCtx.Source = source;
-			voiceCtx.Looped = false;
-			voiceCtx.FramePosition = 0;
-			voiceCtx.Volume = volume;
-			voiceCtx.Playing = true;
-			return;
+	void AudioEngine::UpdateBufferCalibration()
+	{
+		impl->UpdateBufferCalibration();
+	}
+
+	void AudioEngine::CancelBufferCalibration()
+	{
+		if (impl->calibrationStatus.State == BufferCalibrationState::Running)
+		{
+			impl->FinishBufferCalibration(BufferCalibrationState::Failed);
 		}
 	}
 
+	BufferCalibrationStatus AudioEngine::GetBufferCalibrationStatus() const
+	{
+		return impl->calibrationStatus;
+	}
+
+	Mixing::ResamplerQuality AudioEngine::GetResamplerQuality() const
+	{
+		return impl->resamplerQuality;
+	}
+
+	void AudioEngine::SetResamplerQuality(Mixing::ResamplerQuality quality)
+	{
+		impl->SetResamplerQuality(quality);
+	}
+
+	AudioEngineStats AudioEngine::GetStats() const
+	{
+		return impl->GetStats();
+	}
+
+	void AudioEngine::ResetStats()
+	{
+		impl->droppedSounds = 0;
+		impl->deferredCommands = 0;
+		impl->sourceCacheHits = 0;
+		impl->sourceCacheMisses = 0;
+		impl->sourceCacheEvictions = 0;
+		impl->mixerStatsResetRequested.store(true, std::memory_order_release);
+	}
+
 	bool Voice::IsValid() const
 	{
 		auto& impl = Instance->impl;
-		return (impl->GetVoiceContext(Handle) != nullptr);
+		return (impl->GetVoiceState(Handle) != nullptr);
 	}
 
 	bool Voice::IsPlaying() const
 	{
 		auto& impl = Instance->impl;
-		if (auto ctx = impl->GetVoiceContext(Handle); ctx != nullptr)
+		if (auto state = impl->GetVoiceState(Handle); state != nullptr)
 		{
-			return ctx->Playing;
+			return impl->IsVoicePlaying(Handle, *state);
 		}
+		return false;
 	}
 
 	void Voice::SetPlaying(bool play)
 	{
 		auto& impl = Instance->impl;
-		if (auto ctx = impl->GetVoiceContext(Handle); ctx != nullptr)
+		if (auto state = impl->GetVoiceState(Handle); state != nullptr)
 		{
-			ctx->Playing = play;
+			impl->SetVoicePlaying(Handle, *state, play, 0);
+		}
+	}
+
+	void Voice::PlayAt(u64 deviceFrame)
+	{
+		auto& impl = Instance->impl;
+		if (auto state = impl->GetVoiceState(Handle); state != nullptr)
+		{
+			impl->SetVoicePlaying(Handle, *state, true, deviceFrame);
+		}
+	}
+
+	void Voice::StopAt(u64 deviceFrame, u32 fadeFrames)
+	{
+		auto& impl = Instance->impl;
+		if (auto state = impl->GetVoiceState(Handle); state != nullptr)
+		{
+			impl->ScheduleVoiceStop(Handle, *state, deviceFrame, fadeFrames);
 		}
 	}
 
 	bool Voice::IsLooped() const
 	{
 		auto& impl = Instance->impl;
-		if (auto ctx = impl->GetVoiceContext(Handle); ctx != nullptr)
+		if (auto state = impl->GetVoiceState(Handle); state != nullptr)
 		{
-			return ctx->Looped;
+			return state->Looped;
 		}
+		return false;
 	}
 
 	void Voice::SetLoopState(bool loop)
 	{
 		auto& impl = Instance->impl;
-		if (auto ctx = impl->GetVoiceContext(Handle); ctx != nullptr)
+		if (auto state = impl->GetVoiceState(Handle); state != nullptr)
 		{
-			ctx->Looped = loop;
+			state->Looped = loop;
+
+			AudioCommand command = impl->CreateVoiceCommand(AudioCommandType::SetLoopState, Handle, *state);
+			command.Looped = loop;
+			impl->PushCommand(command);
 		}
 	}
 
 	SourceHandle Voice::GetSource() const
 	{
 		auto& impl = Instance->impl;
-		if (auto ctx = impl->GetVoiceContext(Handle); ctx != nullptr)
+		if (auto state = impl->GetVoiceState(Handle); state != nullptr)
 		{
-			return ctx->Source;
+			return state->Source;
 		}
+		return SourceHandle::Invalid;
 	}
 
 	void Voice::SetSource(SourceHandle handle)
 	{
 		auto& impl = Instance->impl;
-		if (auto ctx = impl->GetVoiceContext(Handle); ctx != nullptr)
+		if (auto state = impl->GetVoiceState(Handle); state != nullptr)
 		{
-			ctx->Source = handle;
-			impl->BindStreamingSourceToANewVoice(handle, this->Handle);
+			impl->SetVoiceSource(Handle, *state, handle);
 		}
 	}
 
 	size_t Voice::GetFramePosition() const
 	{
 		auto& impl = Instance->impl;
-		if (auto ctx = impl->GetVoiceContext(Handle); ctx != nullptr)
+		if (auto state = impl->GetVoiceState(Handle); state != nullptr)
 		{
-			return ctx->FramePosition;
+			return impl->GetVoiceFramePosition(Handle, *state);
 		}
+		return 0;
 	}
 
 	void Voice::SetFramePosition(size_t position)
 	{
 		auto& impl = Instance->impl;
-		if (auto ctx = impl->GetVoiceContext(Handle); ctx != nullptr)
+		if (auto state = impl->GetVoiceState(Handle); state != nullptr)
 		{
-			ctx->FramePosition = position;
+			state->Playing = impl->IsVoicePlaying(Handle, *state);
+			state->FramePosition = position;
+
+			AudioCommand command = impl->CreateVoiceCommand(AudioCommandType::SetFramePosition, Handle, *state);
+			command.FramePosition = position;
+			state->PlaybackSerial = command.Serial;
+			state->PositionSerial = command.Serial;
+			state->LastPlaybackTime = {};
+			impl->PushCommand(command);
+		}
+	}
 
-			if (impl->GetSourceData(ctx->Source)->SampleProvider->IsStreamingOnly())
-			{
-				impl->GetSourceData(ctx->Source)->SampleProvider->Seek(position);
-			}
+	TimeSpan Voice::GetPlaybackTime() const
+	{
+		auto& impl = Instance->impl;
+		if (auto state = impl->GetVoiceState(Handle); state != nullptr)
+		{
+			return impl->GetVoicePlaybackTime(Handle, *state);
 		}
+		return TimeSpan{ 0 };
 	}
 
 	f32 Voice::GetVolume() const
 	{
 		auto& impl = Instance->impl;
-		if (auto ctx = impl->GetVoiceContext(Handle); ctx != nullptr)
+		if (auto state = impl->GetVoiceState(Handle); state != nullptr)
 		{
-			return ctx->Volume;
+			return state->Volume;
 		}
+		return 0.0f;
 	}
 
 	void Voice::SetVolume(f32 volume)
 	{
 		auto& impl = Instance->impl;
-		if (auto ctx = impl->GetVoiceContext(Handle); ctx != nullptr)
+		if (auto state = impl->GetVoiceState(Handle); state != nullptr)
+		{
+			state->Volume = volume;
+
+			AudioCommand command = impl->CreateVoiceCommand(AudioCommandType::SetVolume, Handle, *state);
+			command.Volume = volume;
+			impl->PushCommand(command);
+		}
+	}
+
+	f32 Voice::GetPlaybackRate() const
+	{
+		auto& impl = Instance->impl;
+		if (auto state = impl->GetVoiceState(Handle); state != nullptr)
+		{
+			return state->PlaybackRate;
+		}
+		return 1.0f;
+	}
+
+	void Voice::SetPlaybackRate(f32 rate)
+	{
+		auto& impl = Instance->impl;
+		if (auto state = impl->GetVoiceState(Handle); state != nullptr)
+		{
+			state->PlaybackRate = std::clamp(rate, AudioEngine::MinPlaybackRate, AudioEngine::MaxPlaybackRate);
+
+			AudioCommand command = impl->CreateVoiceCommand(AudioCommandType::SetPlaybackRate, Handle, *state);
+			command.PlaybackRate = state->PlaybackRate;
+			impl->PushCommand(command);
+		}
+	}
+
+	AudioBus Voice::GetBus() const
+	{
+		auto& impl = Instance->impl;
+		if (auto state = impl->GetVoiceState(Handle); state != nullptr)
+		{
+			return state->Bus;
+		}
+		return AudioBus::SFX;
+	}
+
+	void Voice::SetBus(AudioBus bus)
+	{
+		auto& impl = Instance->impl;
+		if (auto state = impl->GetVoiceState(Handle); state != nullptr && bus < AudioBus::Count)
 		{
-			ctx->Volume = volume;
+			state->Bus = bus;
+
+			AudioCommand command = impl->CreateVoiceCommand(AudioCommandType::SetBus, Handle, *state);
+			command.Bus = bus;
+			impl->PushCommand(command);
 		}
 	}
 }
@@ -1,7 +1,12 @@
 #pragma once
 #include "Common/Types.h"
+#include "TimeSpan.h"
 #include "SampleProvider/ISampleProvider.h"
+#include "SampleProvider/StreamingSampleProvider.h"
+#include "Mixing/Resampler.h"
+#include <array>
 #include <memory>
+#include <vector>
 
 namespace Starshine::Audio
 {
@@ -9,8 +14,203 @@ namespace Starshine::Audio
 	// NOTE: Frame: A set of samples spanning across each channel
 	// NOTE: Mixing Sample: 32-bit floating point representation of a 16-bit PCM sample
 
+	// NOTE: Everything except QueueAudioCallback() must be called from the game thread.
+	//		 Voice changes are sent to the audio thread through a command queue and take effect at the start of the next buffer.
+
+	enum class AudioOutputMode : u8
+	{
+		// NOTE: Opens an SDL audio device, which calls QueueAudioCallback() from its own thread
+		Device,
+		// NOTE: No audio device, the owner mixes audio by calling RenderFrames() (e.g. for offline rendering or on machines without sound hardware)
+		Null,
+
+		Count
+	};
+
+	constexpr EnumStringMappingTable<AudioOutputMode> AudioOutputModeStringTable
+	{
+		EnumStringMapping<AudioOutputMode>
+		{ AudioOutputMode::Device, "Device" },
+		{ AudioOutputMode::Null, "Null" }
+	};
+
+	// NOTE: Decides which voice is cut off when all voices are in use
+	enum class VoicePriority : u8
+	{
+		Low,
+		Normal,
+		High,
+		// NOTE: Never stolen. Used by every voice from AllocateVoice(), since the game holds on to their handles (e.g. music and hold loops)
+		Protected,
+
+		Count
+	};
+
+	constexpr EnumStringMappingTable<VoicePriority> VoicePriorityStringTable
+	{
+		EnumStringMapping<VoicePriority>
+		{ VoicePriority::Low, "Low" },
+		{ VoicePriority::Normal, "Normal" },
+		{ VoicePriority::High, "High" },
+		{ VoicePriority::Protected, "Protected" }
+	};
+
+	// NOTE: Voices are mixed into a bus, every bus except the master is mixed into the master bus.
+	//		 Each bus has its own volume and mute state, so whole groups of sounds can be adjusted without touching their voices
+	enum class AudioBus : u8
+	{
+		Master,
+		Music,
+		SFX,
+		UI,
+
+		Count
+	};
+
+	constexpr EnumStringMappingTable<AudioBus> AudioBusStringTable
+	{
+		EnumStringMapping<AudioBus>
+		{ AudioBus::Master, "Master" },
+		{ AudioBus::Music, "Music" },
+		{ AudioBus::SFX, "SFX" },
+		{ AudioBus::UI, "UI" }
+	};
+
+	// NOTE: How decoded (non-streaming) sources are kept in memory
+	enum class SourceStorage : u8
+	{
+		// NOTE: Raw 16-bit PCM
+		PCM16,
+		// NOTE: IMA-ADPCM blocks that are decoded while mixing. About a quarter of the memory, at the cost of some noise on quiet sounds
+		ADPCM,
+
+		Count
+	};
+
+	constexpr EnumStringMappingTable<SourceStorage> SourceStorageStringTable
+	{
+		EnumStringMapping<SourceStorage>
+		{ SourceStorage::PCM16, "PCM16" },
+		{ SourceStorage::ADPCM, "ADPCM" }
+	};
+
+	// NOTE: Levels of the last mixed buffer after the bus volume has been applied, as linear amplitudes per channel
+	struct AudioBusMeter
+	{
+		std::array<f32, 2> Peak{};
+		std::array<f32, 2> RMS{};
+	};
+
+	// NOTE: Mixer statistics since the engine has been initialized or reset.
+	//		 The counters are updated without locks, so the values of a single query may belong to neighbouring buffers
+	struct AudioEngineStats
+	{
+		static constexpr size_t CallbackHistogramBucketCount = 10;
+
+		u64 CallbackCount{};
+		TimeSpan MinCallbackDuration{};
+		TimeSpan AverageCallbackDuration{};
+		TimeSpan MaxCallbackDuration{};
+		TimeSpan LastCallbackDuration{};
+
+		// NOTE: Callback durations relative to the buffer period, bucket i counts the callbacks that took [i; i + 1) tenths of it.
+		//		 The last bucket also counts every callback that missed its deadline
+		std::array<u64, CallbackHistogramBucketCount> CallbackHistogram{};
+
+		// NOTE: Playback length of the last buffer, which is the deadline of the callback that mixes the next one
+		TimeSpan BufferPeriod{};
+		// NOTE: Smallest difference between the buffer period and a callback's duration, negative once a deadline has been missed
+		TimeSpan MinDeadlineMargin{};
+		u64 DeadlineMisses{};
+
+		// NOTE: Device output only. Callbacks that started more than one and a half buffer periods after the previous one,
+		//		 in which case the device has most likely played silence in between
+		u64 Underruns{};
+
+		// NOTE: Device output only. Largest difference between the time between two callbacks and the buffer period
+		TimeSpan MaxCallbackJitter{};
+
+		// NOTE: Of the last buffer, except for the peak
+		u32 ActiveVoices{};
+		u32 PlayingVoices{};
+		u32 PeakPlayingVoices{};
+
+		u32 StreamingVoices{};
+		// NOTE: Lowest decode buffer fill level [0; 1] among the streaming voices of the last buffer
+		f32 MinStreamingBufferFill{ 1.0f };
+		// NOTE: Reads of a streaming voice that returned fewer frames than requested before the end of its source (including the pre-roll after seeking)
+		u64 StreamingStarvations{};
+
+		// NOTE: Game thread. PlaySound() calls that found no voice to steal and commands that had to wait for room in the command queue
+		u64 DroppedSounds{};
+		u64 DeferredCommands{};
+
+		// NOTE: Game thread. Sources loaded by path, including the ones that are no longer referenced but haven't been evicted yet
+		u32 CachedSources{};
+		u32 UnreferencedCachedSources{};
+		size_t CachedSourceMemory{};
+
+		u64 SourceCacheHits{};
+		u64 SourceCacheMisses{};
+		u64 SourceCacheEvictions{};
+	};
+
+	struct BufferCalibrationSettings
+	{
+		// NOTE: Callbacks right after the device has been reopened are ignored, drivers often take a moment to settle
+		TimeSpan SettleDuration{ TimeSpanConversion::FromSeconds(0.5) };
+		TimeSpan MeasureDuration{ TimeSpanConversion::FromSeconds(3.0) };
+
+		// NOTE: Largest callback jitter, as a fraction of the buffer period, that still counts as stable
+		f32 MaxJitter{ 0.5f };
+	};
+
+	enum class BufferCalibrationState : u8
+	{
+		Idle,
+		Running,
+		// NOTE: The smallest stable buffer size has been applied
+		Succeeded,
+		// NOTE: No buffer size was stable (or the calibration was cancelled), the previous size has been restored
+		Failed,
+
+		Count
+	};
+
+	constexpr EnumStringMappingTable<BufferCalibrationState> BufferCalibrationStateStringTable
+	{
+		EnumStringMapping<BufferCalibrationState>
+		{ BufferCalibrationState::Idle, "Idle" },
+		{ BufferCalibrationState::Running, "Running" },
+		{ BufferCalibrationState::Succeeded, "Succeeded" },
+		{ BufferCalibrationState::Failed, "Failed" }
+	};
+
+	struct BufferCalibrationStep
+	{
+		u32 SampleBufferSize{};
+		u64 Callbacks{};
+		u64 Underruns{};
+		u64 DeadlineMisses{};
+		TimeSpan MaxCallbackJitter{};
+		TimeSpan MaxCallbackDuration{};
+		bool Stable{};
+	};
+
+	struct BufferCalibrationStatus
+	{
+		BufferCalibrationState State{};
+		// NOTE: The size that is being measured while running, the chosen one once finished
+		u32 SampleBufferSize{};
+		// NOTE: Every size that has been measured so far, smallest first
+		std::vector<BufferCalibrationStep> Steps;
+	};
+
 	enum class VoiceHandle : u16 { Invalid = 0xFFFF };
-	enum class SourceHandle : u16 { Invalid = 0xFFFF };
+
+	// NOTE: Slot index in the lower 16 bits and the slot's generation in the upper 16 bits,
+	//		 so a handle to an unloaded source never refers to a different source that later reuses the slot
+	enum class SourceHandle : u32 { Invalid = 0xFFFFFFFF };
 
 	class Voice
 	{
@@ -28,6 +228,14 @@ namespace Starshine::Audio
 		bool IsPlaying() const;
 		void SetPlaying(bool play);
 
+		// NOTE: Starts playing exactly at a device frame (see AudioEngine::GetDeviceFrame()). IsPlaying() is true from the call on.
+		//		 Frames that have already been mixed start the voice at the beginning of the next buffer
+		void PlayAt(u64 deviceFrame);
+
+		// NOTE: Fades out linearly over 'fadeFrames' device frames starting at 'deviceFrame' and pauses once the fade has ended.
+		//		 Without a fade the voice stops right at 'deviceFrame'. Sounds played through PlaySound() are freed like at their end
+		void StopAt(u64 deviceFrame, u32 fadeFrames = 0);
+
 		bool IsLooped() const;
 		void SetLoopState(bool loop);
 
@@ -37,8 +245,20 @@ namespace Starshine::Audio
 		size_t GetFramePosition() const;
 		void SetFramePosition(size_t position);
 
+		// NOTE: Position of the audio that is currently audible, interpolated between buffers and compensated for the output latency.
+		//		 Unlike GetFramePosition() it advances smoothly and never goes backwards unless the position is changed.
+		TimeSpan GetPlaybackTime() const;
+
 		f32 GetVolume() const;
 		void SetVolume(f32 volume);
+
+		// NOTE: Speed multiplier, changes tempo and pitch together (e.g. for a practice mode). Clamped to [MinPlaybackRate; MaxPlaybackRate]
+		f32 GetPlaybackRate() const;
+		void SetPlaybackRate(f32 rate);
+
+		// NOTE: Voices start on the SFX bus
+		AudioBus GetBus() const;
+		void SetBus(AudioBus bus);
 	};
 
 	class AudioEngine : NonCopyable
@@ -53,41 +273,157 @@ namespace Starshine::Audio
 		static constexpr u8 DefaultChannelCount = 2;
 		static constexpr i32 DefaultSampleRate = 44100;
 		static constexpr u16 DefaultSampleBufferSize = 2048;
+		static constexpr u16 MinSampleBufferSize = 128;
+		static constexpr u16 MaxSampleBufferSize = 8192;
 
 		static constexpr size_t MaxSimultaneousVoices = 128;
 
+		static constexpr f32 MinPlaybackRate = 0.25f;
+		static constexpr f32 MaxPlaybackRate = 2.0f;
+
+		static constexpr size_t BusGainRampFrames = 512;
+
+		static constexpr size_t DefaultSourceCacheBudget = 64 * 1024 * 1024;
+
 	public:
-		static void CreateInstance();
+		static void CreateInstance(AudioOutputMode mode = AudioOutputMode::Device);
 		static void DestroyInstance();
 
 		static AudioEngine* GetInstance();
 
 	public:
-		bool Initialize();
+		bool Initialize(AudioOutputMode mode = AudioOutputMode::Device);
 		void Destroy();
 
+		// NOTE: Called once per frame by the GameInstance. Frees the sources and voices the audio thread is done with,
+		//		 pushes the commands that didn't fit into the command queue and advances the buffer calibration
+		void Update();
+
+		AudioOutputMode GetOutputMode() const;
+
 	public:
 		// NOTE: This function makes a local copy of the "samples" array that is stored in the source context
 		SourceHandle RegisterSource(ISampleProvider* sampleProvider);
 		SourceHandle LoadSource(const void* encodedData, size_t encodedDataSize);
+
+		// NOTE: Sources loaded by path (including sound bank entries) are cached and reference counted.
+		//		 Loading a path again, or a file with the same contents as a cached one, returns the cached source and adds a reference.
+		//		 Every load has to be paired with an UnloadSource() call
 		SourceHandle LoadSource(std::string_view filePath);
 
-		SourceHandle LoadStreamingSource(std::string_view filePath);
+		// NOTE: Reads and decodes the files in parallel on worker threads, then registers all of them together on the calling thread.
+		//		 Cached files are neither read nor decoded again.
+		//		 'outHandles' receives one handle per path, SourceHandle::Invalid for files that failed to load
+		void LoadSources(const std::string_view* filePaths, size_t count, SourceHandle* outHandles);
+
+		template <size_t Count>
+		std::array<SourceHandle, Count> LoadSources(const std::array<std::string_view, Count>& filePaths)
+		{
+			std::array<SourceHandle, Count> handles{};
+			LoadSources(filePaths.data(), Count, handles.data());
+			return handles;
+		}
+
+		// NOTE: Reads a sound bank with a single mapping (or read) and registers the requested entries together, decoding compressed entries in parallel.
+		//		 'outHandles' receives one handle per entry name, SourceHandle::Invalid for names that aren't part of the bank
+		void LoadSoundBank(std::string_view filePath, const std::string_view* entryNames, size_t count, SourceHandle* outHandles);
 
+		template <size_t Count>
+		std::array<SourceHandle, Count> LoadSoundBank(std::string_view filePath, const std::array<std::string_view, Count>& entryNames)
+		{
+			std::array<SourceHandle, Count> handles{};
+			LoadSoundBank(filePath, entryNames.data(), Count, handles.data());
+			return handles;
+		}
+
+		// NOTE: Streaming sources are never cached, every call opens a new one
+		SourceHandle LoadStreamingSource(std::string_view filePath, const StreamingSettings& settings = {});
+
+		// NOTE: Cached sources are released once their last reference is gone, but stay resident and can be loaded again at no cost
+		//		 until the cache exceeds its budget. Other sources are released immediately
 		void UnloadSource(SourceHandle handle);
 
+		// NOTE: Memory that cached sources may occupy before the least recently used unreferenced ones are evicted.
+		//		 Referenced sources are never evicted, a budget of 0 releases every source as soon as it's no longer referenced
+		size_t GetSourceCacheBudget() const;
+		void SetSourceCacheBudget(size_t budget);
+
+		// NOTE: Evicts every cached source that is no longer referenced
+		void PurgeSourceCache();
+
+		// NOTE: Applies to sources that are decoded from now on by any of the loading functions, sources that are already loaded (or cached) keep their format.
+		//		 Sources registered through RegisterSource() are always kept as they are
+		SourceStorage GetSourceStorage() const;
+		void SetSourceStorage(SourceStorage storage);
+
+		// NOTE: Allocated voices are never stolen, but may steal a sound played through PlaySound() if all voices are in use
 		VoiceHandle AllocateVoice(SourceHandle source);
 		void FreeVoice(VoiceHandle handle);
 
 		/* NOTE: Add a voice, assign a provided source to it, play itand discard it when done 
 		(Sounds with set looping positions will not loop when played through this function) */
-		void PlaySound(SourceHandle source, f32 volume);
+		// NOTE: If all voices are in use, the quietest (then oldest) sound of the lowest priority that is not above 'priority' is stopped to make room
+		void PlaySound(SourceHandle source, f32 volume, VoicePriority priority = VoicePriority::Normal, AudioBus bus = AudioBus::SFX);
+
+		// NOTE: Same as PlaySound(), but the sound starts exactly at 'deviceFrame' instead of the beginning of the next buffer
+		void PlaySoundAt(u64 deviceFrame, SourceHandle source, f32 volume, VoicePriority priority = VoicePriority::Normal, AudioBus bus = AudioBus::SFX);
+
+	public:
+		// NOTE: Volume changes are ramped over 'BusGainRampFrames' device frames to avoid clicks. Muting keeps the volume
+		f32 GetBusVolume(AudioBus bus) const;
+		void SetBusVolume(AudioBus bus, f32 volume);
+
+		bool IsBusMuted(AudioBus bus) const;
+		void SetBusMuted(AudioBus bus, bool muted);
+
+		AudioBusMeter GetBusMeter(AudioBus bus) const;
+
+	public:
+		// NOTE: Audible time of the output device since it has been opened, interpolated from the timestamp recorded with every callback
+		TimeSpan GetDeviceTime() const;
+
+		// NOTE: Device frame that is audible right now, the position of GetDeviceTime() in device frames.
+		//		 Playback scheduled at a frame is sample accurate as long as it's scheduled at least one buffer plus the output latency ahead
+		u64 GetDeviceFrame() const;
+		u64 GetDeviceFrame(TimeSpan deviceTime) const;
+
+		// NOTE: Time between the start of a callback and the moment its first frame is heard, defaults to the length of one buffer
+		TimeSpan GetOutputLatency() const;
+		void SetOutputLatency(TimeSpan latency);
+
+		// NOTE: Interleaved samples per callback (twice the frames), rounded up to a power of two within [MinSampleBufferSize; MaxSampleBufferSize].
+		//		 Changing it reopens the output device, which resets the output latency to the length of one buffer.
+		//		 Returns false if the device could not be opened with the new size, in which case the previous size is kept
+		u32 GetSampleBufferSize() const;
+		bool SetSampleBufferSize(u32 sampleBufferSize);
+
+		// NOTE: Device output only. Measures every buffer size from the smallest one up and keeps the first one without underruns, deadline misses
+		//		 or excessive callback jitter. Update() advances it once per frame, as does calling UpdateBufferCalibration() directly.
+		//		 The statistics are reset for every step, sounds keep playing but may crackle while small sizes are measured
+		void StartBufferCalibration(const BufferCalibrationSettings& settings = {});
+		void UpdateBufferCalibration();
+		void CancelBufferCalibration();
+		BufferCalibrationStatus GetBufferCalibrationStatus() const;
+
+		// NOTE: Filter used for voices whose source rate differs from the device rate or whose playback rate isn't 1.0
+		Mixing::ResamplerQuality GetResamplerQuality() const;
+		void SetResamplerQuality(Mixing::ResamplerQuality quality);
+
+	public:
+		AudioEngineStats GetStats() const;
+
+		// NOTE: The audio thread clears its counters at the start of the next buffer
+		void ResetStats();
 
 	public:
 		// NOTE: This function is meant to be used only as a callback for SDL's audio subsystem.
 		// 'length' is the amount of samples in the 'stream' array.
 		void QueueAudioCallback(f32* stream, size_t length);
 
+		// NOTE: Null device only. Mixes 'frameCount' interleaved stereo frames into 'stream' on the calling thread.
+		//		 Voice changes made before the call take effect at the first frame.
+		bool RenderFrames(f32* stream, size_t frameCount);
+
 	private:
 		struct Impl;
 		std::unique_ptr<Impl> impl{};
@@ -0,0 +1,94 @@
+#include "OggSeekIndex.h"
+#include <SDL2/SDL_endian.h>
+#include <SDL2/SDL_stdinc.h>
+#include <algorithm>
+#include <array>
+
+namespace Starshine::Audio
+{
+	namespace OggPage
+	{
+		// NOTE: https://www.xiph.org/ogg/doc/framing.html
+		static constexpr std::array<char, 4> CapturePattern = { 'O', 'g', 'g', 'S' };
+
+		static constexpr size_t HeaderSize = 27;
+		static constexpr size_t GranulePositionOffset = 6;
+		static constexpr size_t SerialNumberOffset = 14;
+		static constexpr size_t SegmentCountOffset = 26;
+
+	}
+
+	bool OggSeekIndex::Build(size_t dataSize, const std::function<size_t(size_t offset, void* dst, size_t size)>& readAt)
+	{
+		seekPoints.clear();
+
+		std::array<u8, OggPage::HeaderSize> header{};
+		std::array<u8, 255> segmentTable{};
+
+		size_t offset = 0;
+		u32 firstSerialNumber = 0;
+		i64 previousGranulePosition = 0;
+
+		while (offset + OggPage::HeaderSize <= dataSize)
+		{
+			if (readAt(offset, header.data(), header.size()) != header.size() || SDL_memcmp(header.data(), OggPage::CapturePattern.data(), OggPage::CapturePattern.size()) != 0)
+			{
+				break;
+			}
+
+			i64 granulePosition{};
+			u32 serialNumber{};
+			SDL_memcpy(&granulePosition, &header[OggPage::GranulePositionOffset], sizeof(granulePosition));
+			SDL_memcpy(&serialNumber, &header[OggPage::SerialNumberOffset], sizeof(serialNumber));
+			granulePosition = static_cast<i64>(SDL_SwapLE64(static_cast<u64>(granulePosition)));
+			serialNumber = SDL_SwapLE32(serialNumber);
+
+			const size_t segmentCount = header[OggPage::SegmentCountOffset];
+			if (readAt(offset + OggPage::HeaderSize, segmentTable.data(), segmentCount) != segmentCount)
+			{
+				break;
+			}
+
+			if (offset == 0)
+			{
+				firstSerialNumber = serialNumber;
+			}
+			else if (serialNumber != firstSerialNumber)
+			{
+				// NOTE: Chained streams restart their granule positions, libvorbisfile's own seeking handles those
+				seekPoints.clear();
+				return false;
+			}
+
+			// NOTE: Header pages have a granule position of 0 and pages that don't complete a packet one of -1, neither can be seeked to
+			if (granulePosition > 0)
+			{
+				seekPoints.push_back(SeekPoint { static_cast<u64>(previousGranulePosition), static_cast<u64>(offset) });
+				previousGranulePosition = granulePosition;
+			}
+
+			size_t bodySize = 0;
+			for (size_t i = 0; i < segmentCount; i++)
+			{
+				bodySize += segmentTable[i];
+			}
+
+			offset += OggPage::HeaderSize + segmentCount + bodySize;
+		}
+
+		seekPoints.shrink_to_fit();
+		return !seekPoints.empty();
+	}
+
+	void OggSeekIndex::Clear()
+	{
+		seekPoints.clear();
+		seekPoints.shrink_to_fit();
+	}
+
+	size_t OggSeekIndex::FindSeekPoint(u64 frame) const
+	{
+		auto it = std::upper_bound(seekPoints.begin(), seekPoints.end(), frame, [](u64 frame, const SeekPoint& point) { return frame < point.Frame; });
+		return (it == seekPoints.begin()) ? NoSeekPoint : static_cast<size_t>(std::distance(seekPoints.begin(), it) - 1);
+	}
+}
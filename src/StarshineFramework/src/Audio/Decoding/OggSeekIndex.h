@@ -0,0 +1,38 @@
+#pragma once
+#include "Common/Types.h"
+#include <functional>
+#include <vector>
+
+namespace Starshine::Audio
+{
+	// NOTE: Start frame and byte offset of every Ogg page that completes audio, built by scanning the page headers once.
+	//		 A seek can then jump straight to the page before the target instead of bisecting the compressed stream.
+	//		 Only single (unchained) logical streams are indexed.
+	class OggSeekIndex
+	{
+	public:
+		struct SeekPoint
+		{
+			// NOTE: Granule position of the previous audio page, the first frame that can be decoded after jumping to 'Offset'
+			u64 Frame{};
+			u64 Offset{};
+		};
+
+		static constexpr size_t NoSeekPoint = static_cast<size_t>(-1);
+
+	public:
+		// NOTE: 'readAt' reads up to 'size' bytes at 'offset' and returns the amount that has been read
+		bool Build(size_t dataSize, const std::function<size_t(size_t offset, void* dst, size_t size)>& readAt);
+		void Clear();
+
+		bool IsEmpty() const { return seekPoints.empty(); }
+		size_t GetSeekPointCount() const { return seekPoints.size(); }
+		const SeekPoint& GetSeekPoint(size_t index) const { return seekPoints[index]; }
+
+		// NOTE: Index of the last seek point at or before 'frame', NoSeekPoint if there is none
+		size_t FindSeekPoint(u64 frame) const;
+
+	private:
+		std::vector<SeekPoint> seekPoints;
+	};
+}
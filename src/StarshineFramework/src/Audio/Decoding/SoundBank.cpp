@@ -0,0 +1,111 @@
+#include "SoundBank.h"
+#include "Common/Logging/Logging.h"
+#include <SDL2/SDL_endian.h>
+#include <SDL2/SDL_stdinc.h>
+#include <array>
+
+namespace Starshine::Audio
+{
+	constexpr const char* LogName = "Starshine::Audio::SoundBank";
+
+	namespace FileFormatDetail
+	{
+		static constexpr u8 CurrentRevision = 0;
+		static constexpr std::array<char, 4> FileSignature = { 'S', 'S', 'B', CurrentRevision };
+
+		// NOTE: Signature, u32 entry count, u32 entry record size, u32 reserved
+		static constexpr size_t HeaderSize = 16;
+
+		// NOTE: char[32] null-terminated name, u8 encoding, u8 channel count, u16 reserved, u32 sample rate,
+		//		 u64 data offset (from the start of the file), u64 data size, u64 loop start, u64 loop end
+		static constexpr size_t MaxNameLength = 32;
+		static constexpr size_t EntryRecordSize = 72;
+	}
+
+	static u32 ReadU32(const u8* data)
+	{
+		u32 value{};
+		SDL_memcpy(&value, data, sizeof(value));
+		return SDL_SwapLE32(value);
+	}
+
+	static u64 ReadU64(const u8* data)
+	{
+		u64 value{};
+		SDL_memcpy(&value, data, sizeof(value));
+		return SDL_SwapLE64(value);
+	}
+
+	bool ParseSoundBank(const u8* fileData, size_t fileSize, std::vector<SoundBankEntry>& outEntries)
+	{
+		using namespace FileFormatDetail;
+
+		if (fileData == nullptr || fileSize < HeaderSize)
+			return false;
+
+		if (SDL_memcmp(fileData, FileSignature.data(), FileSignature.size()) != 0)
+		{
+			LogError(LogName, "Invalid sound bank signature");
+			return false;
+		}
+
+		const size_t entryCount = ReadU32(&fileData[4]);
+		const size_t recordSize = ReadU32(&fileData[8]);
+
+		// NOTE: Newer revisions may only append fields to the record
+		if (recordSize < EntryRecordSize || entryCount > (fileSize - HeaderSize) / recordSize)
+		{
+			LogError(LogName, "Sound bank entry table doesn't fit into the file");
+			return false;
+		}
+
+		outEntries.clear();
+		outEntries.reserve(entryCount);
+
+		for (size_t i = 0; i < entryCount; i++)
+		{
+			const u8* record = &fileData[HeaderSize + i * recordSize];
+			const std::string_view name = std::string_view(reinterpret_cast<const char*>(record), MaxNameLength);
+
+			SoundBankEntry& entry = outEntries.emplace_back();
+			entry.Name = name.substr(0, name.find('\0'));
+			entry.Encoding = static_cast<SoundBankEncoding>(record[32]);
+			entry.ChannelCount = record[33];
+			entry.SampleRate = ReadU32(&record[36]);
+
+			const u64 dataOffset = ReadU64(&record[40]);
+			const u64 dataSize = ReadU64(&record[48]);
+			entry.LoopStart = static_cast<size_t>(ReadU64(&record[56]));
+			entry.LoopEnd = static_cast<size_t>(ReadU64(&record[64]));
+
+			if (dataOffset > fileSize || dataSize > fileSize - dataOffset)
+			{
+				LogError(LogName, "Data of sound bank entry \"%.*s\" is out of bounds", static_cast<int>(entry.Name.size()), entry.Name.data());
+				return false;
+			}
+
+			entry.Data = &fileData[dataOffset];
+			entry.DataSize = static_cast<size_t>(dataSize);
+
+			if (entry.Encoding >= SoundBankEncoding::Count ||
+				(entry.Encoding == SoundBankEncoding::PCM16 && (entry.ChannelCount < 1 || entry.ChannelCount > 2 || entry.SampleRate == 0 || entry.DataSize % (entry.ChannelCount * sizeof(i16)) != 0)))
+			{
+				LogError(LogName, "Sound bank entry \"%.*s\" has an invalid format", static_cast<int>(entry.Name.size()), entry.Name.data());
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	const SoundBankEntry* FindSoundBankEntry(const std::vector<SoundBankEntry>& entries, std::string_view name)
+	{
+		for (const SoundBankEntry& entry : entries)
+		{
+			if (entry.Name == name)
+				return &entry;
+		}
+
+		return nullptr;
+	}
+}
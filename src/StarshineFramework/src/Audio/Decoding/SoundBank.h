@@ -0,0 +1,49 @@
+#pragma once
+#include "Common/Types.h"
+#include <vector>
+
+namespace Starshine::Audio
+{
+	enum class SoundBankEncoding : u8
+	{
+		// NOTE: Interleaved 16-bit samples, registered without decoding
+		PCM16,
+		// NOTE: A complete audio file (e.g. .ogg or .wav), decoded when the bank is loaded
+		Encoded,
+
+		Count
+	};
+
+	constexpr EnumStringMappingTable<SoundBankEncoding> SoundBankEncodingStringTable
+	{
+		EnumStringMapping<SoundBankEncoding>
+		{ SoundBankEncoding::PCM16, "PCM16" },
+		{ SoundBankEncoding::Encoded, "Encoded" }
+	};
+
+	// NOTE: Name and data point into the bank's file data, which has to outlive the entry
+	struct SoundBankEntry
+	{
+		std::string_view Name{};
+		SoundBankEncoding Encoding{};
+
+		// NOTE: PCM16 only, encoded entries carry their format inside their data
+		u32 ChannelCount{};
+		u32 SampleRate{};
+
+		const u8* Data{};
+		size_t DataSize{};
+
+		// NOTE: In frames. Only applied if 'LoopEnd' is greater than 'LoopStart', otherwise the loop points of the decoded file are kept
+		size_t LoopStart{};
+		size_t LoopEnd{};
+	};
+
+	// NOTE: A sound bank packs many small sounds into a single file so that they can be loaded with one read (or mapping) instead of one file per sound.
+	//		 Layout (little endian): a 16 byte header, a table of fixed size entry records, then the data of every entry aligned to 16 bytes.
+	//		 Banks are built from a directory by "python/build_sound_bank.py", which documents the record layout as well.
+	//		 The entry table is parsed in place, nothing is copied.
+	bool ParseSoundBank(const u8* fileData, size_t fileSize, std::vector<SoundBankEntry>& outEntries);
+
+	const SoundBankEntry* FindSoundBankEntry(const std::vector<SoundBankEntry>& entries, std::string_view name);
+}
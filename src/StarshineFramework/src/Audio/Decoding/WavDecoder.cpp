@@ -1,6 +1,8 @@
 #include "WavDecoder.h"
-#include <SDL2/SDL_rwops.h>
+#include <SDL2/SDL_endian.h>
+#include <SDL2/SDL_stdinc.h>
 #include <array>
+#include <string>
 
 namespace Starshine::Audio
 {
@@ -21,20 +23,6 @@ namespace Starshine::Audio
 		i32 Size{};
 	};
 
-	// NOTE: no way we're doing compiler-specific hacks already
-#ifdef _MSC_VER
-__pragma (pack(push, 1))
-#endif // _MSC_VER
-	struct ID3Frame
-	{
-		ID3FrameID Name{};
-		i32 Size{};
-		i16 Flags{};
-	};
-#ifdef _MSC_VER
-__pragma (pack(pop))
-#endif // _MSC_VER
-
 	// NOTE: https://learn.microsoft.com/en-us/windows/win32/api/mmreg/ns-mmreg-waveformatex
 	struct WavFormat
 	{
@@ -46,46 +34,78 @@ __pragma (pack(pop))
 		u16 BitsPerSample{};
 	};
 
-	void ReadID3Frame(SDL_RWops* stream, ID3Frame& frame)
+	// NOTE: ID3v2 header and frame sizes, the header size is stored as a "syncsafe" integer (7 bits per byte)
+	static constexpr size_t ID3HeaderSize = 10;
+	static constexpr size_t ID3FrameHeaderSize = 10;
+
+	static u32 ReadBE32(const u8* data)
 	{
-		SDL_RWread(stream, &frame.Name, sizeof(ID3FrameID), 1);
-		frame.Size = SDL_ReadBE32(stream);
-		frame.Flags = SDL_ReadBE16(stream);
+		u32 value{};
+		SDL_memcpy(&value, data, sizeof(value));
+		return SDL_SwapBE32(value);
 	}
 
-	std::string ReadNullTerminatedString(SDL_RWops* stream, size_t maxLength)
+	// NOTE: https://id3.org/id3v2.3.0
+	//		 The loop points are stored as "TXXX" frames with the descriptions "LoopStart" and "LoopEnd"
+	static void ParseID3LoopPoints(const u8* data, size_t size, WavFileInfo& info)
 	{
-		size_t readLength = 0;
-		size_t readPos = SDL_RWtell(stream);
+		if (size < ID3HeaderSize || SDL_memcmp(data, "ID3\x03", 4) != 0)
+		{
+			// Oh well, no custom looping position for us
+			return;
+		}
+
+		const size_t tagSize = (static_cast<size_t>(data[6] & 0x7F) << 21) | (static_cast<size_t>(data[7] & 0x7F) << 14) |
+			(static_cast<size_t>(data[8] & 0x7F) << 7) | static_cast<size_t>(data[9] & 0x7F);
+		const size_t tagEnd = SDL_min(size, ID3HeaderSize + tagSize);
+
+		bool hasLoopStart = false;
+		bool hasLoopEnd = false;
 
-		while (SDL_RWtell(stream) < SDL_RWsize(stream))
+		for (size_t offset = ID3HeaderSize; offset + ID3FrameHeaderSize <= tagEnd;)
 		{
-			char c = SDL_ReadU8(stream);
+			const size_t frameSize = ReadBE32(&data[offset + 4]);
+			const size_t frameStart = offset + ID3FrameHeaderSize;
 
-			if (c == 0 || readLength + 1 > maxLength)
+			if (frameSize == 0 || frameSize > tagEnd - frameStart)
 			{
 				break;
 			}
 
-			readLength++;
-		}
+			// NOTE: Encoding byte, null-terminated description, value
+			if (SDL_memcmp(&data[offset], ID3LoopFrameID.data(), ID3LoopFrameID.size()) == 0 && frameSize > 1)
+			{
+				const std::string_view frameText = std::string_view(reinterpret_cast<const char*>(&data[frameStart + 1]), frameSize - 1);
+				const size_t descriptionEnd = frameText.find('\0');
 
-		if (readLength == 0)
-		{
-			return "";
-		}
+				if (descriptionEnd != std::string_view::npos)
+				{
+					const std::string_view description = frameText.substr(0, descriptionEnd);
+					const std::string_view valueText = frameText.substr(descriptionEnd + 1);
+					const std::string value = std::string(valueText.substr(0, valueText.find('\0')));
+
+					if (description == "LoopStart" && !value.empty())
+					{
+						info.LoopStart = std::stoull(value);
+						hasLoopStart = true;
+					}
+					else if (description == "LoopEnd" && !value.empty())
+					{
+						info.LoopEnd = std::stoull(value);
+						hasLoopEnd = true;
+					}
+				}
+			}
 
-		std::string result = std::string(readLength, '\0');
+			offset = frameStart + frameSize;
+		}
 
-		SDL_RWseek(stream, readPos, RW_SEEK_SET);
-		SDL_RWread(stream, result.data(), readLength, 1);
-		
-		if (readLength < maxLength)
+		info.IsLooped = hasLoopStart && hasLoopEnd;
+		if (!info.IsLooped)
 		{
-			SDL_RWseek(stream, 1, RW_SEEK_CUR);
+			info.LoopStart = 0;
+			info.LoopEnd = 0;
 		}
-
-		return result;
 	}
 
 	const char* WavDecoder::GetFileExtension() const
@@ -95,131 +115,84 @@ __pragma (pack(pop))
 
 	bool WavDecoder::ParseEncodedData(const void* encodedData, size_t encodedDataSize, DecoderOutput& output)
 	{
-		if (encodedData != nullptr && encodedDataSize > 0)
+		WavFileInfo info{};
+		if (!ParseFileInfo(encodedData, encodedDataSize, info))
 		{
-			SDL_RWops* memStream = SDL_RWFromConstMem(encodedData, static_cast<int>(encodedDataSize));
-
-			// --- Initial RIFF Header
-
-			WavSegment riffHeader{};
-			memStream->read(memStream, &riffHeader, sizeof(WavSegment), 1);
+			return false;
+		}
 
-			if (riffHeader.Name != RiffHeaderID)
-			{
-				SDL_RWclose(memStream);
-				return false;
-			}
+		output.ChannelCount = info.ChannelCount;
+		output.SampleRate = info.SampleRate;
+		output.SampleCount = info.DataSize / sizeof(i16);
+		output.SampleData = std::make_unique<i16[]>(output.SampleCount);
+		SDL_memcpy(output.SampleData.get(), &static_cast<const u8*>(encodedData)[info.DataOffset], output.SampleCount * sizeof(i16));
 
-			WavFileID riffDataType{};
-			memStream->read(memStream, &riffDataType, sizeof(WavFileID), 1);
+		output.IsLooped = info.IsLooped;
+		output.LoopStart = info.LoopStart;
+		output.LoopEnd = info.LoopEnd;
+		return true;
+	}
 
-			if (riffDataType != WaveTypeID)
-			{
-				SDL_RWclose(memStream);
-				return false;
-			}
+	bool WavDecoder::ParseFileInfo(const void* fileData, size_t fileSize, WavFileInfo& info)
+	{
+		const u8* data = static_cast<const u8*>(fileData);
+		if (data == nullptr || fileSize < sizeof(WavSegment) + sizeof(WavFileID))
+		{
+			return false;
+		}
 
-			// --- Format Segment
-			WavSegment formatSegment{};
-			memStream->read(memStream, &formatSegment, sizeof(WavSegment), 1);
+		// --- Initial RIFF Header
+		WavSegment riffHeader{};
+		WavFileID riffDataType{};
+		SDL_memcpy(&riffHeader, &data[0], sizeof(WavSegment));
+		SDL_memcpy(&riffDataType, &data[sizeof(WavSegment)], sizeof(WavFileID));
 
-			if (formatSegment.Name != FormatSegmentID)
-			{
-				SDL_RWclose(memStream);
-				return false;
-			}
+		if (riffHeader.Name != RiffHeaderID || riffDataType != WaveTypeID)
+		{
+			return false;
+		}
 
-			WavFormat audioFormat{};
-			memStream->read(memStream, &audioFormat, sizeof(WavFormat), 1);
+		// NOTE: Segments can appear in any order and unknown ones (e.g. "LIST") are skipped. Segments are padded to an even size
+		bool hasFormat = false;
+		bool hasData = false;
+		WavFormat audioFormat{};
 
-			// --- Data Segment
+		size_t offset = sizeof(WavSegment) + sizeof(WavFileID);
+		while (offset + sizeof(WavSegment) <= fileSize)
+		{
+			WavSegment segment{};
+			SDL_memcpy(&segment, &data[offset], sizeof(WavSegment));
 
-			WavSegment dataSegment{};
-			memStream->read(memStream, &dataSegment, sizeof(WavSegment), 1);
+			const size_t segmentStart = offset + sizeof(WavSegment);
+			const size_t segmentSize = SDL_min(static_cast<size_t>(static_cast<u32>(segment.Size)), fileSize - segmentStart);
 
-			if (dataSegment.Name != DataSegmentID)
+			if (segment.Name == FormatSegmentID && segmentSize >= sizeof(WavFormat))
 			{
-				SDL_RWclose(memStream);
-				return false;
+				SDL_memcpy(&audioFormat, &data[segmentStart], sizeof(WavFormat));
+				hasFormat = true;
 			}
-
-			output.ChannelCount = audioFormat.Channels;
-			output.SampleRate = audioFormat.SamplesPerSecond;
-			output.SampleCount = static_cast<size_t>(dataSegment.Size) / sizeof(i16);
-			output.SampleData = std::make_unique<i16[]>(output.SampleCount);
-
-			memStream->read(memStream, output.SampleData.get(), output.SampleCount * sizeof(i16), 1);
-
-			// --- ID3 Metadata (used for looping, optional)
-
-			size_t remainingFileSize = encodedDataSize - (44ULL + dataSegment.Size);
-			size_t metadataStartPos = SDL_RWtell(memStream) + sizeof(WavSegment);
-
-			if (remainingFileSize > 0)
+			else if (segment.Name == DataSegmentID)
 			{
-				WavSegment metadataSegment{};
-				memStream->read(memStream, &metadataSegment, sizeof(WavSegment), 1);
-				SDL_RWclose(memStream);
-
-				// NOTE: https://id3.org/id3v2.3.0
-				if (metadataSegment.Name == ID3MetadataSegmentID)
-				{
-					SDL_RWops* id3Stream = SDL_RWFromConstMem(&((u8*)encodedData)[metadataStartPos], metadataSegment.Size);
-
-					if (SDL_ReadBE32(id3Stream) != 0x49443303) // 'I', 'D', '3', 0x03
-					{
-						// Oh well, no custom looping position for us
-						SDL_RWclose(id3Stream);
-						return true;
-					}
-
-					SDL_RWseek(id3Stream, 5, RW_SEEK_CUR); // Second version byte + flags (unused)
-					u8 metadataSize = SDL_ReadU8(id3Stream);
-
-					if (metadataSegment.Size - SDL_RWtell(id3Stream) < metadataSize)
-					{
-						SDL_RWclose(id3Stream);
-						return true;
-					}
-
-					// --- Loop Start
-					ID3Frame id3Frame{};
-					ReadID3Frame(id3Stream, id3Frame);
-
-					SDL_ReadU8(id3Stream); // Encoding
-
-					std::string frameName = ReadNullTerminatedString(id3Stream, id3Frame.Size);
-					if (frameName != "LoopStart")
-					{
-						SDL_RWclose(id3Stream);
-						return true;
-					}
-
-					std::string frameValue = ReadNullTerminatedString(id3Stream, id3Frame.Size - (frameName.length() + 2));
-					output.LoopStart = std::stoull(frameValue);
-
-					// --- Loop End
-					ReadID3Frame(id3Stream, id3Frame);
-
-					SDL_ReadU8(id3Stream); // Encoding
-
-					frameName = ReadNullTerminatedString(id3Stream, id3Frame.Size);
-					if (frameName != "LoopEnd")
-					{
-						output.LoopStart = 0;
-						SDL_RWclose(id3Stream);
-						return true;
-					}
-
-					frameValue = ReadNullTerminatedString(id3Stream, id3Frame.Size - (frameName.length() + 2));
-					output.LoopEnd = std::stoull(frameValue);
-					output.IsLooped = true;
-				}
+				info.DataOffset = segmentStart;
+				info.DataSize = segmentSize;
+				hasData = true;
+			}
+			else if (segment.Name == ID3MetadataSegmentID)
+			{
+				ParseID3LoopPoints(&data[segmentStart], segmentSize, info);
 			}
 
-			return true;
+			offset = segmentStart + segmentSize + (segmentSize & 1);
+		}
+
+		if (!hasFormat || !hasData || audioFormat.DataFormat != 1 || audioFormat.BitsPerSample != 16 || audioFormat.Channels < 1 || audioFormat.Channels > 2)
+		{
+			return false;
 		}
 
-		return false;
+		info.ChannelCount = audioFormat.Channels;
+		info.SampleRate = audioFormat.SamplesPerSecond;
+		info.DataSize -= info.DataSize % (info.ChannelCount * sizeof(i16));
+		return true;
 	}
 }
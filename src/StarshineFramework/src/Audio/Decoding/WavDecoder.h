@@ -3,10 +3,29 @@
 
 namespace Starshine::Audio
 {
+	// NOTE: Format, location of the sample data and loop points of a 16-bit PCM WAV file
+	struct WavFileInfo
+	{
+		u32 ChannelCount{};
+		u32 SampleRate{};
+
+		// NOTE: In bytes, relative to the start of the file
+		size_t DataOffset{};
+		size_t DataSize{};
+
+		bool IsLooped{};
+		size_t LoopStart{};
+		size_t LoopEnd{};
+	};
+
 	class WavDecoder : public IDecoder
 	{
 	public:
 		const char* GetFileExtension() const override;
 		bool ParseEncodedData(const void* encodedData, size_t encodedDataSize, DecoderOutput& output) override;
+
+	public:
+		// NOTE: Shared with the streaming provider, which plays the sample data in place instead of copying it
+		static bool ParseFileInfo(const void* fileData, size_t fileSize, WavFileInfo& info);
 	};
 }
@@ -0,0 +1,78 @@
+#include "WavEncoder.h"
+#include <array>
+#include <limits>
+
+namespace Starshine::Audio
+{
+	using WavFileID = std::array<char, 4>;
+
+	static constexpr WavFileID RiffHeaderID { 'R', 'I', 'F', 'F' };
+	static constexpr WavFileID WaveTypeID { 'W', 'A', 'V', 'E' };
+	static constexpr WavFileID FormatSegmentID { 'f', 'm', 't', ' ' };
+	static constexpr WavFileID DataSegmentID { 'd', 'a', 't', 'a' };
+
+	static constexpr u16 PCMDataFormat = 1;
+	static constexpr u16 BitsPerSample = 16;
+	static constexpr u32 FormatSegmentSize = 16;
+
+	static constexpr size_t RiffSizeOffset = 4;
+	static constexpr size_t DataSizeOffset = 40;
+	static constexpr size_t HeaderSize = 44;
+
+	WavEncoder::WavEncoder(IO::IStream& stream, u32 channels, u32 sampleRate) : writer(stream), channels(channels), sampleRate(sampleRate)
+	{
+		const u16 blockAlign = static_cast<u16>(channels * (BitsPerSample / 8));
+
+		writer.WriteBuffer(RiffHeaderID.data(), RiffHeaderID.size());
+		writer.WriteU32_LE(0);
+		writer.WriteBuffer(WaveTypeID.data(), WaveTypeID.size());
+
+		writer.WriteBuffer(FormatSegmentID.data(), FormatSegmentID.size());
+		writer.WriteU32_LE(FormatSegmentSize);
+		writer.WriteU16_LE(PCMDataFormat);
+		writer.WriteU16_LE(static_cast<u16>(channels));
+		writer.WriteU32_LE(sampleRate);
+		writer.WriteU32_LE(sampleRate * blockAlign);
+		writer.WriteU16_LE(blockAlign);
+		writer.WriteU16_LE(BitsPerSample);
+
+		writer.WriteBuffer(DataSegmentID.data(), DataSegmentID.size());
+		writer.WriteU32_LE(0);
+	}
+
+	void WavEncoder::WriteFrames(const f32* samples, size_t frameCount)
+	{
+		constexpr size_t chunkSampleCount = 4096;
+		std::array<i16, chunkSampleCount> chunk;
+
+		const size_t sampleCount = frameCount * channels;
+		for (size_t offset = 0; offset < sampleCount; offset += chunkSampleCount)
+		{
+			const size_t count = (sampleCount - offset < chunkSampleCount) ? (sampleCount - offset) : chunkSampleCount;
+			for (size_t i = 0; i < count; i++)
+			{
+				f32 sample = samples[offset + i];
+				sample = (sample < -1.0f) ? -1.0f : ((sample > 1.0f) ? 1.0f : sample);
+				chunk[i] = static_cast<i16>(sample * static_cast<f32>(std::numeric_limits<i16>::max()));
+			}
+
+			writer.WriteBuffer(chunk.data(), count * sizeof(i16));
+		}
+
+		writtenFrames += frameCount;
+	}
+
+	void WavEncoder::Finish()
+	{
+		const u32 dataSize = static_cast<u32>(writtenFrames * channels * (BitsPerSample / 8));
+		const size_t endPosition = writer.GetPosition();
+
+		writer.Seek(RiffSizeOffset);
+		writer.WriteU32_LE(static_cast<u32>(HeaderSize - 8) + dataSize);
+
+		writer.Seek(DataSizeOffset);
+		writer.WriteU32_LE(dataSize);
+
+		writer.Seek(endPosition);
+	}
+}
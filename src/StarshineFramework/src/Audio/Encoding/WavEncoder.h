@@ -0,0 +1,27 @@
+#pragma once
+#include "Common/Types.h"
+#include "IO/StreamWriter.h"
+
+namespace Starshine::Audio
+{
+	// NOTE: Writes mixing samples as a 16-bit PCM WAV file. The header is written up front and its sizes are patched by Finish()
+	class WavEncoder : NonCopyable
+	{
+	public:
+		WavEncoder(IO::IStream& stream, u32 channels, u32 sampleRate);
+		~WavEncoder() = default;
+
+	public:
+		void WriteFrames(const f32* samples, size_t frameCount);
+		void Finish();
+
+		size_t GetWrittenFrames() const { return writtenFrames; }
+
+	private:
+		IO::StreamWriter writer;
+
+		u32 channels{};
+		u32 sampleRate{};
+		size_t writtenFrames{};
+	};
+}
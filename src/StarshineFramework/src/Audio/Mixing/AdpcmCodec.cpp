@@ -0,0 +1,333 @@
+#include "AdpcmCodec.h"
+#include "SIMD.h"
+#include <SDL2/SDL_endian.h>
+#include <SDL2/SDL_stdinc.h>
+#include <algorithm>
+#include <array>
+
+namespace Starshine::Audio::Mixing
+{
+	static constexpr std::array<i32, 89> StepTable
+	{
+		7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
+		130, 143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166,
+		1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845,
+		8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+	};
+
+	static constexpr std::array<i32, 8> StepIndexTable { -1, -1, -1, -1, 2, 4, 6, 8 };
+	static constexpr i32 MaxStepIndex = static_cast<i32>(StepTable.size()) - 1;
+
+	static inline i16 DecodeCode(AdpcmChannelState& state, u32 code)
+	{
+		const i32 step = StepTable[state.StepIndex];
+
+		i32 difference = step >> 3;
+		if (code & 1) { difference += step >> 2; }
+		if (code & 2) { difference += step >> 1; }
+		if (code & 4) { difference += step; }
+
+		state.Predictor = std::clamp(state.Predictor + ((code & 8) ? -difference : difference), -32768, 32767);
+		state.StepIndex = std::clamp(state.StepIndex + StepIndexTable[code & 7], 0, MaxStepIndex);
+		return static_cast<i16>(state.Predictor);
+	}
+
+	static inline u32 EncodeSample(AdpcmChannelState& state, i16 sample)
+	{
+		const i32 step = StepTable[state.StepIndex];
+		i32 difference = static_cast<i32>(sample) - state.Predictor;
+
+		u32 code = 0;
+		if (difference < 0) { code = 8; difference = -difference; }
+		if (difference >= step) { code |= 4; difference -= step; }
+		if (difference >= (step >> 1)) { code |= 2; difference -= (step >> 1); }
+		if (difference >= (step >> 2)) { code |= 1; }
+
+		// NOTE: The encoder tracks the decoder's output instead of the source, so the error never accumulates
+		DecodeCode(state, code);
+		return code;
+	}
+
+	static inline AdpcmChannelState ReadBlockHeader(const u8* block)
+	{
+		u16 predictor = 0;
+		SDL_memcpy(&predictor, &block[0], sizeof(u16));
+
+		return AdpcmChannelState { static_cast<i16>(SDL_SwapLE16(predictor)), std::min(static_cast<i32>(block[2]), MaxStepIndex) };
+	}
+
+	static inline void WriteBlockHeader(u8* block, const AdpcmChannelState& state)
+	{
+		const u16 predictor = SDL_SwapLE16(static_cast<u16>(static_cast<i16>(state.Predictor)));
+		SDL_memcpy(&block[0], &predictor, sizeof(u16));
+
+		block[2] = static_cast<u8>(state.StepIndex);
+		block[3] = 0;
+	}
+
+	// NOTE: The codes of samples [i; i + 8) of a block, the code of sample i in the lowest nibble
+	static inline i32 ReadCodeWord(const u8* block, size_t i)
+	{
+		u32 word = 0;
+		SDL_memcpy(&word, &block[AdpcmBlockHeaderSize + i / 2], sizeof(u32));
+		return static_cast<i32>(SDL_SwapLE32(word));
+	}
+
+	static inline i16* GetBlockOutput(i16* dst, size_t block, u32 channels)
+	{
+		return &dst[(block / channels) * AdpcmBlockFrames * channels + block % channels];
+	}
+
+	void EncodeAdpcm(u8* dst, const i16* src, size_t frameCount, u32 channels, AdpcmChannelState* states)
+	{
+		const size_t frameBlockCount = GetAdpcmFrameBlockCount(frameCount);
+
+		for (size_t frameBlock = 0; frameBlock < frameBlockCount; frameBlock++)
+		{
+			const size_t firstFrame = frameBlock * AdpcmBlockFrames;
+			const size_t blockFrames = std::min(frameCount - firstFrame, AdpcmBlockFrames);
+
+			for (u32 channel = 0; channel < channels; channel++)
+			{
+				u8* block = &dst[(frameBlock * channels + channel) * AdpcmBlockSize];
+				AdpcmChannelState& state = states[channel];
+
+				WriteBlockHeader(block, state);
+				for (size_t i = 0; i < AdpcmBlockFrames; i += 2)
+				{
+					const i16 first = (i + 0 < blockFrames) ? src[(firstFrame + i + 0) * channels + channel] : 0;
+					const i16 second = (i + 1 < blockFrames) ? src[(firstFrame + i + 1) * channels + channel] : 0;
+
+					const u32 firstCode = EncodeSample(state, first);
+					const u32 secondCode = EncodeSample(state, second);
+					block[AdpcmBlockHeaderSize + i / 2] = static_cast<u8>(firstCode | (secondCode << 4));
+				}
+			}
+		}
+	}
+
+	namespace Scalar
+	{
+		static void DecodeBlock(i16* dst, const u8* block, u32 stride)
+		{
+			AdpcmChannelState state = ReadBlockHeader(block);
+			const u8* codes = &block[AdpcmBlockHeaderSize];
+
+			for (size_t i = 0; i < AdpcmBlockFrames / 2; i++)
+			{
+				dst[(i * 2 + 0) * stride] = DecodeCode(state, codes[i] & 0x0F);
+				dst[(i * 2 + 1) * stride] = DecodeCode(state, codes[i] >> 4);
+			}
+		}
+
+		static void DecodeFrameBlocks(i16* dst, const u8* src, size_t frameBlockCount, u32 channels)
+		{
+			for (size_t block = 0; block < frameBlockCount * channels; block++)
+			{
+				DecodeBlock(GetBlockOutput(dst, block, channels), &src[block * AdpcmBlockSize], channels);
+			}
+		}
+	}
+
+#ifdef STARSHINE_MIXING_X86
+	// NOTE: Every lane decodes a different block. Lanes past the last block decode it a second time into a scratch buffer
+	template <size_t LaneCount>
+	struct DecoderLanes
+	{
+		std::array<const u8*, LaneCount> Blocks{};
+		std::array<i16*, LaneCount> Outputs{};
+
+		alignas(32) std::array<i32, LaneCount> Predictors{};
+		alignas(32) std::array<i32, LaneCount> StepIndices{};
+		alignas(32) std::array<i32, LaneCount> Samples{};
+
+		std::array<i16, AdpcmBlockFrames * 2> DiscardedOutput;
+
+		void Setup(i16* dst, const u8* src, size_t firstBlock, size_t blockCount, u32 channels)
+		{
+			for (size_t lane = 0; lane < LaneCount; lane++)
+			{
+				const size_t block = std::min(firstBlock + lane, blockCount - 1);
+				Blocks[lane] = &src[block * AdpcmBlockSize];
+				Outputs[lane] = (firstBlock + lane < blockCount) ? GetBlockOutput(dst, block, channels) : DiscardedOutput.data();
+
+				const AdpcmChannelState state = ReadBlockHeader(Blocks[lane]);
+				Predictors[lane] = state.Predictor;
+				StepIndices[lane] = state.StepIndex;
+			}
+		}
+
+		inline void StoreSamples(size_t i, u32 stride)
+		{
+			for (size_t lane = 0; lane < LaneCount; lane++)
+			{
+				Outputs[lane][i * stride] = static_cast<i16>(Samples[lane]);
+			}
+		}
+	};
+
+	namespace SSE2
+	{
+		static inline __m128i BitMask(__m128i code, __m128i bit)
+		{
+			return _mm_cmpeq_epi32(_mm_and_si128(code, bit), bit);
+		}
+
+		static void DecodeFrameBlocks(i16* dst, const u8* src, size_t frameBlockCount, u32 channels)
+		{
+			constexpr size_t LaneCount = 4;
+			const size_t blockCount = frameBlockCount * channels;
+
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i one = _mm_set1_epi32(1);
+			const __m128i two = _mm_set1_epi32(2);
+			const __m128i three = _mm_set1_epi32(3);
+			const __m128i four = _mm_set1_epi32(4);
+			const __m128i eight = _mm_set1_epi32(8);
+			const __m128i minusOne = _mm_set1_epi32(-1);
+			const __m128i codeMask = _mm_set1_epi32(0x0F);
+			const __m128i maxStepIndex = _mm_set1_epi32(MaxStepIndex);
+
+			DecoderLanes<LaneCount> lanes;
+			for (size_t firstBlock = 0; firstBlock < blockCount; firstBlock += LaneCount)
+			{
+				lanes.Setup(dst, src, firstBlock, blockCount, channels);
+
+				__m128i predictor = _mm_load_si128(reinterpret_cast<const __m128i*>(lanes.Predictors.data()));
+				__m128i stepIndex = _mm_load_si128(reinterpret_cast<const __m128i*>(lanes.StepIndices.data()));
+
+				for (size_t i = 0; i < AdpcmBlockFrames; i += 8)
+				{
+					__m128i codes = _mm_setr_epi32(ReadCodeWord(lanes.Blocks[0], i), ReadCodeWord(lanes.Blocks[1], i), ReadCodeWord(lanes.Blocks[2], i), ReadCodeWord(lanes.Blocks[3], i));
+
+					for (size_t j = 0; j < 8; j++)
+					{
+						// NOTE: SSE2 has no gather, the step sizes are looked up one lane at a time
+						_mm_store_si128(reinterpret_cast<__m128i*>(lanes.StepIndices.data()), stepIndex);
+						const __m128i step = _mm_setr_epi32(StepTable[lanes.StepIndices[0]], StepTable[lanes.StepIndices[1]], StepTable[lanes.StepIndices[2]], StepTable[lanes.StepIndices[3]]);
+
+						const __m128i code = _mm_and_si128(codes, codeMask);
+						codes = _mm_srli_epi32(codes, 4);
+
+						__m128i difference = _mm_srli_epi32(step, 3);
+						difference = _mm_add_epi32(difference, _mm_and_si128(_mm_srli_epi32(step, 2), BitMask(code, one)));
+						difference = _mm_add_epi32(difference, _mm_and_si128(_mm_srli_epi32(step, 1), BitMask(code, two)));
+						difference = _mm_add_epi32(difference, _mm_and_si128(step, BitMask(code, four)));
+
+						const __m128i sign = BitMask(code, eight);
+						difference = _mm_sub_epi32(_mm_xor_si128(difference, sign), sign);
+
+						// NOTE: Saturating to 16 bits and sign extending again clamps the predictor without SSE4.1's min/max
+						const __m128i packed = _mm_packs_epi32(_mm_add_epi32(predictor, difference), zero);
+						predictor = _mm_srai_epi32(_mm_unpacklo_epi16(packed, packed), 16);
+
+						// NOTE: The step index is always within [-1; 96], so a 16-bit min/max clamps both halves of every lane correctly
+						const __m128i increase = _mm_slli_epi32(_mm_add_epi32(_mm_and_si128(code, three), one), 1);
+						const __m128i increaseMask = BitMask(code, four);
+						stepIndex = _mm_add_epi32(stepIndex, _mm_or_si128(_mm_and_si128(increaseMask, increase), _mm_andnot_si128(increaseMask, minusOne)));
+						stepIndex = _mm_min_epi16(_mm_max_epi16(stepIndex, zero), maxStepIndex);
+
+						_mm_store_si128(reinterpret_cast<__m128i*>(lanes.Samples.data()), predictor);
+						lanes.StoreSamples(i + j, channels);
+					}
+				}
+			}
+		}
+	}
+
+	namespace AVX2
+	{
+		STARSHINE_TARGET_AVX2 static inline __m256i BitMask(__m256i code, __m256i bit)
+		{
+			return _mm256_cmpeq_epi32(_mm256_and_si256(code, bit), bit);
+		}
+
+		STARSHINE_TARGET_AVX2 static void DecodeFrameBlocks(i16* dst, const u8* src, size_t frameBlockCount, u32 channels)
+		{
+			constexpr size_t LaneCount = 8;
+			const size_t blockCount = frameBlockCount * channels;
+
+			const __m256i zero = _mm256_setzero_si256();
+			const __m256i one = _mm256_set1_epi32(1);
+			const __m256i two = _mm256_set1_epi32(2);
+			const __m256i three = _mm256_set1_epi32(3);
+			const __m256i four = _mm256_set1_epi32(4);
+			const __m256i eight = _mm256_set1_epi32(8);
+			const __m256i minusOne = _mm256_set1_epi32(-1);
+			const __m256i codeMask = _mm256_set1_epi32(0x0F);
+			const __m256i minPredictor = _mm256_set1_epi32(-32768);
+			const __m256i maxPredictor = _mm256_set1_epi32(32767);
+			const __m256i maxStepIndex = _mm256_set1_epi32(MaxStepIndex);
+
+			DecoderLanes<LaneCount> lanes;
+			for (size_t firstBlock = 0; firstBlock < blockCount; firstBlock += LaneCount)
+			{
+				lanes.Setup(dst, src, firstBlock, blockCount, channels);
+
+				__m256i predictor = _mm256_load_si256(reinterpret_cast<const __m256i*>(lanes.Predictors.data()));
+				__m256i stepIndex = _mm256_load_si256(reinterpret_cast<const __m256i*>(lanes.StepIndices.data()));
+
+				for (size_t i = 0; i < AdpcmBlockFrames; i += 8)
+				{
+					__m256i codes = _mm256_setr_epi32(
+						ReadCodeWord(lanes.Blocks[0], i), ReadCodeWord(lanes.Blocks[1], i), ReadCodeWord(lanes.Blocks[2], i), ReadCodeWord(lanes.Blocks[3], i),
+						ReadCodeWord(lanes.Blocks[4], i), ReadCodeWord(lanes.Blocks[5], i), ReadCodeWord(lanes.Blocks[6], i), ReadCodeWord(lanes.Blocks[7], i));
+
+					for (size_t j = 0; j < 8; j++)
+					{
+						const __m256i step = _mm256_i32gather_epi32(StepTable.data(), stepIndex, sizeof(i32));
+
+						const __m256i code = _mm256_and_si256(codes, codeMask);
+						codes = _mm256_srli_epi32(codes, 4);
+
+						__m256i difference = _mm256_srli_epi32(step, 3);
+						difference = _mm256_add_epi32(difference, _mm256_and_si256(_mm256_srli_epi32(step, 2), BitMask(code, one)));
+						difference = _mm256_add_epi32(difference, _mm256_and_si256(_mm256_srli_epi32(step, 1), BitMask(code, two)));
+						difference = _mm256_add_epi32(difference, _mm256_and_si256(step, BitMask(code, four)));
+
+						const __m256i sign = BitMask(code, eight);
+						difference = _mm256_sub_epi32(_mm256_xor_si256(difference, sign), sign);
+						predictor = _mm256_min_epi32(_mm256_max_epi32(_mm256_add_epi32(predictor, difference), minPredictor), maxPredictor);
+
+						const __m256i increase = _mm256_slli_epi32(_mm256_add_epi32(_mm256_and_si256(code, three), one), 1);
+						stepIndex = _mm256_add_epi32(stepIndex, _mm256_blendv_epi8(minusOne, increase, BitMask(code, four)));
+						stepIndex = _mm256_min_epi32(_mm256_max_epi32(stepIndex, zero), maxStepIndex);
+
+						_mm256_store_si256(reinterpret_cast<__m256i*>(lanes.Samples.data()), predictor);
+						lanes.StoreSamples(i + j, channels);
+					}
+				}
+			}
+
+			_mm256_zeroupper();
+		}
+	}
+#endif
+
+	static const AdpcmKernelTable KernelTables[EnumCount<InstructionSet>()]
+	{
+		{ Scalar::DecodeFrameBlocks },
+#ifdef STARSHINE_MIXING_X86
+		{ SSE2::DecodeFrameBlocks },
+		{ AVX2::DecodeFrameBlocks },
+#else
+		{ Scalar::DecodeFrameBlocks },
+		{ Scalar::DecodeFrameBlocks },
+#endif
+	};
+
+	const AdpcmKernelTable& GetAdpcmKernels(InstructionSet set)
+	{
+		if (set >= InstructionSet::Count || !IsInstructionSetSupported(set))
+		{
+			return KernelTables[static_cast<size_t>(InstructionSet::Scalar)];
+		}
+
+		return KernelTables[static_cast<size_t>(set)];
+	}
+
+	const AdpcmKernelTable& GetAdpcmKernels()
+	{
+		return KernelTables[static_cast<size_t>(GetBestInstructionSet())];
+	}
+}
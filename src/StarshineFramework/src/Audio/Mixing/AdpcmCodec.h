@@ -0,0 +1,37 @@
+#pragma once
+#include "Common/Types.h"
+#include "MixKernels.h"
+
+namespace Starshine::Audio::Mixing
+{
+	// NOTE: IMA-ADPCM in a block layout of our own. Every block holds 'AdpcmBlockFrames' samples of a single channel,
+	//		 starting with the decoder state (i16 predictor, u8 step index, u8 padding) followed by one 4-bit code per sample, low nibble first.
+	//		 Frame blocks are stored one after another, each holding one block per channel, so any of them can be decoded on its own
+	constexpr size_t AdpcmBlockFrames = 128;
+	constexpr size_t AdpcmBlockHeaderSize = 4;
+	constexpr size_t AdpcmBlockSize = AdpcmBlockHeaderSize + AdpcmBlockFrames / 2;
+
+	constexpr size_t GetAdpcmFrameBlockCount(size_t frameCount) { return (frameCount + AdpcmBlockFrames - 1) / AdpcmBlockFrames; }
+
+	struct AdpcmChannelState
+	{
+		i32 Predictor{};
+		i32 StepIndex{};
+	};
+
+	// NOTE: Encodes 'frameCount' interleaved frames into GetAdpcmFrameBlockCount(frameCount) frame blocks, the last one is padded with silence.
+	//		 'states' holds one entry per channel and carries the encoder state over to the next call, so long sources can be encoded in pieces
+	//		 as long as every piece except the last one is a multiple of 'AdpcmBlockFrames'
+	void EncodeAdpcm(u8* dst, const i16* src, size_t frameCount, u32 channels, AdpcmChannelState* states);
+
+	// NOTE: All kernels produce bit-identical output, the vectorized ones decode one block per lane
+	struct AdpcmKernelTable
+	{
+		// NOTE: Decodes 'frameBlockCount' frame blocks into 'frameBlockCount * AdpcmBlockFrames' interleaved frames
+		void (*DecodeFrameBlocks)(i16* dst, const u8* src, size_t frameBlockCount, u32 channels);
+	};
+
+	// NOTE: Falls back to the scalar kernels if the requested instruction set is not supported by the CPU
+	const AdpcmKernelTable& GetAdpcmKernels(InstructionSet set);
+	const AdpcmKernelTable& GetAdpcmKernels();
+}
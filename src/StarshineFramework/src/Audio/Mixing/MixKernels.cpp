@@ -0,0 +1,307 @@
+#include "MixKernels.h"
+#include "SIMD.h"
+#include <SDL2/SDL_cpuinfo.h>
+#include <math.h>
+
+namespace Starshine::Audio::Mixing
+{
+	namespace Scalar
+	{
+		static void AccumulateMono(f32* dst, const i16* src, size_t frameCount, f32 volume)
+		{
+			const f32 gain = volume * I16ToF32Scale;
+			for (size_t i = 0; i < frameCount; i++)
+			{
+				f32 sample = static_cast<f32>(src[i]) * gain;
+				dst[i * 2 + 0] += sample;
+				dst[i * 2 + 1] += sample;
+			}
+		}
+
+		static void AccumulateStereo(f32* dst, const i16* src, size_t frameCount, f32 volume)
+		{
+			const f32 gain = volume * I16ToF32Scale;
+			for (size_t i = 0; i < frameCount * 2; i++)
+			{
+				dst[i] += static_cast<f32>(src[i]) * gain;
+			}
+		}
+
+		static void AccumulateBus(f32* dst, const f32* src, size_t frameCount, f32 gain, f32 gainStep, BusLevels& levels)
+		{
+			for (size_t i = 0; i < frameCount; i++)
+			{
+				const f32 frameGain = gain + gainStep * static_cast<f32>(i);
+				for (size_t channel = 0; channel < 2; channel++)
+				{
+					f32 sample = src[i * 2 + channel] * frameGain;
+					dst[i * 2 + channel] += sample;
+
+					levels.Peak[channel] = (fabsf(sample) > levels.Peak[channel]) ? fabsf(sample) : levels.Peak[channel];
+					levels.SumOfSquares[channel] += sample * sample;
+				}
+			}
+		}
+
+		static void ClampCopy(f32* dst, const f32* src, size_t sampleCount)
+		{
+			for (size_t i = 0; i < sampleCount; i++)
+			{
+				f32 sample = src[i];
+				dst[i] = (sample < -1.0f) ? -1.0f : ((sample > 1.0f) ? 1.0f : sample);
+			}
+		}
+	}
+
+#ifdef STARSHINE_MIXING_X86
+	namespace SSE2
+	{
+		static void AccumulateMono(f32* dst, const i16* src, size_t frameCount, f32 volume)
+		{
+			const __m128 gain = _mm_set1_ps(volume * I16ToF32Scale);
+
+			size_t i = 0;
+			for (; i + 8 <= frameCount; i += 8)
+			{
+				__m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&src[i]));
+
+				// NOTE: Sign-extend i16 to i32 by placing each sample in the upper half and shifting it back down
+				__m128 lo = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16)), gain);
+				__m128 hi = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16)), gain);
+
+				f32* out = &dst[i * 2];
+				_mm_storeu_ps(&out[0], _mm_add_ps(_mm_loadu_ps(&out[0]), _mm_unpacklo_ps(lo, lo)));
+				_mm_storeu_ps(&out[4], _mm_add_ps(_mm_loadu_ps(&out[4]), _mm_unpackhi_ps(lo, lo)));
+				_mm_storeu_ps(&out[8], _mm_add_ps(_mm_loadu_ps(&out[8]), _mm_unpacklo_ps(hi, hi)));
+				_mm_storeu_ps(&out[12], _mm_add_ps(_mm_loadu_ps(&out[12]), _mm_unpackhi_ps(hi, hi)));
+			}
+
+			Scalar::AccumulateMono(&dst[i * 2], &src[i], frameCount - i, volume);
+		}
+
+		static void AccumulateStereo(f32* dst, const i16* src, size_t frameCount, f32 volume)
+		{
+			const __m128 gain = _mm_set1_ps(volume * I16ToF32Scale);
+			const size_t sampleCount = frameCount * 2;
+
+			size_t i = 0;
+			for (; i + 8 <= sampleCount; i += 8)
+			{
+				__m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&src[i]));
+
+				__m128 lo = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16)), gain);
+				__m128 hi = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16)), gain);
+
+				_mm_storeu_ps(&dst[i + 0], _mm_add_ps(_mm_loadu_ps(&dst[i + 0]), lo));
+				_mm_storeu_ps(&dst[i + 4], _mm_add_ps(_mm_loadu_ps(&dst[i + 4]), hi));
+			}
+
+			Scalar::AccumulateStereo(&dst[i], &src[i], (sampleCount - i) / 2, volume);
+		}
+
+		// NOTE: Folds vector lanes that alternate between the left and the right channel into 'levels'
+		static void MergeBusLevels(BusLevels& levels, const f32* peak, const f32* sumOfSquares, size_t laneCount)
+		{
+			for (size_t lane = 0; lane < laneCount; lane++)
+			{
+				const size_t channel = lane & 1;
+				levels.Peak[channel] = (peak[lane] > levels.Peak[channel]) ? peak[lane] : levels.Peak[channel];
+				levels.SumOfSquares[channel] += sumOfSquares[lane];
+			}
+		}
+
+		static void AccumulateBus(f32* dst, const f32* src, size_t frameCount, f32 gain, f32 gainStep, BusLevels& levels)
+		{
+			const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+			const __m128 laneFrames = _mm_setr_ps(0.0f, 0.0f, 1.0f, 1.0f);
+			const __m128 step = _mm_set1_ps(gainStep);
+
+			__m128 peak = _mm_setzero_ps();
+			__m128 sumOfSquares = _mm_setzero_ps();
+
+			// NOTE: Two frames per vector, the gain is recomputed from the frame index so that the ramp doesn't drift
+			size_t i = 0;
+			for (; i + 2 <= frameCount; i += 2)
+			{
+				__m128 frameGain = _mm_add_ps(_mm_set1_ps(gain + gainStep * static_cast<f32>(i)), _mm_mul_ps(laneFrames, step));
+				__m128 samples = _mm_mul_ps(_mm_loadu_ps(&src[i * 2]), frameGain);
+
+				_mm_storeu_ps(&dst[i * 2], _mm_add_ps(_mm_loadu_ps(&dst[i * 2]), samples));
+
+				peak = _mm_max_ps(peak, _mm_and_ps(samples, absMask));
+				sumOfSquares = _mm_add_ps(sumOfSquares, _mm_mul_ps(samples, samples));
+			}
+
+			alignas(16) f32 peakLanes[4];
+			alignas(16) f32 sumLanes[4];
+			_mm_store_ps(peakLanes, peak);
+			_mm_store_ps(sumLanes, sumOfSquares);
+			MergeBusLevels(levels, peakLanes, sumLanes, 4);
+
+			Scalar::AccumulateBus(&dst[i * 2], &src[i * 2], frameCount - i, gain + gainStep * static_cast<f32>(i), gainStep, levels);
+		}
+
+		static void ClampCopy(f32* dst, const f32* src, size_t sampleCount)
+		{
+			const __m128 minValue = _mm_set1_ps(-1.0f);
+			const __m128 maxValue = _mm_set1_ps(1.0f);
+
+			size_t i = 0;
+			for (; i + 4 <= sampleCount; i += 4)
+			{
+				_mm_storeu_ps(&dst[i], _mm_min_ps(_mm_max_ps(_mm_loadu_ps(&src[i]), minValue), maxValue));
+			}
+
+			Scalar::ClampCopy(&dst[i], &src[i], sampleCount - i);
+		}
+	}
+
+	namespace AVX2
+	{
+		STARSHINE_TARGET_AVX2 static void AccumulateMono(f32* dst, const i16* src, size_t frameCount, f32 volume)
+		{
+			const __m256 gain = _mm256_set1_ps(volume * I16ToF32Scale);
+
+			size_t i = 0;
+			for (; i + 8 <= frameCount; i += 8)
+			{
+				__m256i samples = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&src[i])));
+				__m256 mixed = _mm256_mul_ps(_mm256_cvtepi32_ps(samples), gain);
+
+				// NOTE: unpack works within 128-bit lanes: lo = [0 0 1 1 | 4 4 5 5], hi = [2 2 3 3 | 6 6 7 7]
+				__m256 lo = _mm256_unpacklo_ps(mixed, mixed);
+				__m256 hi = _mm256_unpackhi_ps(mixed, mixed);
+
+				f32* out = &dst[i * 2];
+				_mm256_storeu_ps(&out[0], _mm256_add_ps(_mm256_loadu_ps(&out[0]), _mm256_permute2f128_ps(lo, hi, 0x20)));
+				_mm256_storeu_ps(&out[8], _mm256_add_ps(_mm256_loadu_ps(&out[8]), _mm256_permute2f128_ps(lo, hi, 0x31)));
+			}
+
+			_mm256_zeroupper();
+			Scalar::AccumulateMono(&dst[i * 2], &src[i], frameCount - i, volume);
+		}
+
+		STARSHINE_TARGET_AVX2 static void AccumulateStereo(f32* dst, const i16* src, size_t frameCount, f32 volume)
+		{
+			const __m256 gain = _mm256_set1_ps(volume * I16ToF32Scale);
+			const size_t sampleCount = frameCount * 2;
+
+			size_t i = 0;
+			for (; i + 16 <= sampleCount; i += 16)
+			{
+				__m256i lo = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&src[i + 0])));
+				__m256i hi = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&src[i + 8])));
+
+				_mm256_storeu_ps(&dst[i + 0], _mm256_add_ps(_mm256_loadu_ps(&dst[i + 0]), _mm256_mul_ps(_mm256_cvtepi32_ps(lo), gain)));
+				_mm256_storeu_ps(&dst[i + 8], _mm256_add_ps(_mm256_loadu_ps(&dst[i + 8]), _mm256_mul_ps(_mm256_cvtepi32_ps(hi), gain)));
+			}
+
+			_mm256_zeroupper();
+			Scalar::AccumulateStereo(&dst[i], &src[i], (sampleCount - i) / 2, volume);
+		}
+
+		STARSHINE_TARGET_AVX2 static void AccumulateBus(f32* dst, const f32* src, size_t frameCount, f32 gain, f32 gainStep, BusLevels& levels)
+		{
+			const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+			const __m256 laneFrames = _mm256_setr_ps(0.0f, 0.0f, 1.0f, 1.0f, 2.0f, 2.0f, 3.0f, 3.0f);
+			const __m256 step = _mm256_set1_ps(gainStep);
+
+			__m256 peak = _mm256_setzero_ps();
+			__m256 sumOfSquares = _mm256_setzero_ps();
+
+			size_t i = 0;
+			for (; i + 4 <= frameCount; i += 4)
+			{
+				__m256 frameGain = _mm256_add_ps(_mm256_set1_ps(gain + gainStep * static_cast<f32>(i)), _mm256_mul_ps(laneFrames, step));
+				__m256 samples = _mm256_mul_ps(_mm256_loadu_ps(&src[i * 2]), frameGain);
+
+				_mm256_storeu_ps(&dst[i * 2], _mm256_add_ps(_mm256_loadu_ps(&dst[i * 2]), samples));
+
+				peak = _mm256_max_ps(peak, _mm256_and_ps(samples, absMask));
+				sumOfSquares = _mm256_add_ps(sumOfSquares, _mm256_mul_ps(samples, samples));
+			}
+
+			alignas(32) f32 peakLanes[8];
+			alignas(32) f32 sumLanes[8];
+			_mm256_store_ps(peakLanes, peak);
+			_mm256_store_ps(sumLanes, sumOfSquares);
+
+			_mm256_zeroupper();
+			SSE2::MergeBusLevels(levels, peakLanes, sumLanes, 8);
+
+			Scalar::AccumulateBus(&dst[i * 2], &src[i * 2], frameCount - i, gain + gainStep * static_cast<f32>(i), gainStep, levels);
+		}
+
+		STARSHINE_TARGET_AVX2 static void ClampCopy(f32* dst, const f32* src, size_t sampleCount)
+		{
+			const __m256 minValue = _mm256_set1_ps(-1.0f);
+			const __m256 maxValue = _mm256_set1_ps(1.0f);
+
+			size_t i = 0;
+			for (; i + 8 <= sampleCount; i += 8)
+			{
+				_mm256_storeu_ps(&dst[i], _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(&src[i]), minValue), maxValue));
+			}
+
+			_mm256_zeroupper();
+			Scalar::ClampCopy(&dst[i], &src[i], sampleCount - i);
+		}
+	}
+#endif
+
+	static const MixKernelTable KernelTables[EnumCount<InstructionSet>()]
+	{
+		{ Scalar::AccumulateMono, Scalar::AccumulateStereo, Scalar::AccumulateBus, Scalar::ClampCopy },
+#ifdef STARSHINE_MIXING_X86
+		{ SSE2::AccumulateMono, SSE2::AccumulateStereo, SSE2::AccumulateBus, SSE2::ClampCopy },
+		{ AVX2::AccumulateMono, AVX2::AccumulateStereo, AVX2::AccumulateBus, AVX2::ClampCopy },
+#else
+		{ Scalar::AccumulateMono, Scalar::AccumulateStereo, Scalar::AccumulateBus, Scalar::ClampCopy },
+		{ Scalar::AccumulateMono, Scalar::AccumulateStereo, Scalar::AccumulateBus, Scalar::ClampCopy },
+#endif
+	};
+
+	bool IsInstructionSetSupported(InstructionSet set)
+	{
+		switch (set)
+		{
+		case InstructionSet::Scalar:
+			return true;
+#ifdef STARSHINE_MIXING_X86
+		case InstructionSet::SSE2:
+			return SDL_HasSSE2() == SDL_TRUE;
+		case InstructionSet::AVX2:
+			return SDL_HasAVX2() == SDL_TRUE;
+#endif
+		default:
+			return false;
+		}
+	}
+
+	InstructionSet GetBestInstructionSet()
+	{
+		static const InstructionSet bestSet = []()
+		{
+			if (IsInstructionSetSupported(InstructionSet::AVX2)) { return InstructionSet::AVX2; }
+			if (IsInstructionSetSupported(InstructionSet::SSE2)) { return InstructionSet::SSE2; }
+			return InstructionSet::Scalar;
+		}();
+
+		return bestSet;
+	}
+
+	const MixKernelTable& GetMixKernels(InstructionSet set)
+	{
+		if (set >= InstructionSet::Count || !IsInstructionSetSupported(set))
+		{
+			return KernelTables[static_cast<size_t>(InstructionSet::Scalar)];
+		}
+
+		return KernelTables[static_cast<size_t>(set)];
+	}
+
+	const MixKernelTable& GetMixKernels()
+	{
+		return KernelTables[static_cast<size_t>(GetBestInstructionSet())];
+	}
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "Common/Types.h"
+#include <array>
+#include <limits>
+
+namespace Starshine::Audio::Mixing
+{
+	constexpr f32 I16ToF32Scale = 1.0f / static_cast<f32>(std::numeric_limits<i16>::max());
+
+	enum class InstructionSet : u8
+	{
+		Scalar,
+		SSE2,
+		AVX2,
+
+		Count
+	};
+
+	constexpr EnumStringMappingTable<InstructionSet> InstructionSetStringTable
+	{
+		EnumStringMapping<InstructionSet>
+		{ InstructionSet::Scalar, "Scalar" },
+		{ InstructionSet::SSE2, "SSE2" },
+		{ InstructionSet::AVX2, "AVX2" }
+	};
+
+	// NOTE: Per-channel peak and sum of squares of everything that went through "AccumulateBus", used for bus metering
+	struct BusLevels
+	{
+		std::array<f32, 2> Peak{};
+		std::array<f32, 2> SumOfSquares{};
+	};
+
+	// NOTE: All "Accumulate" kernels convert 16-bit PCM samples to mixing samples, apply the volume
+	//		 and add the result to an interleaved stereo mixing buffer. 'frameCount' is the amount of source frames.
+	//		 None of them clamp the output, the mixer is expected to call "ClampCopy" once after all voices have been mixed.
+	struct MixKernelTable
+	{
+		void (*AccumulateMono)(f32* dst, const i16* src, size_t frameCount, f32 volume);
+		void (*AccumulateStereo)(f32* dst, const i16* src, size_t frameCount, f32 volume);
+
+		// NOTE: Adds 'frameCount' interleaved stereo mixing frames of a bus to 'dst'. The gain starts at 'gain' and changes by 'gainStep' every frame.
+		//		 The levels of the scaled frames are added to 'levels'
+		void (*AccumulateBus)(f32* dst, const f32* src, size_t frameCount, f32 gain, f32 gainStep, BusLevels& levels);
+
+		// NOTE: Clamps 'sampleCount' mixing samples from 'src' to [-1.0; 1.0] and writes them to 'dst' ('dst' may be equal to 'src')
+		void (*ClampCopy)(f32* dst, const f32* src, size_t sampleCount);
+	};
+
+	bool IsInstructionSetSupported(InstructionSet set);
+	InstructionSet GetBestInstructionSet();
+
+	// NOTE: Falls back to the scalar kernels if the requested instruction set is not supported by the CPU
+	const MixKernelTable& GetMixKernels(InstructionSet set);
+	const MixKernelTable& GetMixKernels();
+}
@@ -0,0 +1,328 @@
+#include "Resampler.h"
+#include "SIMD.h"
+#include <math.h>
+
+namespace Starshine::Audio::Mixing
+{
+	constexpr f64 Pi = 3.14159265358979323846;
+
+	constexpr u32 LinearPhaseCount = 256;
+	constexpr u32 SincPhaseCount = 512;
+
+	u32 GetTapCount(ResamplerQuality quality)
+	{
+		switch (quality)
+		{
+		case ResamplerQuality::Linear: return 2;
+		case ResamplerQuality::Low: return 8;
+		case ResamplerQuality::Medium: return 16;
+		case ResamplerQuality::High: return MaxTapCount;
+		default: return 2;
+		}
+	}
+
+	// NOTE: Fraction of the Nyquist frequency that is kept, shorter filters need a wider transition band
+	static f64 GetCutoffRolloff(ResamplerQuality quality)
+	{
+		switch (quality)
+		{
+		case ResamplerQuality::Low: return 0.85;
+		case ResamplerQuality::Medium: return 0.90;
+		case ResamplerQuality::High: return 0.95;
+		default: return 1.0;
+		}
+	}
+
+	static f64 Sinc(f64 x)
+	{
+		return (x == 0.0) ? 1.0 : (sin(Pi * x) / (Pi * x));
+	}
+
+	static f64 BlackmanWindow(f64 x)
+	{
+		return (fabs(x) >= 1.0) ? 0.0 : (0.42 + 0.5 * cos(Pi * x) + 0.08 * cos(2.0 * Pi * x));
+	}
+
+	static void BuildFilterBank(FilterBank& bank, ResamplerQuality quality, f64 cutoff)
+	{
+		bank.TapCount = GetTapCount(quality);
+		bank.PhaseCount = (quality == ResamplerQuality::Linear) ? LinearPhaseCount : SincPhaseCount;
+
+		// NOTE: One extra phase for fractions that round up to the next source frame
+		bank.Coefficients.resize(static_cast<size_t>(bank.PhaseCount + 1) * bank.TapCount);
+
+		const f64 halfWidth = static_cast<f64>(bank.TapCount) / 2.0;
+		const f64 tapOffset = halfWidth - 1.0;
+
+		for (u32 phase = 0; phase <= bank.PhaseCount; phase++)
+		{
+			const f64 fraction = static_cast<f64>(phase) / static_cast<f64>(bank.PhaseCount);
+			f32* coefficients = &bank.Coefficients[static_cast<size_t>(phase) * bank.TapCount];
+
+			f64 sum = 0.0;
+			for (u32 tap = 0; tap < bank.TapCount; tap++)
+			{
+				// NOTE: Distance between the source frame of this tap and the output position
+				const f64 x = static_cast<f64>(tap) - tapOffset - fraction;
+
+				f64 weight = 0.0;
+				if (quality == ResamplerQuality::Linear)
+				{
+					weight = (fabs(x) < 1.0) ? (1.0 - fabs(x)) : 0.0;
+				}
+				else
+				{
+					weight = cutoff * Sinc(cutoff * x) * BlackmanWindow(x / halfWidth);
+				}
+
+				coefficients[tap] = static_cast<f32>(weight);
+				sum += weight;
+			}
+
+			// NOTE: Normalize every phase to unity gain so that DC doesn't ripple with the fractional position
+			for (u32 tap = 0; tap < bank.TapCount; tap++)
+			{
+				coefficients[tap] = static_cast<f32>(static_cast<f64>(coefficients[tap]) / sum);
+			}
+		}
+	}
+
+	FilterBankSet::FilterBankSet(ResamplerQuality quality) : quality(quality)
+	{
+		for (size_t i = 0; i < filterBanks.size(); i++)
+		{
+			BuildFilterBank(filterBanks[i], quality, GetCutoffRolloff(quality) / StepThresholds[i]);
+		}
+	}
+
+	const FilterBank& FilterBankSet::GetFilterBank(f64 step) const
+	{
+		for (size_t i = 0; i < filterBanks.size(); i++)
+		{
+			if (step <= StepThresholds[i])
+			{
+				return filterBanks[i];
+			}
+		}
+
+		return filterBanks.back();
+	}
+
+	namespace Scalar
+	{
+		static f32 Convolve(const f32* coefficients, const f32* samples, u32 tapCount)
+		{
+			f32 sum = 0.0f;
+			for (u32 tap = 0; tap < tapCount; tap++)
+			{
+				sum += coefficients[tap] * samples[tap];
+			}
+			return sum;
+		}
+
+		static void ResampleMono(f32* dst, const f32* src, const FilterBank& bank, f64 position, f64 step, size_t frameCount, f32 volume)
+		{
+			const ptrdiff_t tapOffset = static_cast<ptrdiff_t>(bank.TapCount / 2) - 1;
+
+			for (size_t i = 0; i < frameCount; i++)
+			{
+				const f64 framePosition = position + static_cast<f64>(i) * step;
+				const f64 baseFrame = floor(framePosition);
+				const f32* coefficients = bank.GetPhase(framePosition - baseFrame);
+				const ptrdiff_t firstFrame = static_cast<ptrdiff_t>(baseFrame) - tapOffset;
+
+				const f32 sample = Convolve(coefficients, &src[firstFrame], bank.TapCount) * volume;
+				dst[i * 2 + 0] += sample;
+				dst[i * 2 + 1] += sample;
+			}
+		}
+
+		static void ResampleStereo(f32* dst, const f32* left, const f32* right, const FilterBank& bank, f64 position, f64 step, size_t frameCount, f32 volume)
+		{
+			const ptrdiff_t tapOffset = static_cast<ptrdiff_t>(bank.TapCount / 2) - 1;
+
+			for (size_t i = 0; i < frameCount; i++)
+			{
+				const f64 framePosition = position + static_cast<f64>(i) * step;
+				const f64 baseFrame = floor(framePosition);
+				const f32* coefficients = bank.GetPhase(framePosition - baseFrame);
+				const ptrdiff_t firstFrame = static_cast<ptrdiff_t>(baseFrame) - tapOffset;
+
+				dst[i * 2 + 0] += Convolve(coefficients, &left[firstFrame], bank.TapCount) * volume;
+				dst[i * 2 + 1] += Convolve(coefficients, &right[firstFrame], bank.TapCount) * volume;
+			}
+		}
+	}
+
+#ifdef STARSHINE_MIXING_X86
+	namespace SSE2
+	{
+		static inline f32 HorizontalSum(__m128 value)
+		{
+			__m128 shuffled = _mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 3, 0, 1));
+			__m128 sums = _mm_add_ps(value, shuffled);
+			shuffled = _mm_movehl_ps(shuffled, sums);
+			return _mm_cvtss_f32(_mm_add_ss(sums, shuffled));
+		}
+
+		static void ResampleMono(f32* dst, const f32* src, const FilterBank& bank, f64 position, f64 step, size_t frameCount, f32 volume)
+		{
+			if (bank.TapCount % 4 != 0)
+			{
+				Scalar::ResampleMono(dst, src, bank, position, step, frameCount, volume);
+				return;
+			}
+
+			const ptrdiff_t tapOffset = static_cast<ptrdiff_t>(bank.TapCount / 2) - 1;
+
+			for (size_t i = 0; i < frameCount; i++)
+			{
+				const f64 framePosition = position + static_cast<f64>(i) * step;
+				const f64 baseFrame = floor(framePosition);
+				const f32* coefficients = bank.GetPhase(framePosition - baseFrame);
+				const f32* samples = &src[static_cast<ptrdiff_t>(baseFrame) - tapOffset];
+
+				__m128 sum = _mm_setzero_ps();
+				for (u32 tap = 0; tap < bank.TapCount; tap += 4)
+				{
+					sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(&coefficients[tap]), _mm_loadu_ps(&samples[tap])));
+				}
+
+				const f32 sample = HorizontalSum(sum) * volume;
+				dst[i * 2 + 0] += sample;
+				dst[i * 2 + 1] += sample;
+			}
+		}
+
+		static void ResampleStereo(f32* dst, const f32* left, const f32* right, const FilterBank& bank, f64 position, f64 step, size_t frameCount, f32 volume)
+		{
+			if (bank.TapCount % 4 != 0)
+			{
+				Scalar::ResampleStereo(dst, left, right, bank, position, step, frameCount, volume);
+				return;
+			}
+
+			const ptrdiff_t tapOffset = static_cast<ptrdiff_t>(bank.TapCount / 2) - 1;
+
+			for (size_t i = 0; i < frameCount; i++)
+			{
+				const f64 framePosition = position + static_cast<f64>(i) * step;
+				const f64 baseFrame = floor(framePosition);
+				const f32* coefficients = bank.GetPhase(framePosition - baseFrame);
+				const ptrdiff_t firstFrame = static_cast<ptrdiff_t>(baseFrame) - tapOffset;
+
+				__m128 sumLeft = _mm_setzero_ps();
+				__m128 sumRight = _mm_setzero_ps();
+				for (u32 tap = 0; tap < bank.TapCount; tap += 4)
+				{
+					const __m128 weights = _mm_loadu_ps(&coefficients[tap]);
+					sumLeft = _mm_add_ps(sumLeft, _mm_mul_ps(weights, _mm_loadu_ps(&left[firstFrame + tap])));
+					sumRight = _mm_add_ps(sumRight, _mm_mul_ps(weights, _mm_loadu_ps(&right[firstFrame + tap])));
+				}
+
+				dst[i * 2 + 0] += HorizontalSum(sumLeft) * volume;
+				dst[i * 2 + 1] += HorizontalSum(sumRight) * volume;
+			}
+		}
+	}
+
+	namespace AVX2
+	{
+		STARSHINE_TARGET_AVX2 static inline f32 HorizontalSum(__m256 value)
+		{
+			return SSE2::HorizontalSum(_mm_add_ps(_mm256_castps256_ps128(value), _mm256_extractf128_ps(value, 1)));
+		}
+
+		STARSHINE_TARGET_AVX2 static void ResampleMono(f32* dst, const f32* src, const FilterBank& bank, f64 position, f64 step, size_t frameCount, f32 volume)
+		{
+			if (bank.TapCount % 8 != 0)
+			{
+				SSE2::ResampleMono(dst, src, bank, position, step, frameCount, volume);
+				return;
+			}
+
+			const ptrdiff_t tapOffset = static_cast<ptrdiff_t>(bank.TapCount / 2) - 1;
+
+			for (size_t i = 0; i < frameCount; i++)
+			{
+				const f64 framePosition = position + static_cast<f64>(i) * step;
+				const f64 baseFrame = floor(framePosition);
+				const f32* coefficients = bank.GetPhase(framePosition - baseFrame);
+				const f32* samples = &src[static_cast<ptrdiff_t>(baseFrame) - tapOffset];
+
+				__m256 sum = _mm256_setzero_ps();
+				for (u32 tap = 0; tap < bank.TapCount; tap += 8)
+				{
+					sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(&coefficients[tap]), _mm256_loadu_ps(&samples[tap])));
+				}
+
+				const f32 sample = HorizontalSum(sum) * volume;
+				dst[i * 2 + 0] += sample;
+				dst[i * 2 + 1] += sample;
+			}
+
+			_mm256_zeroupper();
+		}
+
+		STARSHINE_TARGET_AVX2 static void ResampleStereo(f32* dst, const f32* left, const f32* right, const FilterBank& bank, f64 position, f64 step, size_t frameCount, f32 volume)
+		{
+			if (bank.TapCount % 8 != 0)
+			{
+				SSE2::ResampleStereo(dst, left, right, bank, position, step, frameCount, volume);
+				return;
+			}
+
+			const ptrdiff_t tapOffset = static_cast<ptrdiff_t>(bank.TapCount / 2) - 1;
+
+			for (size_t i = 0; i < frameCount; i++)
+			{
+				const f64 framePosition = position + static_cast<f64>(i) * step;
+				const f64 baseFrame = floor(framePosition);
+				const f32* coefficients = bank.GetPhase(framePosition - baseFrame);
+				const ptrdiff_t firstFrame = static_cast<ptrdiff_t>(baseFrame) - tapOffset;
+
+				__m256 sumLeft = _mm256_setzero_ps();
+				__m256 sumRight = _mm256_setzero_ps();
+				for (u32 tap = 0; tap < bank.TapCount; tap += 8)
+				{
+					const __m256 weights = _mm256_loadu_ps(&coefficients[tap]);
+					sumLeft = _mm256_add_ps(sumLeft, _mm256_mul_ps(weights, _mm256_loadu_ps(&left[firstFrame + tap])));
+					sumRight = _mm256_add_ps(sumRight, _mm256_mul_ps(weights, _mm256_loadu_ps(&right[firstFrame + tap])));
+				}
+
+				dst[i * 2 + 0] += HorizontalSum(sumLeft) * volume;
+				dst[i * 2 + 1] += HorizontalSum(sumRight) * volume;
+			}
+
+			_mm256_zeroupper();
+		}
+	}
+#endif
+
+	static const ResampleKernelTable KernelTables[EnumCount<InstructionSet>()]
+	{
+		{ Scalar::ResampleMono, Scalar::ResampleStereo },
+#ifdef STARSHINE_MIXING_X86
+		{ SSE2::ResampleMono, SSE2::ResampleStereo },
+		{ AVX2::ResampleMono, AVX2::ResampleStereo },
+#else
+		{ Scalar::ResampleMono, Scalar::ResampleStereo },
+		{ Scalar::ResampleMono, Scalar::ResampleStereo },
+#endif
+	};
+
+	const ResampleKernelTable& GetResampleKernels(InstructionSet set)
+	{
+		if (set >= InstructionSet::Count || !IsInstructionSetSupported(set))
+		{
+			return KernelTables[static_cast<size_t>(InstructionSet::Scalar)];
+		}
+
+		return KernelTables[static_cast<size_t>(set)];
+	}
+
+	const ResampleKernelTable& GetResampleKernels()
+	{
+		return KernelTables[static_cast<size_t>(GetBestInstructionSet())];
+	}
+}
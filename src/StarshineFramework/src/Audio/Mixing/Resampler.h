@@ -0,0 +1,97 @@
+#pragma once
+#include "Common/Types.h"
+#include "MixKernels.h"
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace Starshine::Audio::Mixing
+{
+	enum class ResamplerQuality : u8
+	{
+		Linear,
+		Low,
+		Medium,
+		High,
+
+		Count
+	};
+
+	constexpr EnumStringMappingTable<ResamplerQuality> ResamplerQualityStringTable
+	{
+		EnumStringMapping<ResamplerQuality>
+		{ ResamplerQuality::Linear, "Linear" },
+		{ ResamplerQuality::Low, "Low" },
+		{ ResamplerQuality::Medium, "Medium" },
+		{ ResamplerQuality::High, "High" }
+	};
+
+	// NOTE: Tap count of the most expensive preset, every voice keeps this many frames of history so that presets can be switched at any time
+	constexpr u32 MaxTapCount = 32;
+
+	// NOTE: Upper limit for the amount of source frames consumed per output frame (e.g. a 96 kHz source played at twice the speed on a 48 kHz device)
+	constexpr u32 MaxResampleStep = 4;
+
+	u32 GetTapCount(ResamplerQuality quality);
+
+	// NOTE: Windowed-sinc coefficients for every fractional position between two source frames ("phases").
+	//		 Each phase holds 'TapCount' coefficients that are applied to the frames [i - TapCount / 2 + 1; i + TapCount / 2] for an output at i + fraction.
+	struct FilterBank
+	{
+		u32 TapCount{};
+		u32 PhaseCount{};
+		std::vector<f32> Coefficients;
+
+		inline const f32* GetPhase(f64 fraction) const
+		{
+			return &Coefficients[static_cast<size_t>(fraction * static_cast<f64>(PhaseCount) + 0.5) * TapCount];
+		}
+	};
+
+	// NOTE: One filter bank per cutoff frequency, a voice that skips source frames (step > 1) needs a lower cutoff to avoid aliasing
+	class FilterBankSet : NonCopyable
+	{
+	public:
+		FilterBankSet(ResamplerQuality quality);
+		~FilterBankSet() = default;
+
+	public:
+		const FilterBank& GetFilterBank(f64 step) const;
+		ResamplerQuality GetQuality() const { return quality; }
+
+	private:
+		static constexpr std::array<f64, 6> StepThresholds { 1.0, 1.25, 1.5, 2.0, 3.0, static_cast<f64>(MaxResampleStep) };
+
+		ResamplerQuality quality{};
+		std::array<FilterBank, StepThresholds.size()> filterBanks;
+	};
+
+	// NOTE: Per-voice resampler state, owned by the audio thread
+	struct ResamplerState
+	{
+		// NOTE: The last 'MaxTapCount' source frames per channel, oldest first
+		std::array<std::array<f32, MaxTapCount>, 2> History{};
+
+		// NOTE: Position of the next output frame relative to the next source frame that will be read (0 or negative once resampling)
+		f64 Position{};
+
+		// NOTE: Set once the voice has been resampled. From then on the read position is ahead of the output
+		//		 and the voice keeps using the resampler until it is moved to a new position.
+		bool Active{};
+
+		void Reset() { *this = ResamplerState {}; }
+	};
+
+	// NOTE: The "Resample" kernels read planar mixing samples around 'position + i * step' for every output frame 'i',
+	//		 apply the volume and add the result to an interleaved stereo mixing buffer.
+	//		 'src' has to be readable from [floor(position) - TapCount / 2 + 1] up to [floor(position + (frameCount - 1) * step) + TapCount / 2].
+	struct ResampleKernelTable
+	{
+		void (*ResampleMono)(f32* dst, const f32* src, const FilterBank& bank, f64 position, f64 step, size_t frameCount, f32 volume);
+		void (*ResampleStereo)(f32* dst, const f32* left, const f32* right, const FilterBank& bank, f64 position, f64 step, size_t frameCount, f32 volume);
+	};
+
+	// NOTE: Falls back to the scalar kernels if the requested instruction set is not supported by the CPU
+	const ResampleKernelTable& GetResampleKernels(InstructionSet set);
+	const ResampleKernelTable& GetResampleKernels();
+}
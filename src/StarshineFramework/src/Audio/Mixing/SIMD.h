@@ -0,0 +1,13 @@
+#pragma once
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define STARSHINE_MIXING_X86
+#include <immintrin.h>
+#endif
+
+// NOTE: MSVC allows using AVX2 intrinsics without any special compiler flags, GCC and Clang need a per-function target instead
+#if defined(__GNUC__) || defined(__clang__)
+#define STARSHINE_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define STARSHINE_TARGET_AVX2
+#endif
@@ -0,0 +1,153 @@
+#include "AdpcmSampleProvider.h"
+#include "Audio/Mixing/AdpcmCodec.h"
+#include <SDL2/SDL_stdinc.h>
+#include <algorithm>
+#include <array>
+#include <vector>
+
+namespace Starshine::Audio
+{
+	// NOTE: Sources are read and encoded in pieces, so encoding never needs a second decoded copy of the whole source
+	constexpr size_t EncodeChunkFrames = Mixing::AdpcmBlockFrames * 64;
+
+	// NOTE: Enough frame blocks to cover a whole buffer of the default size in one call, which keeps the decoder's lanes busy
+	constexpr size_t DecodeChunkFrameBlocks = 9;
+
+	AdpcmSampleProvider::AdpcmSampleProvider(ISampleProvider& source)
+	{
+		const u32 sourceChannels = source.GetChannelCount();
+		const size_t sourceFrames = (sourceChannels > 0) ? source.GetSampleAmount() / sourceChannels : 0;
+
+		if (source.IsStreamingOnly() || sourceChannels < 1 || sourceChannels > 2 || sourceFrames == 0)
+		{
+			return;
+		}
+
+		channels = sourceChannels;
+		sampleRate = source.GetSampleRate();
+		sampleCount = sourceFrames * channels;
+		loopStart_frames = source.GetLoopStart_Frames();
+		loopEnd_frames = source.GetLoopEnd_Frames();
+
+		blockDataSize = Mixing::GetAdpcmFrameBlockCount(sourceFrames) * channels * Mixing::AdpcmBlockSize;
+		blockData = std::make_unique<u8[]>(blockDataSize);
+
+		std::array<Mixing::AdpcmChannelState, 2> states{};
+		std::vector<i16> chunk(EncodeChunkFrames * channels);
+
+		for (size_t frame = 0; frame < sourceFrames; frame += EncodeChunkFrames)
+		{
+			const size_t chunkFrames = SDL_min(sourceFrames - frame, EncodeChunkFrames);
+			const size_t readSamples = source.ReadSamples(chunk.data(), frame * channels, chunkFrames * channels);
+			std::fill(chunk.begin() + readSamples, chunk.end(), static_cast<i16>(0));
+
+			const size_t frameBlock = frame / Mixing::AdpcmBlockFrames;
+			Mixing::EncodeAdpcm(&blockData[frameBlock * channels * Mixing::AdpcmBlockSize], chunk.data(), chunkFrames, channels, states.data());
+		}
+	}
+
+	AdpcmSampleProvider::~AdpcmSampleProvider()
+	{
+		Destroy();
+	}
+
+	void AdpcmSampleProvider::Destroy()
+	{
+		blockData = nullptr;
+		blockDataSize = 0;
+		sampleCount = 0;
+		samplePosition = 0;
+	}
+
+	bool AdpcmSampleProvider::IsStreamingOnly() const
+	{
+		return false;
+	}
+
+	u32 AdpcmSampleProvider::GetChannelCount() const
+	{
+		return channels;
+	}
+
+	u32 AdpcmSampleProvider::GetSampleRate() const
+	{
+		return sampleRate;
+	}
+
+	size_t AdpcmSampleProvider::GetSampleAmount() const
+	{
+		return sampleCount;
+	}
+
+	size_t AdpcmSampleProvider::GetLoopStart_Frames() const
+	{
+		return loopStart_frames;
+	}
+
+	size_t AdpcmSampleProvider::GetLoopEnd_Frames() const
+	{
+		return loopEnd_frames;
+	}
+
+	size_t AdpcmSampleProvider::ReadSamples(i16* dstBuffer, size_t offset, size_t size)
+	{
+		if (offset >= sampleCount)
+		{
+			return 0;
+		}
+
+		const Mixing::AdpcmKernelTable& kernels = Mixing::GetAdpcmKernels();
+		const size_t frameBlockSamples = Mixing::AdpcmBlockFrames * channels;
+		const size_t samplesToRead = SDL_min(sampleCount - offset, size);
+
+		// NOTE: Reads rarely start or end on a block boundary, so the touched blocks are decoded into a local buffer first
+		std::array<i16, DecodeChunkFrameBlocks * Mixing::AdpcmBlockFrames * 2> decodedSamples;
+
+		size_t readSamples = 0;
+		while (readSamples < samplesToRead)
+		{
+			const size_t remainingSamples = samplesToRead - readSamples;
+			const size_t firstFrameBlock = (offset + readSamples) / frameBlockSamples;
+			const size_t blockOffset = (offset + readSamples) % frameBlockSamples;
+
+			const size_t frameBlockCount = SDL_min((blockOffset + remainingSamples + frameBlockSamples - 1) / frameBlockSamples, DecodeChunkFrameBlocks);
+			kernels.DecodeFrameBlocks(decodedSamples.data(), &blockData[firstFrameBlock * channels * Mixing::AdpcmBlockSize], frameBlockCount, channels);
+
+			const size_t copiedSamples = SDL_min(frameBlockCount * frameBlockSamples - blockOffset, remainingSamples);
+			SDL_memcpy(&dstBuffer[readSamples], &decodedSamples[blockOffset], copiedSamples * sizeof(i16));
+			readSamples += copiedSamples;
+		}
+
+		return samplesToRead;
+	}
+
+	f32 AdpcmSampleProvider::GetBufferFillLevel() const
+	{
+		return 1.0f;
+	}
+
+	size_t AdpcmSampleProvider::GetMemorySize() const
+	{
+		return blockDataSize;
+	}
+
+	size_t AdpcmSampleProvider::GetSamplePosition() const
+	{
+		return samplePosition;
+	}
+
+	size_t AdpcmSampleProvider::GetNextSamples(i16* dstBuffer, size_t size)
+	{
+		size_t readSamples = ReadSamples(dstBuffer, samplePosition, size);
+		samplePosition += readSamples;
+		return readSamples;
+	}
+
+	void AdpcmSampleProvider::Seek(size_t samplePosition)
+	{
+		if (samplePosition < sampleCount)
+		{
+			this->samplePosition = samplePosition;
+		}
+	}
+}
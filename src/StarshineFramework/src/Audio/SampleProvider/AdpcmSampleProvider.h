@@ -0,0 +1,48 @@
+#pragma once
+#include "ISampleProvider.h"
+#include <memory>
+
+namespace Starshine::Audio
+{
+	// NOTE: Keeps a source in memory as IMA-ADPCM blocks (see Mixing/AdpcmCodec.h), about a quarter of the size of 16-bit PCM.
+	//		 Reads decode the blocks they touch with the vectorized decoder, there is no decoded copy of the source
+	class AdpcmSampleProvider : public ISampleProvider, NonCopyable
+	{
+	public:
+		// NOTE: Encodes every sample of a non-streaming source, including its format and loop points
+		AdpcmSampleProvider(ISampleProvider& source);
+		~AdpcmSampleProvider() override;
+
+		void Destroy();
+		bool IsStreamingOnly() const;
+
+		u32 GetChannelCount() const;
+		u32 GetSampleRate() const;
+		size_t GetSampleAmount() const;
+
+		size_t GetLoopStart_Frames() const;
+		size_t GetLoopEnd_Frames() const;
+
+		size_t ReadSamples(i16* dstBuffer, size_t offset, size_t size);
+		f32 GetBufferFillLevel() const;
+		size_t GetMemorySize() const;
+
+	public:
+		size_t GetSamplePosition() const;
+
+		size_t GetNextSamples(i16* dstBuffer, size_t size);
+		void Seek(size_t samplePosition);
+
+	private:
+		u32 channels{};
+		u32 sampleRate{};
+
+		size_t sampleCount{};
+		size_t blockDataSize{};
+		std::unique_ptr<u8[]> blockData{};
+
+		size_t samplePosition{};
+		size_t loopStart_frames{};
+		size_t loopEnd_frames{};
+	};
+}
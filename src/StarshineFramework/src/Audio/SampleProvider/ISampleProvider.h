@@ -20,6 +20,12 @@ namespace Starshine::Audio
 
 		virtual size_t ReadSamples(i16* dstBuffer, size_t offset, size_t size) = 0;
 
+		// NOTE: Fraction [0; 1] of the decode buffer that currently holds samples, sources without one are always full
+		virtual f32 GetBufferFillLevel() const = 0;
+
+		// NOTE: Bytes of sample data the source keeps in memory (decoded or compressed samples and decode buffers, not mapped files)
+		virtual size_t GetMemorySize() const = 0;
+
 	public:
 		virtual size_t GetSamplePosition() const = 0;
 
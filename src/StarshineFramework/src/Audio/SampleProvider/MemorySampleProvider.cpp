@@ -7,7 +7,7 @@ namespace Starshine::Audio
 	MemorySampleProvider::MemorySampleProvider(const i16* sampleData, size_t sampleCount) : sampleCount(sampleCount)
 	{
 		samples = std::make_unique<u16[]>(sampleCount);
-		std::copy(&sampleData[0], &sampleData[sampleCount - 1], samples.get());
+		std::copy(&sampleData[0], &sampleData[0] + sampleCount, samples.get());
 	}
 
 	MemorySampleProvider::~MemorySampleProvider()
@@ -63,6 +63,16 @@ namespace Starshine::Audio
 		return samplesToRead;
 	}
 
+	f32 MemorySampleProvider::GetBufferFillLevel() const
+	{
+		return 1.0f;
+	}
+
+	size_t MemorySampleProvider::GetMemorySize() const
+	{
+		return sampleCount * sizeof(i16);
+	}
+
 	size_t MemorySampleProvider::GetSamplePosition() const
 	{
 		return samplePosition;
@@ -24,6 +24,8 @@ namespace Starshine::Audio
 		size_t GetLoopEnd_Frames() const;
 
 		size_t ReadSamples(i16* dstBuffer, size_t offset, size_t size);
+		f32 GetBufferFillLevel() const;
+		size_t GetMemorySize() const;
 
 	public:
 		size_t GetSamplePosition() const;
@@ -1,23 +1,102 @@
 #include "StreamingSampleProvider.h"
+#include "Audio/Decoding/OggSeekIndex.h"
 #include <vorbis/vorbisfile.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "Common/SPSCRingBuffer.h"
 #include "Common/Logging/Logging.h"
+#include "IO/MemoryMappedFile.h"
+#include <string.h>
 
 namespace Starshine::Audio
 {
 	namespace Vorbisfile
 	{
+		static constexpr size_t ReadAheadSize = 32 * 1024;
+
+		// NOTE: Encoded input of the decoder, read directly by the vorbisfile callbacks.
+		//		 Either a view of memory that lives as long as the provider (a memory-mapped file or an owned copy)
+		//		 or a stream that is read through a small read-ahead buffer so that only the decoder state stays resident
 		struct DecoderState
 		{
-			std::unique_ptr<u8[]> EncodedData{};
+			const u8* EncodedData{};
 			size_t EncodedDataSize{};
 			size_t EncodedPosition{};
+
+			std::unique_ptr<u8[]> OwnedData{};
+			IO::MemoryMappedFile MappedFile{};
+
+			std::unique_ptr<IO::IStream> Stream{};
+			std::unique_ptr<u8[]> ReadAhead{};
+			size_t ReadAheadStart{};
+			size_t ReadAheadFilled{};
 		};
 
+		static size_t ReadFromStream(DecoderState& state, u8* dst, size_t size)
+		{
+			size_t totalReadSize = 0;
+
+			while (totalReadSize < size)
+			{
+				size_t bufferOffset = state.EncodedPosition - state.ReadAheadStart;
+				if (state.EncodedPosition >= state.ReadAheadStart && bufferOffset < state.ReadAheadFilled)
+				{
+					size_t copySize = SDL_min(size - totalReadSize, state.ReadAheadFilled - bufferOffset);
+					memcpy(&dst[totalReadSize], &state.ReadAhead[bufferOffset], copySize);
+
+					state.EncodedPosition += copySize;
+					totalReadSize += copySize;
+					continue;
+				}
+
+				if (state.Stream->GetPosition() != state.EncodedPosition)
+				{
+					state.Stream->Seek(state.EncodedPosition);
+				}
+
+				state.ReadAheadStart = state.EncodedPosition;
+				state.ReadAheadFilled = state.Stream->ReadBuffer(state.ReadAhead.get(), ReadAheadSize);
+
+				if (state.ReadAheadFilled == 0)
+				{
+					break;
+				}
+			}
+
+			return totalReadSize;
+		}
+
+		// NOTE: Reads without moving the decoder's position, used to scan the page headers
+		static size_t ReadAt(DecoderState& state, size_t offset, void* dst, size_t size)
+		{
+			if (offset >= state.EncodedDataSize)
+			{
+				return 0;
+			}
+
+			size = SDL_min(size, state.EncodedDataSize - offset);
+
+			if (state.Stream != nullptr)
+			{
+				state.Stream->Seek(offset);
+				return state.Stream->ReadBuffer(dst, size);
+			}
+
+			memcpy(dst, &state.EncodedData[offset], size);
+			return size;
+		}
+
 		static size_t VF_Read(void* dst, size_t itemAmount, size_t itemSize, void* decoderState)
 		{
 			DecoderState* state = static_cast<DecoderState*>(decoderState);
 			size_t readSize = itemAmount * itemSize;
 
+			if (state->EncodedPosition >= state->EncodedDataSize)
+			{
+				return 0;
+			}
+
 			readSize = SDL_min(readSize, state->EncodedDataSize - state->EncodedPosition);
 
 			if (readSize == 0)
@@ -25,7 +104,12 @@ namespace Starshine::Audio
 				return 0;
 			}
 
-			std::copy(&state->EncodedData[state->EncodedPosition], &state->EncodedData[state->EncodedPosition + readSize], reinterpret_cast<u8*>(dst));
+			if (state->Stream != nullptr)
+			{
+				return ReadFromStream(*state, static_cast<u8*>(dst), readSize);
+			}
+
+			memcpy(dst, &state->EncodedData[state->EncodedPosition], readSize);
 			state->EncodedPosition += readSize;
 			return readSize;
 		}
@@ -33,20 +117,30 @@ namespace Starshine::Audio
 		static int VF_Seek(void* decoderState, ogg_int64_t offset, int dir)
 		{
 			DecoderState* state = static_cast<DecoderState*>(decoderState);
+
+			ogg_int64_t newPosition = 0;
 			switch (dir)
 			{
 			case SEEK_SET:
-				state->EncodedPosition = offset;
-				return 0;
+				newPosition = offset;
+				break;
 			case SEEK_CUR:
-				state->EncodedPosition += offset;
-				return 0;
+				newPosition = static_cast<ogg_int64_t>(state->EncodedPosition) + offset;
+				break;
 			case SEEK_END:
-				state->EncodedPosition = state->EncodedDataSize - offset - 1;
-				return 0;
+				newPosition = static_cast<ogg_int64_t>(state->EncodedDataSize) + offset;
+				break;
+			default:
+				return -1;
+			}
+
+			if (newPosition < 0 || newPosition > static_cast<ogg_int64_t>(state->EncodedDataSize))
+			{
+				return -1;
 			}
 
-			return -1;
+			state->EncodedPosition = static_cast<size_t>(newPosition);
+			return 0;
 		}
 
 		static int VF_Close(void* decoderState)
@@ -82,8 +176,13 @@ namespace Starshine::Audio
 	{
 		using DecoderState = Vorbisfile::DecoderState;
 
-		Impl() {}
-		~Impl() {}
+		static constexpr size_t DecodeChunkSampleCount = 2048;
+		static constexpr std::chrono::milliseconds DecodeThreadPollInterval { 5 };
+
+		Impl(const StreamingSettings& settings) : settings(settings) {}
+		~Impl() { Destroy(); }
+
+		StreamingSettings settings{};
 
 		u32 channels{};
 		u32 sampleRate{};
@@ -97,19 +196,81 @@ namespace Starshine::Audio
 		DecoderState state{};
 
 		OggVorbis_File ovFile{};
+		bool ovFileOpen{};
 		int currentBitstream{};
 
+		// NOTE: Only used by the thread that decodes
+		OggSeekIndex seekIndex{};
+
+		// NOTE: Decode thread state. The audio thread is the consumer of the ring buffer and the decode thread is the producer
+		std::unique_ptr<SPSCRingBuffer<i16>> decodedSamples{};
+		std::thread decodeThread{};
+		std::atomic<bool> stopDecodeThread{};
+
+		std::mutex decodeThreadMutex{};
+		std::condition_variable decodeThreadWakeup{};
+
+		// NOTE: Only used by the decode thread. Stream position of the next sample written to the ring buffer
+		size_t decodePosition{};
+
+		// NOTE: Written by the audio thread
+		std::atomic<size_t> requestedSeekPosition{};
+		std::atomic<u32> requestedSeekSerial{};
+
+		// NOTE: Written by the decode thread once it has seeked.
+		//		 Everything in the ring buffer before 'seekWriteIndex' belongs to the old position
+		std::atomic<size_t> seekWriteIndex{};
+		std::atomic<u32> handledSeekSerial{};
+
+		// NOTE: Audio thread state
+		u32 expectedSeekSerial{};
+		bool seekPending{};
+		bool preRolling{ true };
+
 		bool Initialize(const u8* encodedData, size_t encodedDataSize)
 		{
-			state.EncodedData = std::make_unique<u8[]>(encodedDataSize);
-			std::copy(&encodedData[0], &encodedData[encodedDataSize - 1], &state.EncodedData[0]);
+			state.OwnedData = std::make_unique<u8[]>(encodedDataSize);
+			std::copy(&encodedData[0], &encodedData[encodedDataSize], &state.OwnedData[0]);
+
+			state.EncodedData = state.OwnedData.get();
 			state.EncodedDataSize = encodedDataSize;
+			return OpenDecoder();
+		}
+
+		bool Initialize(IO::MemoryMappedFile&& mappedFile)
+		{
+			state.MappedFile = std::move(mappedFile);
+
+			state.EncodedData = state.MappedFile.GetData();
+			state.EncodedDataSize = state.MappedFile.GetSize();
+			return OpenDecoder();
+		}
+
+		bool Initialize(std::unique_ptr<IO::IStream> stream)
+		{
+			state.Stream = std::move(stream);
+			state.ReadAhead = std::make_unique<u8[]>(Vorbisfile::ReadAheadSize);
+
+			state.EncodedDataSize = state.Stream->GetSize();
+			state.ReadAheadStart = state.Stream->GetPosition();
+			state.EncodedPosition = state.ReadAheadStart;
+			return OpenDecoder();
+		}
+
+		bool OpenDecoder()
+		{
+			if (state.EncodedDataSize == 0)
+			{
+				return false;
+			}
 
 			if (ov_open_callbacks(&state, &ovFile, NULL, 0, Vorbisfile::VF_Callbacks) != 0)
 			{
 				return false;
 			}
 
+			ovFileOpen = true;
+
 			vorbis_info* info = ov_info(&ovFile, -1);
 			vorbis_comment* comments = ov_comment(&ovFile, -1);
 
@@ -141,16 +302,141 @@ namespace Starshine::Audio
 			sampleRate = info->rate;
 			sampleCount = ov_pcm_total(&ovFile, -1) * info->channels;
 
+			if (settings.BuildSeekIndex)
+			{
+				seekIndex.Build(state.EncodedDataSize, [this](size_t offset, void* dst, size_t size) { return Vorbisfile::ReadAt(state, offset, dst, size); });
+			}
+
+			if (settings.DecodeOnWorkerThread)
+			{
+				decodedSamples = std::make_unique<SPSCRingBuffer<i16>>(settings.BufferedFrames * channels);
+				decodeThread = std::thread([this]() { DecodeThreadLoop(); });
+			}
+
 			return true;
 		}
 
 		void Destroy()
 		{
-			ov_clear(&ovFile);
+			if (decodeThread.joinable())
+			{
+				stopDecodeThread.store(true, std::memory_order_release);
+				decodeThreadWakeup.notify_one();
+				decodeThread.join();
+			}
+
+			if (ovFileOpen)
+			{
+				ov_clear(&ovFile);
+				ovFileOpen = false;
+			}
+		}
+
+		// --- Decode thread
+
+		void DecodeThreadLoop()
+		{
+			std::array<i16, DecodeChunkSampleCount> chunk{};
+			bool endOfStream = false;
+
+			while (!stopDecodeThread.load(std::memory_order_acquire))
+			{
+				u32 seekSerial = requestedSeekSerial.load(std::memory_order_acquire);
+				if (seekSerial != handledSeekSerial.load(std::memory_order_relaxed))
+				{
+					decodePosition = requestedSeekPosition.load(std::memory_order_relaxed);
+					SeekDecoder(decodePosition / channels);
+					endOfStream = false;
+
+					seekWriteIndex.store(decodedSamples->GetWriteIndex(), std::memory_order_relaxed);
+					handledSeekSerial.store(seekSerial, std::memory_order_release);
+				}
+
+				if (!endOfStream && decodedSamples->GetFreeSpace() >= chunk.size())
+				{
+					// NOTE: Decoding continues at the loop start once the end has been reached, so that a looping voice never waits for a seek.
+					//		 The reader relies on every pass holding exactly the samples up to 'sampleCount' to wrap around in place
+					if (decodePosition >= sampleCount)
+					{
+						endOfStream = !WrapDecoderToLoopStart();
+						continue;
+					}
+
+					long readBytes = ov_read(&ovFile, reinterpret_cast<char*>(chunk.data()), static_cast<int>(chunk.size() * sizeof(i16)), 0, 2, 1, &currentBitstream);
+					size_t readSamples = (readBytes > 0) ? static_cast<size_t>(readBytes) / sizeof(i16) : 0;
+
+					// NOTE: A decoder that ends early is padded with silence to keep the ring buffer in sync with the stream positions
+					if (readSamples == 0)
+					{
+						readSamples = chunk.size();
+						chunk.fill(0);
+					}
+
+					readSamples = SDL_min(readSamples, sampleCount - decodePosition);
+					decodedSamples->Write(chunk.data(), readSamples);
+					decodePosition += readSamples;
+					continue;
+				}
+
+				std::unique_lock<std::mutex> lock(decodeThreadMutex);
+				decodeThreadWakeup.wait_for(lock, DecodeThreadPollInterval);
+			}
+		}
+
+		bool WrapDecoderToLoopStart()
+		{
+			const size_t loopStartPosition = loopStart_frames * channels;
+			if (loopStartPosition >= sampleCount)
+			{
+				return false;
+			}
+
+			SeekDecoder(loopStart_frames);
+			decodePosition = loopStartPosition;
+			return true;
+		}
+
+		// --- Audio thread
+
+		size_t ReadBufferedSamples(i16* dstBuffer, size_t size)
+		{
+			if (handledSeekSerial.load(std::memory_order_acquire) != expectedSeekSerial)
+			{
+				return 0;
+			}
+
+			if (seekPending)
+			{
+				decodedSamples->DiscardUntil(seekWriteIndex.load(std::memory_order_relaxed));
+				seekPending = false;
+				preRolling = true;
+			}
+
+			size_t remainingSamples = sampleCount - samplePosition;
+
+			if (preRolling)
+			{
+				size_t preRollSamples = SDL_min(settings.PreRollFrames * channels, remainingSamples);
+				if (decodedSamples->GetAvailable() < preRollSamples)
+				{
+					return 0;
+				}
+				preRolling = false;
+			}
+
+			size_t readSamples = decodedSamples->Read(dstBuffer, SDL_min(remainingSamples, size));
+			samplePosition += readSamples;
+
+			return readSamples;
 		}
 
 		size_t ReadNextSamples(i16* dstBuffer, size_t size)
 		{
+			if (decodedSamples != nullptr)
+			{
+				return ReadBufferedSamples(dstBuffer, size);
+			}
+
 			size_t remainingSamples = sampleCount - samplePosition;
 			size_t samplesToRead = SDL_min(remainingSamples, size);
 
@@ -165,6 +451,11 @@ namespace Starshine::Audio
 				while (remainingBytes > 0)
 				{
 					long readBytes = ov_read(&ovFile, &reinterpret_cast<char*>(dstBuffer)[copyOffset], remainingBytes, 0, 2, 1, &currentBitstream);
+					if (readBytes <= 0)
+					{
+						break;
+					}
+
 					copyOffset += readBytes;
 					totalReadBytes += readBytes;
 					remainingBytes -= readBytes;
@@ -180,20 +471,108 @@ namespace Starshine::Audio
 
 		void Seek(size_t position)
 		{
-			if (position < sampleCount)
+			if (position >= sampleCount)
+			{
+				return;
+			}
+
+			// NOTE: After the last sample has been read, the ring buffer already continues at the loop start
+			if (decodedSamples != nullptr && samplePosition >= sampleCount && position == loopStart_frames * channels)
 			{
-				ov_pcm_seek(&ovFile, position / channels);
 				samplePosition = position;
+				return;
+			}
+
+			samplePosition = position;
+
+			if (decodedSamples != nullptr)
+			{
+				requestedSeekPosition.store(position, std::memory_order_relaxed);
+				requestedSeekSerial.store(++expectedSeekSerial, std::memory_order_release);
+				seekPending = true;
+
+				decodeThreadWakeup.notify_one();
+				return;
 			}
+
+			SeekDecoder(position / channels);
+		}
+
+		// --- Thread that decodes
+
+		void SeekDecoder(size_t frame)
+		{
+			if (!SeekToIndexedPage(frame))
+			{
+				ov_pcm_seek(&ovFile, static_cast<ogg_int64_t>(frame));
+			}
+		}
+
+		bool SeekToIndexedPage(size_t frame)
+		{
+			// NOTE: A page can start with the rest of a packet from the previous page, in which case decoding starts a little after the indexed frame.
+			//		 If that is already past the target, the page before it is used instead
+			constexpr size_t maxAttempts = 2;
+
+			size_t pointIndex = seekIndex.FindSeekPoint(frame);
+			for (size_t attempt = 0; attempt < maxAttempts && pointIndex != OggSeekIndex::NoSeekPoint; attempt++)
+			{
+				if (ov_raw_seek(&ovFile, static_cast<ogg_int64_t>(seekIndex.GetSeekPoint(pointIndex).Offset)) != 0)
+				{
+					return false;
+				}
+
+				const ogg_int64_t pagePosition = ov_pcm_tell(&ovFile);
+				if (pagePosition >= 0 && static_cast<size_t>(pagePosition) <= frame)
+				{
+					return SkipFrames(frame - static_cast<size_t>(pagePosition));
+				}
+
+				pointIndex = (pointIndex > 0) ? pointIndex - 1 : OggSeekIndex::NoSeekPoint;
+			}
+
+			return false;
+		}
+
+		bool SkipFrames(size_t frameCount)
+		{
+			std::array<i16, DecodeChunkSampleCount> discarded{};
+			size_t remainingBytes = frameCount * channels * sizeof(i16);
+
+			while (remainingBytes > 0)
+			{
+				const int requestedBytes = static_cast<int>(SDL_min(remainingBytes, discarded.size() * sizeof(i16)));
+				const long readBytes = ov_read(&ovFile, reinterpret_cast<char*>(discarded.data()), requestedBytes, 0, 2, 1, &currentBitstream);
+				if (readBytes <= 0)
+				{
+					return false;
+				}
+
+				remainingBytes -= static_cast<size_t>(readBytes);
+			}
+
+			return true;
 		}
 	};
 
-	StreamingSampleProvider::StreamingSampleProvider(const u8* encodedData, size_t encodedDataSize)
+	StreamingSampleProvider::StreamingSampleProvider(const u8* encodedData, size_t encodedDataSize, const StreamingSettings& settings)
 	{
-		impl = std::make_unique<Impl>();
+		impl = std::make_unique<Impl>(settings);
 		impl->Initialize(encodedData, encodedDataSize);
 	}
 
+	StreamingSampleProvider::StreamingSampleProvider(IO::MemoryMappedFile&& mappedFile, const StreamingSettings& settings)
+	{
+		impl = std::make_unique<Impl>(settings);
+		impl->Initialize(std::move(mappedFile));
+	}
+
+	StreamingSampleProvider::StreamingSampleProvider(std::unique_ptr<IO::IStream> stream, const StreamingSettings& settings)
+	{
+		impl = std::make_unique<Impl>(settings);
+		impl->Initialize(std::move(stream));
+	}
+
 	StreamingSampleProvider::~StreamingSampleProvider()
 	{
 	}
@@ -203,6 +582,11 @@ namespace Starshine::Audio
 		impl->Destroy();
 	}
 
+	bool StreamingSampleProvider::IsOpen() const
+	{
+		return impl->ovFileOpen;
+	}
+
 	bool StreamingSampleProvider::IsStreamingOnly() const
 	{
 		return true;
@@ -238,6 +622,27 @@ namespace Starshine::Audio
 		return 0;
 	}
 
+	f32 StreamingSampleProvider::GetBufferFillLevel() const
+	{
+		// NOTE: Without a decode thread samples are decoded on demand, so the source can never run dry
+		if (impl->decodedSamples == nullptr)
+		{
+			return 1.0f;
+		}
+
+		return static_cast<f32>(impl->decodedSamples->GetAvailable()) / static_cast<f32>(impl->decodedSamples->GetCapacity());
+	}
+
+	size_t StreamingSampleProvider::GetMemorySize() const
+	{
+		if (impl->decodedSamples == nullptr)
+		{
+			return 0;
+		}
+
+		return impl->decodedSamples->GetCapacity() * sizeof(i16);
+	}
+
 	size_t StreamingSampleProvider::GetSamplePosition() const
 	{
 		return impl->samplePosition;
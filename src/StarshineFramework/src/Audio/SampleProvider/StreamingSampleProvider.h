@@ -1,21 +1,52 @@
 #pragma once
 #include "ISampleProvider.h"
+#include "IO/IStream.h"
+#include "IO/MemoryMappedFile.h"
 #include <memory>
 
 namespace Starshine::Audio
 {
+	struct StreamingSettings
+	{
+		// NOTE: Decode on a background thread into a ring buffer instead of decoding inside the audio callback.
+		//		 When disabled, samples are decoded synchronously (deterministic, but prone to callback deadline misses)
+		bool DecodeOnWorkerThread{ true };
+
+		// NOTE: Capacity of the decoded sample ring buffer
+		size_t BufferedFrames{ 44100 };
+
+		// NOTE: Amount of frames that have to be decoded after opening or seeking before samples are handed out again
+		size_t PreRollFrames{ 8192 };
+
+		// NOTE: Map the file into memory when loading by path instead of reading it through a file stream
+		bool MemoryMapFile{ true };
+
+		// NOTE: Scan the page headers when opening, so that seeking jumps to the right page instead of bisecting the file
+		bool BuildSeekIndex{ true };
+	};
+
 	class StreamingSampleProvider : public ISampleProvider, NonCopyable
 	{
 		friend class AudioEngine;
 		friend class DecoderFactory;
 
 	public:
-		StreamingSampleProvider(const u8* encodedData, size_t encodedDataSize);
+		// NOTE: Copies the encoded data, prefer one of the other constructors for files
+		StreamingSampleProvider(const u8* encodedData, size_t encodedDataSize, const StreamingSettings& settings = {});
+
+		// NOTE: Decodes straight from the mapped file, nothing is copied
+		StreamingSampleProvider(IO::MemoryMappedFile&& mappedFile, const StreamingSettings& settings = {});
+
+		// NOTE: Reads the stream on demand through a small read-ahead buffer. The stream is only accessed by the thread that decodes
+		StreamingSampleProvider(std::unique_ptr<IO::IStream> stream, const StreamingSettings& settings = {});
 		~StreamingSampleProvider() override;
 
 		void Destroy();
 		bool IsStreamingOnly() const;
 
+		// NOTE: False if the encoded data could not be opened by the decoder
+		bool IsOpen() const;
+
 		u32 GetChannelCount() const;
 		u32 GetSampleRate() const;
 		size_t GetSampleAmount() const;
@@ -24,11 +55,18 @@ namespace Starshine::Audio
 		size_t GetLoopEnd_Frames() const;
 
 		size_t ReadSamples(i16* dstBuffer, size_t offset, size_t size);
+		f32 GetBufferFillLevel() const;
+		size_t GetMemorySize() const;
 
 	public:
 		size_t GetSamplePosition() const;
 
+		// NOTE: With a decode thread, this returns fewer samples than requested (possibly none) while the ring buffer refills
 		size_t GetNextSamples(i16* dstBuffer, size_t size);
+
+		// NOTE: With a decode thread, seeking is asynchronous and GetNextSamples() returns nothing until the pre-roll has been decoded.
+		//		 Seeking to the loop start after the last sample has been read is the exception, the decode thread has already wrapped around.
+		//		 With a seek index, a seek costs one jump plus decoding at most a page worth of audio, no matter where the target is
 		void Seek(size_t samplePosition);
 
 	private:
@@ -0,0 +1,148 @@
+#include "WavStreamingSampleProvider.h"
+#include "Audio/Decoding/WavDecoder.h"
+#include <SDL2/SDL_stdinc.h>
+
+namespace Starshine::Audio
+{
+	// NOTE: Read ahead about a second of stereo 44.1 kHz audio and request the next window once half of it has been played
+	constexpr size_t PrefetchWindowSamples = 88200;
+
+	WavStreamingSampleProvider::WavStreamingSampleProvider(IO::MemoryMappedFile&& mappedFile) : mappedFile(std::move(mappedFile))
+	{
+		WavFileInfo info{};
+		if (!this->mappedFile.IsOpen() || !WavDecoder::ParseFileInfo(this->mappedFile.GetData(), this->mappedFile.GetSize(), info))
+		{
+			this->mappedFile.Close();
+			return;
+		}
+
+		// NOTE: The data chunk starts at an even offset, so samples can only be misaligned if the file has been written incorrectly.
+		//		 The samples are always memcpy'd, which doesn't care about alignment
+		samples = reinterpret_cast<const i16*>(this->mappedFile.GetData() + info.DataOffset);
+
+		channels = info.ChannelCount;
+		sampleRate = info.SampleRate;
+		sampleCount = info.DataSize / sizeof(i16);
+
+		if (info.IsLooped && info.LoopEnd > info.LoopStart)
+		{
+			loopStart_frames = info.LoopStart;
+			loopEnd_frames = info.LoopEnd;
+		}
+
+		PrefetchAhead(0);
+	}
+
+	WavStreamingSampleProvider::~WavStreamingSampleProvider()
+	{
+		Destroy();
+	}
+
+	void WavStreamingSampleProvider::Destroy()
+	{
+		samples = nullptr;
+		sampleCount = 0;
+		samplePosition = 0;
+		mappedFile.Close();
+	}
+
+	bool WavStreamingSampleProvider::IsStreamingOnly() const
+	{
+		return true;
+	}
+
+	bool WavStreamingSampleProvider::IsOpen() const
+	{
+		return samples != nullptr;
+	}
+
+	u32 WavStreamingSampleProvider::GetChannelCount() const
+	{
+		return channels;
+	}
+
+	u32 WavStreamingSampleProvider::GetSampleRate() const
+	{
+		return sampleRate;
+	}
+
+	size_t WavStreamingSampleProvider::GetSampleAmount() const
+	{
+		return sampleCount;
+	}
+
+	size_t WavStreamingSampleProvider::GetLoopStart_Frames() const
+	{
+		return loopStart_frames;
+	}
+
+	size_t WavStreamingSampleProvider::GetLoopEnd_Frames() const
+	{
+		return loopEnd_frames;
+	}
+
+	size_t WavStreamingSampleProvider::ReadSamples(i16* dstBuffer, size_t offset, size_t size)
+	{
+		if (offset >= sampleCount)
+		{
+			return 0;
+		}
+
+		size_t samplesToRead = SDL_min(sampleCount - offset, size);
+		SDL_memcpy(dstBuffer, &samples[offset], samplesToRead * sizeof(i16));
+
+		return samplesToRead;
+	}
+
+	f32 WavStreamingSampleProvider::GetBufferFillLevel() const
+	{
+		// NOTE: The whole file is always available, a page that isn't resident yet only costs a page fault
+		return 1.0f;
+	}
+
+	size_t WavStreamingSampleProvider::GetMemorySize() const
+	{
+		return 0;
+	}
+
+	size_t WavStreamingSampleProvider::GetSamplePosition() const
+	{
+		return samplePosition;
+	}
+
+	size_t WavStreamingSampleProvider::GetNextSamples(i16* dstBuffer, size_t size)
+	{
+		size_t samplesToRead = ReadSamples(dstBuffer, samplePosition, size);
+		samplePosition += samplesToRead;
+
+		if (samplePosition + PrefetchWindowSamples / 2 > prefetchedUntil)
+		{
+			PrefetchAhead(samplePosition);
+		}
+
+		return samplesToRead;
+	}
+
+	void WavStreamingSampleProvider::Seek(size_t samplePosition)
+	{
+		if (samplePosition < sampleCount)
+		{
+			this->samplePosition = samplePosition;
+			PrefetchAhead(samplePosition);
+		}
+	}
+
+	void WavStreamingSampleProvider::PrefetchAhead(size_t samplePosition)
+	{
+		if (samples == nullptr || samplePosition >= sampleCount)
+		{
+			return;
+		}
+
+		const size_t prefetchSamples = SDL_min(PrefetchWindowSamples, sampleCount - samplePosition);
+		const size_t dataOffset = reinterpret_cast<const u8*>(samples) - mappedFile.GetData();
+
+		mappedFile.Prefetch(dataOffset + samplePosition * sizeof(i16), prefetchSamples * sizeof(i16));
+		prefetchedUntil = samplePosition + prefetchSamples;
+	}
+}
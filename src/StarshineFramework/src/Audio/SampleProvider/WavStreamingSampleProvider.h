@@ -0,0 +1,56 @@
+#pragma once
+#include "ISampleProvider.h"
+#include "IO/MemoryMappedFile.h"
+
+namespace Starshine::Audio
+{
+	// NOTE: Plays the "data" chunk of a 16-bit PCM WAV file straight from a memory mapping.
+	//		 There is nothing to decode, samples are copied out of the mapping and the OS is asked to read ahead of the playback position
+	class WavStreamingSampleProvider : public ISampleProvider, NonCopyable
+	{
+	public:
+		WavStreamingSampleProvider(IO::MemoryMappedFile&& mappedFile);
+		~WavStreamingSampleProvider() override;
+
+		void Destroy();
+		bool IsStreamingOnly() const;
+
+		// NOTE: False if the file is not a 16-bit PCM WAV file
+		bool IsOpen() const;
+
+		u32 GetChannelCount() const;
+		u32 GetSampleRate() const;
+		size_t GetSampleAmount() const;
+
+		size_t GetLoopStart_Frames() const;
+		size_t GetLoopEnd_Frames() const;
+
+		size_t ReadSamples(i16* dstBuffer, size_t offset, size_t size);
+		f32 GetBufferFillLevel() const;
+		size_t GetMemorySize() const;
+
+	public:
+		size_t GetSamplePosition() const;
+
+		size_t GetNextSamples(i16* dstBuffer, size_t size);
+		void Seek(size_t samplePosition);
+
+	private:
+		void PrefetchAhead(size_t samplePosition);
+
+	private:
+		IO::MemoryMappedFile mappedFile;
+		const i16* samples{};
+
+		u32 channels{};
+		u32 sampleRate{};
+		size_t sampleCount{};
+
+		size_t samplePosition{};
+		size_t loopStart_frames{};
+		size_t loopEnd_frames{};
+
+		// NOTE: End of the range that has last been handed to the OS for read-ahead
+		size_t prefetchedUntil{};
+	};
+}
@@ -6,6 +6,7 @@
 #include "Input/Keyboard.h"
 #include "Input/Gamepad.h"
 #include "Audio/AudioEngine.h"
+#include "IO/Path/File.h"
 
 #include "ImGui/Core/imgui.h"
 #include "ImGui/Core/backends/imgui_impl_sdl2.h"
@@ -57,7 +58,7 @@ namespace Starshine
 		{
 		}
 
-		bool Initialize(bool initImGui)
+		bool Initialize(bool initImGui, DeviceType deviceType)
 		{
 #if defined (_DEBUG)
 			LogMessage("--- Starshine %02d.%02d [Debug] ---", BuildInfo::BuildYear - 2000, BuildInfo::BuildMonth);
@@ -69,7 +70,8 @@ namespace Starshine
 			LogMessage("Git Information: %s, %s", BuildInfo::GitBranchName, BuildInfo::GitCommitHashString);
 
 			SDL_Init(SDL_INIT_EVERYTHING);
-			Parent->GameWindow = std::make_unique<Window>("", 1280, 720, SDL_WINDOW_SHOWN);
+			const SDL_WindowFlags windowFlags = (deviceType == DeviceType::OpenGL) ? static_cast<SDL_WindowFlags>(SDL_WINDOW_SHOWN | SDL_WINDOW_OPENGL) : SDL_WINDOW_SHOWN;
+			Parent->GameWindow = std::make_unique<Window>("", 1280, 720, windowFlags);
 
 			if (!Parent->GameWindow->Exists())
 			{
@@ -80,7 +82,7 @@ namespace Starshine
 
 			BaseWindow = Parent->GameWindow->GetBaseWindow();
 
-			Rendering::InitializeDevice(BaseWindow, DeviceType::D3D11);
+			Rendering::InitializeDevice(BaseWindow, deviceType);
 			GFXDevice = Rendering::GetDevice();
 
 			Keyboard::Initialize();
@@ -88,6 +90,13 @@ namespace Starshine
 
 			AudioEngine::CreateInstance();
 
+			// NOTE: ImGui is only rendered through its D3D11 backend
+			if (initImGui && deviceType != DeviceType::D3D11)
+			{
+				LogMessage("ImGui isn't supported with the %s device", DeviceTypeNames[static_cast<size_t>(deviceType)]);
+				initImGui = false;
+			}
+
 			if (initImGui)
 			{
 				IMGUI_CHECKVERSION();
@@ -110,7 +119,9 @@ namespace Starshine
 
 				ImGuiStyle& style = ImGui::GetStyle();
 				style.FontSizeBase = 18.0f;
-				io.Fonts->AddFontFromFileTTF("imgui/fonts/SourceSans3-Regular.ttf");
+				// NOTE: Only the tools ship the font, everything else uses ImGui's built-in one
+				if (IO::File::Exists("imgui/fonts/SourceSans3-Regular.ttf"))
+					io.Fonts->AddFontFromFileTTF("imgui/fonts/SourceSans3-Regular.ttf");
 				ImGuiStyles::ApplyImGuiStyle();
 
 				ImGuiLoaded = true;
@@ -247,6 +258,8 @@ namespace Starshine
 					ImGui::NewFrame();
 				}
 
+				AudioEngine::GetInstance()->Update();
+
 				if (CurrentState != nullptr && !Timing.FirstFrame) { CurrentState->Update(Timing.GameTime); }
 				if (CurrentState != nullptr && !Timing.FirstFrame) { CurrentState->Draw(Timing.GameTime); }
 				else
@@ -310,9 +323,9 @@ namespace Starshine
 		return nullptr;
 	}
 
-	bool GameInstance::Initialize(bool initImGui)
+	bool GameInstance::Initialize(bool initImGui, Rendering::DeviceType deviceType)
 	{
-		return impl->Initialize(initImGui);
+		return impl->Initialize(initImGui, deviceType);
 	}
 
 	void GameInstance::EnterLoop()
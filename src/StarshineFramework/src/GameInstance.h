@@ -5,6 +5,7 @@
 #include <memory>
 #include <functional>
 #include "TimeSpan.h"
+#include "Rendering/Types.h"
 
 namespace Starshine
 {
@@ -42,7 +43,7 @@ namespace Starshine
 		Window* const GetWindow();
 
 	public:
-		bool Initialize(bool initImGui);
+		bool Initialize(bool initImGui, Rendering::DeviceType deviceType = Rendering::DeviceType::D3D11);
 		void EnterLoop();
 		void Destroy();
 
@@ -0,0 +1,122 @@
+#include "AudioEngineStatsWindow.h"
+#include "ImGui/Core/imgui.h"
+#include "Audio/AudioEngine.h"
+#include <string>
+
+using namespace Starshine::Audio;
+namespace Gui = ImGui;
+
+namespace Starshine::ImGuiExtensions
+{
+	void AudioEngineStatsWindow::OnGUI()
+	{
+		// NOTE: Games that run without ImGui can still own the window, it's just never drawn
+		AudioEngine* audioEngine = AudioEngine::GetInstance();
+		if (!DrawWindow || audioEngine == nullptr || Gui::GetCurrentContext() == nullptr)
+			return;
+
+		const AudioEngineStats stats = audioEngine->GetStats();
+		const f64 bufferPeriod = stats.BufferPeriod.GetMilliseconds();
+
+		loadHistory[loadHistoryOffset] = (bufferPeriod > 0.0) ? static_cast<f32>(stats.LastCallbackDuration.GetMilliseconds() / bufferPeriod) : 0.0f;
+		loadHistoryOffset = (loadHistoryOffset + 1) % LoadHistorySize;
+
+		if (Gui::Begin("Audio Engine", &DrawWindow))
+		{
+			Gui::Text("Output: %s, %.2f ms per buffer", EnumToString(AudioOutputModeStringTable, audioEngine->GetOutputMode()).data(), bufferPeriod);
+
+			Gui::SeparatorText("Callback");
+			Gui::Text("Callbacks: %llu", stats.CallbackCount);
+			Gui::Text("Duration (min / avg / max): %.3f / %.3f / %.3f ms",
+				stats.MinCallbackDuration.GetMilliseconds(), stats.AverageCallbackDuration.GetMilliseconds(), stats.MaxCallbackDuration.GetMilliseconds());
+			Gui::Text("Min deadline margin: %.3f ms", stats.MinDeadlineMargin.GetMilliseconds());
+			Gui::Text("Deadline misses: %llu", stats.DeadlineMisses);
+			Gui::Text("Underruns: %llu", stats.Underruns);
+			Gui::Text("Max jitter: %.3f ms", stats.MaxCallbackJitter.GetMilliseconds());
+
+			Gui::PlotLines("##CallbackLoad", loadHistory.data(), static_cast<int>(LoadHistorySize), static_cast<int>(loadHistoryOffset),
+				"Load", 0.0f, 1.0f, ImVec2(0.0f, 60.0f));
+
+			std::array<f32, AudioEngineStats::CallbackHistogramBucketCount> histogram{};
+			for (size_t i = 0; i < histogram.size(); i++)
+			{
+				histogram[i] = static_cast<f32>(stats.CallbackHistogram[i]);
+			}
+
+			Gui::PlotHistogram("##CallbackHistogram", histogram.data(), static_cast<int>(histogram.size()), 0,
+				"Load (10% buckets)", 0.0f, FLT_MAX, ImVec2(0.0f, 60.0f));
+
+			Gui::SeparatorText("Buffer");
+			const BufferCalibrationStatus calibration = audioEngine->GetBufferCalibrationStatus();
+			const bool calibrating = (calibration.State == BufferCalibrationState::Running);
+
+			Gui::BeginDisabled(calibrating);
+			const u32 sampleBufferSize = audioEngine->GetSampleBufferSize();
+			if (Gui::BeginCombo("Buffer size", std::to_string(sampleBufferSize).c_str()))
+			{
+				for (u32 size = AudioEngine::MinSampleBufferSize; size <= AudioEngine::MaxSampleBufferSize; size *= 2)
+				{
+					if (Gui::Selectable(std::to_string(size).c_str(), size == sampleBufferSize))
+						audioEngine->SetSampleBufferSize(size);
+				}
+
+				Gui::EndCombo();
+			}
+			Gui::EndDisabled();
+
+			if (Gui::Button(calibrating ? "Cancel calibration" : "Calibrate"))
+			{
+				if (calibrating)
+					audioEngine->CancelBufferCalibration();
+				else
+					audioEngine->StartBufferCalibration();
+			}
+
+			Gui::SameLine();
+			Gui::Text("%s (%u)", EnumToString(BufferCalibrationStateStringTable, calibration.State).data(), calibration.SampleBufferSize);
+
+			for (const BufferCalibrationStep& step : calibration.Steps)
+			{
+				Gui::BulletText("%u: %llu underruns, %llu misses, %.2f ms jitter, %.2f ms max%s", step.SampleBufferSize, step.Underruns, step.DeadlineMisses,
+					step.MaxCallbackJitter.GetMilliseconds(), step.MaxCallbackDuration.GetMilliseconds(), step.Stable ? " (stable)" : "");
+			}
+
+			Gui::SeparatorText("Voices");
+			Gui::Text("Active: %u", stats.ActiveVoices);
+			Gui::Text("Playing: %u (peak %u / %llu)", stats.PlayingVoices, stats.PeakPlayingVoices, AudioEngine::MaxSimultaneousVoices);
+			Gui::Text("Dropped sounds: %llu", stats.DroppedSounds);
+			Gui::Text("Deferred commands: %llu", stats.DeferredCommands);
+
+			Gui::SeparatorText("Streaming");
+			Gui::Text("Streaming voices: %u", stats.StreamingVoices);
+			Gui::ProgressBar(stats.MinStreamingBufferFill, ImVec2(-FLT_MIN, 0.0f), "Min buffer fill");
+			Gui::Text("Starvations: %llu", stats.StreamingStarvations);
+
+			Gui::SeparatorText("Source cache");
+			Gui::Text("Cached sources: %u (%u unreferenced)", stats.CachedSources, stats.UnreferencedCachedSources);
+			Gui::Text("Memory: %.2f / %.2f MiB", static_cast<f64>(stats.CachedSourceMemory) / (1024.0 * 1024.0),
+				static_cast<f64>(audioEngine->GetSourceCacheBudget()) / (1024.0 * 1024.0));
+			Gui::Text("Hits: %llu, misses: %llu, evictions: %llu", stats.SourceCacheHits, stats.SourceCacheMisses, stats.SourceCacheEvictions);
+			if (Gui::Button("Purge unreferenced"))
+				audioEngine->PurgeSourceCache();
+
+			const SourceStorage sourceStorage = audioEngine->GetSourceStorage();
+			if (Gui::BeginCombo("Storage of new sources", EnumToString(SourceStorageStringTable, sourceStorage).data()))
+			{
+				for (size_t i = 0; i < EnumCount<SourceStorage>(); i++)
+				{
+					const SourceStorage storage = static_cast<SourceStorage>(i);
+					if (Gui::Selectable(EnumToString(SourceStorageStringTable, storage).data(), storage == sourceStorage))
+						audioEngine->SetSourceStorage(storage);
+				}
+
+				Gui::EndCombo();
+			}
+
+			Gui::Spacing();
+			if (Gui::Button("Reset"))
+				audioEngine->ResetStats();
+		}
+		Gui::End();
+	}
+}
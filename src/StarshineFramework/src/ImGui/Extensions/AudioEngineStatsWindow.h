@@ -0,0 +1,27 @@
+#pragma once
+#include "Common/Types.h"
+#include <array>
+
+namespace Starshine::ImGuiExtensions
+{
+	// NOTE: Debug window for the audio engine's mixer statistics, meant for tuning the buffer size on the target machine
+	class AudioEngineStatsWindow : NonCopyable
+	{
+	public:
+		AudioEngineStatsWindow() = default;
+		~AudioEngineStatsWindow() = default;
+
+	public:
+		void OnGUI();
+
+	public:
+		bool DrawWindow{};
+
+	private:
+		static constexpr size_t LoadHistorySize = 240;
+
+		// NOTE: Duration of the last callback relative to the buffer period, sampled once per drawn frame
+		std::array<f32, LoadHistorySize> loadHistory{};
+		size_t loadHistoryOffset{};
+	};
+}
@@ -400,8 +400,11 @@ namespace Starshine::Rendering::D3D11
 		{
 			if (texture == nullptr)
 			{
-				D3D11.DeviceContext->PSSetShaderResources(slot, 1, nullptr);
-				D3D11.DeviceContext->PSSetSamplers(slot, 1, nullptr);
+				// NOTE: The views and samplers are passed as arrays, unbinding a slot takes an array holding a null entry
+				ID3D11ShaderResourceView* const nullView{};
+				ID3D11SamplerState* const nullSampler{};
+				D3D11.DeviceContext->PSSetShaderResources(slot, 1, &nullView);
+				D3D11.DeviceContext->PSSetSamplers(slot, 1, &nullSampler);
 			}
 			else
 			{
@@ -609,7 +612,7 @@ namespace Starshine::Rendering::D3D11
 	{
 		if (texture == nullptr)
 		{
-			impl->SetTexture(nullptr, 0);
+			impl->SetTexture(nullptr, slot);
 		}
 		else
 		{
@@ -1,5 +1,8 @@
 #include "Device.h"
 #include "D3D11/D3D11Device.h"
+#include "OpenGL/OpenGLDevice.h"
+#include "Software/SoftwareDevice.h"
+#include "Null/NullDevice.h"
 #include "Common/Logging/Logging.h"
 
 namespace Starshine::Rendering
@@ -11,16 +14,23 @@ namespace Starshine::Rendering
 
 	bool InitializeDevice(SDL_Window* sdlWindow, DeviceType type)
 	{
-		if (sdlWindow == nullptr) { return false; }
+		// NOTE: The software and null devices can render without a window, so can the OpenGL one through EGL on Linux
+		if (sdlWindow == nullptr && type == DeviceType::D3D11) { return false; }
 
 		switch (type)
 		{
 		case DeviceType::OpenGL:
-			assert(false);
+			GlobalDevice = std::make_unique<OpenGL::OpenGLDevice>();
 			break;
 		case DeviceType::D3D11:
 			GlobalDevice = std::make_unique<D3D11::D3D11Device>();
 			break;
+		case DeviceType::Software:
+			GlobalDevice = std::make_unique<Software::SoftwareDevice>();
+			break;
+		case DeviceType::Null:
+			GlobalDevice = std::make_unique<Null::NullDevice>();
+			break;
 		}
 
 		LogInfo(LogName, "Device Type: %s", DeviceTypeNames[static_cast<size_t>(type)]);
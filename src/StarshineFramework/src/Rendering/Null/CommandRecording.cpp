@@ -0,0 +1,464 @@
+#include "CommandRecording.h"
+#include "Common/Logging/Logging.h"
+#include "IO/Path/File.h"
+#include <unordered_map>
+
+namespace Starshine::Rendering::Null
+{
+	static constexpr const char* LogName{ "CommandRecording" };
+
+	namespace FileFormatDetail
+	{
+		// NOTE: Bump whenever CommandType or any of the CommandArgs change
+		static constexpr u8 CurrentRevision = 0;
+		static constexpr std::array<char, 4> FileSignature = { 'S', 'C', 'R', CurrentRevision };
+	}
+
+	struct CommandHeader
+	{
+		CommandType Type{};
+		u32 ArgsSize{};
+		u32 PayloadSize{};
+	};
+
+	void CommandRecording::Clear()
+	{
+		data.clear();
+		frameCount = 0;
+	}
+
+	bool CommandRecording::IsEmpty() const
+	{
+		return data.empty();
+	}
+
+	size_t CommandRecording::GetSize() const
+	{
+		return data.size();
+	}
+
+	u32 CommandRecording::GetFrameCount() const
+	{
+		return frameCount;
+	}
+
+	void CommandRecording::Write(CommandType type, const void* args, size_t argsSize, const void* payload, size_t payloadSize)
+	{
+		assert(argsSize + payloadSize <= UINT32_MAX);
+
+		CommandHeader header{};
+		header.Type = type;
+		header.ArgsSize = static_cast<u32>(argsSize);
+		header.PayloadSize = static_cast<u32>(payloadSize);
+
+		const size_t position = data.size();
+		data.resize(position + sizeof(CommandHeader) + header.ArgsSize + header.PayloadSize);
+
+		u8* output = &data[position];
+		SDL_memcpy(output, &header, sizeof(CommandHeader));
+		output += sizeof(CommandHeader);
+
+		if (argsSize > 0) { SDL_memcpy(output, args, argsSize); }
+		output += argsSize;
+
+		if (payloadSize > 0) { SDL_memcpy(output, payload, payloadSize); }
+
+		if (type == CommandType::SwapBuffers)
+		{
+			frameCount++;
+		}
+	}
+
+	bool CommandRecording::Read(size_t& position, CommandView& command) const
+	{
+		if (position + sizeof(CommandHeader) > data.size())
+		{
+			return false;
+		}
+
+		CommandHeader header{};
+		SDL_memcpy(&header, &data[position], sizeof(CommandHeader));
+
+		const size_t argsPosition = position + sizeof(CommandHeader);
+		const size_t payloadPosition = argsPosition + header.ArgsSize;
+		const size_t endPosition = payloadPosition + header.PayloadSize;
+
+		if (endPosition > data.size() || header.Type >= CommandType::Count)
+		{
+			return false;
+		}
+
+		command.Type = header.Type;
+		command.Args = data.data() + argsPosition;
+		command.ArgsSize = header.ArgsSize;
+		command.Payload = data.data() + payloadPosition;
+		command.PayloadSize = header.PayloadSize;
+
+		position = endPosition;
+		return true;
+	}
+
+	bool CommandRecording::SaveToFile(std::string_view filePath) const
+	{
+		IO::FileStream fileStream = IO::File::CreateWrite(filePath);
+		if (!fileStream.IsOpen())
+		{
+			LogError(LogName, "Failed to create %.*s", static_cast<int>(filePath.size()), filePath.data());
+			return false;
+		}
+
+		IO::StreamWriter writer(fileStream);
+		writer.WriteBuffer(FileFormatDetail::FileSignature.data(), FileFormatDetail::FileSignature.size());
+		writer.WriteU32(frameCount);
+		writer.WriteU64(static_cast<u64>(data.size()));
+		writer.WriteBuffer(data.data(), data.size());
+
+		return true;
+	}
+
+	bool CommandRecording::LoadFromFile(std::string_view filePath)
+	{
+		Clear();
+
+		IO::FileStream fileStream = IO::File::OpenRead(filePath);
+		if (!fileStream.IsOpen())
+		{
+			LogError(LogName, "Failed to open %.*s", static_cast<int>(filePath.size()), filePath.data());
+			return false;
+		}
+
+		IO::StreamReader reader(fileStream);
+
+		char signature[4]{};
+		reader.ReadBuffer(signature, sizeof(signature));
+		if (SDL_memcmp(signature, FileFormatDetail::FileSignature.data(), FileFormatDetail::FileSignature.size()) != 0)
+		{
+			LogError(LogName, "%.*s isn't a recording or was made by a different revision", static_cast<int>(filePath.size()), filePath.data());
+			return false;
+		}
+
+		const u32 fileFrameCount = reader.ReadU32();
+		const u64 dataSize = reader.ReadU64();
+		if (dataSize > fileStream.GetSize() - fileStream.GetPosition())
+		{
+			LogError(LogName, "%.*s is truncated", static_cast<int>(filePath.size()), filePath.data());
+			return false;
+		}
+
+		data.resize(static_cast<size_t>(dataSize));
+		reader.ReadBuffer(data.data(), data.size());
+		frameCount = fileFrameCount;
+
+		return true;
+	}
+
+	struct CommandReplayer::Impl
+	{
+		const CommandRecording& Recording;
+		Device& TargetDevice;
+
+		size_t Position{};
+		u32 ReplayedFrames{};
+
+		std::unordered_map<ResourceID, std::unique_ptr<Buffer>> Buffers;
+		std::unordered_map<ResourceID, std::unique_ptr<Shader>> Shaders;
+		std::unordered_map<ResourceID, std::unique_ptr<VertexDesc>> VertexDescs;
+		std::unordered_map<ResourceID, std::unique_ptr<Graphics::Texture>> Textures;
+		std::unordered_map<ResourceID, std::unique_ptr<BlendState>> BlendStates;
+
+		// NOTE: Slots that have been bound by the replay, they are unbound before the resources are released
+		u32 UsedTextureSlots{};
+		std::array<u32, EnumCount<ShaderStage>()> UsedUniformSlots{};
+
+		Impl(const CommandRecording& recording, Device& device) : Recording(recording), TargetDevice(device) {}
+
+		~Impl()
+		{
+			ReleaseResources();
+		}
+
+		template <typename ResourceType>
+		static ResourceType* Find(const std::unordered_map<ResourceID, std::unique_ptr<ResourceType>>& resources, ResourceID id)
+		{
+			auto it = resources.find(id);
+			return (it != resources.end()) ? it->second.get() : nullptr;
+		}
+
+		void ReleaseResources()
+		{
+			TargetDevice.SetVertexBuffer(nullptr, nullptr);
+			TargetDevice.SetIndexBuffer(nullptr);
+			TargetDevice.SetShader(nullptr);
+			TargetDevice.SetBlendState(nullptr);
+
+			for (u32 slot = 0; slot < 32; slot++)
+			{
+				if ((UsedTextureSlots & (1u << slot)) != 0) { TargetDevice.SetTexture(nullptr, slot); }
+
+				for (size_t stage = 0; stage < UsedUniformSlots.size(); stage++)
+				{
+					if ((UsedUniformSlots[stage] & (1u << slot)) != 0) { TargetDevice.SetUniformBuffer(nullptr, static_cast<ShaderStage>(stage), slot); }
+				}
+			}
+
+			UsedTextureSlots = 0;
+			UsedUniformSlots = {};
+
+			// NOTE: Vertex descs may refer to their shaders
+			VertexDescs.clear();
+			Shaders.clear();
+			Buffers.clear();
+			Textures.clear();
+			BlendStates.clear();
+		}
+
+		void Execute(const CommandView& command)
+		{
+			switch (command.Type)
+			{
+			case CommandType::CreateBuffer:
+			{
+				CommandArgs::CreateBuffer args{};
+				if (!command.GetArgs(args)) { break; }
+
+				BufferCreationData creationData{};
+				creationData.Type = args.Type;
+				creationData.Dynamic = args.Dynamic;
+				creationData.IndexFormat = args.IndexFormat;
+				creationData.Size = static_cast<size_t>(args.Size);
+				creationData.InitialData = (command.PayloadSize >= args.Size) ? command.Payload : nullptr;
+
+				std::unique_ptr<Buffer> buffer{};
+				if (!TargetDevice.CreateBuffer(creationData, buffer))
+				{
+					LogError(LogName, "Failed to create buffer %u", args.ID);
+				}
+
+				Buffers[args.ID] = std::move(buffer);
+				break;
+			}
+			case CommandType::DestroyBuffer:
+			{
+				CommandArgs::Resource args{};
+				if (command.GetArgs(args)) { Buffers.erase(args.ID); }
+				break;
+			}
+			case CommandType::SetBufferData:
+			{
+				CommandArgs::SetBufferData args{};
+				if (!command.GetArgs(args)) { break; }
+
+				if (Buffer* buffer = Find(Buffers, args.ID); buffer != nullptr)
+				{
+					buffer->SetData(command.Payload, static_cast<size_t>(args.Offset), command.PayloadSize);
+				}
+				break;
+			}
+			case CommandType::CreateShader:
+			{
+				CommandArgs::CreateShader args{};
+				if (!command.GetArgs(args) || args.VertexShaderSize > command.PayloadSize) { break; }
+
+				const size_t vsSize = static_cast<size_t>(args.VertexShaderSize);
+				std::unique_ptr<Shader> shader{};
+				if (!TargetDevice.CreateShader(command.Payload, vsSize, command.Payload + vsSize, command.PayloadSize - vsSize, shader))
+				{
+					LogError(LogName, "Failed to create shader %u", args.ID);
+				}
+
+				Shaders[args.ID] = std::move(shader);
+				break;
+			}
+			case CommandType::DestroyShader:
+			{
+				CommandArgs::Resource args{};
+				if (command.GetArgs(args)) { Shaders.erase(args.ID); }
+				break;
+			}
+			case CommandType::CreateVertexDesc:
+			{
+				CommandArgs::CreateVertexDesc args{};
+				if (!command.GetArgs(args) || static_cast<size_t>(args.AttribCount) * sizeof(VertexAttrib) != command.PayloadSize) { break; }
+
+				std::vector<VertexAttrib> attribs(args.AttribCount);
+				SDL_memcpy(attribs.data(), command.Payload, command.PayloadSize);
+
+				std::unique_ptr<VertexDesc> desc{};
+				if (!TargetDevice.CreateVertexDesc(attribs.data(), attribs.size(), Find(Shaders, args.Shader), desc))
+				{
+					LogError(LogName, "Failed to create vertex desc %u", args.ID);
+				}
+
+				VertexDescs[args.ID] = std::move(desc);
+				break;
+			}
+			case CommandType::DestroyVertexDesc:
+			{
+				CommandArgs::Resource args{};
+				if (command.GetArgs(args)) { VertexDescs.erase(args.ID); }
+				break;
+			}
+			case CommandType::UploadTexture:
+			{
+				CommandArgs::UploadTexture args{};
+				if (!command.GetArgs(args) || Graphics::GetTextureDataSize(args.Size, args.Format) != command.PayloadSize) { break; }
+
+				auto texture = std::make_unique<Graphics::Texture>(args.Size, args.Format, args.Flags, command.Payload, args.Dynamic);
+				if (!TargetDevice.UploadTexture(texture.get()))
+				{
+					LogError(LogName, "Failed to upload texture %u", args.ID);
+				}
+
+				Textures[args.ID] = std::move(texture);
+				break;
+			}
+			case CommandType::DestroyTexture:
+			{
+				CommandArgs::Resource args{};
+				if (command.GetArgs(args)) { Textures.erase(args.ID); }
+				break;
+			}
+			case CommandType::CreateBlendState:
+			{
+				CommandArgs::CreateBlendState args{};
+				if (!command.GetArgs(args)) { break; }
+
+				std::unique_ptr<BlendState> state{};
+				if (!TargetDevice.CreateBlendState(args.Desc, state))
+				{
+					LogError(LogName, "Failed to create blend state %u", args.ID);
+				}
+
+				BlendStates[args.ID] = std::move(state);
+				break;
+			}
+			case CommandType::DestroyBlendState:
+			{
+				CommandArgs::Resource args{};
+				if (command.GetArgs(args)) { BlendStates.erase(args.ID); }
+				break;
+			}
+			case CommandType::SetViewport:
+			{
+				CommandArgs::SetViewport args{};
+				if (command.GetArgs(args)) { TargetDevice.SetViewportSize(args.Viewport); }
+				break;
+			}
+			case CommandType::Clear:
+			{
+				CommandArgs::Clear args{};
+				if (command.GetArgs(args)) { TargetDevice.Clear(args.Flags, args.ClearColor, args.Depth, args.Stencil); }
+				break;
+			}
+			case CommandType::SwapBuffers:
+				break;
+			case CommandType::DrawArrays:
+			{
+				CommandArgs::DrawArrays args{};
+				if (command.GetArgs(args)) { TargetDevice.DrawArrays(args.Type, args.FirstVertex, args.VertexCount); }
+				break;
+			}
+			case CommandType::DrawIndexed:
+			{
+				CommandArgs::DrawIndexed args{};
+				if (command.GetArgs(args)) { TargetDevice.DrawIndexed(args.Type, args.FirstIndex, args.BaseVertexIndex, args.IndexCount); }
+				break;
+			}
+			case CommandType::SetVertexBuffer:
+			{
+				CommandArgs::SetVertexBuffer args{};
+				if (command.GetArgs(args)) { TargetDevice.SetVertexBuffer(Find(Buffers, args.Buffer), Find(VertexDescs, args.VertexDesc)); }
+				break;
+			}
+			case CommandType::SetIndexBuffer:
+			{
+				CommandArgs::Resource args{};
+				if (command.GetArgs(args)) { TargetDevice.SetIndexBuffer(Find(Buffers, args.ID)); }
+				break;
+			}
+			case CommandType::SetUniformBuffer:
+			{
+				CommandArgs::SetUniformBuffer args{};
+				if (!command.GetArgs(args) || args.Stage >= ShaderStage::Count) { break; }
+
+				if (args.BufferIndex < 32) { UsedUniformSlots[static_cast<size_t>(args.Stage)] |= (1u << args.BufferIndex); }
+				TargetDevice.SetUniformBuffer(Find(Buffers, args.Buffer), args.Stage, args.BufferIndex);
+				break;
+			}
+			case CommandType::SetShader:
+			{
+				CommandArgs::Resource args{};
+				if (command.GetArgs(args)) { TargetDevice.SetShader(Find(Shaders, args.ID)); }
+				break;
+			}
+			case CommandType::SetTexture:
+			{
+				CommandArgs::SetTexture args{};
+				if (!command.GetArgs(args)) { break; }
+
+				if (args.Slot < 32) { UsedTextureSlots |= (1u << args.Slot); }
+				TargetDevice.SetTexture(Find(Textures, args.Texture), args.Slot);
+				break;
+			}
+			case CommandType::SetBlendState:
+			{
+				CommandArgs::Resource args{};
+				if (command.GetArgs(args)) { TargetDevice.SetBlendState(Find(BlendStates, args.ID)); }
+				break;
+			}
+			default:
+				break;
+			}
+		}
+
+		bool ReplayFrame()
+		{
+			bool replayedAny = false;
+
+			CommandView command{};
+			while (Recording.Read(Position, command))
+			{
+				replayedAny = true;
+				Execute(command);
+
+				if (command.Type == CommandType::SwapBuffers)
+				{
+					ReplayedFrames++;
+					break;
+				}
+			}
+
+			return replayedAny;
+		}
+
+		void Restart()
+		{
+			ReleaseResources();
+			Position = 0;
+			ReplayedFrames = 0;
+		}
+	};
+
+	CommandReplayer::CommandReplayer(const CommandRecording& recording, Device& device) : impl(std::make_unique<Impl>(recording, device))
+	{
+	}
+
+	CommandReplayer::~CommandReplayer()
+	{
+	}
+
+	bool CommandReplayer::ReplayFrame()
+	{
+		return impl->ReplayFrame();
+	}
+
+	void CommandReplayer::Restart()
+	{
+		impl->Restart();
+	}
+
+	u32 CommandReplayer::GetReplayedFrameCount() const
+	{
+		return impl->ReplayedFrames;
+	}
+}
@@ -0,0 +1,143 @@
+#pragma once
+#include "Common/Types.h"
+#include "Common/Rect.h"
+#include "Common/Color.h"
+#include "Rendering/Device.h"
+#include <memory>
+#include <vector>
+
+namespace Starshine::Rendering::Null
+{
+	// NOTE: Resources are referred to by IDs in a recording, 0 stands for nullptr
+	using ResourceID = u32;
+
+	enum class CommandType : u8
+	{
+		CreateBuffer,
+		DestroyBuffer,
+		SetBufferData,
+		CreateShader,
+		DestroyShader,
+		CreateVertexDesc,
+		DestroyVertexDesc,
+		UploadTexture,
+		DestroyTexture,
+		CreateBlendState,
+		DestroyBlendState,
+
+		SetViewport,
+		Clear,
+		SwapBuffers,
+
+		DrawArrays,
+		DrawIndexed,
+
+		SetVertexBuffer,
+		SetIndexBuffer,
+		SetUniformBuffer,
+		SetShader,
+		SetTexture,
+		SetBlendState,
+
+		Count
+	};
+
+	// NOTE: Arguments of every command. They are stored as they are in memory,
+	//		 so a recording can only be replayed by a build with the same layout (the file header stores a version for that)
+	namespace CommandArgs
+	{
+		// NOTE: Destroy*, SetIndexBuffer, SetShader and SetBlendState
+		struct Resource { ResourceID ID; };
+
+		// NOTE: Followed by the initial data, if there is any
+		struct CreateBuffer { ResourceID ID; BufferType Type; bool Dynamic; IndexFormat IndexFormat; u64 Size; };
+		// NOTE: Followed by the data
+		struct SetBufferData { ResourceID ID; u64 Offset; };
+		// NOTE: Followed by the vertex shader and then the fragment shader data
+		struct CreateShader { ResourceID ID; u64 VertexShaderSize; };
+		// NOTE: Followed by the VertexAttrib array
+		struct CreateVertexDesc { ResourceID ID; ResourceID Shader; u32 AttribCount; };
+		// NOTE: Followed by the texel data
+		struct UploadTexture { ResourceID ID; ivec2 Size; Graphics::TextureFormat Format; Graphics::TextureFlags Flags; bool Dynamic; };
+		struct CreateBlendState { ResourceID ID; BlendStateDesc Desc; };
+
+		struct SetViewport { RectangleF Viewport; };
+		struct Clear { ClearFlags Flags; Color ClearColor; f32 Depth; u8 Stencil; };
+
+		struct DrawArrays { PrimitiveType Type; u32 FirstVertex; u32 VertexCount; };
+		struct DrawIndexed { PrimitiveType Type; u32 FirstIndex; u32 BaseVertexIndex; u32 IndexCount; };
+
+		struct SetVertexBuffer { ResourceID Buffer; ResourceID VertexDesc; };
+		struct SetUniformBuffer { ResourceID Buffer; ShaderStage Stage; u32 BufferIndex; };
+		struct SetTexture { ResourceID Texture; u32 Slot; };
+	}
+
+	struct CommandView
+	{
+		CommandType Type{};
+
+		const u8* Args{};
+		u32 ArgsSize{};
+
+		const u8* Payload{};
+		u32 PayloadSize{};
+
+		template <typename ArgsType>
+		bool GetArgs(ArgsType& args) const
+		{
+			if (ArgsSize != sizeof(ArgsType)) { return false; }
+
+			SDL_memcpy(&args, Args, sizeof(ArgsType));
+			return true;
+		}
+	};
+
+	// NOTE: A stream of device commands, stored back to back as a header followed by the arguments and the payload.
+	//		 Every frame ends with a SwapBuffers command
+	class CommandRecording
+	{
+	public:
+		void Clear();
+
+		bool IsEmpty() const;
+		size_t GetSize() const;
+		u32 GetFrameCount() const;
+
+	public:
+		void Write(CommandType type, const void* args, size_t argsSize, const void* payload = nullptr, size_t payloadSize = 0);
+
+		// NOTE: Returns false once the end has been reached, 'position' is advanced to the next command
+		bool Read(size_t& position, CommandView& command) const;
+
+	public:
+		bool SaveToFile(std::string_view filePath) const;
+		bool LoadFromFile(std::string_view filePath);
+
+	private:
+		std::vector<u8> data;
+		u32 frameCount{};
+	};
+
+	// NOTE: Executes a recording on another device, a frame at a time. Resources are created on that device as the commands come up
+	//		 and are owned by the replayer until the recording destroys them or the replayer is destroyed
+	class CommandReplayer : NonCopyable
+	{
+	public:
+		CommandReplayer(const CommandRecording& recording, Device& device);
+		~CommandReplayer();
+
+	public:
+		// NOTE: Executes every command up to the next SwapBuffers, which is left to the caller.
+		//		 Returns false if there was nothing left to replay
+		bool ReplayFrame();
+
+		// NOTE: Releases everything that has been created and starts over from the first frame
+		void Restart();
+
+		u32 GetReplayedFrameCount() const;
+
+	private:
+		struct Impl;
+		std::unique_ptr<Impl> impl;
+	};
+}
@@ -0,0 +1,479 @@
+#include "NullDevice.h"
+#include "NullResources.h"
+#include "Common/Logging/Logging.h"
+#include <algorithm>
+#include <map>
+
+namespace Starshine::Rendering::Null
+{
+	static constexpr const char* LogName{ "NullDevice" };
+
+	// NOTE: Used when there is no window to take the size from
+	static constexpr ivec2 DefaultViewportSize{ 1280, 720 };
+
+	static constexpr size_t MaxUniformBufferSlots{ 14 };
+	static constexpr size_t MaxTextureSlots{ 16 };
+
+	struct NullDevice::Impl
+	{
+		NullDevice& Parent;
+
+		RectangleF CurrentViewport{};
+
+		// NOTE: Every resource that is alive, ordered by creation so that the ones referred to by others come first when recording them
+		ResourceID LastResourceID{};
+		std::map<ResourceID, const NullBuffer*> Buffers;
+		std::map<ResourceID, const NullShader*> Shaders;
+		std::map<ResourceID, const NullVertexDesc*> VertexDescs;
+		std::map<ResourceID, const NullTexture*> Textures;
+		std::map<ResourceID, const NullBlendState*> BlendStates;
+
+		struct BoundStateData
+		{
+			ResourceID VertexBuffer{};
+			ResourceID VertexDesc{};
+			ResourceID IndexBuffer{};
+			ResourceID Shader{};
+			ResourceID BlendState{};
+
+			std::array<ResourceID, MaxTextureSlots> Textures{};
+			std::array<std::array<ResourceID, MaxUniformBufferSlots>, EnumCount<ShaderStage>()> UniformBuffers{};
+		} Bound;
+
+		bool Recording{};
+		CommandRecording CurrentRecording;
+
+		NullFrameStats FrameStats{};
+		NullFrameStats LastFrameStats{};
+
+		u32 FrameCount{};
+		NullFrameStats TotalStats{};
+		NullFrameStats PeakStats{};
+
+		Impl(NullDevice& parent) : Parent(parent) {}
+
+		bool Initialize(SDL_Window* window)
+		{
+			ivec2 size = DefaultViewportSize;
+			if (window != nullptr)
+			{
+				SDL_GetWindowSizeInPixels(window, &size.x, &size.y);
+			}
+
+			CurrentViewport = RectangleF(0.0f, 0.0f, static_cast<f32>(size.x), static_cast<f32>(size.y));
+			return true;
+		}
+
+		void Destroy()
+		{
+			if (FrameCount > 0)
+			{
+				const f64 frames = static_cast<f64>(FrameCount);
+				LogInfo(LogName, "%u frames, per frame average (peak): %.1f (%u) draw calls, %.1f (%u) vertices, %.1f (%u) state changes, %.1f (%u) redundant binds, %.1f (%.1f) KB uploaded",
+					FrameCount,
+					TotalStats.DrawCalls / frames, PeakStats.DrawCalls,
+					TotalStats.Vertices / frames, PeakStats.Vertices,
+					TotalStats.StateChanges / frames, PeakStats.StateChanges,
+					TotalStats.RedundantBinds / frames, PeakStats.RedundantBinds,
+					TotalStats.UploadedBytes / frames / 1024.0, PeakStats.UploadedBytes / 1024.0);
+			}
+
+			Recording = false;
+			CurrentRecording.Clear();
+			Bound = {};
+		}
+
+		void SwapBuffers()
+		{
+			RecordWithoutArgs(CommandType::SwapBuffers);
+
+			LastFrameStats = FrameStats;
+			FrameStats = {};
+
+			FrameCount++;
+			AccumulateStats(TotalStats, LastFrameStats, [](auto total, auto frame) { return total + frame; });
+			AccumulateStats(PeakStats, LastFrameStats, [](auto peak, auto frame) { return std::max(peak, frame); });
+		}
+
+		template <typename Func>
+		static void AccumulateStats(NullFrameStats& target, const NullFrameStats& frame, Func func)
+		{
+			target.DrawCalls = func(target.DrawCalls, frame.DrawCalls);
+			target.Vertices = func(target.Vertices, frame.Vertices);
+			target.StateChanges = func(target.StateChanges, frame.StateChanges);
+			target.RedundantBinds = func(target.RedundantBinds, frame.RedundantBinds);
+			target.BufferUploads = func(target.BufferUploads, frame.BufferUploads);
+			target.TextureUploads = func(target.TextureUploads, frame.TextureUploads);
+			target.UploadedBytes = func(target.UploadedBytes, frame.UploadedBytes);
+		}
+
+		template <typename ArgsType>
+		void Record(CommandType type, const ArgsType& args, const void* payload = nullptr, size_t payloadSize = 0)
+		{
+			if (Recording)
+			{
+				CurrentRecording.Write(type, &args, sizeof(ArgsType), payload, payloadSize);
+			}
+		}
+
+		void RecordWithoutArgs(CommandType type)
+		{
+			if (Recording)
+			{
+				CurrentRecording.Write(type, nullptr, 0);
+			}
+		}
+
+		// NOTE: Returns true if the binding has changed
+		bool Bind(ResourceID& boundID, ResourceID newID)
+		{
+			if (boundID == newID)
+			{
+				FrameStats.RedundantBinds++;
+				return false;
+			}
+
+			boundID = newID;
+			FrameStats.StateChanges++;
+			return true;
+		}
+
+		// NOTE: Recorded exactly like the original calls, see StartRecording()
+		void RecordBuffer(const NullBuffer& buffer)
+		{
+			CommandArgs::CreateBuffer args{ buffer.ID, buffer.Properties.Type, buffer.Properties.Dynamic, buffer.Properties.IndexFormat, buffer.Properties.Size };
+			CurrentRecording.Write(CommandType::CreateBuffer, &args, sizeof(args), buffer.Data.get(), buffer.Properties.Size);
+		}
+
+		void RecordShader(const NullShader& shader)
+		{
+			CommandArgs::CreateShader args{ shader.ID, shader.VertexShaderSize };
+			CurrentRecording.Write(CommandType::CreateShader, &args, sizeof(args), shader.Data.data(), shader.Data.size());
+		}
+
+		void RecordVertexDesc(const NullVertexDesc& desc)
+		{
+			CommandArgs::CreateVertexDesc args{ desc.ID, desc.ShaderID, static_cast<u32>(desc.Attribs.size()) };
+			CurrentRecording.Write(CommandType::CreateVertexDesc, &args, sizeof(args), desc.Attribs.data(), desc.Attribs.size() * sizeof(VertexAttrib));
+		}
+
+		void RecordTexture(const NullTexture& texture)
+		{
+			const Graphics::Texture& parent = *texture.ParentTexture;
+			CommandArgs::UploadTexture args{ texture.ID, parent.GetSize(), parent.GetFormat(), parent.GetFlags(), parent.GPUTexture.Dynamic };
+			CurrentRecording.Write(CommandType::UploadTexture, &args, sizeof(args), parent.GetData(), parent.GetDataSize());
+		}
+
+		void RecordBlendState(const NullBlendState& state)
+		{
+			CommandArgs::CreateBlendState args{ state.ID, state.Desc };
+			CurrentRecording.Write(CommandType::CreateBlendState, &args, sizeof(args));
+		}
+
+		void StartRecording()
+		{
+			CurrentRecording.Clear();
+			Recording = true;
+
+			// NOTE: Buffers keep their current contents, so the recording starts from the state the first frame actually sees
+			for (const auto& [id, buffer] : Buffers) { RecordBuffer(*buffer); }
+			for (const auto& [id, shader] : Shaders) { RecordShader(*shader); }
+			for (const auto& [id, desc] : VertexDescs) { RecordVertexDesc(*desc); }
+			for (const auto& [id, texture] : Textures) { RecordTexture(*texture); }
+			for (const auto& [id, state] : BlendStates) { RecordBlendState(*state); }
+
+			Record(CommandType::SetViewport, CommandArgs::SetViewport{ CurrentViewport });
+			Record(CommandType::SetVertexBuffer, CommandArgs::SetVertexBuffer{ Bound.VertexBuffer, Bound.VertexDesc });
+			Record(CommandType::SetIndexBuffer, CommandArgs::Resource{ Bound.IndexBuffer });
+			Record(CommandType::SetShader, CommandArgs::Resource{ Bound.Shader });
+			Record(CommandType::SetBlendState, CommandArgs::Resource{ Bound.BlendState });
+
+			for (u32 slot = 0; slot < MaxTextureSlots; slot++)
+			{
+				if (Bound.Textures[slot] != 0) { Record(CommandType::SetTexture, CommandArgs::SetTexture{ Bound.Textures[slot], slot }); }
+			}
+
+			for (size_t stage = 0; stage < Bound.UniformBuffers.size(); stage++)
+			{
+				for (u32 slot = 0; slot < MaxUniformBufferSlots; slot++)
+				{
+					const ResourceID buffer = Bound.UniformBuffers[stage][slot];
+					if (buffer != 0) { Record(CommandType::SetUniformBuffer, CommandArgs::SetUniformBuffer{ buffer, static_cast<ShaderStage>(stage), slot }); }
+				}
+			}
+
+			LogInfo(LogName, "Recording started");
+		}
+
+		CommandRecording StopRecording()
+		{
+			Recording = false;
+			LogInfo(LogName, "Recording stopped: %u frames, %zu bytes", CurrentRecording.GetFrameCount(), CurrentRecording.GetSize());
+
+			CommandRecording result = std::move(CurrentRecording);
+			CurrentRecording.Clear();
+			return result;
+		}
+
+		void OnResourceDestroyed(CommandType destroyCommand, ResourceID id)
+		{
+			switch (destroyCommand)
+			{
+			case CommandType::DestroyBuffer: Buffers.erase(id); break;
+			case CommandType::DestroyShader: Shaders.erase(id); break;
+			case CommandType::DestroyVertexDesc: VertexDescs.erase(id); break;
+			case CommandType::DestroyTexture: Textures.erase(id); break;
+			case CommandType::DestroyBlendState: BlendStates.erase(id); break;
+			default: assert(false); return;
+			}
+
+			Record(destroyCommand, CommandArgs::Resource{ id });
+		}
+	};
+
+	NullDevice::NullDevice() : impl(std::make_unique<Impl>(*this))
+	{
+	}
+
+	NullDevice::~NullDevice()
+	{
+	}
+
+	bool NullDevice::Initialize(SDL_Window* gameWindow)
+	{
+		return impl->Initialize(gameWindow);
+	}
+
+	void NullDevice::Destroy()
+	{
+		impl->Destroy();
+	}
+
+	void NullDevice::ReportExistingObjects()
+	{
+		LogInfo(LogName, "Existing objects: %zu buffers, %zu shaders, %zu vertex descs, %zu textures, %zu blend states",
+			impl->Buffers.size(), impl->Shaders.size(), impl->VertexDescs.size(), impl->Textures.size(), impl->BlendStates.size());
+	}
+
+	void NullDevice::OnWindowResize(i32 width, i32 height)
+	{
+		SetViewportSize(RectangleF(0.0f, 0.0f, static_cast<f32>(width), static_cast<f32>(height)));
+	}
+
+	RectangleF NullDevice::GetViewportSize() const
+	{
+		return impl->CurrentViewport;
+	}
+
+	void NullDevice::SetViewportSize(const RectangleF& newSize)
+	{
+		impl->CurrentViewport = newSize;
+		impl->Record(CommandType::SetViewport, CommandArgs::SetViewport{ newSize });
+	}
+
+	void NullDevice::Clear(ClearFlags flags, const Color& color, f32 depth, u8 stencil)
+	{
+		impl->Record(CommandType::Clear, CommandArgs::Clear{ flags, color, depth, stencil });
+	}
+
+	void NullDevice::SwapBuffers()
+	{
+		impl->SwapBuffers();
+	}
+
+	void NullDevice::DrawArrays(PrimitiveType type, u32 firstVertex, u32 vertexCount)
+	{
+		impl->FrameStats.DrawCalls++;
+		impl->FrameStats.Vertices += vertexCount;
+		impl->Record(CommandType::DrawArrays, CommandArgs::DrawArrays{ type, firstVertex, vertexCount });
+	}
+
+	void NullDevice::DrawIndexed(PrimitiveType type, u32 firstIndex, u32 baseVertexIndex, u32 indexCount)
+	{
+		impl->FrameStats.DrawCalls++;
+		impl->FrameStats.Vertices += indexCount;
+		impl->Record(CommandType::DrawIndexed, CommandArgs::DrawIndexed{ type, firstIndex, baseVertexIndex, indexCount });
+	}
+
+	bool NullDevice::CreateBuffer(const BufferCreationData& props, std::unique_ptr<Buffer>& buffer)
+	{
+		auto nullBuffer = std::make_unique<NullBuffer>(*this, ++impl->LastResourceID, props);
+		impl->Buffers[nullBuffer->ID] = nullBuffer.get();
+
+		if (props.InitialData != nullptr)
+		{
+			impl->FrameStats.BufferUploads++;
+			impl->FrameStats.UploadedBytes += props.Size;
+		}
+
+		if (impl->Recording) { impl->RecordBuffer(*nullBuffer); }
+
+		buffer = std::move(nullBuffer);
+		return true;
+	}
+
+	bool NullDevice::CreateShader(const void* vsData, size_t vsSize, const void* fsData, size_t fsSize, std::unique_ptr<Shader>& shader)
+	{
+		if (vsData == nullptr || fsData == nullptr || vsSize == 0 || fsSize == 0) { return false; }
+
+		auto nullShader = std::make_unique<NullShader>(*this, ++impl->LastResourceID, vsData, vsSize, fsData, fsSize);
+		impl->Shaders[nullShader->ID] = nullShader.get();
+
+		if (impl->Recording) { impl->RecordShader(*nullShader); }
+
+		shader = std::move(nullShader);
+		return true;
+	}
+
+	bool NullDevice::CreateVertexDesc(const VertexAttrib* attribs, size_t attribCount, const Shader* shader, std::unique_ptr<VertexDesc>& desc)
+	{
+		if (shader == nullptr || attribs == nullptr || attribCount == 0 || attribCount > 8) { return false; }
+
+		auto nullDesc = std::make_unique<NullVertexDesc>(*this, ++impl->LastResourceID, attribs, attribCount, static_cast<const NullShader*>(shader));
+		impl->VertexDescs[nullDesc->ID] = nullDesc.get();
+
+		if (impl->Recording) { impl->RecordVertexDesc(*nullDesc); }
+
+		desc = std::move(nullDesc);
+		return true;
+	}
+
+	bool NullDevice::UploadTexture(Graphics::Texture* texture)
+	{
+		assert(texture != nullptr);
+		assert(texture->GetData() != nullptr);
+
+		auto nullTexture = std::make_unique<NullTexture>(*this, ++impl->LastResourceID, texture);
+		impl->Textures[nullTexture->ID] = nullTexture.get();
+
+		impl->FrameStats.TextureUploads++;
+		impl->FrameStats.UploadedBytes += texture->GetDataSize();
+
+		if (impl->Recording) { impl->RecordTexture(*nullTexture); }
+
+		texture->GPUTexture.Resource = std::move(nullTexture);
+		return true;
+	}
+
+	bool NullDevice::CreateBlendState(const BlendStateDesc& desc, std::unique_ptr<BlendState>& state)
+	{
+		auto nullState = std::make_unique<NullBlendState>(*this, ++impl->LastResourceID, desc);
+		impl->BlendStates[nullState->ID] = nullState.get();
+
+		if (impl->Recording) { impl->RecordBlendState(*nullState); }
+
+		state = std::move(nullState);
+		return true;
+	}
+
+	void NullDevice::SetVertexBuffer(const Buffer* buffer, const VertexDesc* desc)
+	{
+		const NullBuffer* nullBuffer = static_cast<const NullBuffer*>(buffer);
+		const NullVertexDesc* nullDesc = static_cast<const NullVertexDesc*>(desc);
+		assert(nullBuffer == nullptr || nullBuffer->Properties.Type == BufferType::Vertex);
+
+		const ResourceID bufferID = (nullBuffer != nullptr && nullDesc != nullptr) ? nullBuffer->ID : 0;
+		const ResourceID descID = (nullBuffer != nullptr && nullDesc != nullptr) ? nullDesc->ID : 0;
+
+		// NOTE: Counted as a single bind, the backends set both at once as well
+		if (impl->Bound.VertexBuffer == bufferID && impl->Bound.VertexDesc == descID)
+		{
+			impl->FrameStats.RedundantBinds++;
+		}
+		else
+		{
+			impl->Bound.VertexBuffer = bufferID;
+			impl->Bound.VertexDesc = descID;
+			impl->FrameStats.StateChanges++;
+		}
+
+		impl->Record(CommandType::SetVertexBuffer, CommandArgs::SetVertexBuffer{ bufferID, descID });
+	}
+
+	void NullDevice::SetIndexBuffer(const Buffer* buffer)
+	{
+		const NullBuffer* nullBuffer = static_cast<const NullBuffer*>(buffer);
+		assert(nullBuffer == nullptr || nullBuffer->Properties.Type == BufferType::Index);
+
+		const ResourceID bufferID = (nullBuffer != nullptr) ? nullBuffer->ID : 0;
+		impl->Bind(impl->Bound.IndexBuffer, bufferID);
+		impl->Record(CommandType::SetIndexBuffer, CommandArgs::Resource{ bufferID });
+	}
+
+	void NullDevice::SetUniformBuffer(const Buffer* buffer, ShaderStage stage, u32 bufferIndex)
+	{
+		const NullBuffer* nullBuffer = static_cast<const NullBuffer*>(buffer);
+		assert(nullBuffer == nullptr || nullBuffer->Properties.Type == BufferType::Uniform);
+
+		if (bufferIndex >= MaxUniformBufferSlots || stage >= ShaderStage::Count)
+		{
+			return;
+		}
+
+		const ResourceID bufferID = (nullBuffer != nullptr) ? nullBuffer->ID : 0;
+		impl->Bind(impl->Bound.UniformBuffers[static_cast<size_t>(stage)][bufferIndex], bufferID);
+		impl->Record(CommandType::SetUniformBuffer, CommandArgs::SetUniformBuffer{ bufferID, stage, bufferIndex });
+	}
+
+	void NullDevice::SetShader(const Shader* shader)
+	{
+		const ResourceID shaderID = (shader != nullptr) ? static_cast<const NullShader*>(shader)->ID : 0;
+		impl->Bind(impl->Bound.Shader, shaderID);
+		impl->Record(CommandType::SetShader, CommandArgs::Resource{ shaderID });
+	}
+
+	void NullDevice::SetTexture(Graphics::Texture* texture, u32 slot)
+	{
+		if (slot >= MaxTextureSlots)
+		{
+			return;
+		}
+
+		if (texture != nullptr && texture->GPUTexture.Resource == nullptr)
+			UploadTexture(texture);
+
+		const ResourceID textureID = (texture != nullptr) ? static_cast<const NullTexture*>(texture->GPUTexture.Resource.get())->ID : 0;
+		impl->Bind(impl->Bound.Textures[slot], textureID);
+		impl->Record(CommandType::SetTexture, CommandArgs::SetTexture{ textureID, slot });
+	}
+
+	void NullDevice::SetBlendState(const BlendState* state)
+	{
+		const ResourceID stateID = (state != nullptr) ? static_cast<const NullBlendState*>(state)->ID : 0;
+		impl->Bind(impl->Bound.BlendState, stateID);
+		impl->Record(CommandType::SetBlendState, CommandArgs::Resource{ stateID });
+	}
+
+	void NullDevice::StartRecording()
+	{
+		impl->StartRecording();
+	}
+
+	CommandRecording NullDevice::StopRecording()
+	{
+		return impl->StopRecording();
+	}
+
+	bool NullDevice::IsRecording() const
+	{
+		return impl->Recording;
+	}
+
+	NullFrameStats NullDevice::GetLastFrameStats() const
+	{
+		return impl->LastFrameStats;
+	}
+
+	void NullDevice::OnBufferDataSet(const NullBuffer& buffer, size_t offset, size_t size)
+	{
+		impl->FrameStats.BufferUploads++;
+		impl->FrameStats.UploadedBytes += size;
+
+		impl->Record(CommandType::SetBufferData, CommandArgs::SetBufferData{ buffer.ID, offset }, &buffer.Data[offset], size);
+	}
+
+	void NullDevice::OnResourceDestroyed(CommandType destroyCommand, ResourceID id)
+	{
+		impl->OnResourceDestroyed(destroyCommand, id);
+	}
+}
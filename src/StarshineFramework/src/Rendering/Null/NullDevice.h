@@ -0,0 +1,89 @@
+#pragma once
+#include "Rendering/Device.h"
+#include "CommandRecording.h"
+
+namespace Starshine::Rendering::Null
+{
+	struct NullBuffer;
+
+	struct NullFrameStats
+	{
+		u32 DrawCalls{};
+		// NOTE: Vertices of DrawArrays() and indices of DrawIndexed()
+		u32 Vertices{};
+
+		// NOTE: Binds that changed something, and binds of whatever was already bound
+		u32 StateChanges{};
+		u32 RedundantBinds{};
+
+		u32 BufferUploads{};
+		u32 TextureUploads{};
+		u64 UploadedBytes{};
+	};
+
+	// NOTE: Executes nothing, it only counts what a frame asks of the device and can record the commands to replay them on another device later.
+	//		 Meant for measuring batching without a GPU, it works without a window too
+	class NullDevice : public Device
+	{
+	public:
+		NullDevice();
+		~NullDevice();
+
+	public:
+		bool Initialize(SDL_Window* gameWindow);
+		void Destroy();
+		void ReportExistingObjects();
+
+	public:
+		void OnWindowResize(i32 width, i32 height);
+
+	public:
+		RectangleF GetViewportSize() const;
+		void SetViewportSize(const RectangleF& newSize);
+
+	public:
+		void Clear(ClearFlags flags, const Color& color, f32 depth, u8 stencil);
+		void SwapBuffers();
+
+	public:
+		void DrawArrays(PrimitiveType type, u32 firstVertex, u32 vertexCount);
+		void DrawIndexed(PrimitiveType type, u32 firstIndex, u32 baseVertexIndex, u32 indexCount);
+
+	public:
+		bool CreateBuffer(const BufferCreationData& props, std::unique_ptr<Buffer>& buffer);
+
+		bool CreateShader(const void* vsData, size_t vsSize, const void* fsData, size_t fsSize, std::unique_ptr<Shader>& shader);
+		bool CreateVertexDesc(const VertexAttrib* attribs, size_t attribCount, const Shader* shader, std::unique_ptr<VertexDesc>& desc);
+
+		bool UploadTexture(Graphics::Texture* texture);
+
+		bool CreateBlendState(const BlendStateDesc& desc, std::unique_ptr<BlendState>& state);
+
+	public:
+		void SetVertexBuffer(const Buffer* buffer, const VertexDesc* desc);
+		void SetIndexBuffer(const Buffer* buffer);
+		void SetUniformBuffer(const Buffer* buffer, ShaderStage stage, u32 bufferIndex);
+		void SetShader(const Shader* shader);
+		void SetTexture(Graphics::Texture* texture, u32 slot);
+
+		void SetBlendState(const BlendState* state);
+
+	public:
+		// NOTE: Resources that already exist and the current bindings are recorded first, so the recording can be replayed on its own
+		void StartRecording();
+		CommandRecording StopRecording();
+		bool IsRecording() const;
+
+		// NOTE: Stats of the last frame that was presented with SwapBuffers()
+		NullFrameStats GetLastFrameStats() const;
+
+	public:
+		// NOTE: Called by the resources themselves
+		void OnBufferDataSet(const NullBuffer& buffer, size_t offset, size_t size);
+		void OnResourceDestroyed(CommandType destroyCommand, ResourceID id);
+
+	private:
+		struct Impl;
+		std::unique_ptr<Impl> impl{ nullptr };
+	};
+}
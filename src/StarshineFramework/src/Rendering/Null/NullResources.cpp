@@ -0,0 +1,80 @@
+#include "NullResources.h"
+
+namespace Starshine::Rendering::Null
+{
+	NullBuffer::NullBuffer(NullDevice& device, ResourceID id, const BufferCreationData& props)
+		: ID(id), Properties(props), deviceRef(device)
+	{
+		if (!props.Dynamic) assert(props.InitialData != nullptr);
+
+		Data = std::make_unique<u8[]>(props.Size);
+		if (props.InitialData != nullptr)
+		{
+			SDL_memcpy(Data.get(), props.InitialData, props.Size);
+		}
+		else
+		{
+			SDL_memset(Data.get(), 0, props.Size);
+		}
+
+		Properties.InitialData = nullptr;
+	}
+
+	NullBuffer::~NullBuffer()
+	{
+		deviceRef.OnResourceDestroyed(CommandType::DestroyBuffer, ID);
+	}
+
+	void NullBuffer::SetData(const void* source, size_t offset, size_t size)
+	{
+		// NOTE: Same rules as the other devices, only dynamic buffers can be written to
+		if (Properties.Dynamic && (offset + size) <= Properties.Size)
+		{
+			SDL_memcpy(&Data[offset], source, size);
+			deviceRef.OnBufferDataSet(*this, offset, size);
+		}
+	}
+
+	NullShader::NullShader(NullDevice& device, ResourceID id, const void* vsData, size_t vsSize, const void* fsData, size_t fsSize)
+		: ID(id), VertexShaderSize(vsSize), deviceRef(device)
+	{
+		Data.resize(vsSize + fsSize);
+		SDL_memcpy(Data.data(), vsData, vsSize);
+		SDL_memcpy(Data.data() + vsSize, fsData, fsSize);
+	}
+
+	NullShader::~NullShader()
+	{
+		deviceRef.OnResourceDestroyed(CommandType::DestroyShader, ID);
+	}
+
+	NullVertexDesc::NullVertexDesc(NullDevice& device, ResourceID id, const VertexAttrib* attribs, size_t attribCount, const NullShader* shader)
+		: ID(id), Attribs(attribs, attribs + attribCount), ShaderID(shader != nullptr ? shader->ID : 0), deviceRef(device)
+	{
+	}
+
+	NullVertexDesc::~NullVertexDesc()
+	{
+		deviceRef.OnResourceDestroyed(CommandType::DestroyVertexDesc, ID);
+	}
+
+	NullTexture::NullTexture(NullDevice& device, ResourceID id, Graphics::Texture* texture)
+		: ID(id), ParentTexture(texture), deviceRef(device)
+	{
+	}
+
+	NullTexture::~NullTexture()
+	{
+		deviceRef.OnResourceDestroyed(CommandType::DestroyTexture, ID);
+	}
+
+	NullBlendState::NullBlendState(NullDevice& device, ResourceID id, const BlendStateDesc& desc)
+		: BlendState(desc), ID(id), deviceRef(device)
+	{
+	}
+
+	NullBlendState::~NullBlendState()
+	{
+		deviceRef.OnResourceDestroyed(CommandType::DestroyBlendState, ID);
+	}
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include "Rendering/Buffers.h"
+#include "Rendering/Shader.h"
+#include "Rendering/VertexDesc.h"
+#include "Rendering/Texture.h"
+#include "Rendering/State.h"
+#include "CommandRecording.h"
+#include "NullDevice.h"
+#include <memory>
+#include <vector>
+
+namespace Starshine::Rendering::Null
+{
+	// NOTE: The null device executes nothing, but its resources keep everything they were created from,
+	//		 so that a recording started later on can recreate them first
+
+	struct NullBuffer : public Buffer
+	{
+	public:
+		NullBuffer(NullDevice& device, ResourceID id, const BufferCreationData& props);
+		~NullBuffer() override;
+
+	public:
+		void SetData(const void* source, size_t offset, size_t size);
+
+	public:
+		const ResourceID ID{};
+		std::unique_ptr<u8[]> Data{};
+		BufferCreationData Properties{};
+
+		NullDevice& deviceRef;
+	};
+
+	struct NullShader : public Shader
+	{
+	public:
+		NullShader(NullDevice& device, ResourceID id, const void* vsData, size_t vsSize, const void* fsData, size_t fsSize);
+		~NullShader() override;
+
+	public:
+		const ResourceID ID{};
+		size_t VertexShaderSize{};
+		// NOTE: Vertex shader data followed by the fragment shader data
+		std::vector<u8> Data;
+
+		NullDevice& deviceRef;
+	};
+
+	struct NullVertexDesc : public VertexDesc
+	{
+	public:
+		NullVertexDesc(NullDevice& device, ResourceID id, const VertexAttrib* attribs, size_t attribCount, const NullShader* shader);
+		~NullVertexDesc() override;
+
+	public:
+		const ResourceID ID{};
+		std::vector<VertexAttrib> Attribs;
+		ResourceID ShaderID{};
+
+		NullDevice& deviceRef;
+	};
+
+	struct NullTexture : public Texture
+	{
+	public:
+		NullTexture(NullDevice& device, ResourceID id, Graphics::Texture* texture);
+		~NullTexture() override;
+
+	public:
+		const ResourceID ID{};
+		Graphics::Texture* ParentTexture{};
+
+		NullDevice& deviceRef;
+	};
+
+	struct NullBlendState : public BlendState
+	{
+	public:
+		NullBlendState(NullDevice& device, ResourceID id, const BlendStateDesc& desc);
+		~NullBlendState() override;
+
+	public:
+		const ResourceID ID{};
+
+		NullDevice& deviceRef;
+	};
+}
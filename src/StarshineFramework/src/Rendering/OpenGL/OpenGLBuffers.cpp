@@ -1,38 +1,144 @@
 #include "OpenGLBuffers.h"
+#include "Common/MathExt.h"
+#include <SDL2/SDL_timer.h>
 
 namespace Starshine::Rendering::OpenGL
 {
-	VertexBuffer_OpenGL::VertexBuffer_OpenGL(OpenGLDevice& device, size_t size, bool dynamic)
-		: DeviceRef(device), Size(size), Dynamic(dynamic) {}
+	// NOTE: Dynamic buffers get about this much memory in total, enough regions for a few frames of sprite uploads
+	static constexpr size_t DynamicRingTargetSize = 8 * 1024 * 1024;
+	static constexpr size_t MinDynamicRegions = 3;
+	static constexpr size_t MaxDynamicRegions = 64;
 
-	VertexBuffer_OpenGL::~VertexBuffer_OpenGL()
+	OpenGLBuffer::OpenGLBuffer(OpenGLDevice& device, const BufferCreationData& props)
+		: Properties(props), deviceRef(device)
 	{
-		glDeleteBuffersARB(1, &Handle);
+		if (!props.Dynamic) assert(props.InitialData != nullptr);
+
+		const OpenGLCapabilities& caps = device.GetCapabilities();
+
+		// NOTE: Same as D3D11, uniform buffers are kept at a multiple of 16
+		RegionSize = (props.Type == BufferType::Uniform) ? MathExtensions::GetAlignedSize(props.Size, 16) : props.Size;
+
+		if (props.Dynamic)
+		{
+			RegionSize = MathExtensions::GetAlignedSize(RegionSize, static_cast<size_t>(caps.UniformBufferOffsetAlignment));
+			RegionCount = static_cast<u32>(MathExtensions::Clamp<size_t>(DynamicRingTargetSize / RegionSize, MinDynamicRegions, MaxDynamicRegions));
+			RegionFences.resize(RegionCount, nullptr);
+		}
+
+		const GLsizeiptr totalSize = static_cast<GLsizeiptr>(RegionSize * RegionCount);
+
+		// NOTE: Bound to the copy target so the vertex array's index buffer binding isn't touched
+		glGenBuffers(1, &BaseBuffer);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, BaseBuffer);
+
+		if (caps.BufferStorage != nullptr)
+		{
+			if (props.Dynamic)
+			{
+				static constexpr GLbitfield mapFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+				caps.BufferStorage(GL_COPY_WRITE_BUFFER, totalSize, nullptr, mapFlags);
+				MappedData = reinterpret_cast<u8*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, totalSize, mapFlags));
+
+				if (props.InitialData != nullptr)
+					::memcpy(MappedData, props.InitialData, props.Size);
+			}
+			else if (RegionSize == props.Size)
+			{
+				caps.BufferStorage(GL_COPY_WRITE_BUFFER, totalSize, props.InitialData, 0);
+			}
+			else
+			{
+				// NOTE: Immutable storage has to be filled up front, including the padding of uniform buffers
+				std::vector<u8> initialData(RegionSize, 0);
+				::memcpy(initialData.data(), props.InitialData, props.Size);
+				caps.BufferStorage(GL_COPY_WRITE_BUFFER, totalSize, initialData.data(), 0);
+			}
+		}
+		else
+		{
+			glBufferData(GL_COPY_WRITE_BUFFER, totalSize, nullptr, props.Dynamic ? GL_STREAM_DRAW : GL_STATIC_DRAW);
+			if (props.InitialData != nullptr)
+				glBufferSubData(GL_COPY_WRITE_BUFFER, 0, static_cast<GLsizeiptr>(props.Size), props.InitialData);
+		}
+
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
 	}
 
-	void VertexBuffer_OpenGL::SetData(const void* source, size_t offset, size_t size)
+	OpenGLBuffer::~OpenGLBuffer()
 	{
-		if (Handle != 0 && Dynamic && source != nullptr && size + offset < Size)
+		deviceRef.OnBufferDestroyed(this);
+
+		for (GLsync& fence : RegionFences)
 		{
-			glBindBufferARB(GL_ARRAY_BUFFER_ARB, Handle);
-			glBufferSubDataARB(GL_ARRAY_BUFFER_ARB, offset, size, source);
+			if (fence != nullptr)
+				glDeleteSync(fence);
 		}
+
+		// NOTE: Deleting a buffer unmaps it as well
+		glDeleteBuffers(1, &BaseBuffer);
 	}
 
-	IndexBuffer_OpenGL::IndexBuffer_OpenGL(OpenGLDevice& device, size_t size, IndexFormat format, bool dynamic)
-		: DeviceRef(device), Size(size), Format(format), Dynamic(dynamic) {}
+	void OpenGLBuffer::SetData(const void* source, size_t offset, size_t size)
+	{
+		if (!Properties.Dynamic || (offset + size) > Properties.Size) { return; }
+
+		if (MappedData == nullptr)
+		{
+			CurrentRegion = (CurrentRegion + 1) % RegionCount;
 
-	IndexBuffer_OpenGL::~IndexBuffer_OpenGL()
+			glBindBuffer(GL_COPY_WRITE_BUFFER, BaseBuffer);
+			glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(GetCurrentOffset() + offset), static_cast<GLsizeiptr>(size), source);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+			deviceRef.OnBufferDataSet(size, false, 0.0);
+			return;
+		}
+
+		// NOTE: Every draw that read the current region has been issued by now
+		RegionFences[CurrentRegion] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		CurrentRegion = (CurrentRegion + 1) % RegionCount;
+
+		bool waitedForFence = false;
+		f64 waitTime_ms = 0.0;
+
+		GLsync& regionFence = RegionFences[CurrentRegion];
+		if (regionFence != nullptr)
+		{
+			if (glClientWaitSync(regionFence, 0, 0) == GL_TIMEOUT_EXPIRED)
+			{
+				// NOTE: The GPU is a whole ring behind, this is the only place where the CPU ever waits for it
+				static constexpr GLuint64 waitTimeout_ns = 1'000'000'000;
+				const u64 waitStart = SDL_GetPerformanceCounter();
+
+				while (glClientWaitSync(regionFence, GL_SYNC_FLUSH_COMMANDS_BIT, waitTimeout_ns) == GL_TIMEOUT_EXPIRED) {}
+
+				waitedForFence = true;
+				waitTime_ms = static_cast<f64>(SDL_GetPerformanceCounter() - waitStart) * 1000.0 / static_cast<f64>(SDL_GetPerformanceFrequency());
+			}
+
+			glDeleteSync(regionFence);
+			regionFence = nullptr;
+		}
+
+		::memcpy(&MappedData[GetCurrentOffset() + offset], source, size);
+		deviceRef.OnBufferDataSet(size, waitedForFence, waitTime_ms);
+	}
+
+	void OpenGLBuffer::SetDebugName(std::string_view name)
 	{
-		glDeleteBuffersARB(1, &Handle);
+#if defined (_DEBUG)
+		glObjectLabel(GL_BUFFER, BaseBuffer, static_cast<GLsizei>(name.length()), name.data());
+#endif
 	}
 
-	void IndexBuffer_OpenGL::SetData(const void* source, size_t offset, size_t size)
+	size_t OpenGLBuffer::GetCurrentOffset() const
 	{
-		if (Handle != 0 && Dynamic && source != nullptr && size + offset < Size)
-		{
-			glBindBufferARB(GL_ELEMENT_ARRAY_BUFFER_ARB, Handle);
-			glBufferSubDataARB(GL_ELEMENT_ARRAY_BUFFER_ARB, offset, size, source);
-		}
+		return static_cast<size_t>(CurrentRegion) * RegionSize;
+	}
+
+	size_t OpenGLBuffer::GetBindSize() const
+	{
+		return (Properties.Type == BufferType::Uniform) ? MathExtensions::GetAlignedSize(Properties.Size, 16) : Properties.Size;
 	}
 }
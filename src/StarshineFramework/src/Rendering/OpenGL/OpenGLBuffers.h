@@ -1,36 +1,38 @@
 #pragma once
 #include "Rendering/Buffers.h"
 #include "OpenGLDevice.h"
-#include <glad/glad.h>
+#include <vector>
 
 namespace Starshine::Rendering::OpenGL
 {
-	struct VertexBuffer_OpenGL : public VertexBuffer
+	// NOTE: Dynamic buffers are persistently mapped and split into a ring of regions. Every SetData() moves on to the next region
+	//		 (like D3D11's WRITE_DISCARD does), so the data is written straight into memory the GPU reads from while the draws
+	//		 of the previous regions are still in flight. Each region is fenced when it's left and only waited on when it's reused
+	struct OpenGLBuffer : public Buffer
 	{
-		VertexBuffer_OpenGL(OpenGLDevice& device, size_t size, bool dynamic);
-		~VertexBuffer_OpenGL();
+	public:
+		OpenGLBuffer(OpenGLDevice& device, const BufferCreationData& props);
+		~OpenGLBuffer() override;
 
-		void SetData(const void* source, size_t offset, size_t size) override;
+	public:
+		void SetData(const void* source, size_t offset, size_t size);
+		void SetDebugName(std::string_view name);
 
-		OpenGLDevice& DeviceRef;
+		// NOTE: Start of the region the last SetData() wrote to, which is what draws have to read from
+		size_t GetCurrentOffset() const;
+		size_t GetBindSize() const;
 
-		GLuint Handle = 0;
-		size_t Size = 0;
-		bool Dynamic = false;
-	};
-
-	struct IndexBuffer_OpenGL : public IndexBuffer
-	{
-		IndexBuffer_OpenGL(OpenGLDevice& device, size_t size, IndexFormat format, bool dynamic);
-		~IndexBuffer_OpenGL();
+	public:
+		GLuint BaseBuffer{};
+		BufferCreationData Properties{};
 
-		void SetData(const void* source, size_t offset, size_t size) override;
+		size_t RegionSize{};
+		u32 RegionCount{ 1 };
+		u32 CurrentRegion{};
 
-		OpenGLDevice& DeviceRef;
+		std::vector<GLsync> RegionFences{};
+		u8* MappedData{};
 
-		GLuint Handle = 0;
-		size_t Size = 0;
-		bool Dynamic = false;
-		IndexFormat Format = {};
+		OpenGLDevice& deviceRef;
 	};
 }
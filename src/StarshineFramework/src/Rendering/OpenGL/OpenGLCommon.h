@@ -1,12 +1,41 @@
 #pragma once
 #include "Rendering/Types.h"
+#include "Rendering/VertexDesc.h"
 #include <glad/glad.h>
 
+// NOTE: glad is generated for GL 4.3, buffer storage (GL 4.4 / ARB_buffer_storage) is loaded by the device itself
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#define GL_MAP_COHERENT_BIT 0x0080
+#define GL_DYNAMIC_STORAGE_BIT 0x0100
+#define GL_CLIENT_STORAGE_BIT 0x0200
+#endif
+
+typedef void (APIENTRYP PFNSTARSHINEGLBUFFERSTORAGEPROC)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+
 namespace Starshine::Rendering::OpenGL
 {
+	// NOTE: GLSL has no register semantics, the shaders have to declare these explicitly (see glshaders/)
+	namespace Bindings
+	{
+		// NOTE: Vertex uniform buffer N is at binding N, fragment uniform buffer N at FragmentUniformBufferBase + N
+		static constexpr u32 FragmentUniformBufferBase = 8;
+
+		// NOTE: Texture slot N is texture unit N, the last unit is kept for uploads so they don't disturb the bound textures
+		static constexpr u32 UploadTextureUnit = 15;
+
+		// NOTE: Attribute location is the base of its type + its index, e.g. COLOR0 -> 4, TEXCOORD1 -> 9
+		static constexpr std::array<GLuint, EnumCount<VertexAttribType>()> AttribBaseLocations
+		{
+			0,
+			4,
+			8
+		};
+	}
+
 	namespace ConversionTables
 	{
-		constexpr std::array<GLenum, EnumCount<PrimitiveType>()> GLPrimitiveTypes =
+		static constexpr std::array<GLenum, EnumCount<PrimitiveType>()> GLPrimitiveTypes
 		{
 			GL_POINTS,
 			GL_LINES,
@@ -15,68 +44,30 @@ namespace Starshine::Rendering::OpenGL
 			GL_TRIANGLE_STRIP
 		};
 
-		constexpr std::array<GLenum, EnumCount<IndexFormat>()> GLIndexFormats =
+		static constexpr std::array<GLenum, EnumCount<IndexFormat>()> GLIndexFormats
 		{
 			GL_UNSIGNED_SHORT,
 			GL_UNSIGNED_INT
 		};
 
-		constexpr std::array<GLenum, EnumCount<BlendFactor>()> GLBlendFactors =
-		{
-			GL_ZERO,
-			GL_ONE,
-			GL_SRC_COLOR,
-			GL_ONE_MINUS_SRC_COLOR,
-			GL_DST_COLOR,
-			GL_ONE_MINUS_DST_COLOR,
-			GL_SRC_ALPHA,
-			GL_ONE_MINUS_SRC_ALPHA,
-			GL_DST_ALPHA,
-			GL_ONE_MINUS_DST_ALPHA
-		};
-
-		constexpr std::array<GLenum, EnumCount<BlendOperation>()> GLBlendOperations =
-		{
-			GL_FUNC_ADD,
-			GL_FUNC_SUBTRACT,
-			GL_FUNC_REVERSE_SUBTRACT,
-			GL_MIN,
-			GL_MAX
-		};
-
-		constexpr std::array<GLenum, EnumCount<PolygonOrientation>()> GLPolygonOrientation =
-		{
-			GL_CW,
-			GL_CCW
-		};
-
-		constexpr std::array<GLenum, EnumCount<Face>()> GLFace =
+		static constexpr std::array<size_t, EnumCount<IndexFormat>()> GLIndexSizes
 		{
-			GL_FRONT,
-			GL_BACK,
-			GL_FRONT_AND_BACK
+			sizeof(u16),
+			sizeof(u32)
 		};
 
-		constexpr std::array<GLenum, EnumCount<GFX::TextureFormat>()> GLTextureDataFormats =
+		static constexpr std::array<GLenum, EnumCount<Graphics::TextureFormat>()> GLTextureInternalFormats
 		{
-			GL_RGBA,
-			2, // https://docs.gl/gl2/glTexImage2D
-			GL_RED,
-
-			0,
-			0,
-			0
+			GL_RGBA8,
+			GL_RG8,
+			GL_R8
 		};
 
-		constexpr std::array<GLenum, EnumCount<GFX::TextureFormat>()> GLTextureDisplayFormats =
+		static constexpr std::array<GLenum, EnumCount<Graphics::TextureFormat>()> GLTextureDataFormats
 		{
 			GL_RGBA,
-			GL_LUMINANCE_ALPHA,
-			GL_RED,
-
-			GL_COMPRESSED_RGB_S3TC_DXT1_EXT,
-			GL_COMPRESSED_RGBA_S3TC_DXT3_EXT,
-			GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+			GL_RG,
+			GL_RED
 		};
 	}
 }
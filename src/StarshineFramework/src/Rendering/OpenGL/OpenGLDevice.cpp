@@ -1,461 +1,696 @@
-#include <glad/glad.h>
-#include "Common/MathExt.h"
-#include "Common/Logging/Logging.h"
-#include "Rendering/Types.h"
 #include "OpenGLDevice.h"
-#include "OpenGLCommon.h"
-#include "OpenGLBuffers.h"
-#include "OpenGLVertexDesc.h"
+#include "Common/Logging/Logging.h"
+#include "Misc/ImageHelper.h"
 #include "OpenGLShader.h"
+#include "OpenGLVertexDesc.h"
+#include "OpenGLBuffers.h"
 #include "OpenGLTexture.h"
-#include <array>
-#include "IO/Xml.h"
-#include "IO/Path/File.h"
+#include "OpenGLState.h"
+#include <SDL2/SDL_video.h>
+#include <cstring>
+
+#if defined (__linux__)
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
 
 namespace Starshine::Rendering::OpenGL
 {
-	using std::array;
-	using std::string_view;
+	static constexpr const char* LogName{ "OpenGLDevice" };
+
+	// NOTE: Same as the software device, used when there's no window to take the size from
+	static constexpr ivec2 DefaultOffscreenSize{ 1280, 720 };
 
-	constexpr const char* LogName = "Starshine::Rendering::OpenGL";
+	static constexpr size_t MaxUniformBufferSlots = 8;
+
+#if defined (_DEBUG)
+	static void APIENTRY OnDebugMessage(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* message, const void* userParam)
+	{
+		switch (severity)
+		{
+		case GL_DEBUG_SEVERITY_HIGH:
+			LogError(LogName, "%.*s", static_cast<int>(length), message);
+			break;
+		case GL_DEBUG_SEVERITY_MEDIUM:
+			LogWarn(LogName, "%.*s", static_cast<int>(length), message);
+			break;
+		}
+	}
+#endif
 
 	struct OpenGLDevice::Impl
 	{
-		SDL_Window* GameWindow = nullptr;
-		SDL_GLContext GLContext{};
+		OpenGLDevice& Parent;
 
-		bool VertexBufferSet = false;
-		bool VertexDescSet = false;
+		SDL_Window* SDLWindow{};
+		SDL_GLContext SDLContext{};
 
-		bool IndexBufferSet = false;
-		GLenum CurrentIndexFormat = 0;
+#if defined (__linux__)
+		struct EGLData
+		{
+			EGLDisplay Display{ EGL_NO_DISPLAY };
+			EGLContext Context{ EGL_NO_CONTEXT };
+		} EGL;
+#endif
+
+		OpenGLCapabilities Capabilities{};
+
+		// NOTE: Only used without a window, the window's default framebuffer is used otherwise
+		struct OffscreenData
+		{
+			GLuint Framebuffer{};
+			GLuint ColorRenderbuffer{};
+		} Offscreen;
 
-		bool ShaderSet = false;
+		ivec2 FramebufferSize{};
+		RectangleF CurrentViewport{};
 
-		bool Initialize(SDL_Window* gameWindow)
+		struct BufferBinding
 		{
-			u32 windowFlags = SDL_GetWindowFlags(gameWindow);
-			if ((windowFlags & SDL_WINDOW_OPENGL) != SDL_WINDOW_OPENGL)
+			const OpenGLBuffer* Buffer{};
+			// NOTE: Dynamic buffers move to another region with every SetData(), so the bound range is checked before each draw
+			size_t BoundOffset{};
+			bool Dirty{};
+		};
+
+		struct DrawStateData
+		{
+			BufferBinding VertexBuffer{};
+			GLuint VertexArray{};
+			GLsizei VertexStride{};
+
+			const OpenGLBuffer* IndexBuffer{};
+			bool IndexBufferDirty{};
+
+			std::array<BufferBinding, MaxUniformBufferSlots * EnumCount<ShaderStage>()> UniformBuffers{};
+		} DrawState;
+
+		struct DrawCheckFlagsData
+		{
+			bool VertexBufferSet{ false };
+			bool IndexBufferSet{ false };
+			bool VertexDescSet{ false };
+			bool ShaderSet{ false };
+		} DrawCheckFlags;
+
+		OpenGLFrameStats CurrentFrameStats{};
+		OpenGLFrameStats LastFrameStats{};
+
+		Impl(OpenGLDevice& parent) : Parent(parent)
+		{
+		}
+
+		~Impl()
+		{
+		}
+
+		bool Initialize(SDL_Window* window)
+		{
+			SDLWindow = window;
+			GLADloadproc loadProc{};
+
+			if (window != nullptr)
 			{
-				LogError(LogName, "Game window is not an OpenGL window (SDL_WINDOW_OPENGL was not specified in SDL_CreateWindow)");
+				SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 4);
+				SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
+				SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+				SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
+				SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 0);
+#if defined (_DEBUG)
+				SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS, SDL_GL_CONTEXT_DEBUG_FLAG);
+#endif
+
+				if ((SDLContext = SDL_GL_CreateContext(window)) == nullptr)
+				{
+					LogError(LogName, "SDL_GL_CreateContext failed. Error: %s", SDL_GetError());
+					return false;
+				}
+
+				SDL_GL_MakeCurrent(window, SDLContext);
+				SDL_GL_SetSwapInterval(1);
+				SDL_GL_GetDrawableSize(window, &FramebufferSize.x, &FramebufferSize.y);
+
+				loadProc = reinterpret_cast<GLADloadproc>(SDL_GL_GetProcAddress);
+			}
+			else
+			{
+#if defined (__linux__)
+				if (!CreateSurfacelessContext()) { return false; }
+
+				FramebufferSize = DefaultOffscreenSize;
+				loadProc = reinterpret_cast<GLADloadproc>(eglGetProcAddress);
+#else
+				LogError(LogName, "Rendering without a window needs EGL, which is only used on Linux");
+				return false;
+#endif
+			}
+
+			if (gladLoadGLLoader(loadProc) == 0)
+			{
+				LogError(LogName, "Failed to load the GL functions");
+				return false;
+			}
+
+			if (!GLAD_GL_VERSION_4_3)
+			{
+				LogError(LogName, "GL 4.3 is needed, the context only has %d.%d", GLVersion.major, GLVersion.minor);
 				return false;
 			}
 
-			GameWindow = gameWindow;
+			LogInfo(LogName, "%s, %s", glGetString(GL_RENDERER), glGetString(GL_VERSION));
+
+			LoadCapabilities(loadProc);
 
-			SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 4);
-			SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
-			SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
 #if defined (_DEBUG)
-			SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS, SDL_GL_CONTEXT_DEBUG_FLAG);
+			glEnable(GL_DEBUG_OUTPUT);
+			glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+			glDebugMessageCallback(OnDebugMessage, nullptr);
 #endif
 
-			if ((GLContext = SDL_GL_CreateContext(GameWindow)) == NULL)
+			if (SDLWindow == nullptr)
+			{
+				CreateOffscreenFramebuffer(FramebufferSize);
+			}
+
+			// NOTE: Same fixed state as the D3D11 device, no depth testing, culling or scissoring
+			glDisable(GL_DEPTH_TEST);
+			glDisable(GL_CULL_FACE);
+			glDisable(GL_SCISSOR_TEST);
+			glDisable(GL_BLEND);
+
+			SetViewport(RectangleF(0.0f, 0.0f, static_cast<f32>(FramebufferSize.x), static_cast<f32>(FramebufferSize.y)));
+			return true;
+		}
+
+#if defined (__linux__)
+		bool CreateSurfacelessContext()
+		{
+			PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+			if (getPlatformDisplay == nullptr)
 			{
-				char message[512] = {};
-				SDL_snprintf(message, 511, "Failed to create an OpenGL context.\nError: %s", SDL_GetError());
+				LogError(LogName, "EGL_EXT_platform_base isn't supported");
+				return false;
+			}
 
-				LogError(LogName, message);
-				SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Error (GFX)", message, GameWindow);
+			EGL.Display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
 
+			EGLint majorVersion{}, minorVersion{};
+			if (EGL.Display == EGL_NO_DISPLAY || eglInitialize(EGL.Display, &majorVersion, &minorVersion) != EGL_TRUE)
+			{
+				LogError(LogName, "Failed to initialize a surfaceless EGL display. Error: 0x%04X", eglGetError());
 				return false;
 			}
 
-			if (!gladLoadGLLoader((GLADloadproc)SDL_GL_GetProcAddress))
+			LogInfo(LogName, "EGL %d.%d, %s", majorVersion, minorVersion, eglQueryString(EGL.Display, EGL_VENDOR));
+
+			if (eglBindAPI(EGL_OPENGL_API) != EGL_TRUE)
 			{
-				LogError(LogName, "(GLAD) Failed to load OpenGL functions");
-				SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Error (GLAD)", "Failed to load OpenGL functions", GameWindow);
-				SDL_GL_DeleteContext(GLContext);
+				LogError(LogName, "eglBindAPI failed. Error: 0x%04X", eglGetError());
 				return false;
 			}
 
-			SDL_GL_SetSwapInterval(1);
+			const EGLint contextAttribs[]
+			{
+				EGL_CONTEXT_MAJOR_VERSION, 4,
+				EGL_CONTEXT_MINOR_VERSION, 3,
+				EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+#if defined (_DEBUG)
+				EGL_CONTEXT_OPENGL_DEBUG, EGL_TRUE,
+#endif
+				EGL_NONE
+			};
+
+			// NOTE: EGL_KHR_no_config_context and EGL_KHR_surfaceless_context, nothing is ever presented
+			if ((EGL.Context = eglCreateContext(EGL.Display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, contextAttribs)) == EGL_NO_CONTEXT)
+			{
+				LogError(LogName, "eglCreateContext failed. Error: 0x%04X", eglGetError());
+				return false;
+			}
 
-			LogInfo(LogName, "OpenGL Version: %s", glGetString(GL_VERSION));
-			LogInfo(LogName, "OpenGL Renderer: %s", glGetString(GL_RENDERER));
-			
-			glEnable(GL_CULL_FACE);
-			glFrontFace(GL_CW);
-			glCullFace(GL_BACK);
+			if (eglMakeCurrent(EGL.Display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL.Context) != EGL_TRUE)
+			{
+				LogError(LogName, "eglMakeCurrent failed. Error: 0x%04X", eglGetError());
+				return false;
+			}
 
 			return true;
 		}
+#endif
 
-		void Destroy()
+		void LoadCapabilities(GLADloadproc loadProc)
 		{
-			SDL_GL_DeleteContext(GLContext);
+			bool hasBufferStorage = GLAD_GL_VERSION_4_3 && (GLVersion.major > 4 || GLVersion.minor >= 4);
+
+			GLint extensionCount = 0;
+			glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+			for (GLint i = 0; i < extensionCount && !hasBufferStorage; i++)
+			{
+				const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+				hasBufferStorage = (std::strcmp(extension, "GL_ARB_buffer_storage") == 0);
+			}
+
+			if (hasBufferStorage)
+			{
+				Capabilities.BufferStorage = reinterpret_cast<PFNSTARSHINEGLBUFFERSTORAGEPROC>(loadProc("glBufferStorage"));
+			}
+
+			if (Capabilities.BufferStorage == nullptr)
+			{
+				LogWarn(LogName, "Buffer storage isn't supported, dynamic buffers are updated through glBufferSubData()");
+			}
+
+			glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &Capabilities.UniformBufferOffsetAlignment);
 		}
 
-		void SwapBuffers()
+		void CreateOffscreenFramebuffer(ivec2 size)
 		{
-			SDL_GL_SwapWindow(GameWindow);
+			DestroyOffscreenFramebuffer();
+
+			glGenRenderbuffers(1, &Offscreen.ColorRenderbuffer);
+			glBindRenderbuffer(GL_RENDERBUFFER, Offscreen.ColorRenderbuffer);
+			glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, size.x, size.y);
+			glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+			glGenFramebuffers(1, &Offscreen.Framebuffer);
+			glBindFramebuffer(GL_FRAMEBUFFER, Offscreen.Framebuffer);
+			glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, Offscreen.ColorRenderbuffer);
+
+			if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+			{
+				LogError(LogName, "The offscreen framebuffer is incomplete");
+			}
+
+			FramebufferSize = size;
 		}
 
-		void DrawArrays(PrimitiveType type, u32 firstVertex, u32 vertexCount)
+		void DestroyOffscreenFramebuffer()
 		{
-			if (VertexBufferSet && VertexDescSet && ShaderSet)
+			if (Offscreen.Framebuffer != 0)
 			{
-				GLenum primType = ConversionTables::GLPrimitiveTypes[static_cast<size_t>(type)];
-				glDrawArrays(primType, firstVertex, vertexCount);
+				glBindFramebuffer(GL_FRAMEBUFFER, 0);
+				glDeleteFramebuffers(1, &Offscreen.Framebuffer);
+				glDeleteRenderbuffers(1, &Offscreen.ColorRenderbuffer);
+
+				Offscreen.Framebuffer = 0;
+				Offscreen.ColorRenderbuffer = 0;
 			}
 		}
 
-		void DrawIndexed(PrimitiveType type, u32 firstIndex, u32 indexCount)
+		void Destroy()
 		{
-			if (VertexBufferSet && IndexBufferSet && VertexDescSet && ShaderSet)
+			LogInfo(LogName, "Last frame: %u draw calls, %u buffer uploads (%llu bytes), %u fence waits (%.3f ms)",
+				LastFrameStats.DrawCalls, LastFrameStats.BufferUploads, static_cast<unsigned long long>(LastFrameStats.UploadedBytes),
+				LastFrameStats.FenceWaits, LastFrameStats.FenceWaitTime_ms);
+
+			DrawState = {};
+			DrawCheckFlags = {};
+
+			glBindVertexArray(0);
+			glUseProgram(0);
+			glFinish();
+
+			DestroyOffscreenFramebuffer();
+
+			if (SDLContext != nullptr)
 			{
-				GLenum primType = ConversionTables::GLPrimitiveTypes[static_cast<size_t>(type)];
-				size_t firstIndexPointer = static_cast<size_t>(firstIndex) * ((CurrentIndexFormat == GL_UNSIGNED_SHORT) ? 2 : 4);
+				SDL_GL_DeleteContext(SDLContext);
+				SDLContext = nullptr;
+			}
+
+#if defined (__linux__)
+			if (EGL.Display != EGL_NO_DISPLAY)
+			{
+				eglMakeCurrent(EGL.Display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+				if (EGL.Context != EGL_NO_CONTEXT)
+					eglDestroyContext(EGL.Display, EGL.Context);
 
-				glDrawElements(primType, indexCount, CurrentIndexFormat, (const void*)firstIndexPointer);
+				eglTerminate(EGL.Display);
+				EGL = {};
 			}
+#endif
 		}
 
-		void SetVertexBuffer(const VertexBuffer_OpenGL* buffer)
+		void SetViewport(const RectangleF& viewport)
 		{
-			if (buffer == nullptr)
+			CurrentViewport = viewport;
+
+			// NOTE: GL's window coordinates start at the bottom left, the viewport is given from the top left like on D3D11
+			const GLint bottom = FramebufferSize.y - static_cast<GLint>(viewport.Y + viewport.Height);
+			glViewport(static_cast<GLint>(viewport.X), bottom, static_cast<GLsizei>(viewport.Width), static_cast<GLsizei>(viewport.Height));
+		}
+
+		void Clear(ClearFlags flags, const Color& color, f32 depth, u8 stencil)
+		{
+			GLbitfield clearMask = 0;
+
+			if ((flags & ClearFlags_Color) != 0)
 			{
-				glBindBuffer(GL_ARRAY_BUFFER, 0);
-				VertexBufferSet = false;
+				glClearColor(
+					static_cast<GLfloat>(color.R) / 255.0f,
+					static_cast<GLfloat>(color.G) / 255.0f,
+					static_cast<GLfloat>(color.B) / 255.0f,
+					static_cast<GLfloat>(color.A) / 255.0f);
+
+				clearMask |= GL_COLOR_BUFFER_BIT;
 			}
-			else
+
+			if ((flags & ClearFlags_Depth) != 0)
+			{
+				glClearDepthf(depth);
+				clearMask |= GL_DEPTH_BUFFER_BIT;
+			}
+
+			if ((flags & ClearFlags_Stencil) != 0)
 			{
-				GLuint glBufferHandle = buffer->Handle;
-				glBindBuffer(GL_ARRAY_BUFFER, glBufferHandle);
-				VertexBufferSet = true;
+				glClearStencil(stencil);
+				clearMask |= GL_STENCIL_BUFFER_BIT;
 			}
+
+			if (clearMask != 0)
+				glClear(clearMask);
 		}
 
-		void SetVertexDesc(const VertexDesc_OpenGL* desc)
+		void SwapBuffers()
 		{
-			if (desc != nullptr)
+			if (SDLWindow != nullptr)
 			{
-				for (auto& attrib : desc->Attribs)
-				{
-					switch (attrib.Type)
-					{
-					case VertexAttribType::Position:
-						//glVertexPointer(attrib.Components, attrib.Format, attrib.VertexSize, (const void*)attrib.Offset);
-						break;
-					case VertexAttribType::Color:
-						//glColorPointer(attrib.Components, attrib.Format, attrib.VertexSize, (const void*)attrib.Offset);
-						break;
-					case VertexAttribType::TexCoord:
-						//glTexCoordPointer(attrib.Components, attrib.Format, attrib.VertexSize, (const void*)attrib.Offset);
-						break;
-					}
-				}
-
-				VertexDescSet = true;
+				SDL_GL_SwapWindow(SDLWindow);
 			}
 			else
 			{
-				VertexDescSet = false;
+				// NOTE: Nothing to present, the frame only has to be submitted
+				glFlush();
 			}
+
+			LastFrameStats = CurrentFrameStats;
+			CurrentFrameStats = {};
+
+			SetViewport(RectangleF(0.0f, 0.0f, static_cast<f32>(FramebufferSize.x), static_cast<f32>(FramebufferSize.y)));
 		}
 
-		void SetIndexBuffer(const IndexBuffer_OpenGL* buffer)
+		void OnWindowResize(i32 width, i32 height)
 		{
-			if (buffer == nullptr)
+			if (SDLWindow != nullptr)
 			{
-				glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-				IndexBufferSet = false;
+				SDL_GL_GetDrawableSize(SDLWindow, &FramebufferSize.x, &FramebufferSize.y);
 			}
 			else
 			{
-				GLuint glBufferHandle = buffer->Handle;
-				glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, glBufferHandle);
-				CurrentIndexFormat = ConversionTables::GLIndexFormats[static_cast<size_t>(buffer->Format)];
-				IndexBufferSet = true;
+				CreateOffscreenFramebuffer(ivec2(width, height));
 			}
+
+			SetViewport(RectangleF(0.0f, 0.0f, static_cast<f32>(FramebufferSize.x), static_cast<f32>(FramebufferSize.y)));
+			LogInfo(LogName, "Main render target and viewport have been resized. New size: %dx%d", FramebufferSize.x, FramebufferSize.y);
 		}
-	};
 
-	OpenGLDevice::OpenGLDevice() : impl(std::make_unique<Impl>())
-	{
-	}
+		void BindBufferRange(BufferBinding& binding, GLuint bindingIndex)
+		{
+			const size_t currentOffset = binding.Buffer->GetCurrentOffset();
+			if (binding.Dirty || binding.BoundOffset != currentOffset)
+			{
+				glBindBufferRange(GL_UNIFORM_BUFFER, bindingIndex, binding.Buffer->BaseBuffer,
+					static_cast<GLintptr>(currentOffset), static_cast<GLsizeiptr>(binding.Buffer->GetBindSize()));
 
-	OpenGLDevice::~OpenGLDevice()
-	{
-	}
+				binding.BoundOffset = currentOffset;
+				binding.Dirty = false;
+			}
+		}
 
-	bool OpenGLDevice::Initialize(SDL_Window* gameWindow)
-	{
-		return impl->Initialize(gameWindow);
-	}
+		void PrepareDraw(bool indexed)
+		{
+			BufferBinding& vertexBinding = DrawState.VertexBuffer;
+			const size_t vertexOffset = vertexBinding.Buffer->GetCurrentOffset();
 
-	void OpenGLDevice::Destroy()
-	{
-		impl->Destroy();
-	}
+			if (vertexBinding.Dirty)
+			{
+				glBindVertexArray(DrawState.VertexArray);
+				DrawState.IndexBufferDirty = true;
+			}
 
-	void OpenGLDevice::OnWindowResize(i32 width, i32 height)
-	{
-		if (ResizeViewportOnWindowResize)
-		{
-			glViewport(0, 0, width, height);
-		}
-	}
+			if (vertexBinding.Dirty || vertexBinding.BoundOffset != vertexOffset)
+			{
+				glBindVertexBuffer(0, vertexBinding.Buffer->BaseBuffer, static_cast<GLintptr>(vertexOffset), DrawState.VertexStride);
+				vertexBinding.BoundOffset = vertexOffset;
+				vertexBinding.Dirty = false;
+			}
 
-	RectangleF OpenGLDevice::GetViewportSize() const
-	{
-		RectangleF viewport = {};
-		glGetFloatv(GL_VIEWPORT, &viewport.X);
-		return viewport;
-	}
+			if (indexed && DrawState.IndexBufferDirty)
+			{
+				glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, DrawState.IndexBuffer->BaseBuffer);
+				DrawState.IndexBufferDirty = false;
+			}
 
-	void OpenGLDevice::Clear(ClearFlags flags, const Color& color, f32 depth, u8 stencil)
-	{
-		GLenum clearFlags = 0;
+			for (size_t i = 0; i < DrawState.UniformBuffers.size(); i++)
+			{
+				if (DrawState.UniformBuffers[i].Buffer != nullptr)
+					BindBufferRange(DrawState.UniformBuffers[i], static_cast<GLuint>(i));
+			}
+		}
 
-		if ((flags & ClearFlags::ClearFlags_Color) != 0)
+		void DrawArrays(PrimitiveType type, u32 firstVertex, u32 vertexCount)
 		{
-			glClearColor(
-				static_cast<float>(color.R) / 255.0f,
-				static_cast<float>(color.G) / 255.0f,
-				static_cast<float>(color.B) / 255.0f,
-				static_cast<float>(color.A) / 255.0f);
+			if (DrawCheckFlags.VertexBufferSet && DrawCheckFlags.VertexDescSet && DrawCheckFlags.ShaderSet)
+			{
+				PrepareDraw(false);
+				glDrawArrays(ConversionTables::GLPrimitiveTypes[static_cast<size_t>(type)], static_cast<GLint>(firstVertex), static_cast<GLsizei>(vertexCount));
 
-			clearFlags |= GL_COLOR_BUFFER_BIT;
+				CurrentFrameStats.DrawCalls++;
+			}
 		}
 
-		if ((flags & ClearFlags::ClearFlags_Depth) != 0)
+		void DrawIndexed(PrimitiveType type, u32 firstIndex, u32 baseVertexIndex, u32 indexCount)
 		{
-			glClearDepth(static_cast<double>(depth));
-			clearFlags |= GL_DEPTH_BUFFER_BIT;
+			if (DrawCheckFlags.VertexBufferSet && DrawCheckFlags.IndexBufferSet && DrawCheckFlags.VertexDescSet && DrawCheckFlags.ShaderSet)
+			{
+				PrepareDraw(true);
+
+				const size_t indexFormat = static_cast<size_t>(DrawState.IndexBuffer->Properties.IndexFormat);
+				const size_t indexOffset = DrawState.IndexBuffer->GetCurrentOffset() + firstIndex * ConversionTables::GLIndexSizes[indexFormat];
+
+				glDrawElementsBaseVertex(ConversionTables::GLPrimitiveTypes[static_cast<size_t>(type)], static_cast<GLsizei>(indexCount),
+					ConversionTables::GLIndexFormats[indexFormat], reinterpret_cast<const void*>(indexOffset), static_cast<GLint>(baseVertexIndex));
+
+				CurrentFrameStats.DrawCalls++;
+			}
 		}
 
-		if ((flags & ClearFlags::ClearFlags_Stencil) != 0)
+		void SetVertexBuffer(const OpenGLBuffer* buffer, const OpenGLVertexDesc* desc)
 		{
-			glClearStencil(stencil);
-			clearFlags |= GL_STENCIL_BUFFER_BIT;
+			if (buffer == nullptr || desc == nullptr)
+			{
+				DrawState.VertexBuffer = {};
+				DrawState.VertexArray = 0;
+				DrawState.VertexStride = 0;
+				glBindVertexArray(0);
+			}
+			else
+			{
+				DrawState.VertexBuffer.Buffer = buffer;
+				DrawState.VertexBuffer.Dirty = true;
+				DrawState.VertexArray = desc->VertexArray;
+				DrawState.VertexStride = desc->VertexStride;
+			}
+
+			DrawCheckFlags.VertexBufferSet = (buffer != nullptr);
+			DrawCheckFlags.VertexDescSet = (desc != nullptr);
 		}
 
-		glClear(clearFlags);
-	}
+		void SetIndexBuffer(const OpenGLBuffer* buffer)
+		{
+			// NOTE: The index buffer binding belongs to the vertex array, it's bound right before drawing
+			DrawState.IndexBuffer = buffer;
+			DrawState.IndexBufferDirty = true;
 
-	void OpenGLDevice::SwapBuffers()
-	{
-		impl->SwapBuffers();
-	}
+			DrawCheckFlags.IndexBufferSet = (buffer != nullptr);
+		}
 
-	void OpenGLDevice::SetBlendState(bool enable, BlendFactor srcColor, BlendFactor destColor, BlendFactor srcAlpha, BlendFactor destAlpha)
-	{
-		GLboolean blendEnabled = glIsEnabled(GL_BLEND);
-		if (enable)
+		void SetUniformBuffer(const OpenGLBuffer* buffer, ShaderStage stage, u32 bufferIndex)
 		{
-			if (!blendEnabled) { glEnable(GL_BLEND); }
+			assert(bufferIndex < MaxUniformBufferSlots);
+
+			const u32 bindingIndex = (stage == ShaderStage::Fragment) ? Bindings::FragmentUniformBufferBase + bufferIndex : bufferIndex;
+			BufferBinding& binding = DrawState.UniformBuffers[bindingIndex];
+
+			if (buffer == nullptr)
+			{
+				binding = {};
+				glBindBufferBase(GL_UNIFORM_BUFFER, bindingIndex, 0);
+			}
+			else
+			{
+				binding.Buffer = buffer;
+				binding.Dirty = true;
+			}
 		}
-		else
+
+		void SetShader(const OpenGLShader* shader)
 		{
-			if (blendEnabled) { glDisable(GL_BLEND); }
-			return;
+			glUseProgram((shader != nullptr) ? shader->Program : 0);
+			DrawCheckFlags.ShaderSet = (shader != nullptr && shader->IsUsable());
 		}
 
-		GLenum glSrcColor = ConversionTables::GLBlendFactors[static_cast<size_t>(srcColor)];
-		GLenum glDstColor = ConversionTables::GLBlendFactors[static_cast<size_t>(destColor)];
-		GLenum glSrcAlpha = ConversionTables::GLBlendFactors[static_cast<size_t>(srcAlpha)];
-		GLenum glDstAlpha = ConversionTables::GLBlendFactors[static_cast<size_t>(destAlpha)];
-
-		glBlendFuncSeparate(glSrcColor, glDstColor, glSrcAlpha, glDstAlpha);
-	}
+		void SetTexture(const OpenGLTexture* texture, u32 slot)
+		{
+			assert(slot < Bindings::UploadTextureUnit);
 
-	void OpenGLDevice::SetBlendOperation(BlendOperation op)
-	{
-		GLenum glOperation = ConversionTables::GLBlendOperations[static_cast<size_t>(op)];
-		glBlendEquation(glOperation);
-	}
+			glActiveTexture(GL_TEXTURE0 + slot);
+			glBindTexture(GL_TEXTURE_2D, (texture != nullptr) ? texture->BaseTexture : 0);
+		}
 
-	void OpenGLDevice::SetFaceCullingState(bool enable, PolygonOrientation backFaceOrientation)
-	{
-		GLboolean cullingEnabled = glIsEnabled(GL_CULL_FACE);
-		if (enable)
+		void SetBlendState(const OpenGLBlendState* state)
 		{
-			if (!cullingEnabled) { glEnable(GL_CULL_FACE); }
+			if (state == nullptr)
+			{
+				glDisable(GL_BLEND);
+			}
+			else
+			{
+				glEnable(GL_BLEND);
+				glBlendFuncSeparate(state->SrcColor, state->DstColor, state->SrcAlpha, state->DstAlpha);
+				glBlendEquationSeparate(state->ColorOp, state->AlphaOp);
+			}
 		}
-		else
+
+		void OnBufferDestroyed(const OpenGLBuffer* buffer)
 		{
-			if (cullingEnabled) { glDisable(GL_CULL_FACE); }
-			return;
-		}
+			if (DrawState.VertexBuffer.Buffer == buffer)
+			{
+				DrawState.VertexBuffer = {};
+				DrawCheckFlags.VertexBufferSet = false;
+			}
 
-		GLenum glOrientation = ConversionTables::GLPolygonOrientation[static_cast<size_t>(backFaceOrientation)];
+			if (DrawState.IndexBuffer == buffer)
+			{
+				DrawState.IndexBuffer = nullptr;
+				DrawCheckFlags.IndexBufferSet = false;
+			}
 
-		glFrontFace(glOrientation);
-		glCullFace(GL_FRONT); // Oh well...
-	}
+			for (BufferBinding& binding : DrawState.UniformBuffers)
+			{
+				if (binding.Buffer == buffer)
+					binding = {};
+			}
+		}
+	};
 
-	void OpenGLDevice::DrawArrays(PrimitiveType type, u32 firstVertex, u32 vertexCount)
+	OpenGLDevice::OpenGLDevice() : impl(std::make_unique<Impl>(*this))
 	{
-		impl->DrawArrays(type, firstVertex, vertexCount);
 	}
 
-	void OpenGLDevice::DrawIndexed(PrimitiveType type, u32 firstIndex, u32 vertexCount, u32 indexCount)
+	OpenGLDevice::~OpenGLDevice()
 	{
-		impl->DrawIndexed(type, firstIndex, indexCount);
 	}
 
-	std::unique_ptr<VertexBuffer> OpenGLDevice::CreateVertexBuffer(size_t size, const void* initialData, bool dynamic)
+	bool OpenGLDevice::Initialize(SDL_Window* gameWindow)
 	{
-		if (!dynamic && initialData == nullptr || size == 0)
-		{
-			return nullptr;
-		}
-
-		GLsizeiptr bufferLength = static_cast<GLsizeiptr>(size);
-		GLenum bufferUsage = (dynamic) ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW;
-
-		GLuint bufferHandle = 0;
-		glGenBuffers(1, &bufferHandle);
-		glBindBuffer(GL_ARRAY_BUFFER, bufferHandle);
-
-		if (initialData != nullptr)
-		{
-			glBufferData(GL_ARRAY_BUFFER, bufferLength, initialData, bufferUsage);
-		}
-		else
-		{
-			glBufferData(GL_ARRAY_BUFFER, bufferLength, NULL, bufferUsage);
-		}
-
-		std::unique_ptr<VertexBuffer_OpenGL> buffer = std::make_unique<VertexBuffer_OpenGL>(*this, size, dynamic);
-		buffer->Handle = bufferHandle;
-
-		return buffer;
+		return impl->Initialize(gameWindow);
 	}
 
-	std::unique_ptr<IndexBuffer> OpenGLDevice::CreateIndexBuffer(size_t size, IndexFormat format, const void* initialData, bool dynamic)
+	void OpenGLDevice::Destroy()
 	{
-		if (!dynamic && initialData == nullptr || size == 0)
-		{
-			return nullptr;
-		}
-
-		GLsizeiptr bufferLength = static_cast<GLsizeiptr>(size);
-		GLenum bufferUsage = (dynamic) ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW;
-
-		GLuint bufferHandle = 0;
-		glGenBuffers(1, &bufferHandle);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, bufferHandle);
-
-		if (initialData != nullptr)
-		{
-			glBufferData(GL_ELEMENT_ARRAY_BUFFER, bufferLength, initialData, bufferUsage);
-		}
-		else
-		{
-			glBufferData(GL_ELEMENT_ARRAY_BUFFER, bufferLength, NULL, bufferUsage);
-		}
-
-		std::unique_ptr<IndexBuffer_OpenGL> buffer = std::make_unique<IndexBuffer_OpenGL>(*this, size, format, dynamic);
-		buffer->Handle = bufferHandle;
-
-		return buffer;
+		impl->Destroy();
 	}
 
-	std::unique_ptr<VertexDesc> OpenGLDevice::CreateVertexDesc(const VertexAttrib* attribs, size_t attribCount)
+	void OpenGLDevice::ReportExistingObjects()
 	{
-		if (attribs == nullptr || attribCount == 0)
-		{
-			return nullptr;
-		}
+		// NOTE: GL has no way to list the objects that are still alive
+	}
 
-		std::unique_ptr<VertexDesc_OpenGL> desc = std::make_unique<VertexDesc_OpenGL>(*this, attribs, attribCount);
-		return desc;
+	void OpenGLDevice::OnWindowResize(i32 width, i32 height)
+	{
+		impl->OnWindowResize(width, height);
 	}
 
-	std::unique_ptr<Shader> OpenGLDevice::LoadShader(const void* vsData, size_t vsSize, const void* fsData, size_t fsSize)
+	RectangleF OpenGLDevice::GetViewportSize() const
 	{
-		if (vsData == nullptr || vsSize == 0 || fsData == nullptr || fsSize == 0)
-		{
-			return nullptr;
-		}
+		return impl->CurrentViewport;
+	}
 
-		GLuint vpHandle = 0;
-		GLuint fpHandle = 0;
+	void OpenGLDevice::SetViewportSize(const RectangleF& newSize)
+	{
+		impl->SetViewport(newSize);
+	}
 
-		glGenProgramsARB(1, &vpHandle);
-		glGenProgramsARB(1, &fpHandle);
+	void OpenGLDevice::Clear(ClearFlags flags, const Color& color, f32 depth, u8 stencil)
+	{
+		impl->Clear(flags, color, depth, stencil);
+	}
 
-		glBindProgramARB(GL_VERTEX_PROGRAM_ARB, vpHandle);
-		glProgramStringARB(GL_VERTEX_PROGRAM_ARB, GL_PROGRAM_FORMAT_ASCII_ARB, static_cast<GLsizei>(vsSize), vsData);
+	void OpenGLDevice::SwapBuffers()
+	{
+		impl->SwapBuffers();
+	}
 
-		GLint errorPos = -1;
-		const GLubyte* errorString = nullptr;
+	void OpenGLDevice::DrawArrays(PrimitiveType type, u32 firstVertex, u32 vertexCount)
+	{
+		impl->DrawArrays(type, firstVertex, vertexCount);
+	}
 
-		glGetIntegerv(GL_PROGRAM_ERROR_POSITION_ARB, &errorPos);
-		if (errorPos != -1)
-		{
-			errorString = glGetString(GL_PROGRAM_ERROR_STRING_ARB);
-			LogError(LogName, "Failed to assemble vertex program. Error (pos: %d): %s", errorPos, errorString);
+	void OpenGLDevice::DrawIndexed(PrimitiveType type, u32 firstIndex, u32 baseVertexIndex, u32 indexCount)
+	{
+		impl->DrawIndexed(type, firstIndex, baseVertexIndex, indexCount);
+	}
 
-			glDeleteProgramsARB(1, &vpHandle);
-			return nullptr;
-		}
+	bool OpenGLDevice::CreateBuffer(const BufferCreationData& props, std::unique_ptr<Buffer>& buffer)
+	{
+		buffer = std::make_unique<OpenGLBuffer>(*this, props);
+		return true;
+	}
 
-		glBindProgramARB(GL_FRAGMENT_PROGRAM_ARB, fpHandle);
-		glProgramStringARB(GL_FRAGMENT_PROGRAM_ARB, GL_PROGRAM_FORMAT_ASCII_ARB, static_cast<GLsizei>(fsSize), fsData);
+	bool OpenGLDevice::CreateShader(const void* vsData, size_t vsSize, const void* fsData, size_t fsSize, std::unique_ptr<Shader>& shader)
+	{
+		if (vsData == nullptr || fsData == nullptr || vsSize == 0 || fsSize == 0) { return false; }
 
-		glGetIntegerv(GL_PROGRAM_ERROR_POSITION_ARB, &errorPos);
-		if (errorPos != -1)
-		{
-			errorString = glGetString(GL_PROGRAM_ERROR_STRING_ARB);
-			LogError(LogName, "Failed to assemble fragment program. Error (pos: %d): %s", errorPos, errorString);
+		std::unique_ptr<OpenGLShader> glShader = std::make_unique<OpenGLShader>(*this,
+			std::string_view(reinterpret_cast<const char*>(vsData), vsSize), std::string_view(reinterpret_cast<const char*>(fsData), fsSize));
 
-			glDeleteProgramsARB(1, &vpHandle);
-			glDeleteProgramsARB(1, &fpHandle);
-			return nullptr;
-		}
+		if (!glShader->IsUsable()) { return false; }
 
-		std::unique_ptr<Shader_D3D9> shader = std::make_unique<Shader_D3D9>(*this, vpHandle, fpHandle);
-		return shader;
+		shader = std::move(glShader);
+		return true;
 	}
 
-	std::unique_ptr<Texture> OpenGLDevice::CreateTexture(u32 width, u32 height, GFX::TextureFormat format, bool nearestFilter, bool repeat)
+	bool OpenGLDevice::CreateVertexDesc(const VertexAttrib* attribs, size_t attribCount, const Shader* shader, std::unique_ptr<VertexDesc>& desc)
 	{
-		if (width == 0 || height == 0) { return nullptr; }
-		if (!MathExtensions::IsPowerOf2(width) || !MathExtensions::IsPowerOf2(height)) { return nullptr; }
+		if (shader == nullptr || attribs == nullptr || attribCount == 0 || attribCount > 8) { return false; }
 
-		GLuint texHandle = 0;
-		GLenum filter = nearestFilter ? GL_NEAREST : GL_LINEAR;
-		GLenum wrapMode = repeat ? GL_REPEAT : GL_CLAMP_TO_EDGE;
+		desc = std::make_unique<OpenGLVertexDesc>(*this, attribs, attribCount);
+		return true;
+	}
 
-		glGenTextures(1, &texHandle);
-		glBindTexture(GL_TEXTURE_2D, texHandle);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrapMode);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrapMode);
+	bool OpenGLDevice::UploadTexture(Graphics::Texture* texture)
+	{
+		assert(texture != nullptr);
+		assert(texture->GetData() != nullptr);
 
-		GLenum pixelFormat = ConversionTables::GLTextureDisplayFormats[static_cast<size_t>(format)];
-		GLenum dataFormat = ConversionTables::GLTextureDataFormats[static_cast<size_t>(format)];
-		glTexImage2D(GL_TEXTURE_2D, 0, dataFormat, width, height, 0, pixelFormat, GL_UNSIGNED_BYTE, NULL);
+		texture->GPUTexture.Resource = std::make_unique<OpenGLTexture>(*this, texture);
 
-		std::unique_ptr<Texture_D3D9> texture = std::make_unique<Texture_D3D9>(*this, width, height, format, false);
-		texture->Handle = texHandle;
-		texture->Filter = filter;
-		texture->WrapMode = wrapMode;
+		return true;
+	}
 
-		return texture;
+	bool OpenGLDevice::CreateBlendState(const BlendStateDesc& desc, std::unique_ptr<BlendState>& state)
+	{
+		state = std::make_unique<OpenGLBlendState>(*this, desc);
+		return true;
 	}
 
-	void OpenGLDevice::SetVertexBuffer(VertexBuffer* buffer, const VertexDesc* desc)
+	void OpenGLDevice::SetVertexBuffer(const Buffer* buffer, const VertexDesc* desc)
 	{
 		if (buffer == nullptr || desc == nullptr)
 		{
-			impl->SetVertexDesc(nullptr);
-			impl->SetVertexBuffer(nullptr);
+			impl->SetVertexBuffer(nullptr, nullptr);
 		}
 		else
 		{
-			const VertexBuffer_OpenGL* glBuffer = static_cast<const VertexBuffer_OpenGL*>(buffer);
-			const VertexDesc_OpenGL* glDesc = static_cast<const VertexDesc_OpenGL*>(desc);
-			impl->SetVertexDesc(glDesc);
-			impl->SetVertexBuffer(glBuffer);
+			const OpenGLBuffer* glBuffer = static_cast<const OpenGLBuffer*>(buffer);
+			assert(glBuffer->Properties.Type == BufferType::Vertex);
+
+			const OpenGLVertexDesc* glVtxDesc = static_cast<const OpenGLVertexDesc*>(desc);
+			impl->SetVertexBuffer(glBuffer, glVtxDesc);
 		}
 	}
 
-	void OpenGLDevice::SetIndexBuffer(IndexBuffer* buffer)
+	void OpenGLDevice::SetIndexBuffer(const Buffer* buffer)
 	{
 		if (buffer == nullptr)
 		{
@@ -463,99 +698,121 @@ namespace Starshine::Rendering::OpenGL
 		}
 		else
 		{
-			const IndexBuffer_OpenGL* glBuffer = static_cast<const IndexBuffer_OpenGL*>(buffer);
+			const OpenGLBuffer* glBuffer = static_cast<const OpenGLBuffer*>(buffer);
+			assert(glBuffer->Properties.Type == BufferType::Index);
+
 			impl->SetIndexBuffer(glBuffer);
 		}
 	}
 
-	void OpenGLDevice::SetShader(const Shader* shader)
+	void OpenGLDevice::SetUniformBuffer(const Buffer* buffer, ShaderStage stage, u32 bufferIndex)
 	{
-		if (shader == nullptr)
+		if (buffer == nullptr)
 		{
-			glBindProgramARB(GL_VERTEX_PROGRAM_ARB, 0);
-			glBindProgramARB(GL_FRAGMENT_PROGRAM_ARB, 0);
-			impl->ShaderSet = false;
+			impl->SetUniformBuffer(nullptr, stage, bufferIndex);
 		}
 		else
 		{
-			const Shader_D3D9* glShader = static_cast<const Shader_D3D9*>(shader);
-			glBindProgramARB(GL_VERTEX_PROGRAM_ARB, glShader->VertexProgramHandle);
-			glBindProgramARB(GL_FRAGMENT_PROGRAM_ARB, glShader->FragmentProgramHandle);
-			impl->ShaderSet = true;
+			const OpenGLBuffer* glBuffer = static_cast<const OpenGLBuffer*>(buffer);
+			assert(glBuffer->Properties.Type == BufferType::Uniform);
+
+			impl->SetUniformBuffer(glBuffer, stage, bufferIndex);
 		}
 	}
 
-	void OpenGLDevice::SetTexture(const Texture* texture, u32 slot)
+	void OpenGLDevice::SetShader(const Shader* shader)
+	{
+		impl->SetShader(static_cast<const OpenGLShader*>(shader));
+	}
+
+	void OpenGLDevice::SetTexture(Graphics::Texture* texture, u32 slot)
 	{
-		glActiveTextureARB(GL_TEXTURE0_ARB + slot);
 		if (texture == nullptr)
 		{
-			glBindTexture(GL_TEXTURE_2D, 0);
+			impl->SetTexture(nullptr, slot);
 		}
 		else
 		{
-			const Texture_D3D9* glTexture = static_cast<const Texture_D3D9*>(texture);
-			glBindTexture(GL_TEXTURE_2D, glTexture->Handle);
+			if (texture->GPUTexture.Resource == nullptr)
+				UploadTexture(texture);
+
+			const OpenGLTexture* glTexture = static_cast<const OpenGLTexture*>(texture->GPUTexture.Resource.get());
+			impl->SetTexture(glTexture, slot);
 		}
 	}
 
-	/*void Shader_OpenGL::AddVariable(ShaderVariable& variable)
+	void OpenGLDevice::SetBlendState(const BlendState* state)
 	{
-		Variables.push_back(variable);
+		impl->SetBlendState(static_cast<const OpenGLBlendState*>(state));
 	}
 
-	ShaderVariableIndex Shader_OpenGL::GetVariableIndex(std::string_view name)
+	const OpenGLCapabilities& OpenGLDevice::GetCapabilities() const
 	{
-		for (size_t i = 0; i < Variables.size(); i++)
-		{
-			if (Variables.at(i).Name == name)
-			{
-				return static_cast<ShaderVariableIndex>(i);
-			}
-		}
+		return impl->Capabilities;
+	}
 
-		return InvalidShaderVariable;
+	ivec2 OpenGLDevice::GetFramebufferSize() const
+	{
+		return impl->FramebufferSize;
 	}
 
-	void Shader_OpenGL::SetVariableValue(ShaderVariableIndex varIndex, void* value)
+	bool OpenGLDevice::ReadFramebuffer(std::vector<u32>& pixels)
 	{
-		if (varIndex == InvalidShaderVariable)
+		const ivec2 size = impl->FramebufferSize;
+		const size_t rowSize = static_cast<size_t>(size.x);
+		pixels.resize(rowSize * size.y);
+
+		glPixelStorei(GL_PACK_ALIGNMENT, 4);
+		glReadPixels(0, 0, size.x, size.y, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+		if (glGetError() != GL_NO_ERROR)
 		{
-			return;
+			LogError(LogName, "Failed to read the framebuffer back");
+			return false;
 		}
 
-		ShaderVariable& varToUpdate = Variables.at(static_cast<size_t>(varIndex));
-		varToUpdate.Value = value;
+		// NOTE: GL reads the bottom row first
+		for (i32 y = 0; y < size.y / 2; y++)
+		{
+			std::swap_ranges(&pixels[y * rowSize], &pixels[(y + 1) * rowSize], &pixels[(size.y - 1 - y) * rowSize]);
+		}
 
-		UpdateVariables = true;
+		return true;
 	}
 
-	u32 Texture_OpenGL::GetWidth() const
+	bool OpenGLDevice::SaveFramebuffer(std::string_view pngFilePath)
 	{
-		return Width;
+		std::vector<u32> pixels{};
+		if (!ReadFramebuffer(pixels)) { return false; }
+
+		if (!Misc::ImageHelper::WritePNGFile(pngFilePath, impl->FramebufferSize, reinterpret_cast<const u8*>(pixels.data())))
+		{
+			LogError(LogName, "Failed to save the framebuffer to %.*s", static_cast<int>(pngFilePath.size()), pngFilePath.data());
+			return false;
+		}
+
+		return true;
 	}
 
-	u32 Texture_OpenGL::GetHeight() const
+	OpenGLFrameStats OpenGLDevice::GetLastFrameStats() const
 	{
-		return Height;
+		return impl->LastFrameStats;
 	}
 
-	void Texture_OpenGL::SetData(u32 x, u32 y, u32 width, u32 height, const void* data)
+	void OpenGLDevice::OnBufferDataSet(size_t size, bool waitedForFence, f64 waitTime_ms)
 	{
-		if (Handle == InvalidResourceHandle)
-		{
-			return;
-		}
+		impl->CurrentFrameStats.BufferUploads++;
+		impl->CurrentFrameStats.UploadedBytes += size;
 
-		if (x + width > Width || y + height > Height)
+		if (waitedForFence)
 		{
-			return;
+			impl->CurrentFrameStats.FenceWaits++;
+			impl->CurrentFrameStats.FenceWaitTime_ms += waitTime_ms;
 		}
+	}
 
-		ResourceContext* ctx = Backend->GetResourceContext(Handle);
-		GLenum pixelFormat = ConversionTables::GLTextureDisplayFormats[static_cast<size_t>(Format)];
-
-		glBindTexture(GL_TEXTURE_2D, ctx->BaseResourceHandle);
-		glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, pixelFormat, GL_UNSIGNED_BYTE, data);
-	}*/
+	void OpenGLDevice::OnBufferDestroyed(const Buffer* buffer)
+	{
+		impl->OnBufferDestroyed(static_cast<const OpenGLBuffer*>(buffer));
+	}
 }
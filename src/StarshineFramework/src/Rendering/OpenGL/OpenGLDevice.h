@@ -1,8 +1,31 @@
 #pragma once
 #include "Rendering/Device.h"
+#include "OpenGLCommon.h"
+#include <vector>
 
 namespace Starshine::Rendering::OpenGL
 {
+	struct OpenGLCapabilities
+	{
+		// NOTE: Null when neither GL 4.4 nor ARB_buffer_storage is available, dynamic buffers fall back to glBufferSubData() then
+		PFNSTARSHINEGLBUFFERSTORAGEPROC BufferStorage{};
+		GLint UniformBufferOffsetAlignment{ 256 };
+	};
+
+	struct OpenGLFrameStats
+	{
+		u32 DrawCalls{};
+		u32 BufferUploads{};
+		u64 UploadedBytes{};
+
+		// NOTE: Uploads that had to wait for the GPU to be done with the next region of a dynamic buffer
+		u32 FenceWaits{};
+		f64 FenceWaitTime_ms{};
+	};
+
+	// NOTE: Core profile GL 4.3 device. With a window it renders to the window's default framebuffer through an SDL context,
+	//		 without one it creates a surfaceless EGL context (Linux only, e.g. Mesa's llvmpipe) and renders to an offscreen
+	//		 framebuffer, which defaults to 1280x720
 	class OpenGLDevice : public Device
 	{
 	public:
@@ -12,41 +35,61 @@ namespace Starshine::Rendering::OpenGL
 	public:
 		bool Initialize(SDL_Window* gameWindow);
 		void Destroy();
+		void ReportExistingObjects();
 
+	public:
 		void OnWindowResize(i32 width, i32 height);
 
 	public:
 		RectangleF GetViewportSize() const;
+		void SetViewportSize(const RectangleF& newSize);
+
 	public:
 		void Clear(ClearFlags flags, const Color& color, f32 depth, u8 stencil);
 		void SwapBuffers();
 
 	public:
-		void SetBlendState(bool enable, BlendFactor srcColor, BlendFactor destColor, BlendFactor srcAlpha, BlendFactor destAlpha);
-		void SetBlendOperation(BlendOperation op);
-
-		void SetFaceCullingState(bool enable, PolygonOrientation backFaceOrientation);
-
 		void DrawArrays(PrimitiveType type, u32 firstVertex, u32 vertexCount);
-		void DrawIndexed(PrimitiveType type, u32 firstIndex, u32 vertexCount, u32 indexCount);
+		void DrawIndexed(PrimitiveType type, u32 firstIndex, u32 baseVertexIndex, u32 indexCount);
 
 	public:
-		std::unique_ptr<VertexBuffer> CreateVertexBuffer(size_t size, const void* initialData, bool dynamic);
-		std::unique_ptr<IndexBuffer> CreateIndexBuffer(size_t size, IndexFormat format, const void* initialData, bool dynamic);
-		std::unique_ptr<VertexDesc> CreateVertexDesc(const VertexAttrib* attribs, size_t attribCount);
+		bool CreateBuffer(const BufferCreationData& props, std::unique_ptr<Buffer>& buffer);
+
+		// NOTE: Expects GLSL source instead of bytecode, see OpenGLShader.h
+		bool CreateShader(const void* vsData, size_t vsSize, const void* fsData, size_t fsSize, std::unique_ptr<Shader>& shader);
+		bool CreateVertexDesc(const VertexAttrib* attribs, size_t attribCount, const Shader* shader, std::unique_ptr<VertexDesc>& desc);
 
-		std::unique_ptr<Shader> LoadShader(const void* vsData, size_t vsSize, const void* fsData, size_t fsSize);
+		bool UploadTexture(Graphics::Texture* texture);
 
-		std::unique_ptr<Texture> CreateTexture(u32 width, u32 height, GFX::TextureFormat format, bool nearestFilter, bool repeat);
+		bool CreateBlendState(const BlendStateDesc& desc, std::unique_ptr<BlendState>& state);
 
 	public:
-		void SetVertexBuffer(const VertexBuffer* buffer, const VertexDesc* desc);
-		void SetIndexBuffer(const IndexBuffer* buffer);
+		void SetVertexBuffer(const Buffer* buffer, const VertexDesc* desc);
+		void SetIndexBuffer(const Buffer* buffer);
+		void SetUniformBuffer(const Buffer* buffer, ShaderStage stage, u32 bufferIndex);
 		void SetShader(const Shader* shader);
-		void SetTexture(const Texture* texture, u32 slot);
+		void SetTexture(Graphics::Texture* texture, u32 slot);
+
+		void SetBlendState(const BlendState* state);
+
+	public:
+		const OpenGLCapabilities& GetCapabilities() const;
+
+		ivec2 GetFramebufferSize() const;
+		// NOTE: Reads back the current frame as packed RGBA8 rows, top row first
+		bool ReadFramebuffer(std::vector<u32>& pixels);
+		bool SaveFramebuffer(std::string_view pngFilePath);
+
+		// NOTE: Stats of the last frame that was presented with SwapBuffers()
+		OpenGLFrameStats GetLastFrameStats() const;
+
+	public:
+		// NOTE: Called by the buffers themselves
+		void OnBufferDataSet(size_t size, bool waitedForFence, f64 waitTime_ms);
+		void OnBufferDestroyed(const Buffer* buffer);
 
 	private:
 		struct Impl;
-		std::unique_ptr<Impl> impl = nullptr;
+		std::unique_ptr<Impl> impl{ nullptr };
 	};
 }
@@ -1,52 +1,94 @@
 #include "OpenGLShader.h"
-#include <glm/gtc/type_ptr.hpp>
+#include "Common/Logging/Logging.h"
+#include <vector>
 
 namespace Starshine::Rendering::OpenGL
 {
-	Shader_OpenGL::Shader_OpenGL(OpenGLDevice& device, GLuint programHandle)
-		: DeviceRef(device), ProgramHandle(programHandle)
-	{}
+	static constexpr const char* LogName{ "OpenGLShader" };
 
-	Shader_OpenGL::~Shader_OpenGL()
+	static GLuint CompileStage(GLenum stage, std::string_view source)
 	{
-		glDeleteProgram(ProgramHandle);
-	}
+		const GLchar* sourceData = source.data();
+		const GLint sourceLength = static_cast<GLint>(source.size());
 
-	void Shader_OpenGL::SetVertexShaderVariables(u32 index, size_t count, const f32* values)
-	{
-		if (ProgramHandle != 0 && values != nullptr && count > 0)
+		GLuint shader = glCreateShader(stage);
+		glShaderSource(shader, 1, &sourceData, &sourceLength);
+		glCompileShader(shader);
+
+		GLint compiled = GL_FALSE;
+		glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+
+		if (compiled != GL_TRUE)
 		{
-			glProgramUniform4fv(ProgramHandle, index, count, values);
+			GLint logLength = 0;
+			glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &logLength);
+
+			std::vector<GLchar> infoLog(static_cast<size_t>(logLength) + 1, '\0');
+			glGetShaderInfoLog(shader, logLength, nullptr, infoLog.data());
+
+			LogError(LogName, "Failed to compile the %s shader: %s", (stage == GL_VERTEX_SHADER) ? "vertex" : "fragment", infoLog.data());
+			glDeleteShader(shader);
+			return 0;
 		}
+
+		return shader;
 	}
 
-	void Shader_OpenGL::SetFragmentShaderVariables(u32 index, size_t count, const f32* values)
+	OpenGLShader::OpenGLShader(OpenGLDevice& device, std::string_view vsSource, std::string_view fsSource)
+		: deviceRef(device)
 	{
-		if (ProgramHandle != 0 && values != nullptr && count > 0)
+		GLuint vertexShader = CompileStage(GL_VERTEX_SHADER, vsSource);
+		GLuint fragmentShader = CompileStage(GL_FRAGMENT_SHADER, fsSource);
+
+		if (vertexShader == 0 || fragmentShader == 0)
 		{
-			glProgramUniform4fv(ProgramHandle, index, count, values);
+			glDeleteShader(vertexShader);
+			glDeleteShader(fragmentShader);
+			return;
 		}
-	}
 
-	void Shader_OpenGL::SetVertexShaderMatrix(u32 index, const mat4& matrix)
-	{
-		if (ProgramHandle != 0)
+		Program = glCreateProgram();
+		glAttachShader(Program, vertexShader);
+		glAttachShader(Program, fragmentShader);
+		glLinkProgram(Program);
+
+		// NOTE: The program keeps what it needs, the stages can go right away
+		glDetachShader(Program, vertexShader);
+		glDetachShader(Program, fragmentShader);
+		glDeleteShader(vertexShader);
+		glDeleteShader(fragmentShader);
+
+		GLint linked = GL_FALSE;
+		glGetProgramiv(Program, GL_LINK_STATUS, &linked);
+
+		if (linked != GL_TRUE)
 		{
-			mat4 transposed = glm::transpose(matrix);
-			auto valuePtr = glm::value_ptr(transposed);
+			GLint logLength = 0;
+			glGetProgramiv(Program, GL_INFO_LOG_LENGTH, &logLength);
+
+			std::vector<GLchar> infoLog(static_cast<size_t>(logLength) + 1, '\0');
+			glGetProgramInfoLog(Program, logLength, nullptr, infoLog.data());
 
-			glProgramUniformMatrix4fv(ProgramHandle, index, 1, GL_FALSE, valuePtr);
+			LogError(LogName, "Failed to link the program: %s", infoLog.data());
+			glDeleteProgram(Program);
+			Program = 0;
 		}
 	}
 
-	void Shader_OpenGL::SetFragmentShaderMatrix(u32 index, const mat4& matrix)
+	OpenGLShader::~OpenGLShader()
 	{
-		if (ProgramHandle != 0)
-		{
-			mat4 transposed = glm::transpose(matrix);
-			auto valuePtr = glm::value_ptr(transposed);
+		glDeleteProgram(Program);
+	}
 
-			glProgramUniformMatrix4fv(ProgramHandle, index, 1, GL_FALSE, valuePtr);
-		}
+	bool OpenGLShader::IsUsable() const
+	{
+		return Program != 0;
+	}
+
+	void OpenGLShader::SetDebugName(std::string_view name)
+	{
+#if defined (_DEBUG)
+		glObjectLabel(GL_PROGRAM, Program, static_cast<GLsizei>(name.length()), name.data());
+#endif
 	}
 }
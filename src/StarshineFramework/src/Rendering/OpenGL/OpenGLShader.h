@@ -1,23 +1,23 @@
 #pragma once
 #include "Rendering/Shader.h"
 #include "OpenGLDevice.h"
-#include <glad/glad.h>
 
 namespace Starshine::Rendering::OpenGL
 {
-	struct Shader_OpenGL : public Shader
+	// NOTE: Built from GLSL source, the HLSL shaders have ports under glshaders/ which Utilities::LoadShader picks for this device
+	struct OpenGLShader : public Shader
 	{
-		Shader_OpenGL(OpenGLDevice& device, GLuint programHandle);
-		~Shader_OpenGL();
+	public:
+		OpenGLShader(OpenGLDevice& device, std::string_view vsSource, std::string_view fsSource);
+		~OpenGLShader() override;
 
-		void SetVertexShaderVariables(u32 index, size_t count, const f32* values);
-		void SetFragmentShaderVariables(u32 index, size_t count, const f32* values);
+	public:
+		bool IsUsable() const;
+		void SetDebugName(std::string_view name);
 
-		void SetVertexShaderMatrix(u32 index, const mat4& matrix);
-		void SetFragmentShaderMatrix(u32 index, const mat4& matrix);
+	public:
+		GLuint Program{};
 
-		OpenGLDevice& DeviceRef;
-
-		GLuint ProgramHandle{};
+		OpenGLDevice& deviceRef;
 	};
 }
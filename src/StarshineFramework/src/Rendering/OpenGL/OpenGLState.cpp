@@ -0,0 +1,44 @@
+#include "OpenGLState.h"
+
+namespace Starshine::Rendering::OpenGL
+{
+	namespace ConversionTables
+	{
+		static constexpr std::array<GLenum, EnumCount<BlendFactor>()> GLBlendFactors
+		{
+			GL_ZERO,
+			GL_ONE,
+
+			GL_SRC_COLOR,
+			GL_ONE_MINUS_SRC_COLOR,
+			GL_DST_COLOR,
+			GL_ONE_MINUS_DST_COLOR,
+
+			GL_SRC_ALPHA,
+			GL_ONE_MINUS_SRC_ALPHA,
+			GL_DST_ALPHA,
+			GL_ONE_MINUS_DST_ALPHA
+		};
+
+		static constexpr std::array<GLenum, EnumCount<BlendOperation>()> GLBlendOperations
+		{
+			GL_FUNC_ADD,
+			GL_FUNC_SUBTRACT,
+			GL_FUNC_REVERSE_SUBTRACT,
+			GL_MIN,
+			GL_MAX
+		};
+	}
+
+	OpenGLBlendState::OpenGLBlendState(OpenGLDevice& device, const BlendStateDesc& desc) : BlendState(desc), deviceRef(device)
+	{
+		SrcColor = ConversionTables::GLBlendFactors[static_cast<size_t>(Desc.SrcColor)];
+		DstColor = ConversionTables::GLBlendFactors[static_cast<size_t>(Desc.DstColor)];
+
+		SrcAlpha = ConversionTables::GLBlendFactors[static_cast<size_t>(Desc.SrcAlpha)];
+		DstAlpha = ConversionTables::GLBlendFactors[static_cast<size_t>(Desc.DstAlpha)];
+
+		ColorOp = ConversionTables::GLBlendOperations[static_cast<size_t>(Desc.ColorOp)];
+		AlphaOp = ConversionTables::GLBlendOperations[static_cast<size_t>(Desc.AlphaOp)];
+	}
+}
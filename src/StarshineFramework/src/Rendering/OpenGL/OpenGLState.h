@@ -0,0 +1,25 @@
+#pragma once
+#include "Rendering/State.h"
+#include "OpenGLDevice.h"
+
+namespace Starshine::Rendering::OpenGL
+{
+	// NOTE: GL has no blend state objects, the converted factors are applied by the device when the state is set
+	struct OpenGLBlendState : public BlendState
+	{
+	public:
+		OpenGLBlendState(OpenGLDevice& device, const BlendStateDesc& desc);
+		~OpenGLBlendState() override = default;
+
+	public:
+		GLenum SrcColor{};
+		GLenum DstColor{};
+		GLenum SrcAlpha{};
+		GLenum DstAlpha{};
+
+		GLenum ColorOp{};
+		GLenum AlphaOp{};
+
+		OpenGLDevice& deviceRef;
+	};
+}
@@ -1,47 +1,62 @@
 #include "OpenGLTexture.h"
-#include "OpenGLCommon.h"
 
 namespace Starshine::Rendering::OpenGL
 {
-	Texture_D3D9::Texture_D3D9(OpenGLDevice& device, u32 width, u32 height, GFX::TextureFormat format, bool dynamic) :
-		DeviceRef(device), Width(width), Height(height), Format(format), Dynamic(dynamic)
+	OpenGLTexture::OpenGLTexture(OpenGLDevice& device, Graphics::Texture* texture)
+		: deviceRef(device), ParentTexture(texture)
 	{
-	}
+		const ivec2 texSize = texture->GetSize();
+		const Graphics::TextureFormat texFormat = texture->GetFormat();
+		const Graphics::TextureFlags texFlags = texture->GetFlags();
 
-	Texture_D3D9::~Texture_D3D9()
-	{
-		glDeleteTextures(1, &Handle);
-		Handle = 0;
-	}
+		glGenTextures(1, &BaseTexture);
+		glActiveTexture(GL_TEXTURE0 + Bindings::UploadTextureUnit);
+		glBindTexture(GL_TEXTURE_2D, BaseTexture);
 
-	u32 Texture_D3D9::GetWidth() const
-	{
-		return Width;
-	}
+		// NOTE: Single level immutable storage, like the D3D11 textures
+		glTexStorage2D(GL_TEXTURE_2D, 1, ConversionTables::GLTextureInternalFormats[static_cast<size_t>(texFormat)], texSize.x, texSize.y);
 
-	u32 Texture_D3D9::GetHeight() const
-	{
-		return Height;
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, texSize.x, texSize.y,
+			ConversionTables::GLTextureDataFormats[static_cast<size_t>(texFormat)], GL_UNSIGNED_BYTE, texture->GetData());
+
+		const GLint filter = texFlags.NearestFiltering ? GL_NEAREST : GL_LINEAR;
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, texFlags.WrapS ? GL_REPEAT : GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, texFlags.WrapT ? GL_REPEAT : GL_CLAMP_TO_EDGE);
+
+		glBindTexture(GL_TEXTURE_2D, 0);
 	}
 
-	GFX::TextureFormat Texture_D3D9::GetFormat() const
+	OpenGLTexture::~OpenGLTexture()
 	{
-		return Format;
+		glDeleteTextures(1, &BaseTexture);
 	}
 
-	void Texture_D3D9::SetData(const void* source, u32 x, u32 y, u32 width, u32 height)
+	void OpenGLTexture::SetData(const void* source, i32 x, i32 y, i32 width, i32 height)
 	{
-		if (Handle != 0 && source != nullptr)
-		{
-			if (x + width > Width || y + height > Height)
-			{
-				return;
-			}
+		const bool dynamic = ParentTexture->GPUTexture.Dynamic;
+		const ivec2 texSize = ParentTexture->GetSize();
 
-			GLenum pixelFormat = ConversionTables::GLTextureDisplayFormats[static_cast<size_t>(Format)];
-
-			glBindTexture(GL_TEXTURE_2D, Handle);
-			glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, pixelFormat, GL_UNSIGNED_BYTE, source);
+		if (dynamic && (x + width) <= texSize.x && (y + height) <= texSize.y)
+		{
+			// NOTE: Source rows are as wide as the whole texture, same as the D3D11 texture's pitch
+			glActiveTexture(GL_TEXTURE0 + Bindings::UploadTextureUnit);
+			glBindTexture(GL_TEXTURE_2D, BaseTexture);
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+			glPixelStorei(GL_UNPACK_ROW_LENGTH, texSize.x);
+			glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height,
+				ConversionTables::GLTextureDataFormats[static_cast<size_t>(ParentTexture->GetFormat())], GL_UNSIGNED_BYTE, source);
+			glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+			glBindTexture(GL_TEXTURE_2D, 0);
 		}
 	}
+
+	void OpenGLTexture::SetDebugName(std::string_view name)
+	{
+#if defined (_DEBUG)
+		glObjectLabel(GL_TEXTURE, BaseTexture, static_cast<GLsizei>(name.length()), name.data());
+#endif
+	}
 }
@@ -1,30 +1,24 @@
 #pragma once
 #include "Rendering/Texture.h"
 #include "OpenGLDevice.h"
-#include <glad/glad.h>
 
 namespace Starshine::Rendering::OpenGL
 {
-	struct Texture_D3D9 : public Texture
+	struct OpenGLTexture : public Texture
 	{
-		Texture_D3D9(OpenGLDevice& device, u32 width, u32 height, GFX::TextureFormat format, bool dynamic);
-		~Texture_D3D9();
+	public:
+		OpenGLTexture(OpenGLDevice& device, Graphics::Texture* texture);
+		~OpenGLTexture() override;
 
-		u32 GetWidth() const;
-		u32 GetHeight() const;
-		GFX::TextureFormat GetFormat() const;
+	public:
+		void SetData(const void* source, i32 x, i32 y, i32 width, i32 height);
+		void SetDebugName(std::string_view name);
 
-		void SetData(const void* source, u32 x, u32 y, u32 width, u32 height);
+	public:
+		GLuint BaseTexture{};
 
-		OpenGLDevice& DeviceRef;
-		GLuint Handle{};
+		OpenGLDevice& deviceRef;
 
-		GLenum Filter{ GL_LINEAR };
-		GLenum WrapMode{ GL_CLAMP_TO_EDGE };
-
-		u32 Width{};
-		u32 Height{};
-		GFX::TextureFormat Format{ GFX::TextureFormat::Unknown };
-		bool Dynamic{};
+		Graphics::Texture* ParentTexture{};
 	};
 }
@@ -1,52 +1,73 @@
 #include "OpenGLVertexDesc.h"
-#include "OpenGLCommon.h"
+#include "Common/MathExt.h"
 
 namespace Starshine::Rendering::OpenGL
 {
 	namespace ConversionTables
 	{
-		constexpr std::array<GLenum, EnumCount<VertexAttribFormat>()> GLVertexAttribFormat =
+		struct GLAttribFormat
 		{
-			GL_FLOAT,
-			GL_FLOAT,
-			GL_FLOAT,
-			GL_FLOAT,
-
-			GL_UNSIGNED_BYTE,
-			GL_UNSIGNED_BYTE
+			GLint Components{};
+			GLenum Type{};
+			GLboolean Normalized{};
+			bool Integer{};
 		};
 
-		constexpr std::array<u32, EnumCount<VertexAttribFormat>()> GLVertexAttribComponentsFormat =
+		static constexpr std::array<GLAttribFormat, EnumCount<VertexAttribFormat>()> GLAttribFormats
 		{
-			1,
-			2,
-			3,
-			4,
+			GLAttribFormat { 1, GL_FLOAT, GL_FALSE, false },
+			GLAttribFormat { 2, GL_FLOAT, GL_FALSE, false },
+			GLAttribFormat { 3, GL_FLOAT, GL_FALSE, false },
+			GLAttribFormat { 4, GL_FLOAT, GL_FALSE, false },
 
-			4,
-			4
+			GLAttribFormat { 4, GL_UNSIGNED_BYTE, GL_FALSE, true },
+			GLAttribFormat { 4, GL_UNSIGNED_BYTE, GL_TRUE, false }
 		};
 	}
 
-	VertexDesc_OpenGL::VertexDesc_OpenGL(OpenGLDevice& device, const VertexAttrib* attribs, size_t attribCount) : DeviceRef(device)
+	OpenGLVertexDesc::OpenGLVertexDesc(OpenGLDevice& device, const VertexAttrib* attribs, size_t attribCount)
+		: deviceRef(device)
 	{
-		Attribs.reserve(attribCount);
+		// NOTE: The formats can only be set on a bound vertex array, the device's one is put back afterwards
+		GLint previousVertexArray = 0;
+		glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &previousVertexArray);
+
+		glGenVertexArrays(1, &VertexArray);
+		glBindVertexArray(VertexArray);
+
 		for (size_t i = 0; i < attribCount; i++)
 		{
-			const VertexAttrib& gfxAttrib = attribs[i];
-			VertexAttrib_OpenGL& glAttrib = Attribs.emplace_back();
-
-			glAttrib.Type = gfxAttrib.Type;
-			glAttrib.Index = gfxAttrib.Index;
-			glAttrib.Format = ConversionTables::GLVertexAttribFormat[static_cast<size_t>(gfxAttrib.Format)];
-			glAttrib.Components = ConversionTables::GLVertexAttribComponentsFormat[static_cast<size_t>(gfxAttrib.Format)];
-			glAttrib.VertexSize = gfxAttrib.VertexSize;
-			glAttrib.Offset = gfxAttrib.Offset;
+			const VertexAttrib* stAttrib = &attribs[i];
+			const ConversionTables::GLAttribFormat& format = ConversionTables::GLAttribFormats[static_cast<size_t>(stAttrib->Format)];
+			const GLuint location = Bindings::AttribBaseLocations[static_cast<size_t>(stAttrib->Type)] + stAttrib->Index;
+
+			glEnableVertexAttribArray(location);
+			if (format.Integer)
+			{
+				// NOTE: Same as DXGI's UINT formats, the shader gets the raw integers
+				glVertexAttribIFormat(location, format.Components, format.Type, stAttrib->Offset);
+			}
+			else
+			{
+				glVertexAttribFormat(location, format.Components, format.Type, format.Normalized, stAttrib->Offset);
+			}
+			glVertexAttribBinding(location, 0);
+
+			VertexStride = MathExtensions::Max(VertexStride, static_cast<GLsizei>(stAttrib->VertexSize));
 		}
+
+		glBindVertexArray(static_cast<GLuint>(previousVertexArray));
+	}
+
+	OpenGLVertexDesc::~OpenGLVertexDesc()
+	{
+		glDeleteVertexArrays(1, &VertexArray);
 	}
 
-	VertexDesc_OpenGL::~VertexDesc_OpenGL()
+	void OpenGLVertexDesc::SetDebugName(std::string_view name)
 	{
-		Attribs.clear();
+#if defined (_DEBUG)
+		glObjectLabel(GL_VERTEX_ARRAY, VertexArray, static_cast<GLsizei>(name.length()), name.data());
+#endif
 	}
 }
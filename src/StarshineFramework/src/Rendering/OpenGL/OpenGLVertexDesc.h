@@ -1,30 +1,23 @@
 #pragma once
 #include "Rendering/VertexDesc.h"
 #include "OpenGLDevice.h"
-#include <glad/glad.h>
-#include <vector>
 
 namespace Starshine::Rendering::OpenGL
 {
-	struct VertexAttrib_OpenGL
+	// NOTE: The attribute formats live in a vertex array object, the vertex buffer itself is bound to binding point 0 when drawing
+	struct OpenGLVertexDesc : public VertexDesc
 	{
-		VertexAttribType Type{};
-		u32 Index;
+	public:
+		OpenGLVertexDesc(OpenGLDevice& device, const VertexAttrib* attribs, size_t attribCount);
+		~OpenGLVertexDesc() override;
 
-		GLenum Format{};
-		u32 Components{};
+	public:
+		void SetDebugName(std::string_view name);
 
-		GLsizei VertexSize;
-		GLsizei Offset;
-	};
-
-	struct VertexDesc_OpenGL : public VertexDesc
-	{
-		VertexDesc_OpenGL(OpenGLDevice& device, const VertexAttrib* attribs, size_t attribCount);
-		~VertexDesc_OpenGL();
-
-		OpenGLDevice& DeviceRef;
+	public:
+		GLuint VertexArray{};
+		GLsizei VertexStride{};
 
-		std::vector<VertexAttrib_OpenGL> Attribs;
+		OpenGLDevice& deviceRef;
 	};
 }
@@ -27,11 +27,9 @@ namespace Starshine::Rendering::Render2D
 	void FontRenderer::DrawString(const Font* font, std::string_view text, const vec2& position, const vec2& scale,
 		const Color& fillColor, const Color& outlineColor)
 	{
-		vec2 sprPos{};
-		vec2 sprScale{};
-
-		sprRenderer.GetBasePositionAndScale(sprPos, sprScale);
-		sprRenderer.RenderSprites(nullptr);
+		FontUniforms.FontType = static_cast<i32>(font->GetType());
+		FontUniforms.OutlineColor_Vec4 = outlineColor.ToVector4();
+		sprRenderer.SetShader(fontShader.get(), fontUniformBuffer.get(), &FontUniforms, sizeof(FontUniforms));
 
 		vec2 basePos{};
 		vec2 glyphOffset{};
@@ -77,17 +75,7 @@ namespace Starshine::Rendering::Render2D
 			prevGlyph = glyph;
 		}
 
-		FontUniforms.FontType = static_cast<i32>(font->GetType());
-		FontUniforms.OutlineColor_Vec4 = outlineColor.ToVector4();
-		fontUniformBuffer->SetData(&FontUniforms, 0, sizeof(FontUniforms));
-
-		auto device = sprRenderer.GetRenderingDevice();
-		device->SetUniformBuffer(fontUniformBuffer.get(), ShaderStage::Fragment, 0);
-
-		sprRenderer.SetBasePositionAndScale(sprPos, sprScale);
-		sprRenderer.RenderSprites(fontShader.get());
-
-		sprRenderer.SetBasePositionAndScale(sprPos, sprScale);
+		sprRenderer.SetShader(nullptr);
 	}
 
 	vec2 FontRenderer::MeasureString(const Font* font, std::string_view text)
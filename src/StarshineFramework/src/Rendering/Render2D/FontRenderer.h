@@ -19,7 +19,7 @@ namespace Starshine::Rendering::Render2D
 		~FontRenderer() = default;
 
 	public:
-		// NOTE: This function flushes all pushed sprites currently stored in sprite renderer before drawing text
+		// NOTE: Glyphs are pushed with the font shader as the sprite renderer's current shader, which is cleared again afterwards
 		void DrawString(const Graphics::Font* font, std::string_view text, const vec2& position, const vec2& scale,
 			const Color& fillColor, const Color& outlineColor = DefaultColors::Transparent);
 
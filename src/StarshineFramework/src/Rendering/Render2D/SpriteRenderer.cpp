@@ -1,6 +1,10 @@
 #include "SpriteRenderer.h"
+#include "SpriteVertexKernels.h"
 #include "Rendering/Utilities.h"
+#include "Common/ThreadPool.h"
+#include <algorithm>
 #include <array>
+#include <unordered_map>
 #include <vector>
 #include <Common/MathExt.h>
 #include <glm/ext.hpp>
@@ -19,6 +23,19 @@ namespace Starshine::Rendering::Render2D
 
 	constexpr size_t MaxShapeVertices = 2048;
 
+	// NOTE: Distinct combinations of blend mode, shader, fragment uniforms and base transform a single flush can hold
+	constexpr size_t MaxDrawStates = 4096;
+	constexpr u16 InvalidDrawStateIndex = 0xFFFF;
+
+	// NOTE: Sort key layout, from the most to the least significant bits:
+	//		 [63-56] Layer, [55-52] Blend mode, [51-40] Draw state, [39-24] Texture, [23-0] Submission order
+	//		 Submission ordered layers leave the blend mode, draw state and texture bits empty
+	constexpr u64 SortKeyLayerShift = 56;
+	constexpr u64 SortKeyBlendModeShift = 52;
+	constexpr u64 SortKeyDrawStateShift = 40;
+	constexpr u64 SortKeyTextureShift = 24;
+	constexpr u64 SortKeySequenceMask = (1ull << SortKeyTextureShift) - 1;
+
 	struct SpriteVertexColors
 	{
 		Color TopLeft;
@@ -52,13 +69,47 @@ namespace Starshine::Rendering::Render2D
 
 		PrimitiveType PrimitiveType = PrimitiveType::Triangles;
 		StarshineTex* Texture = nullptr;
+
+		u16 DrawStateIndex = InvalidDrawStateIndex;
+		u8 Layer = 0;
+	};
+
+	// NOTE: Everything besides the texture that used to require a flush to change
+	struct DrawState
+	{
+		BlendMode BlendMode = BlendMode::Normal;
+		Shader* Shader = nullptr;
+
+		Buffer* FragmentUniformBuffer = nullptr;
+		u32 FragmentUniformOffset = 0;
+		u32 FragmentUniformSize = 0;
+
+		vec2 BasePosition{};
+		vec2 BaseScale{ 1.0f, 1.0f };
+	};
+
+	// NOTE: Neighbouring commands in sorted order that are drawn with a single draw call, each distinct texture gets a slot of its own
+	struct DrawBatch
+	{
+		u32 FirstSpriteIndex = 0;
+		u32 SpriteCount = 0;
+
+		u32 ShapeFirstVertex = 0;
+		u32 ShapeVertexCount = 0;
+
+		PrimitiveType PrimitiveType = PrimitiveType::Triangles;
+		u16 DrawStateIndex = InvalidDrawStateIndex;
+
+		array<StarshineTex*, SpriteTextureSlots> Textures{};
+		u32 TextureCount = 0;
 	};
 
-	constexpr array<VertexAttrib, 3> SpriteVertexAttribs
+	constexpr array<VertexAttrib, 4> SpriteVertexAttribs
 	{
 		VertexAttrib { VertexAttribType::Position, 0, VertexAttribFormat::Float2, sizeof(SpriteVertex), offsetof(SpriteVertex, Position) },
 		VertexAttrib { VertexAttribType::TexCoord, 0, VertexAttribFormat::Float2, sizeof(SpriteVertex), offsetof(SpriteVertex, TexCoord) },
-		VertexAttrib { VertexAttribType::Color, 0, VertexAttribFormat::UnsignedByte4Norm, sizeof(SpriteVertex), offsetof(SpriteVertex, Color) }
+		VertexAttrib { VertexAttribType::Color, 0, VertexAttribFormat::UnsignedByte4Norm, sizeof(SpriteVertex), offsetof(SpriteVertex, Color) },
+		VertexAttrib { VertexAttribType::TexCoord, 1, VertexAttribFormat::Float1, sizeof(SpriteVertex), offsetof(SpriteVertex, TextureSlot) }
 	};
 
 	constexpr std::array<BlendStateDesc, EnumCount<BlendMode>()> BlendModeDescs
@@ -105,10 +156,14 @@ namespace Starshine::Rendering::Render2D
 			std::unique_ptr<Graphics::Texture> DefaultTexture{};
 		} DefaultSpriteResources;
 
-		vector<SpriteState> Sprites;
+		SpriteBatch Sprites;
 		vector<DrawCommand> DrawCommands;
+		// NOTE: Always MaxVertices long, uploaded with a single SetData() after the vertices of all pushed sprites have been generated
 		vector<SpriteVertex> SpriteVertices;
 
+		// NOTE: Created on the first batch that's large enough to be split
+		std::unique_ptr<ThreadPool> VertexPool;
+
 		vector<SpriteVertex> ShapeVertices;
 
 		u32 PushedSprites = 0;
@@ -118,11 +173,37 @@ namespace Starshine::Rendering::Render2D
 		SpriteState CurrentSprite{};
 		DrawCommand CurrentList{};
 
+		vector<DrawState> DrawStates;
+		// NOTE: Fragment uniforms of all draw states, copied when a state is recorded since callers reuse their uniform structs
+		vector<u8> FragmentUniformData;
+
+		vector<u64> SortKeys;
+		vector<DrawBatch> DrawBatches;
+		// NOTE: Only written when sorting changed the order of the sprite commands
+		vector<SpriteVertex> SortedVertices;
+		std::unordered_map<const StarshineTex*, u16> TextureIndices;
+
+		BlendMode CurrentBlendMode = BlendMode::Normal;
+		Shader* CurrentShader = nullptr;
+		Buffer* CurrentFragmentUniformBuffer = nullptr;
+		vector<u8> CurrentFragmentUniforms;
+		u8 CurrentLayer = 0;
+		// NOTE: Looked up again on the next push after any part of the current state has changed
+		u16 CurrentDrawStateIndex = InvalidDrawStateIndex;
+
+		array<SpriteLayerOrder, 256> LayerOrders{};
+
+		SpriteRendererStats Stats{};
+
 	public:
 		Impl(SpriteRenderer& parent) : SpriteSheetRenderer(parent), FontRenderer(parent), AnimationSetRenderer(parent)
 		{
 			GFXDevice = Rendering::GetDevice();
 
+			Sprites.Reserve(MaxSprites);
+			SpriteVertices.resize(MaxVertices);
+			SortedVertices.resize(MaxVertices);
+
 			Internal_CreateDefaultSpriteResources();
 			Internal_CreateShaderUniformBuffer();
 
@@ -274,102 +355,358 @@ namespace Starshine::Rendering::Render2D
 			CurrentList = {};
 		}
 
+		static bool IsListPrimitive(PrimitiveType primType)
+		{
+			return primType == PrimitiveType::Points || primType == PrimitiveType::Lines || primType == PrimitiveType::Triangles;
+		}
+
+		bool MatchesCurrentDrawState(const DrawState& state) const
+		{
+			if (state.BlendMode != CurrentBlendMode || state.Shader != CurrentShader || state.FragmentUniformBuffer != CurrentFragmentUniformBuffer ||
+				state.BasePosition != BasePosition || state.BaseScale != BaseScale || state.FragmentUniformSize != CurrentFragmentUniforms.size())
+				return false;
+
+			return CurrentFragmentUniforms.empty() ||
+				SDL_memcmp(&FragmentUniformData[state.FragmentUniformOffset], CurrentFragmentUniforms.data(), CurrentFragmentUniforms.size()) == 0;
+		}
+
+		u16 GetCurrentDrawStateIndex()
+		{
+			if (CurrentDrawStateIndex != InvalidDrawStateIndex)
+				return CurrentDrawStateIndex;
+
+			// NOTE: A frame only has a handful of states, most of them are the default state with a different blend mode or text color
+			for (size_t i = DrawStates.size(); i > 0; i--)
+			{
+				if (MatchesCurrentDrawState(DrawStates[i - 1]))
+				{
+					CurrentDrawStateIndex = static_cast<u16>(i - 1);
+					return CurrentDrawStateIndex;
+				}
+			}
+
+			assert(DrawStates.size() < MaxDrawStates);
+
+			DrawState& state = DrawStates.emplace_back();
+			state.BlendMode = CurrentBlendMode;
+			state.Shader = CurrentShader;
+			state.FragmentUniformBuffer = CurrentFragmentUniformBuffer;
+			state.FragmentUniformOffset = static_cast<u32>(FragmentUniformData.size());
+			state.FragmentUniformSize = static_cast<u32>(CurrentFragmentUniforms.size());
+			state.BasePosition = BasePosition;
+			state.BaseScale = BaseScale;
+
+			FragmentUniformData.insert(FragmentUniformData.end(), CurrentFragmentUniforms.cbegin(), CurrentFragmentUniforms.cend());
+
+			CurrentDrawStateIndex = static_cast<u16>(DrawStates.size() - 1);
+			return CurrentDrawStateIndex;
+		}
+
+		void BeginDrawCommand(StarshineTex* texture, PrimitiveType primType, u16 drawStateIndex)
+		{
+			if (PushedDrawCommands > 0)
+			{
+				DrawCommands.push_back(CurrentList);
+			}
+
+			PushedDrawCommands++;
+
+			CurrentList = {};
+			CurrentList.FirstSpriteIndex = PushedSprites;
+			CurrentList.ShapeFirstVertex = PushedShapeVertices;
+			CurrentList.PrimitiveType = primType;
+			CurrentList.Texture = texture;
+			CurrentList.DrawStateIndex = drawStateIndex;
+			CurrentList.Layer = CurrentLayer;
+		}
+
+		bool CanAppendToCurrentList(StarshineTex* texture, PrimitiveType primType, u16 drawStateIndex) const
+		{
+			return PushedDrawCommands > 0 && CurrentList.Texture == texture && CurrentList.PrimitiveType == primType &&
+				CurrentList.DrawStateIndex == drawStateIndex && CurrentList.Layer == CurrentLayer;
+		}
+
 		void PushSprite(StarshineTex* texture)
 		{
-			if (PushedSprites >= MaxSprites)
+			if (PushedSprites >= MaxSprites || DrawStates.size() >= MaxDrawStates)
 			{
 				RenderSprites(nullptr, true);
 			}
 
+			StarshineTex* listTex = (texture != nullptr) ? texture : DefaultSpriteResources.DefaultTexture.get();
+			const u16 drawStateIndex = GetCurrentDrawStateIndex();
+
+			if (!CanAppendToCurrentList(listTex, PrimitiveType::Triangles, drawStateIndex) || CurrentList.ShapeVertexCount != 0)
+			{
+				BeginDrawCommand(listTex, PrimitiveType::Triangles, drawStateIndex);
+			}
+
+			CurrentList.SpriteCount++;
+
 			PushedSprites++;
-			Sprites.push_back(CurrentSprite);
+			Sprites.Push(CurrentSprite.Position, CurrentSprite.Origin, CurrentSprite.Size, CurrentSprite.RotationCos, CurrentSprite.RotationSin, CurrentSprite.SourceRect_TexSpace,
+				CurrentSprite.VertexColors.TopLeft, CurrentSprite.VertexColors.TopRight, CurrentSprite.VertexColors.BottomLeft, CurrentSprite.VertexColors.BottomRight);
 
 			ResetSprite();
+		}
 
-			StarshineTex* listTex = (texture != nullptr) ? texture : DefaultSpriteResources.DefaultTexture.get();
+		u64 GetSortKey(const DrawCommand& command, size_t sequence)
+		{
+			u64 key = (static_cast<u64>(command.Layer) << SortKeyLayerShift) | static_cast<u64>(sequence);
 
-			if (CurrentList.Texture != listTex || CurrentList.ShapeVertexCount != 0)
+			if (LayerOrders[command.Layer] == SpriteLayerOrder::State)
 			{
-				if (PushedDrawCommands == 0)
-				{
-					CurrentList.Texture = listTex;
-					CurrentList.PrimitiveType = PrimitiveType::Triangles;
+				const u16 textureIndex = TextureIndices.try_emplace(command.Texture, static_cast<u16>(TextureIndices.size())).first->second;
 
-					CurrentList.SpriteCount++;
-					PushedDrawCommands = 1;
-				}
-				else
+				key |= static_cast<u64>(DrawStates[command.DrawStateIndex].BlendMode) << SortKeyBlendModeShift;
+				key |= static_cast<u64>(command.DrawStateIndex) << SortKeyDrawStateShift;
+				key |= static_cast<u64>(textureIndex) << SortKeyTextureShift;
+			}
+
+			return key;
+		}
+
+		// NOTE: Returns whether the sprite commands are still in submission order, in which case the vertices don't have to be moved
+		bool SortDrawCommands()
+		{
+			assert(DrawCommands.size() <= SortKeySequenceMask);
+
+			SortKeys.resize(DrawCommands.size());
+			for (size_t i = 0; i < DrawCommands.size(); i++)
+			{
+				SortKeys[i] = GetSortKey(DrawCommands[i], i);
+			}
+
+			// NOTE: Every key ends with its command's submission order, so they're unique and sorting them is stable
+			std::sort(SortKeys.begin(), SortKeys.end());
+
+			bool inSubmissionOrder = true;
+			u32 sortedSpriteIndex = 0;
+
+			for (const u64 key : SortKeys)
+			{
+				DrawCommand& command = DrawCommands[key & SortKeySequenceMask];
+				if (command.SpriteCount == 0)
+					continue;
+
+				inSubmissionOrder &= (command.FirstSpriteIndex == sortedSpriteIndex);
+				sortedSpriteIndex += command.SpriteCount;
+			}
+
+			return inSubmissionOrder;
+		}
+
+		// NOTE: Copies the vertices of every sprite command to its place in sorted order, where BuildDrawBatches() expects them
+		void MoveVerticesToSortedOrder()
+		{
+			u32 sortedSpriteIndex = 0;
+
+			for (const u64 key : SortKeys)
+			{
+				const DrawCommand& command = DrawCommands[key & SortKeySequenceMask];
+				if (command.SpriteCount == 0)
+					continue;
+
+				SDL_memcpy(&SortedVertices[static_cast<size_t>(sortedSpriteIndex) * 4], &SpriteVertices[static_cast<size_t>(command.FirstSpriteIndex) * 4],
+					static_cast<size_t>(command.SpriteCount) * 4 * sizeof(SpriteVertex));
+
+				sortedSpriteIndex += command.SpriteCount;
+			}
+		}
+
+		static bool CanMergeDrawCommands(const DrawBatch& batch, const DrawCommand& command)
+		{
+			if (batch.DrawStateIndex != command.DrawStateIndex || batch.PrimitiveType != command.PrimitiveType)
+				return false;
+
+			// NOTE: Sprites are uploaded in sorted order, so the sprites of neighbouring commands are always next to each other
+			if (batch.SpriteCount != 0 && command.SpriteCount != 0)
+				return true;
+
+			// NOTE: Strips can't be joined without connecting the last vertex of one shape to the first of the next
+			if (batch.ShapeVertexCount != 0 && command.ShapeVertexCount != 0)
+				return IsListPrimitive(command.PrimitiveType) && command.ShapeFirstVertex == batch.ShapeFirstVertex + batch.ShapeVertexCount;
+
+			return false;
+		}
+
+		// NOTE: Returns the slot the texture is bound to in the batch, adding it if there's one left. SpriteTextureSlots if the batch is full
+		static u32 GetBatchTextureSlot(DrawBatch& batch, StarshineTex* texture)
+		{
+			for (u32 slot = 0; slot < batch.TextureCount; slot++)
+			{
+				if (batch.Textures[slot] == texture)
+					return slot;
+			}
+
+			if (batch.TextureCount >= SpriteTextureSlots)
+				return SpriteTextureSlots;
+
+			batch.Textures[batch.TextureCount] = texture;
+			return batch.TextureCount++;
+		}
+
+		void WriteTextureSlot(const DrawCommand& command, u32 slot)
+		{
+			const f32 slotValue = static_cast<f32>(slot);
+
+			if (command.SpriteCount != 0)
+			{
+				std::fill_n(&Sprites.TextureSlot[command.FirstSpriteIndex], command.SpriteCount, slotValue);
+			}
+
+			for (u32 i = 0; i < command.ShapeVertexCount; i++)
+			{
+				ShapeVertices[static_cast<size_t>(command.ShapeFirstVertex) + i].TextureSlot = slotValue;
+			}
+		}
+
+		// NOTE: Joins the commands in sorted order into draw batches and writes the texture slot of every command to its sprites and shape vertices,
+		//		 which is why it has to run before the sprite vertices are generated. Batches are only broken by a different draw state or primitive type,
+		//		 by non neighbouring shapes or once SpriteTextureSlots distinct textures are in use
+		void BuildDrawBatches()
+		{
+			u32 sortedSpriteIndex = 0;
+
+			for (const u64 key : SortKeys)
+			{
+				const DrawCommand& command = DrawCommands[key & SortKeySequenceMask];
+				if (command.SpriteCount == 0 && command.ShapeVertexCount == 0)
+					continue;
+
+				u32 slot = SpriteTextureSlots;
+				if (!DrawBatches.empty() && CanMergeDrawCommands(DrawBatches.back(), command))
 				{
-					DrawCommands.push_back(CurrentList);
-					PushedDrawCommands++;
+					slot = GetBatchTextureSlot(DrawBatches.back(), command.Texture);
+				}
 
-					CurrentList.Texture = listTex;
-					CurrentList.PrimitiveType = PrimitiveType::Triangles;
+				if (slot == SpriteTextureSlots)
+				{
+					DrawBatch& newBatch = DrawBatches.emplace_back();
+					newBatch.FirstSpriteIndex = sortedSpriteIndex;
+					newBatch.ShapeFirstVertex = command.ShapeFirstVertex;
+					newBatch.PrimitiveType = command.PrimitiveType;
+					newBatch.DrawStateIndex = command.DrawStateIndex;
 
-					CurrentList.FirstSpriteIndex = PushedSprites - 1;
-					CurrentList.SpriteCount = 1;
+					slot = GetBatchTextureSlot(newBatch, command.Texture);
 				}
 
-				CurrentList.ShapeFirstVertex = 0;
-				CurrentList.ShapeVertexCount = 0;
+				DrawBatch& batch = DrawBatches.back();
+				batch.SpriteCount += command.SpriteCount;
+				batch.ShapeVertexCount += command.ShapeVertexCount;
+
+				WriteTextureSlot(command, slot);
+				sortedSpriteIndex += command.SpriteCount;
 			}
-			else
+		}
+
+		struct AppliedDrawState
+		{
+			const DrawState* State = nullptr;
+			Shader* Shader = nullptr;
+			array<StarshineTex*, SpriteTextureSlots> Textures{};
+			const Buffer* VertexBuffer = nullptr;
+		};
+
+		void ApplyDrawState(const DrawState& state, Shader* flushShader, const RectangleF& viewportSize, AppliedDrawState& applied)
+		{
+			const DrawState* prevState = applied.State;
+
+			if (prevState == nullptr || prevState->BlendMode != state.BlendMode)
+			{
+				ApplyBlendMode(state.BlendMode);
+			}
+
+			Shader* shader = (state.Shader != nullptr) ? state.Shader : flushShader;
+			if (applied.Shader != shader)
+			{
+				GFXDevice->SetShader(shader);
+				applied.Shader = shader;
+			}
+
+			if (prevState == nullptr || prevState->BasePosition != state.BasePosition || prevState->BaseScale != state.BaseScale)
+			{
+				RectangleF transformRect = viewportSize;
+				transformRect.X += state.BasePosition.x;
+				transformRect.Y += state.BasePosition.y;
+				transformRect.Width /= state.BaseScale.x;
+				transformRect.Height /= state.BaseScale.y;
+				ShaderUniforms.TransformMatrix = glm::transpose(glm::orthoRH_ZO(transformRect.X, transformRect.Width, transformRect.Height, transformRect.Y, 0.0f, 1.0f));
+
+				GraphicsResources.ShaderUniformBuffer->SetData(&ShaderUniforms, 0, sizeof(ShaderUniformsBufferData));
+				GFXDevice->SetUniformBuffer(GraphicsResources.ShaderUniformBuffer.get(), ShaderStage::Vertex, 0);
+			}
+
+			if (state.FragmentUniformBuffer != nullptr && (prevState == nullptr || prevState->FragmentUniformBuffer != state.FragmentUniformBuffer ||
+				prevState->FragmentUniformOffset != state.FragmentUniformOffset))
 			{
-				CurrentList.SpriteCount++;
+				state.FragmentUniformBuffer->SetData(&FragmentUniformData[state.FragmentUniformOffset], 0, state.FragmentUniformSize);
+				GFXDevice->SetUniformBuffer(state.FragmentUniformBuffer, ShaderStage::Fragment, 0);
 			}
+
+			applied.State = &state;
 		}
 
-		void RenderSprites(Shader* shader, bool doNotResetBaseValues)
+		void DrawCommandBatch(const DrawBatch& batch, Shader* flushShader, const RectangleF& viewportSize, AppliedDrawState& applied)
 		{
-			if (PushedSprites == 0 && PushedShapeVertices == 0)
+			const DrawState& state = DrawStates[batch.DrawStateIndex];
+			if (applied.State != &state)
 			{
-				return;
+				ApplyDrawState(state, flushShader, viewportSize, applied);
 			}
 
-			DrawCommands.push_back(CurrentList);
-
-			size_t spriteVertexCount = static_cast<size_t>(PushedSprites) * 4;
-			if (SpriteVertices.size() < spriteVertexCount)
+			// NOTE: Slots past the batch's textures keep whatever was bound last, the batch's vertices never refer to them
+			for (u32 slot = 0; slot < batch.TextureCount; slot++)
 			{
-				SpriteVertices.insert(SpriteVertices.cbegin(), spriteVertexCount - SpriteVertices.size(), SpriteVertex());
+				if (applied.Textures[slot] != batch.Textures[slot])
+				{
+					GFXDevice->SetTexture(batch.Textures[slot], slot);
+					applied.Textures[slot] = batch.Textures[slot];
+					Stats.TextureBinds++;
+				}
 			}
 
-			size_t baseVertex = 0;
-			for (auto curSprite = Sprites.cbegin(); curSprite != Sprites.cbegin() + PushedSprites; curSprite++)
+			const Buffer* vertexBuffer = (batch.SpriteCount != 0) ? GraphicsResources.SpriteVertexBuffer.get() : GraphicsResources.ShapeVertexBuffer.get();
+			if (applied.VertexBuffer != vertexBuffer)
 			{
-				// Top-left
-				SpriteVertex* vertex = &SpriteVertices[baseVertex + 0];
-				vec2 basePos = {};
+				GFXDevice->SetVertexBuffer(vertexBuffer, GraphicsResources.VertexDesc.get());
+				applied.VertexBuffer = vertexBuffer;
+			}
 
-				vertex->Position = MathExtensions::RotateVector(basePos, curSprite->Origin, curSprite->RotationCos, curSprite->RotationSin) + curSprite->Position;
-				vertex->TexCoord = { curSprite->SourceRect_TexSpace.X, curSprite->SourceRect_TexSpace.Y };
-				vertex->Color = curSprite->VertexColors.TopLeft;
+			if (batch.SpriteCount != 0)
+			{
+				GFXDevice->DrawIndexed(PrimitiveType::Triangles, batch.FirstSpriteIndex * 6, 0, batch.SpriteCount * 6);
+			}
+			else
+			{
+				GFXDevice->DrawArrays(batch.PrimitiveType, batch.ShapeFirstVertex, batch.ShapeVertexCount);
+			}
 
-				// Bottom-right
-				vertex = &SpriteVertices[baseVertex + 1];
-				basePos = { curSprite->Size.x, curSprite->Size.y };
+			Stats.DrawCalls++;
+		}
 
-				vertex->Position = MathExtensions::RotateVector(basePos, curSprite->Origin, curSprite->RotationCos, curSprite->RotationSin) + curSprite->Position;
-				vertex->TexCoord = { curSprite->SourceRect_TexSpace.Width, curSprite->SourceRect_TexSpace.Height };
-				vertex->Color = curSprite->VertexColors.BottomRight;
+		void RenderSprites(Shader* shader, bool doNotResetBaseValues)
+		{
+			if (PushedSprites == 0 && PushedShapeVertices == 0)
+			{
+				return;
+			}
 
-				// Top-right
-				vertex = &SpriteVertices[baseVertex + 2];
-				basePos = { curSprite->Size.x, 0.0f };
+			DrawCommands.push_back(CurrentList);
 
-				vertex->Position = MathExtensions::RotateVector(basePos, curSprite->Origin, curSprite->RotationCos, curSprite->RotationSin) + curSprite->Position;
-				vertex->TexCoord = { curSprite->SourceRect_TexSpace.Width, curSprite->SourceRect_TexSpace.Y };
-				vertex->Color = curSprite->VertexColors.TopRight;
+			const bool inSubmissionOrder = SortDrawCommands();
+			BuildDrawBatches();
 
-				// Bottom-left
-				vertex = &SpriteVertices[baseVertex + 3];
-				basePos = { 0.0f, curSprite->Size.y };
+			if (Sprites.Count >= ParallelSpriteThreshold && VertexPool == nullptr)
+			{
+				VertexPool = std::make_unique<ThreadPool>();
+			}
 
-				vertex->Position = MathExtensions::RotateVector(basePos, curSprite->Origin, curSprite->RotationCos, curSprite->RotationSin) + curSprite->Position;
-				vertex->TexCoord = { curSprite->SourceRect_TexSpace.X, curSprite->SourceRect_TexSpace.Height };
-				vertex->Color = curSprite->VertexColors.BottomLeft;
+			GenerateSpriteVertices(SpriteVertices.data(), Sprites, VertexPool.get());
 
-				baseVertex += 4;
+			if (!inSubmissionOrder)
+			{
+				MoveVerticesToSortedOrder();
 			}
 
 			if (!ShapeVertices.empty())
@@ -379,53 +716,39 @@ namespace Starshine::Rendering::Render2D
 
 			if (PushedSprites > 0)
 			{
-				GraphicsResources.SpriteVertexBuffer->SetData(SpriteVertices.data(), 0, static_cast<size_t>(PushedSprites) * sizeof(SpriteVertex) * 4);
+				const SpriteVertex* vertices = inSubmissionOrder ? SpriteVertices.data() : SortedVertices.data();
+				GraphicsResources.SpriteVertexBuffer->SetData(vertices, 0, static_cast<size_t>(PushedSprites) * sizeof(SpriteVertex) * 4);
 			}
 
-			Shader* spriteShader = (shader != nullptr) ? shader : DefaultSpriteResources.DefaultShader.get();
-
-			RectangleF viewportSize = GFXDevice->GetViewportSize();
-			viewportSize.X += BasePosition.x;
-			viewportSize.Y += BasePosition.y;
-			viewportSize.Width /= BaseScale.x;
-			viewportSize.Height /= BaseScale.y;
-			ShaderUniforms.TransformMatrix = glm::transpose(glm::orthoRH_ZO(viewportSize.X, viewportSize.Width, viewportSize.Height, viewportSize.Y, 0.0f, 1.0f));
-
-			GraphicsResources.ShaderUniformBuffer->SetData(&ShaderUniforms, 0, sizeof(ShaderUniformsBufferData));
-			GFXDevice->SetUniformBuffer(GraphicsResources.ShaderUniformBuffer.get(), ShaderStage::Vertex, 0);
+			Shader* flushShader = (shader != nullptr) ? shader : DefaultSpriteResources.DefaultShader.get();
+			const RectangleF viewportSize = GFXDevice->GetViewportSize();
 
 			GFXDevice->SetIndexBuffer(GraphicsResources.SpriteIndexBuffer.get());
-			GFXDevice->SetShader(spriteShader);
-
-			bool switchBackToSpriteBuffer = true;
 
-			for (auto list = DrawCommands.cbegin(); list != DrawCommands.cend(); list++)
+			AppliedDrawState applied{};
+			for (const DrawBatch& batch : DrawBatches)
 			{
-				GFXDevice->SetTexture(list->Texture, 0);
-				if (list->ShapeVertexCount == 0)
-				{
-					if (switchBackToSpriteBuffer)
-					{
-						GFXDevice->SetVertexBuffer(GraphicsResources.SpriteVertexBuffer.get(), GraphicsResources.VertexDesc.get());
-						switchBackToSpriteBuffer = false;
-					}
-					GFXDevice->DrawIndexed(PrimitiveType::Triangles, list->FirstSpriteIndex * 6, 0, list->SpriteCount * 6);
-				}
-				else
-				{
-					GFXDevice->SetVertexBuffer(GraphicsResources.ShapeVertexBuffer.get(), GraphicsResources.VertexDesc.get());
-					GFXDevice->DrawArrays(list->PrimitiveType, list->ShapeFirstVertex, list->ShapeVertexCount);
-					switchBackToSpriteBuffer = true;
-				}
+				DrawCommandBatch(batch, flushShader, viewportSize, applied);
 			}
 
-			Sprites.clear();
+			Stats.Flushes++;
+			Stats.Commands += static_cast<u32>(DrawCommands.size());
+			Stats.Sprites += PushedSprites;
+			Stats.ShapeVertices += PushedShapeVertices;
+
+			Sprites.Clear();
 			ShapeVertices.clear();
 			DrawCommands.clear();
+			SortKeys.clear();
+			DrawBatches.clear();
+			DrawStates.clear();
+			FragmentUniformData.clear();
+			TextureIndices.clear();
 
 			PushedSprites = 0;
 			PushedDrawCommands = 0;
 			PushedShapeVertices = 0;
+			CurrentDrawStateIndex = InvalidDrawStateIndex;
 
 			ResetSprite();
 			ResetList();
@@ -434,66 +757,62 @@ namespace Starshine::Rendering::Render2D
 			{
 				BasePosition = {};
 				BaseScale = vec2(1.0f);
+				CurrentLayer = 0;
 			}
 		}
 
 		void PushShape(const SpriteVertex* vertices, size_t vertexCount, PrimitiveType primType, StarshineTex* texture)
 		{
-			if (PushedDrawCommands + 1 >= MaxLists || PushedShapeVertices + vertexCount >= MaxShapeVertices)
+			if (PushedDrawCommands + 1 >= MaxLists || PushedShapeVertices + vertexCount >= MaxShapeVertices || DrawStates.size() >= MaxDrawStates)
 				RenderSprites(nullptr, true);
 
 			StarshineTex* listTex = (texture != nullptr) ? texture : DefaultSpriteResources.DefaultTexture.get();
+			const u16 drawStateIndex = GetCurrentDrawStateIndex();
 
-			if (CurrentList.SpriteCount != 0 || CurrentList.PrimitiveType != primType || CurrentList.Texture != listTex)
+			if (!CanAppendToCurrentList(listTex, primType, drawStateIndex) || CurrentList.SpriteCount != 0 || !IsListPrimitive(primType))
 			{
-				if (PushedDrawCommands == 0)
-				{
-					PushedDrawCommands++;
-				}
-				else
-				{
-					DrawCommands.push_back(CurrentList);
-					PushedDrawCommands++;
-
-					CurrentList.FirstSpriteIndex = 0;
-					CurrentList.SpriteCount = 0;
-				}
+				BeginDrawCommand(listTex, primType, drawStateIndex);
 			}
 
-			CurrentList.Texture = listTex;
-			CurrentList.PrimitiveType = primType;
+			CurrentList.ShapeVertexCount += static_cast<u32>(vertexCount);
+			ShapeVertices.insert(ShapeVertices.end(), vertices, vertices + vertexCount);
 
-			CurrentList.ShapeVertexCount += vertexCount;
+			PushedShapeVertices += static_cast<u32>(vertexCount);
+		}
 
-			size_t capacity = PushedShapeVertices;
-			if (capacity < PushedShapeVertices + vertexCount)
+		void ApplyBlendMode(BlendMode mode)
+		{
+			if (mode == BlendMode::Disabled)
 			{
-				ShapeVertices.reserve(PushedShapeVertices + vertexCount);
+				GFXDevice->SetBlendState(nullptr);
 			}
-
-			for (size_t i = 0; i < vertexCount; i++)
+			else
 			{
-				const SpriteVertex* srcVertex = &vertices[i];
-				SpriteVertex& newVertex = ShapeVertices.emplace_back();
-
-				newVertex.Position = srcVertex->Position;
-				newVertex.TexCoord = srcVertex->TexCoord;
-				newVertex.Color = srcVertex->Color;
+				GFXDevice->SetBlendState(BlendStates[static_cast<size_t>(mode)].get());
 			}
-
-			PushedShapeVertices += vertexCount;
 		}
 
 		void SetBlendMode(BlendMode mode)
 		{
-			if (mode == BlendMode::Disabled)
+			if (CurrentBlendMode != mode)
 			{
-				GFXDevice->SetBlendState(nullptr);
+				CurrentBlendMode = mode;
+				CurrentDrawStateIndex = InvalidDrawStateIndex;
 			}
+		}
+
+		void SetShader(Shader* shader, Buffer* fragmentUniformBuffer, const void* fragmentUniformData, size_t fragmentUniformSize)
+		{
+			CurrentShader = shader;
+			CurrentFragmentUniformBuffer = fragmentUniformBuffer;
+
+			const u8* data = static_cast<const u8*>(fragmentUniformData);
+			if (fragmentUniformBuffer != nullptr && data != nullptr)
+				CurrentFragmentUniforms.assign(data, data + fragmentUniformSize);
 			else
-			{
-				GFXDevice->SetBlendState(BlendStates[static_cast<size_t>(mode)].get());
-			}
+				CurrentFragmentUniforms.clear();
+
+			CurrentDrawStateIndex = InvalidDrawStateIndex;
 		}
 	};
 
@@ -578,10 +897,31 @@ namespace Starshine::Rendering::Render2D
 		impl->PushSprite(texture);
 	}
 
+	void SpriteRenderer::SetShader(Shader* shader, Buffer* fragmentUniformBuffer, const void* fragmentUniformData, size_t fragmentUniformSize)
+	{
+		impl->SetShader(shader, fragmentUniformBuffer, fragmentUniformData, fragmentUniformSize);
+	}
+
+	void SpriteRenderer::SetLayer(u8 layer)
+	{
+		impl->CurrentLayer = layer;
+	}
+
+	u8 SpriteRenderer::GetLayer() const
+	{
+		return impl->CurrentLayer;
+	}
+
+	void SpriteRenderer::SetLayerOrder(u8 layer, SpriteLayerOrder order)
+	{
+		impl->LayerOrders[layer] = order;
+	}
+
 	void SpriteRenderer::SetBasePositionAndScale(const vec2& pos, const vec2& scale)
 	{
 		impl->BasePosition = pos;
 		impl->BaseScale = scale;
+		impl->CurrentDrawStateIndex = InvalidDrawStateIndex;
 	}
 
 	void SpriteRenderer::GetBasePositionAndScale(vec2& pos, vec2& scale)
@@ -595,6 +935,16 @@ namespace Starshine::Rendering::Render2D
 		impl->RenderSprites(shader, false);
 	}
 
+	SpriteRendererStats SpriteRenderer::GetStats() const
+	{
+		return impl->Stats;
+	}
+
+	void SpriteRenderer::ResetStats()
+	{
+		impl->Stats = {};
+	}
+
 	void SpriteRenderer::PushShape(const SpriteVertex* vertices, size_t vertexCount, PrimitiveType primType, StarshineTex* texture)
 	{
 		impl->PushShape(vertices, vertexCount, primType, texture);
@@ -8,11 +8,41 @@
 
 namespace Starshine::Rendering::Render2D
 {
+	// NOTE: Number of textures a single sprite draw call can sample from, see SpriteVertex::TextureSlot
+	constexpr u32 SpriteTextureSlots = 8;
+
 	struct SpriteVertex
 	{
 		vec2 Position{};
 		vec2 TexCoord{};
 		Color Color{};
+		// NOTE: Texture slot the vertex samples from, assigned by the renderer when the textures of a draw call are packed into slots.
+		//		 Stored as a float since every device can fetch those, the vertex shader converts it to an integer
+		f32 TextureSlot{};
+	};
+
+	// NOTE: How the commands of a sprite layer are ordered when they're drawn.
+	//		 Layers themselves are always drawn in ascending order, but only within the same flush
+	enum class SpriteLayerOrder : u8
+	{
+		// NOTE: Draw order is the submission order, only neighbouring commands with the same state are merged
+		Submission,
+		// NOTE: Commands are grouped by blend mode, shader and texture. Only for layers whose sprites don't depend on each other's order, like text
+		State,
+
+		Count
+	};
+
+	// NOTE: Counted since the last ResetStats() call, e.g. once per frame.
+	//		 Commands are what the pushed sprites and shapes were recorded as, each of which used to be a draw call of its own
+	struct SpriteRendererStats
+	{
+		u32 Flushes{};
+		u32 Commands{};
+		u32 DrawCalls{};
+		u32 TextureBinds{};
+		u32 Sprites{};
+		u32 ShapeVertices{};
 	};
 
 	class SpriteRenderer
@@ -39,15 +69,31 @@ namespace Starshine::Rendering::Render2D
 		void SetSpriteFlip(bool flipHorizontal, bool flipVertical);
 		void SetSpriteColor(const Color& color);
 
+		// NOTE: Blend mode, shader and layer are recorded with every pushed sprite and shape, none of them require a flush
 		void SetBlendMode(Graphics::BlendMode mode);
 
+		// NOTE: Shader used for the sprites pushed after this call, nullptr for the one passed to RenderSprites().
+		//		 The fragment uniform data is copied and uploaded to the given buffer right before the sprites are drawn.
+		//		 Sprite shaders have to sample the texture bound to the vertex' TextureSlot, like FS_SpriteDefault does
+		void SetShader(Shader* shader, Buffer* fragmentUniformBuffer = nullptr, const void* fragmentUniformData = nullptr, size_t fragmentUniformSize = 0);
+
+		void SetLayer(u8 layer);
+		u8 GetLayer() const;
+		void SetLayerOrder(u8 layer, SpriteLayerOrder order);
+
 		void PushSprite(Graphics::Texture* texture);
 
 		void SetBasePositionAndScale(const vec2& pos, const vec2& scale);
 		void GetBasePositionAndScale(vec2& pos, vec2& scale);
 
+		// NOTE: Draws all pushed sprites, the given shader is used for those that were pushed without one.
+		//		 Resets the base position and scale as well as the current layer
 		void RenderSprites(Shader* shader);
 
+	public:
+		SpriteRendererStats GetStats() const;
+		void ResetStats();
+
 	public:
 		void PushShape(const SpriteVertex* vertices, size_t vertexCount, PrimitiveType primType, Graphics::Texture* texture);
 
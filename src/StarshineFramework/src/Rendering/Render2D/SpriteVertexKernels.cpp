@@ -0,0 +1,196 @@
+#include "SpriteVertexKernels.h"
+#include "Common/ThreadPool.h"
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define STARSHINE_SPRITE_VERTICES_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace Starshine::Rendering::Render2D
+{
+	static_assert(sizeof(SpriteVertex) == 24 && offsetof(SpriteVertex, TexCoord) == 8 && offsetof(SpriteVertex, Color) == 16 && offsetof(SpriteVertex, TextureSlot) == 20,
+		"The vertex kernels write Position and TexCoord as a single 16 byte store followed by the color and texture slot");
+
+	void SpriteBatch::Reserve(size_t capacity)
+	{
+		Capacity = capacity;
+
+		for (auto* values : { &PositionX, &PositionY, &Left, &Top, &Right, &Bottom, &RotationCos, &RotationSin, &SourceLeft, &SourceTop, &SourceRight, &SourceBottom, &TextureSlot })
+		{
+			values->resize(capacity);
+		}
+
+		for (auto& colors : Colors)
+		{
+			colors.resize(capacity);
+		}
+
+		Count = MathExtensions::Min(Count, capacity);
+	}
+
+	void SpriteBatch::Clear()
+	{
+		Count = 0;
+	}
+
+	void SpriteBatch::Push(const vec2& position, const vec2& origin, const vec2& size, f32 rotationCos, f32 rotationSin,
+		const RectangleF& texSpaceSource, const Color& topLeft, const Color& topRight, const Color& bottomLeft, const Color& bottomRight)
+	{
+		assert(Count < Capacity);
+		const size_t i = Count++;
+
+		PositionX[i] = position.x;
+		PositionY[i] = position.y;
+		Left[i] = 0.0f - origin.x;
+		Top[i] = 0.0f - origin.y;
+		Right[i] = size.x - origin.x;
+		Bottom[i] = size.y - origin.y;
+		RotationCos[i] = rotationCos;
+		RotationSin[i] = rotationSin;
+
+		SourceLeft[i] = texSpaceSource.X;
+		SourceTop[i] = texSpaceSource.Y;
+		SourceRight[i] = texSpaceSource.Width;
+		SourceBottom[i] = texSpaceSource.Height;
+		TextureSlot[i] = 0.0f;
+
+		Colors[SpriteVertexCorner_TopLeft][i] = topLeft;
+		Colors[SpriteVertexCorner_BottomRight][i] = bottomRight;
+		Colors[SpriteVertexCorner_TopRight][i] = topRight;
+		Colors[SpriteVertexCorner_BottomLeft][i] = bottomLeft;
+	}
+
+	// NOTE: Same math as MathExtensions::RotateVector(), so the results don't depend on which path a sprite takes
+	static void GenerateSpriteVerticesScalar(SpriteVertex* dst, const SpriteBatch& batch, size_t firstSprite, size_t endSprite)
+	{
+		for (size_t i = firstSprite; i < endSprite; i++)
+		{
+			const f32 cos = batch.RotationCos[i];
+			const f32 sin = batch.RotationSin[i];
+			const f32 x = batch.PositionX[i];
+			const f32 y = batch.PositionY[i];
+
+			const std::array<vec2, SpriteVertexCorner_Count> corners
+			{
+				vec2(batch.Left[i], batch.Top[i]),
+				vec2(batch.Right[i], batch.Bottom[i]),
+				vec2(batch.Right[i], batch.Top[i]),
+				vec2(batch.Left[i], batch.Bottom[i])
+			};
+
+			const std::array<vec2, SpriteVertexCorner_Count> texCoords
+			{
+				vec2(batch.SourceLeft[i], batch.SourceTop[i]),
+				vec2(batch.SourceRight[i], batch.SourceBottom[i]),
+				vec2(batch.SourceRight[i], batch.SourceTop[i]),
+				vec2(batch.SourceLeft[i], batch.SourceBottom[i])
+			};
+
+			SpriteVertex* vertex = &dst[i * 4];
+			for (size_t corner = 0; corner < SpriteVertexCorner_Count; corner++, vertex++)
+			{
+				vertex->Position.x = corners[corner].x * cos - corners[corner].y * sin + x;
+				vertex->Position.y = corners[corner].x * sin + corners[corner].y * cos + y;
+				vertex->TexCoord = texCoords[corner];
+				vertex->Color = batch.Colors[corner][i];
+				vertex->TextureSlot = batch.TextureSlot[i];
+			}
+		}
+	}
+
+#if defined(STARSHINE_SPRITE_VERTICES_SSE2)
+	// NOTE: Transposes the X, Y, U and V of 4 sprites into one Position + TexCoord pair per sprite and writes them to the given corner
+	static inline void StoreCorner(SpriteVertex* dst, const std::vector<Color>& colors, const std::vector<f32>& slots, size_t firstSprite, size_t corner,
+		__m128 x, __m128 y, __m128 u, __m128 v)
+	{
+		_MM_TRANSPOSE4_PS(x, y, u, v);
+
+		SpriteVertex* vertex = &dst[firstSprite * 4 + corner];
+		_mm_storeu_ps(reinterpret_cast<f32*>(&vertex[0]), x);
+		_mm_storeu_ps(reinterpret_cast<f32*>(&vertex[4]), y);
+		_mm_storeu_ps(reinterpret_cast<f32*>(&vertex[8]), u);
+		_mm_storeu_ps(reinterpret_cast<f32*>(&vertex[12]), v);
+
+		vertex[0].Color = colors[firstSprite + 0];
+		vertex[4].Color = colors[firstSprite + 1];
+		vertex[8].Color = colors[firstSprite + 2];
+		vertex[12].Color = colors[firstSprite + 3];
+
+		vertex[0].TextureSlot = slots[firstSprite + 0];
+		vertex[4].TextureSlot = slots[firstSprite + 1];
+		vertex[8].TextureSlot = slots[firstSprite + 2];
+		vertex[12].TextureSlot = slots[firstSprite + 3];
+	}
+
+	static void GenerateSpriteVerticesSSE2(SpriteVertex* dst, const SpriteBatch& batch, size_t firstSprite, size_t endSprite)
+	{
+		size_t i = firstSprite;
+		for (; i + 4 <= endSprite; i += 4)
+		{
+			const __m128 cos = _mm_loadu_ps(&batch.RotationCos[i]);
+			const __m128 sin = _mm_loadu_ps(&batch.RotationSin[i]);
+			const __m128 x = _mm_loadu_ps(&batch.PositionX[i]);
+			const __m128 y = _mm_loadu_ps(&batch.PositionY[i]);
+
+			const __m128 left = _mm_loadu_ps(&batch.Left[i]);
+			const __m128 top = _mm_loadu_ps(&batch.Top[i]);
+			const __m128 right = _mm_loadu_ps(&batch.Right[i]);
+			const __m128 bottom = _mm_loadu_ps(&batch.Bottom[i]);
+
+			// NOTE: Every corner shares its X with one corner and its Y with another, so each product is only computed once
+			const __m128 leftCos = _mm_mul_ps(left, cos), leftSin = _mm_mul_ps(left, sin);
+			const __m128 rightCos = _mm_mul_ps(right, cos), rightSin = _mm_mul_ps(right, sin);
+			const __m128 topCos = _mm_mul_ps(top, cos), topSin = _mm_mul_ps(top, sin);
+			const __m128 bottomCos = _mm_mul_ps(bottom, cos), bottomSin = _mm_mul_ps(bottom, sin);
+
+			const __m128 sourceLeft = _mm_loadu_ps(&batch.SourceLeft[i]);
+			const __m128 sourceTop = _mm_loadu_ps(&batch.SourceTop[i]);
+			const __m128 sourceRight = _mm_loadu_ps(&batch.SourceRight[i]);
+			const __m128 sourceBottom = _mm_loadu_ps(&batch.SourceBottom[i]);
+
+			StoreCorner(dst, batch.Colors[SpriteVertexCorner_TopLeft], batch.TextureSlot, i, SpriteVertexCorner_TopLeft,
+				_mm_add_ps(_mm_sub_ps(leftCos, topSin), x), _mm_add_ps(_mm_add_ps(leftSin, topCos), y), sourceLeft, sourceTop);
+
+			StoreCorner(dst, batch.Colors[SpriteVertexCorner_BottomRight], batch.TextureSlot, i, SpriteVertexCorner_BottomRight,
+				_mm_add_ps(_mm_sub_ps(rightCos, bottomSin), x), _mm_add_ps(_mm_add_ps(rightSin, bottomCos), y), sourceRight, sourceBottom);
+
+			StoreCorner(dst, batch.Colors[SpriteVertexCorner_TopRight], batch.TextureSlot, i, SpriteVertexCorner_TopRight,
+				_mm_add_ps(_mm_sub_ps(rightCos, topSin), x), _mm_add_ps(_mm_add_ps(rightSin, topCos), y), sourceRight, sourceTop);
+
+			StoreCorner(dst, batch.Colors[SpriteVertexCorner_BottomLeft], batch.TextureSlot, i, SpriteVertexCorner_BottomLeft,
+				_mm_add_ps(_mm_sub_ps(leftCos, bottomSin), x), _mm_add_ps(_mm_add_ps(leftSin, bottomCos), y), sourceLeft, sourceBottom);
+		}
+
+		GenerateSpriteVerticesScalar(dst, batch, i, endSprite);
+	}
+#endif
+
+	void GenerateSpriteVertices(SpriteVertex* dst, const SpriteBatch& batch, size_t firstSprite, size_t spriteCount)
+	{
+		assert(firstSprite + spriteCount <= batch.Count);
+
+#if defined(STARSHINE_SPRITE_VERTICES_SSE2)
+		GenerateSpriteVerticesSSE2(dst, batch, firstSprite, firstSprite + spriteCount);
+#else
+		GenerateSpriteVerticesScalar(dst, batch, firstSprite, firstSprite + spriteCount);
+#endif
+	}
+
+	void GenerateSpriteVertices(SpriteVertex* dst, const SpriteBatch& batch, ThreadPool* pool)
+	{
+		if (pool == nullptr || batch.Count < ParallelSpriteThreshold)
+		{
+			GenerateSpriteVertices(dst, batch, 0, batch.Count);
+			return;
+		}
+
+		// NOTE: Chunks are a multiple of 4 sprites, so only the last one has a scalar tail
+		const size_t chunkCount = (batch.Count + SpritesPerChunk - 1) / SpritesPerChunk;
+		pool->ParallelFor(chunkCount, [dst, &batch](size_t chunk)
+		{
+			const size_t firstSprite = chunk * SpritesPerChunk;
+			GenerateSpriteVertices(dst, batch, firstSprite, MathExtensions::Min(SpritesPerChunk, batch.Count - firstSprite));
+		});
+	}
+}
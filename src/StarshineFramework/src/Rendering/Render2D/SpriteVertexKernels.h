@@ -0,0 +1,63 @@
+#pragma once
+#include "SpriteRenderer.h"
+#include <array>
+#include <vector>
+
+namespace Starshine
+{
+	class ThreadPool;
+}
+
+namespace Starshine::Rendering::Render2D
+{
+	// NOTE: Pushed sprites in a structure of arrays layout, so the vertex kernels can load the same value of 4 sprites at once.
+	//		 The corners are already relative to the sprite's origin, e.g. Left = -Origin.x and Right = Size.x - Origin.x
+	struct SpriteBatch
+	{
+	public:
+		void Reserve(size_t capacity);
+		void Clear();
+
+		void Push(const vec2& position, const vec2& origin, const vec2& size, f32 rotationCos, f32 rotationSin,
+			const RectangleF& texSpaceSource, const Color& topLeft, const Color& topRight, const Color& bottomLeft, const Color& bottomRight);
+
+	public:
+		size_t Count{};
+		size_t Capacity{};
+
+		std::vector<f32> PositionX, PositionY;
+		std::vector<f32> Left, Top, Right, Bottom;
+		std::vector<f32> RotationCos, RotationSin;
+
+		// NOTE: Texture space, same as SpriteState::SourceRect_TexSpace (X and Y at the top left, Width and Height at the bottom right)
+		std::vector<f32> SourceLeft, SourceTop, SourceRight, SourceBottom;
+
+		// NOTE: In vertex order, see SpriteVertexCorner
+		std::array<std::vector<Color>, 4> Colors;
+
+		// NOTE: Pushed as 0, the renderer assigns the slots once it knows which sprites share a draw call
+		std::vector<f32> TextureSlot;
+	};
+
+	// NOTE: Order of a sprite's 4 vertices, the sprite index buffer is built around it
+	enum SpriteVertexCorner : u8
+	{
+		SpriteVertexCorner_TopLeft,
+		SpriteVertexCorner_BottomRight,
+		SpriteVertexCorner_TopRight,
+		SpriteVertexCorner_BottomLeft,
+
+		SpriteVertexCorner_Count
+	};
+
+	// NOTE: Writes the 4 vertices of sprites [firstSprite; firstSprite + spriteCount) to 'dst', starting at vertex firstSprite * 4.
+	//		 Uses SSE2 where available, 4 sprites per iteration
+	void GenerateSpriteVertices(SpriteVertex* dst, const SpriteBatch& batch, size_t firstSprite, size_t spriteCount);
+
+	// NOTE: Same as above for the whole batch. Batches of at least ParallelSpriteThreshold sprites are split into chunks for the pool's workers
+	void GenerateSpriteVertices(SpriteVertex* dst, const SpriteBatch& batch, ThreadPool* pool);
+
+	// NOTE: Below this, waking up the workers costs more than it saves (about 20 us for 2048 sprites on a single thread)
+	constexpr size_t ParallelSpriteThreshold = 2048;
+	constexpr size_t SpritesPerChunk = 512;
+}
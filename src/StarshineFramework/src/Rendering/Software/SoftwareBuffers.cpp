@@ -0,0 +1,31 @@
+#include "SoftwareBuffers.h"
+
+namespace Starshine::Rendering::Software
+{
+	SoftwareBuffer::SoftwareBuffer(SoftwareDevice& device, const BufferCreationData& props)
+		: Properties(props), deviceRef(device)
+	{
+		if (!props.Dynamic) assert(props.InitialData != nullptr);
+
+		Data = std::make_unique<u8[]>(props.Size);
+		if (props.InitialData != nullptr)
+		{
+			SDL_memcpy(Data.get(), props.InitialData, props.Size);
+		}
+		else
+		{
+			SDL_memset(Data.get(), 0, props.Size);
+		}
+
+		Properties.InitialData = nullptr;
+	}
+
+	void SoftwareBuffer::SetData(const void* source, size_t offset, size_t size)
+	{
+		// NOTE: Draws read their vertices, indices and uniforms when they are issued, so overwriting a buffer never affects earlier draws
+		if (Properties.Dynamic && (offset + size) <= Properties.Size)
+		{
+			SDL_memcpy(&Data[offset], source, size);
+		}
+	}
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include "Rendering/Buffers.h"
+#include "SoftwareDevice.h"
+#include <memory>
+
+namespace Starshine::Rendering::Software
+{
+	struct SoftwareBuffer : public Buffer
+	{
+	public:
+		SoftwareBuffer(SoftwareDevice& device, const BufferCreationData& props);
+		~SoftwareBuffer() override = default;
+
+	public:
+		void SetData(const void* source, size_t offset, size_t size);
+
+	public:
+		std::unique_ptr<u8[]> Data{};
+		BufferCreationData Properties{};
+
+		SoftwareDevice& deviceRef;
+	};
+}
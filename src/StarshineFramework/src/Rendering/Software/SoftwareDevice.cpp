@@ -0,0 +1,579 @@
+#include "SoftwareDevice.h"
+#include "Common/Logging/Logging.h"
+#include "Misc/ImageHelper.h"
+#include "SoftwareBuffers.h"
+#include "SoftwareRasterizer.h"
+#include "SoftwareShader.h"
+#include "SoftwareState.h"
+#include "SoftwareTexture.h"
+#include "SoftwareVertexDesc.h"
+#include <array>
+#include <vector>
+
+namespace Starshine::Rendering::Software
+{
+	static constexpr const char* LogName{ "SoftwareDevice" };
+
+	// NOTE: Used when there is no window to take the size from
+	static constexpr ivec2 DefaultFramebufferSize{ 1280, 720 };
+
+	static constexpr size_t MaxUniformBufferSlots{ 4 };
+	// NOTE: Same as SpriteTextureSlots, the built-in programs pick the slot from TEXCOORD1 of the triangle's first vertex
+	static constexpr size_t MaxTextureSlots{ 8 };
+
+	struct SoftwareDevice::Impl
+	{
+		SDL_Window* SDLWindow{};
+
+		Rasterizer Raster;
+		RectangleF CurrentViewport{};
+
+		struct BoundStateData
+		{
+			const SoftwareBuffer* VertexBuffer{};
+			const SoftwareVertexDesc* VertexDesc{};
+			const SoftwareBuffer* IndexBuffer{};
+			const SoftwareShader* Shader{};
+			std::array<const SoftwareTexture*, MaxTextureSlots> Textures{};
+			const SoftwareBlendState* BlendState{};
+
+			std::array<const SoftwareBuffer*, MaxUniformBufferSlots> VertexUniformBuffers{};
+			std::array<const SoftwareBuffer*, MaxUniformBufferSlots> FragmentUniformBuffers{};
+		} Bound;
+
+		// NOTE: Output of the vertex stage for the vertices of the current draw call. Vertices behind the eye are marked invalid
+		std::vector<RasterVertex> TransformedVertices;
+		std::vector<u8> TransformedVertexValid;
+		std::vector<u8> TransformedVertexSlots;
+
+		// NOTE: State of the current draw call, its texture changes with the texture slot of the triangles
+		RasterState DrawState{};
+		u8 DrawStateSlot{};
+
+		u32 DrawCalls{};
+		SoftwareFrameStats LastFrameStats{};
+
+		bool Initialize(SDL_Window* window)
+		{
+			SDLWindow = window;
+
+			ivec2 size = DefaultFramebufferSize;
+			if (window != nullptr)
+			{
+				SDL_GetWindowSizeInPixels(window, &size.x, &size.y);
+			}
+
+			Raster.Resize(size);
+			CurrentViewport = RectangleF(0.0f, 0.0f, static_cast<f32>(size.x), static_cast<f32>(size.y));
+
+			LogInfo(LogName, "Framebuffer size: %dx%d", size.x, size.y);
+			return true;
+		}
+
+		void Destroy()
+		{
+			Raster.Resize(ivec2(0, 0));
+			Bound = {};
+			SDLWindow = nullptr;
+		}
+
+		void OnWindowResize(i32 width, i32 height)
+		{
+			Raster.Flush();
+			Raster.Resize(ivec2(width, height));
+			CurrentViewport = RectangleF(0.0f, 0.0f, static_cast<f32>(width), static_cast<f32>(height));
+
+			LogInfo(LogName, "Framebuffer and viewport have been resized. New size: %dx%d", width, height);
+		}
+
+		void Clear(ClearFlags flags, const Color& color, f32 depth, u8 stencil)
+		{
+			if ((flags & ClearFlags_Color) != 0)
+			{
+				Raster.Clear(static_cast<u32>(color.R) | (static_cast<u32>(color.G) << 8) | (static_cast<u32>(color.B) << 16) | (static_cast<u32>(color.A) << 24));
+			}
+
+			// NOTE: There is no depth or stencil buffer
+		}
+
+		void SwapBuffers()
+		{
+			Raster.Flush();
+
+			if (SDLWindow != nullptr)
+			{
+				Present();
+			}
+
+			const RasterStats rasterStats = Raster.GetStats();
+			LastFrameStats.DrawCalls = DrawCalls;
+			LastFrameStats.Triangles = rasterStats.Triangles;
+			LastFrameStats.TileBins = rasterStats.TileBins;
+			LastFrameStats.Flushes = rasterStats.Flushes;
+			LastFrameStats.RasterizeTime_ms = rasterStats.RasterizeTime_ms;
+
+			Raster.ResetStats();
+			DrawCalls = 0;
+		}
+
+		void Present()
+		{
+			SDL_Surface* surface = SDL_GetWindowSurface(SDLWindow);
+			if (surface == nullptr)
+			{
+				return;
+			}
+
+			// NOTE: The surface lags behind by a frame when the window was just resized, copy what fits
+			const ivec2 size = Raster.GetSize();
+			const i32 width = SDL_min(size.x, surface->w);
+			const i32 height = SDL_min(size.y, surface->h);
+
+			if (width <= 0 || height <= 0)
+			{
+				return;
+			}
+
+			if (SDL_MUSTLOCK(surface)) { SDL_LockSurface(surface); }
+
+			SDL_ConvertPixels(width, height, SDL_PIXELFORMAT_RGBA32, Raster.GetPixels(), static_cast<int>(Raster.GetPitch() * sizeof(u32)),
+				surface->format->format, surface->pixels, surface->pitch);
+
+			if (SDL_MUSTLOCK(surface)) { SDL_UnlockSurface(surface); }
+
+			SDL_UpdateWindowSurface(SDLWindow);
+		}
+
+		RasterState GetRasterState() const
+		{
+			RasterState state{};
+			state.Texture = Bound.Textures[0];
+			state.Program = Bound.Shader->Fragment;
+
+			if (Bound.BlendState != nullptr)
+			{
+				state.BlendEnabled = true;
+				state.Blend = Bound.BlendState->Desc;
+			}
+
+			const SoftwareBuffer* fontUniforms = Bound.FragmentUniformBuffers[0];
+			if (state.Program == FragmentProgram::Font && fontUniforms != nullptr && fontUniforms->Properties.Size >= sizeof(i32) * 4 + sizeof(vec4))
+			{
+				// NOTE: Same layout as FontRenderer::FontUniforms
+				SDL_memcpy(&state.FontType, &fontUniforms->Data[0], sizeof(i32));
+				SDL_memcpy(&state.OutlineColor, &fontUniforms->Data[sizeof(i32) * 4], sizeof(vec4));
+			}
+
+			const i32 clipMinX = static_cast<i32>(std::lround(CurrentViewport.X));
+			const i32 clipMinY = static_cast<i32>(std::lround(CurrentViewport.Y));
+			const i32 clipMaxX = static_cast<i32>(std::lround(CurrentViewport.X + CurrentViewport.Width));
+			const i32 clipMaxY = static_cast<i32>(std::lround(CurrentViewport.Y + CurrentViewport.Height));
+			state.ClipRect = Rectangle(clipMinX, clipMinY, clipMaxX - clipMinX, clipMaxY - clipMinY);
+
+			return state;
+		}
+
+		// NOTE: Runs the vertex stage for every vertex in [firstVertex; firstVertex + vertexCount), returns false if the range isn't inside the buffer
+		bool TransformVertices(u32 firstVertex, u32 vertexCount)
+		{
+			const SoftwareVertexDesc& desc = *Bound.VertexDesc;
+			const SoftwareBuffer& buffer = *Bound.VertexBuffer;
+
+			if (desc.VertexStride == 0 || (static_cast<size_t>(firstVertex) + vertexCount) * desc.VertexStride > buffer.Properties.Size)
+			{
+				return false;
+			}
+
+			mat4 transform{ 1.0f };
+			const SoftwareBuffer* transformUniforms = Bound.VertexUniformBuffers[0];
+			if (Bound.Shader->Vertex == VertexProgram::Transform && transformUniforms != nullptr && transformUniforms->Properties.Size >= sizeof(mat4))
+			{
+				SDL_memcpy(&transform, &transformUniforms->Data[0], sizeof(mat4));
+			}
+
+			TransformedVertices.resize(vertexCount);
+			TransformedVertexValid.resize(vertexCount);
+			TransformedVertexSlots.resize(vertexCount);
+
+			for (u32 i = 0; i < vertexCount; i++)
+			{
+				const u8* vertex = &buffer.Data[(static_cast<size_t>(firstVertex) + i) * desc.VertexStride];
+				const vec4 position = desc.Fetch(vertex, VertexAttribType::Position);
+
+				// NOTE: The matrix is laid out for HLSL's mul(position, matrix), which is a row vector multiplication in glm as well
+				vec4 clipPosition = vec4(position.x, position.y, 0.0f, 1.0f);
+				if (Bound.Shader->Vertex == VertexProgram::Transform)
+				{
+					clipPosition = clipPosition * transform;
+				}
+
+				// NOTE: Near plane clipping isn't implemented, 2D rendering never gets there
+				TransformedVertexValid[i] = (clipPosition.w > 0.0f);
+				if (!TransformedVertexValid[i])
+				{
+					continue;
+				}
+
+				const vec2 ndc = vec2(clipPosition.x, clipPosition.y) / clipPosition.w;
+
+				RasterVertex& output = TransformedVertices[i];
+				output.Position.x = CurrentViewport.X + (ndc.x * 0.5f + 0.5f) * CurrentViewport.Width;
+				output.Position.y = CurrentViewport.Y + (0.5f - ndc.y * 0.5f) * CurrentViewport.Height;
+				output.TexCoord = vec2(desc.Fetch(vertex, VertexAttribType::TexCoord));
+				output.Color = desc.Fetch(vertex, VertexAttribType::Color);
+
+				const f32 slot = desc.Fetch(vertex, VertexAttribType::TexCoord, 1).x;
+				TransformedVertexSlots[i] = static_cast<u8>(SDL_clamp(slot, 0.0f, static_cast<f32>(MaxTextureSlots - 1)));
+			}
+
+			return true;
+		}
+
+		void PushTriangle(u32 i0, u32 i1, u32 i2)
+		{
+			if (TransformedVertexValid[i0] && TransformedVertexValid[i1] && TransformedVertexValid[i2])
+			{
+				const u8 slot = TransformedVertexSlots[i0];
+				if (slot != DrawStateSlot)
+				{
+					DrawState.Texture = Bound.Textures[slot];
+					DrawStateSlot = slot;
+					Raster.SetState(DrawState);
+				}
+
+				Raster.PushTriangle(TransformedVertices[i0], TransformedVertices[i1], TransformedVertices[i2]);
+			}
+		}
+
+		// NOTE: 'indices' are relative to the first transformed vertex
+		template <typename IndexType>
+		void AssemblePrimitives(PrimitiveType type, const IndexType* indices, u32 count)
+		{
+			auto index = [indices](u32 i) { return (indices != nullptr) ? static_cast<u32>(indices[i]) : i; };
+
+			switch (type)
+			{
+			case PrimitiveType::Triangles:
+				for (u32 i = 0; i + 2 < count; i += 3)
+				{
+					PushTriangle(index(i), index(i + 1), index(i + 2));
+				}
+				break;
+			case PrimitiveType::TriangleStrip:
+				for (u32 i = 0; i + 2 < count; i++)
+				{
+					// NOTE: Every other triangle has its first two vertices swapped to keep the winding, not that anything gets culled
+					if ((i & 1) == 0)
+						PushTriangle(index(i), index(i + 1), index(i + 2));
+					else
+						PushTriangle(index(i + 1), index(i), index(i + 2));
+				}
+				break;
+			default:
+				// NOTE: Points and lines aren't rasterized, nothing in the framework draws them
+				break;
+			}
+		}
+
+		void BeginDrawState()
+		{
+			DrawState = GetRasterState();
+			DrawStateSlot = 0;
+			Raster.SetState(DrawState);
+		}
+
+		bool CanDraw() const
+		{
+			return Bound.VertexBuffer != nullptr && Bound.VertexDesc != nullptr && Bound.Shader != nullptr && Raster.GetSize().x > 0;
+		}
+
+		void DrawArrays(PrimitiveType type, u32 firstVertex, u32 vertexCount)
+		{
+			if (!CanDraw() || vertexCount == 0)
+			{
+				return;
+			}
+
+			DrawCalls++;
+			if (!TransformVertices(firstVertex, vertexCount))
+			{
+				return;
+			}
+
+			BeginDrawState();
+			AssemblePrimitives<u32>(type, nullptr, vertexCount);
+		}
+
+		template <typename IndexType>
+		void DrawIndexed(PrimitiveType type, const IndexType* indices, u32 baseVertexIndex, u32 indexCount)
+		{
+			// NOTE: Only the referenced vertices go through the vertex stage, which is usually a small part of the buffer
+			u32 minIndex = UINT32_MAX;
+			u32 maxIndex = 0;
+			for (u32 i = 0; i < indexCount; i++)
+			{
+				minIndex = SDL_min(minIndex, static_cast<u32>(indices[i]));
+				maxIndex = SDL_max(maxIndex, static_cast<u32>(indices[i]));
+			}
+
+			if (!TransformVertices(baseVertexIndex + minIndex, maxIndex - minIndex + 1))
+			{
+				return;
+			}
+
+			std::vector<u32> relativeIndices(indexCount);
+			for (u32 i = 0; i < indexCount; i++)
+			{
+				relativeIndices[i] = static_cast<u32>(indices[i]) - minIndex;
+			}
+
+			BeginDrawState();
+			AssemblePrimitives<u32>(type, relativeIndices.data(), indexCount);
+		}
+
+		void DrawIndexed(PrimitiveType type, u32 firstIndex, u32 baseVertexIndex, u32 indexCount)
+		{
+			if (!CanDraw() || Bound.IndexBuffer == nullptr || indexCount == 0)
+			{
+				return;
+			}
+
+			DrawCalls++;
+
+			const SoftwareBuffer& indexBuffer = *Bound.IndexBuffer;
+			const size_t indexSize = (indexBuffer.Properties.IndexFormat == IndexFormat::Index16bit) ? sizeof(u16) : sizeof(u32);
+			if ((static_cast<size_t>(firstIndex) + indexCount) * indexSize > indexBuffer.Properties.Size)
+			{
+				return;
+			}
+
+			const u8* indexData = &indexBuffer.Data[firstIndex * indexSize];
+			if (indexBuffer.Properties.IndexFormat == IndexFormat::Index16bit)
+			{
+				DrawIndexed(type, reinterpret_cast<const u16*>(indexData), baseVertexIndex, indexCount);
+			}
+			else
+			{
+				DrawIndexed(type, reinterpret_cast<const u32*>(indexData), baseVertexIndex, indexCount);
+			}
+		}
+	};
+
+	SoftwareDevice::SoftwareDevice() : impl(std::make_unique<Impl>())
+	{
+	}
+
+	SoftwareDevice::~SoftwareDevice()
+	{
+	}
+
+	bool SoftwareDevice::Initialize(SDL_Window* gameWindow)
+	{
+		return impl->Initialize(gameWindow);
+	}
+
+	void SoftwareDevice::Destroy()
+	{
+		impl->Destroy();
+	}
+
+	void SoftwareDevice::ReportExistingObjects()
+	{
+	}
+
+	void SoftwareDevice::OnWindowResize(i32 width, i32 height)
+	{
+		impl->OnWindowResize(width, height);
+	}
+
+	RectangleF SoftwareDevice::GetViewportSize() const
+	{
+		return impl->CurrentViewport;
+	}
+
+	void SoftwareDevice::SetViewportSize(const RectangleF& newSize)
+	{
+		impl->CurrentViewport = newSize;
+	}
+
+	void SoftwareDevice::Clear(ClearFlags flags, const Color& color, f32 depth, u8 stencil)
+	{
+		impl->Clear(flags, color, depth, stencil);
+	}
+
+	void SoftwareDevice::SwapBuffers()
+	{
+		impl->SwapBuffers();
+	}
+
+	void SoftwareDevice::DrawArrays(PrimitiveType type, u32 firstVertex, u32 vertexCount)
+	{
+		impl->DrawArrays(type, firstVertex, vertexCount);
+	}
+
+	void SoftwareDevice::DrawIndexed(PrimitiveType type, u32 firstIndex, u32 baseVertexIndex, u32 indexCount)
+	{
+		impl->DrawIndexed(type, firstIndex, baseVertexIndex, indexCount);
+	}
+
+	bool SoftwareDevice::CreateBuffer(const BufferCreationData& props, std::unique_ptr<Buffer>& buffer)
+	{
+		buffer = std::make_unique<SoftwareBuffer>(*this, props);
+		return true;
+	}
+
+	bool SoftwareDevice::CreateShader(const void* vsData, size_t vsSize, const void* fsData, size_t fsSize, std::unique_ptr<Shader>& shader)
+	{
+		if (vsData == nullptr || fsData == nullptr || vsSize == 0 || fsSize == 0) { return false; }
+
+		shader = std::make_unique<SoftwareShader>(*this,
+			std::string_view(reinterpret_cast<const char*>(vsData), vsSize), std::string_view(reinterpret_cast<const char*>(fsData), fsSize));
+
+		return true;
+	}
+
+	bool SoftwareDevice::CreateVertexDesc(const VertexAttrib* attribs, size_t attribCount, const Shader* shader, std::unique_ptr<VertexDesc>& desc)
+	{
+		if (shader == nullptr || attribs == nullptr || attribCount == 0 || attribCount > 8) { return false; }
+
+		desc = std::make_unique<SoftwareVertexDesc>(*this, attribs, attribCount);
+		return true;
+	}
+
+	bool SoftwareDevice::UploadTexture(Graphics::Texture* texture)
+	{
+		assert(texture != nullptr);
+		assert(texture->GetData() != nullptr);
+
+		texture->GPUTexture.Resource = std::make_unique<SoftwareTexture>(*this, texture);
+
+		return true;
+	}
+
+	bool SoftwareDevice::CreateBlendState(const BlendStateDesc& desc, std::unique_ptr<BlendState>& state)
+	{
+		state = std::make_unique<SoftwareBlendState>(*this, desc);
+		return true;
+	}
+
+	void SoftwareDevice::SetVertexBuffer(const Buffer* buffer, const VertexDesc* desc)
+	{
+		if (buffer == nullptr || desc == nullptr)
+		{
+			impl->Bound.VertexBuffer = nullptr;
+			impl->Bound.VertexDesc = nullptr;
+		}
+		else
+		{
+			const SoftwareBuffer* swBuffer = static_cast<const SoftwareBuffer*>(buffer);
+			assert(swBuffer->Properties.Type == BufferType::Vertex);
+
+			impl->Bound.VertexBuffer = swBuffer;
+			impl->Bound.VertexDesc = static_cast<const SoftwareVertexDesc*>(desc);
+		}
+	}
+
+	void SoftwareDevice::SetIndexBuffer(const Buffer* buffer)
+	{
+		const SoftwareBuffer* swBuffer = static_cast<const SoftwareBuffer*>(buffer);
+		assert(swBuffer == nullptr || swBuffer->Properties.Type == BufferType::Index);
+
+		impl->Bound.IndexBuffer = swBuffer;
+	}
+
+	void SoftwareDevice::SetUniformBuffer(const Buffer* buffer, ShaderStage stage, u32 bufferIndex)
+	{
+		const SoftwareBuffer* swBuffer = static_cast<const SoftwareBuffer*>(buffer);
+		assert(swBuffer == nullptr || swBuffer->Properties.Type == BufferType::Uniform);
+
+		if (bufferIndex >= MaxUniformBufferSlots)
+		{
+			return;
+		}
+
+		switch (stage)
+		{
+		case ShaderStage::Vertex:
+			impl->Bound.VertexUniformBuffers[bufferIndex] = swBuffer;
+			break;
+		case ShaderStage::Fragment:
+			impl->Bound.FragmentUniformBuffers[bufferIndex] = swBuffer;
+			break;
+		}
+	}
+
+	void SoftwareDevice::SetShader(const Shader* shader)
+	{
+		impl->Bound.Shader = static_cast<const SoftwareShader*>(shader);
+	}
+
+	void SoftwareDevice::SetTexture(Graphics::Texture* texture, u32 slot)
+	{
+		if (slot >= MaxTextureSlots)
+		{
+			return;
+		}
+
+		if (texture == nullptr)
+		{
+			impl->Bound.Textures[slot] = nullptr;
+		}
+		else
+		{
+			if (texture->GPUTexture.Resource == nullptr)
+				UploadTexture(texture);
+
+			impl->Bound.Textures[slot] = static_cast<const SoftwareTexture*>(texture->GPUTexture.Resource.get());
+		}
+	}
+
+	void SoftwareDevice::SetBlendState(const BlendState* state)
+	{
+		impl->Bound.BlendState = static_cast<const SoftwareBlendState*>(state);
+	}
+
+	void SoftwareDevice::FlushDraws()
+	{
+		impl->Raster.Flush();
+	}
+
+	ivec2 SoftwareDevice::GetFramebufferSize() const
+	{
+		return impl->Raster.GetSize();
+	}
+
+	const u32* SoftwareDevice::GetFramebufferData(size_t& pitch)
+	{
+		impl->Raster.Flush();
+
+		pitch = impl->Raster.GetPitch();
+		return impl->Raster.GetPixels();
+	}
+
+	bool SoftwareDevice::SaveFramebuffer(std::string_view pngFilePath)
+	{
+		size_t pitch = 0;
+		const u32* pixels = GetFramebufferData(pitch);
+		const ivec2 size = GetFramebufferSize();
+
+		// NOTE: The PNG writer expects tightly packed rows
+		std::vector<u32> packedPixels(static_cast<size_t>(size.x) * size.y);
+		for (i32 y = 0; y < size.y; y++)
+		{
+			SDL_memcpy(&packedPixels[static_cast<size_t>(y) * size.x], &pixels[y * pitch], size.x * sizeof(u32));
+		}
+
+		if (!Misc::ImageHelper::WritePNGFile(pngFilePath, size, reinterpret_cast<const u8*>(packedPixels.data())))
+		{
+			LogError(LogName, "Failed to save the framebuffer to %.*s", static_cast<int>(pngFilePath.size()), pngFilePath.data());
+			return false;
+		}
+
+		return true;
+	}
+
+	SoftwareFrameStats SoftwareDevice::GetLastFrameStats() const
+	{
+		return impl->LastFrameStats;
+	}
+}
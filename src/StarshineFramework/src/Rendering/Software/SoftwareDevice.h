@@ -0,0 +1,80 @@
+#pragma once
+#include "Rendering/Device.h"
+
+namespace Starshine::Rendering::Software
+{
+	struct SoftwareFrameStats
+	{
+		u32 DrawCalls{};
+		u32 Triangles{};
+		u32 TileBins{};
+		u32 Flushes{};
+		f64 RasterizeTime_ms{};
+	};
+
+	// NOTE: Renders on the CPU into a framebuffer in system memory, which is copied to the window's surface when presenting.
+	//		 It works without a window too (the framebuffer then defaults to 1280x720), so frames can be rendered and saved
+	//		 on machines without a GPU, e.g. for reference images or benchmarks
+	class SoftwareDevice : public Device
+	{
+	public:
+		SoftwareDevice();
+		~SoftwareDevice();
+
+	public:
+		bool Initialize(SDL_Window* gameWindow);
+		void Destroy();
+		void ReportExistingObjects();
+
+	public:
+		void OnWindowResize(i32 width, i32 height);
+
+	public:
+		RectangleF GetViewportSize() const;
+		void SetViewportSize(const RectangleF& newSize);
+
+	public:
+		void Clear(ClearFlags flags, const Color& color, f32 depth, u8 stencil);
+		void SwapBuffers();
+
+	public:
+		void DrawArrays(PrimitiveType type, u32 firstVertex, u32 vertexCount);
+		void DrawIndexed(PrimitiveType type, u32 firstIndex, u32 baseVertexIndex, u32 indexCount);
+
+	public:
+		bool CreateBuffer(const BufferCreationData& props, std::unique_ptr<Buffer>& buffer);
+
+		// NOTE: Expects the shader names instead of bytecode, see SoftwareShader.h
+		bool CreateShader(const void* vsData, size_t vsSize, const void* fsData, size_t fsSize, std::unique_ptr<Shader>& shader);
+		bool CreateVertexDesc(const VertexAttrib* attribs, size_t attribCount, const Shader* shader, std::unique_ptr<VertexDesc>& desc);
+
+		bool UploadTexture(Graphics::Texture* texture);
+
+		bool CreateBlendState(const BlendStateDesc& desc, std::unique_ptr<BlendState>& state);
+
+	public:
+		void SetVertexBuffer(const Buffer* buffer, const VertexDesc* desc);
+		void SetIndexBuffer(const Buffer* buffer);
+		void SetUniformBuffer(const Buffer* buffer, ShaderStage stage, u32 bufferIndex);
+		void SetShader(const Shader* shader);
+		void SetTexture(Graphics::Texture* texture, u32 slot);
+
+		void SetBlendState(const BlendState* state);
+
+	public:
+		// NOTE: Draws everything that's still queued up
+		void FlushDraws();
+
+		ivec2 GetFramebufferSize() const;
+		// NOTE: Packed RGBA8 rows, 'pitch' is in pixels. Queued draws are flushed first
+		const u32* GetFramebufferData(size_t& pitch);
+		bool SaveFramebuffer(std::string_view pngFilePath);
+
+		// NOTE: Stats of the last frame that was presented with SwapBuffers()
+		SoftwareFrameStats GetLastFrameStats() const;
+
+	private:
+		struct Impl;
+		std::unique_ptr<Impl> impl{ nullptr };
+	};
+}
@@ -0,0 +1,1062 @@
+#include "SoftwareRasterizer.h"
+#include "SoftwareTexture.h"
+#include "Common/ThreadPool.h"
+#include <SDL2/SDL_timer.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define STARSHINE_RASTERIZER_SSE2
+#include <emmintrin.h>
+#endif
+
+// NOTE: The per pixel helpers have to end up inside the pixel loops, MSVC and GCC don't always inline them on their own
+#if defined(_MSC_VER)
+#define STARSHINE_RASTERIZER_INLINE __forceinline
+#else
+#define STARSHINE_RASTERIZER_INLINE inline __attribute__((always_inline))
+#endif
+
+namespace Starshine::Rendering::Software
+{
+	namespace
+	{
+		constexpr i32 TileSizeShift = 6;
+		constexpr i32 TileSize = 1 << TileSizeShift;
+
+		// NOTE: Vertices are snapped to 1/16th of a pixel
+		constexpr i32 SubpixelBits = 4;
+		constexpr i32 SubpixelScale = 1 << SubpixelBits;
+		constexpr i32 SubpixelHalf = SubpixelScale / 2;
+
+		// NOTE: Triangles with a vertex further out than this are dropped instead of clipped.
+		//		 It keeps an edge's step across a tile row below 2^29, so row start values can be clamped to +-2^30 and stepped in 32 bits
+		constexpr f32 GuardBand = 16384.0f;
+		constexpr i64 EdgeClamp = 1LL << 30;
+
+		// NOTE: Texture coordinates are clamped before they are converted to texel indices
+		constexpr f32 MaxTexelCoordinate = 1 << 24;
+
+		enum AttribPlane : u32
+		{
+			AttribPlane_U,
+			AttribPlane_V,
+			AttribPlane_R,
+			AttribPlane_G,
+			AttribPlane_B,
+			AttribPlane_A,
+
+			AttribPlane_Count
+		};
+
+		struct TriangleSetup
+		{
+			// NOTE: Edge values at the center of pixel (0, 0), including the fill rule bias, and their change per pixel
+			std::array<i64, 3> EdgeOrigin{};
+			std::array<i32, 3> EdgeStepX{};
+			std::array<i32, 3> EdgeStepY{};
+
+			// NOTE: Pixel bounds, already clipped. Max is exclusive
+			i32 MinX{}, MinY{};
+			i32 MaxX{}, MaxY{};
+
+			// NOTE: Affine attribute planes, the value at the center of pixel (x, y) is Z + X * x + Y * y
+			std::array<vec3, AttribPlane_Count> Planes{};
+
+			u32 StateIndex{};
+		};
+
+#if defined(STARSHINE_RASTERIZER_SSE2)
+		struct I4
+		{
+			__m128i V;
+
+			I4() = default;
+			explicit I4(__m128i v) : V(v) {}
+			explicit I4(i32 v) : V(_mm_set1_epi32(v)) {}
+			I4(i32 a, i32 b, i32 c, i32 d) : V(_mm_setr_epi32(a, b, c, d)) {}
+
+			static I4 Load(const u32* src) { return I4(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src))); }
+			void Store(u32* dst) const { _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), V); }
+
+			I4 operator+(const I4& o) const { return I4(_mm_add_epi32(V, o.V)); }
+			I4 operator&(const I4& o) const { return I4(_mm_and_si128(V, o.V)); }
+			I4 operator|(const I4& o) const { return I4(_mm_or_si128(V, o.V)); }
+
+			template <int Bits> I4 ShiftLeft() const { return I4(_mm_slli_epi32(V, Bits)); }
+			template <int Bits> I4 ShiftRight() const { return I4(_mm_srli_epi32(V, Bits)); }
+
+			I4 Equals(const I4& o) const { return I4(_mm_cmpeq_epi32(V, o.V)); }
+			u32 SignBits() const { return static_cast<u32>(_mm_movemask_ps(_mm_castsi128_ps(V))); }
+
+			void ToArray(i32* dst) const { _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), V); }
+		};
+
+		// NOTE: Lanes of 'a' where 'mask' is set, lanes of 'b' everywhere else
+		inline I4 Select(const I4& mask, const I4& a, const I4& b) { return I4(_mm_or_si128(_mm_and_si128(mask.V, a.V), _mm_andnot_si128(mask.V, b.V))); }
+
+		struct F4
+		{
+			__m128 V;
+
+			F4() = default;
+			explicit F4(__m128 v) : V(v) {}
+			explicit F4(f32 v) : V(_mm_set1_ps(v)) {}
+			F4(f32 a, f32 b, f32 c, f32 d) : V(_mm_setr_ps(a, b, c, d)) {}
+
+			F4 operator+(const F4& o) const { return F4(_mm_add_ps(V, o.V)); }
+			F4 operator-(const F4& o) const { return F4(_mm_sub_ps(V, o.V)); }
+			F4 operator*(const F4& o) const { return F4(_mm_mul_ps(V, o.V)); }
+
+			// NOTE: Only valid for values that fit in 32 bit integers
+			F4 Floor() const
+			{
+				const __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(V));
+				return F4(_mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, V), _mm_set1_ps(1.0f))));
+			}
+
+			I4 Truncate() const { return I4(_mm_cvttps_epi32(V)); }
+			I4 Round() const { return I4(_mm_cvtps_epi32(V)); }
+
+			static F4 FromInt(const I4& v) { return F4(_mm_cvtepi32_ps(v.V)); }
+		};
+
+		inline F4 Min(const F4& a, const F4& b) { return F4(_mm_min_ps(a.V, b.V)); }
+		inline F4 Max(const F4& a, const F4& b) { return F4(_mm_max_ps(a.V, b.V)); }
+#else
+		struct I4
+		{
+			std::array<i32, 4> V;
+
+			I4() = default;
+			explicit I4(i32 v) : V{ v, v, v, v } {}
+			I4(i32 a, i32 b, i32 c, i32 d) : V{ a, b, c, d } {}
+
+			static I4 Load(const u32* src) { I4 r; SDL_memcpy(r.V.data(), src, sizeof(r.V)); return r; }
+			void Store(u32* dst) const { SDL_memcpy(dst, V.data(), sizeof(V)); }
+
+			I4 operator+(const I4& o) const { return I4(V[0] + o.V[0], V[1] + o.V[1], V[2] + o.V[2], V[3] + o.V[3]); }
+			I4 operator&(const I4& o) const { return I4(V[0] & o.V[0], V[1] & o.V[1], V[2] & o.V[2], V[3] & o.V[3]); }
+			I4 operator|(const I4& o) const { return I4(V[0] | o.V[0], V[1] | o.V[1], V[2] | o.V[2], V[3] | o.V[3]); }
+
+			template <int Bits> I4 ShiftLeft() const
+			{
+				I4 r;
+				for (size_t i = 0; i < 4; i++) { r.V[i] = static_cast<i32>(static_cast<u32>(V[i]) << Bits); }
+				return r;
+			}
+
+			template <int Bits> I4 ShiftRight() const
+			{
+				I4 r;
+				for (size_t i = 0; i < 4; i++) { r.V[i] = static_cast<i32>(static_cast<u32>(V[i]) >> Bits); }
+				return r;
+			}
+
+			I4 Equals(const I4& o) const
+			{
+				I4 r;
+				for (size_t i = 0; i < 4; i++) { r.V[i] = (V[i] == o.V[i]) ? -1 : 0; }
+				return r;
+			}
+
+			u32 SignBits() const
+			{
+				u32 bits = 0;
+				for (size_t i = 0; i < 4; i++) { bits |= (V[i] < 0) ? (1u << i) : 0u; }
+				return bits;
+			}
+
+			void ToArray(i32* dst) const { SDL_memcpy(dst, V.data(), sizeof(V)); }
+		};
+
+		inline I4 Select(const I4& mask, const I4& a, const I4& b)
+		{
+			I4 r;
+			for (size_t i = 0; i < 4; i++) { r.V[i] = (mask.V[i] & a.V[i]) | (~mask.V[i] & b.V[i]); }
+			return r;
+		}
+
+		struct F4
+		{
+			std::array<f32, 4> V;
+
+			F4() = default;
+			explicit F4(f32 v) : V{ v, v, v, v } {}
+			F4(f32 a, f32 b, f32 c, f32 d) : V{ a, b, c, d } {}
+
+			F4 operator+(const F4& o) const { return F4(V[0] + o.V[0], V[1] + o.V[1], V[2] + o.V[2], V[3] + o.V[3]); }
+			F4 operator-(const F4& o) const { return F4(V[0] - o.V[0], V[1] - o.V[1], V[2] - o.V[2], V[3] - o.V[3]); }
+			F4 operator*(const F4& o) const { return F4(V[0] * o.V[0], V[1] * o.V[1], V[2] * o.V[2], V[3] * o.V[3]); }
+
+			F4 Floor() const { return F4(std::floor(V[0]), std::floor(V[1]), std::floor(V[2]), std::floor(V[3])); }
+
+			I4 Truncate() const { return I4(static_cast<i32>(V[0]), static_cast<i32>(V[1]), static_cast<i32>(V[2]), static_cast<i32>(V[3])); }
+			I4 Round() const
+			{
+				return I4(static_cast<i32>(std::nearbyint(V[0])), static_cast<i32>(std::nearbyint(V[1])),
+					static_cast<i32>(std::nearbyint(V[2])), static_cast<i32>(std::nearbyint(V[3])));
+			}
+
+			static F4 FromInt(const I4& v)
+			{
+				return F4(static_cast<f32>(v.V[0]), static_cast<f32>(v.V[1]), static_cast<f32>(v.V[2]), static_cast<f32>(v.V[3]));
+			}
+		};
+
+		inline F4 Min(const F4& a, const F4& b) { return F4(std::min(a.V[0], b.V[0]), std::min(a.V[1], b.V[1]), std::min(a.V[2], b.V[2]), std::min(a.V[3], b.V[3])); }
+		inline F4 Max(const F4& a, const F4& b) { return F4(std::max(a.V[0], b.V[0]), std::max(a.V[1], b.V[1]), std::max(a.V[2], b.V[2]), std::max(a.V[3], b.V[3])); }
+#endif
+
+		inline F4 Clamp01(const F4& v) { return Min(Max(v, F4(0.0f)), F4(1.0f)); }
+		inline F4 Lerp(const F4& a, const F4& b, const F4& t) { return a + (b - a) * t; }
+
+		struct ColorF4
+		{
+			F4 R, G, B, A;
+		};
+
+		STARSHINE_RASTERIZER_INLINE ColorF4 Unpack(const I4& packed)
+		{
+			const I4 byteMask(0xFF);
+			const F4 scale(1.0f / 255.0f);
+
+			return ColorF4
+			{
+				F4::FromInt(packed & byteMask) * scale,
+				F4::FromInt(packed.ShiftRight<8>() & byteMask) * scale,
+				F4::FromInt(packed.ShiftRight<16>() & byteMask) * scale,
+				F4::FromInt(packed.ShiftRight<24>()) * scale
+			};
+		}
+
+		// NOTE: Expects channels in [0; 1], rounds to the nearest value like the GPU does for UNORM targets
+		STARSHINE_RASTERIZER_INLINE I4 Pack(const ColorF4& color)
+		{
+			const F4 scale(255.0f);
+
+			const I4 r = (color.R * scale).Round();
+			const I4 g = (color.G * scale).Round();
+			const I4 b = (color.B * scale).Round();
+			const I4 a = (color.A * scale).Round();
+
+			return r | g.ShiftLeft<8>() | b.ShiftLeft<16>() | a.ShiftLeft<24>();
+		}
+
+		STARSHINE_RASTERIZER_INLINE i32 AddressTexel(i32 index, i32 size, bool wrap)
+		{
+			if (wrap)
+			{
+				if ((size & (size - 1)) == 0)
+				{
+					return index & (size - 1);
+				}
+
+				const i32 wrapped = index % size;
+				return (wrapped < 0) ? wrapped + size : wrapped;
+			}
+
+			return std::clamp(index, 0, size - 1);
+		}
+
+		STARSHINE_RASTERIZER_INLINE F4 GetBlendFactor(BlendFactor factor, const F4& srcValue, const F4& srcAlpha, const F4& dstValue, const F4& dstAlpha)
+		{
+			switch (factor)
+			{
+			case BlendFactor::One:
+				return F4(1.0f);
+			case BlendFactor::SrcColor:
+				return srcValue;
+			case BlendFactor::OneMinusSrcColor:
+				return F4(1.0f) - srcValue;
+			case BlendFactor::DestColor:
+				return dstValue;
+			case BlendFactor::OneMinusDestColor:
+				return F4(1.0f) - dstValue;
+			case BlendFactor::SrcAlpha:
+				return srcAlpha;
+			case BlendFactor::OneMinusSrcAlpha:
+				return F4(1.0f) - srcAlpha;
+			case BlendFactor::DestAlpha:
+				return dstAlpha;
+			case BlendFactor::OneMinusDestAlpha:
+				return F4(1.0f) - dstAlpha;
+			default:
+				return F4(0.0f);
+			}
+		}
+
+		STARSHINE_RASTERIZER_INLINE F4 BlendValue(BlendOperation op, BlendFactor srcFactor, BlendFactor dstFactor,
+			const F4& srcValue, const F4& srcAlpha, const F4& dstValue, const F4& dstAlpha)
+		{
+			switch (op)
+			{
+			case BlendOperation::Min:
+				return Min(srcValue, dstValue);
+			case BlendOperation::Max:
+				return Max(srcValue, dstValue);
+			default:
+				break;
+			}
+
+			const F4 src = srcValue * GetBlendFactor(srcFactor, srcValue, srcAlpha, dstValue, dstAlpha);
+			const F4 dst = dstValue * GetBlendFactor(dstFactor, srcValue, srcAlpha, dstValue, dstAlpha);
+
+			switch (op)
+			{
+			case BlendOperation::Subtract:
+				return src - dst;
+			case BlendOperation::SubtractInverse:
+				return dst - src;
+			default:
+				return src + dst;
+			}
+		}
+
+		enum class SampleMode : u8
+		{
+			// NOTE: No texture bound, or the program doesn't sample it
+			None,
+			// NOTE: 1x1 textures (like the sprite renderer's default white one) don't need any filtering
+			Solid,
+			Nearest,
+			Bilinear,
+		};
+
+		enum class BlendMode : u8
+		{
+			Disabled,
+			// NOTE: The sprite renderer's normal blend mode, by far the most common one
+			Alpha,
+			Generic,
+		};
+
+		// NOTE: Per triangle constants of the fragment stage
+		struct FragmentContext
+		{
+			const RasterState* State{};
+			SampleMode Sampling{};
+			BlendMode Blending{};
+
+			const u32* Texels{};
+			i32 TextureWidth{};
+			i32 TextureHeight{};
+			bool WrapS{};
+			bool WrapT{};
+
+			ColorF4 SolidTexel{};
+
+			FragmentContext(const RasterState& state) : State(&state)
+			{
+				if (state.BlendEnabled)
+				{
+					const BlendStateDesc& blend = state.Blend;
+					const bool alphaBlend = blend.ColorOp == BlendOperation::Add && blend.SrcColor == BlendFactor::SrcAlpha && blend.DstColor == BlendFactor::OneMinusSrcAlpha &&
+						blend.AlphaOp == BlendOperation::Add && blend.SrcAlpha == BlendFactor::Zero && blend.DstAlpha == BlendFactor::One;
+
+					Blending = alphaBlend ? BlendMode::Alpha : BlendMode::Generic;
+				}
+
+				if (state.Program == FragmentProgram::VertexColor || state.Texture == nullptr || state.Texture->Texels == nullptr)
+				{
+					return;
+				}
+
+				Texels = state.Texture->Texels.get();
+				TextureWidth = state.Texture->Size.x;
+				TextureHeight = state.Texture->Size.y;
+				WrapS = state.Texture->Flags.WrapS;
+				WrapT = state.Texture->Flags.WrapT;
+
+				if (TextureWidth == 1 && TextureHeight == 1)
+				{
+					Sampling = SampleMode::Solid;
+					SolidTexel = Unpack(I4(static_cast<i32>(Texels[0])));
+				}
+				else
+				{
+					Sampling = state.Texture->Flags.NearestFiltering ? SampleMode::Nearest : SampleMode::Bilinear;
+				}
+			}
+
+			STARSHINE_RASTERIZER_INLINE I4 Gather(const std::array<i32, 4>& x, const std::array<i32, 4>& y) const
+			{
+				return I4(
+					static_cast<i32>(Texels[y[0] * TextureWidth + x[0]]),
+					static_cast<i32>(Texels[y[1] * TextureWidth + x[1]]),
+					static_cast<i32>(Texels[y[2] * TextureWidth + x[2]]),
+					static_cast<i32>(Texels[y[3] * TextureWidth + x[3]]));
+			}
+
+			template <SampleMode Mode>
+			STARSHINE_RASTERIZER_INLINE ColorF4 Sample(const F4& u, const F4& v) const
+			{
+				if constexpr (Mode == SampleMode::None)
+				{
+					// NOTE: Same as sampling an unbound texture on the GPU
+					return ColorF4{ F4(0.0f), F4(0.0f), F4(0.0f), F4(0.0f) };
+				}
+				else if constexpr (Mode == SampleMode::Solid)
+				{
+					return SolidTexel;
+				}
+				else if constexpr (Mode == SampleMode::Nearest)
+				{
+					const F4 coordMin(-MaxTexelCoordinate);
+					const F4 coordMax(MaxTexelCoordinate);
+
+					std::array<i32, 4> x{}, y{};
+					Min(Max(u * F4(static_cast<f32>(TextureWidth)), coordMin), coordMax).Floor().Truncate().ToArray(x.data());
+					Min(Max(v * F4(static_cast<f32>(TextureHeight)), coordMin), coordMax).Floor().Truncate().ToArray(y.data());
+
+					for (size_t i = 0; i < 4; i++)
+					{
+						x[i] = AddressTexel(x[i], TextureWidth, WrapS);
+						y[i] = AddressTexel(y[i], TextureHeight, WrapT);
+					}
+
+					return Unpack(Gather(x, y));
+				}
+				else
+				{
+					const F4 half(0.5f);
+					const F4 coordMin(-MaxTexelCoordinate);
+					const F4 coordMax(MaxTexelCoordinate);
+
+					const F4 texelX = Min(Max(u * F4(static_cast<f32>(TextureWidth)) - half, coordMin), coordMax);
+					const F4 texelY = Min(Max(v * F4(static_cast<f32>(TextureHeight)) - half, coordMin), coordMax);
+					const F4 floorX = texelX.Floor();
+					const F4 floorY = texelY.Floor();
+					const F4 fracX = texelX - floorX;
+					const F4 fracY = texelY - floorY;
+
+					std::array<i32, 4> x0{}, y0{}, x1{}, y1{};
+					floorX.Truncate().ToArray(x0.data());
+					floorY.Truncate().ToArray(y0.data());
+
+					for (size_t i = 0; i < 4; i++)
+					{
+						x1[i] = AddressTexel(x0[i] + 1, TextureWidth, WrapS);
+						y1[i] = AddressTexel(y0[i] + 1, TextureHeight, WrapT);
+						x0[i] = AddressTexel(x0[i], TextureWidth, WrapS);
+						y0[i] = AddressTexel(y0[i], TextureHeight, WrapT);
+					}
+
+					const ColorF4 t00 = Unpack(Gather(x0, y0));
+					const ColorF4 t10 = Unpack(Gather(x1, y0));
+					const ColorF4 t01 = Unpack(Gather(x0, y1));
+					const ColorF4 t11 = Unpack(Gather(x1, y1));
+
+					return ColorF4
+					{
+						Lerp(Lerp(t00.R, t10.R, fracX), Lerp(t01.R, t11.R, fracX), fracY),
+						Lerp(Lerp(t00.G, t10.G, fracX), Lerp(t01.G, t11.G, fracX), fracY),
+						Lerp(Lerp(t00.B, t10.B, fracX), Lerp(t01.B, t11.B, fracX), fracY),
+						Lerp(Lerp(t00.A, t10.A, fracX), Lerp(t01.A, t11.A, fracX), fracY)
+					};
+				}
+			}
+
+			// NOTE: Built-in counterparts of the fragment shaders, see SoftwareShader.h
+			template <SampleMode Mode>
+			STARSHINE_RASTERIZER_INLINE ColorF4 Shade(const std::array<F4, AttribPlane_Count>& attribs) const
+			{
+				const ColorF4 color{ attribs[AttribPlane_R], attribs[AttribPlane_G], attribs[AttribPlane_B], attribs[AttribPlane_A] };
+
+				if constexpr (Mode == SampleMode::Solid)
+				{
+					// NOTE: Untextured sprites sample a white texel, there is nothing to multiply
+					if (State->Program == FragmentProgram::TextureColor && Texels[0] == 0xFFFFFFFF)
+						return color;
+				}
+
+				switch (State->Program)
+				{
+				case FragmentProgram::VertexColor:
+					return color;
+
+				case FragmentProgram::Font:
+				{
+					const ColorF4 texel = Sample<Mode>(attribs[AttribPlane_U], attribs[AttribPlane_V]);
+					switch (State->FontType)
+					{
+					case 0:
+						return ColorF4{ texel.R * color.R, texel.G * color.G, texel.B * color.B, texel.A * color.A };
+					case 1:
+						return ColorF4{ color.R, color.G, color.B, color.A * texel.R };
+					case 2:
+					{
+						const vec4& outline = State->OutlineColor;
+						return ColorF4
+						{
+							F4(outline.r) + color.R * texel.R,
+							F4(outline.g) + color.G * texel.R,
+							F4(outline.b) + color.B * texel.R,
+							texel.G + color.A * texel.R * texel.R
+						};
+					}
+					default:
+						return ColorF4{ F4(0.0f), F4(0.0f), F4(0.0f), F4(0.0f) };
+					}
+				}
+
+				default:
+				{
+					const ColorF4 texel = Sample<Mode>(attribs[AttribPlane_U], attribs[AttribPlane_V]);
+					return ColorF4{ texel.R * color.R, texel.G * color.G, texel.B * color.B, texel.A * color.A };
+				}
+				}
+			}
+
+			template <SampleMode Mode, BlendMode Blend>
+			STARSHINE_RASTERIZER_INLINE void ShadeAndWrite(u32* dst, u32 coverage, const std::array<F4, AttribPlane_Count>& attribs) const
+			{
+				const ColorF4 shaded = Shade<Mode>(attribs);
+				ColorF4 src{ Clamp01(shaded.R), Clamp01(shaded.G), Clamp01(shaded.B), Clamp01(shaded.A) };
+
+				const I4 dstPacked = I4::Load(dst);
+				if constexpr (Blend == BlendMode::Alpha)
+				{
+					const ColorF4 dstColor = Unpack(dstPacked);
+					const F4 inverseAlpha = F4(1.0f) - src.A;
+
+					src = ColorF4
+					{
+						src.R * src.A + dstColor.R * inverseAlpha,
+						src.G * src.A + dstColor.G * inverseAlpha,
+						src.B * src.A + dstColor.B * inverseAlpha,
+						dstColor.A
+					};
+				}
+				else if constexpr (Blend == BlendMode::Generic)
+				{
+					const BlendStateDesc& blend = State->Blend;
+					const ColorF4 dstColor = Unpack(dstPacked);
+
+					src = ColorF4
+					{
+						Clamp01(BlendValue(blend.ColorOp, blend.SrcColor, blend.DstColor, src.R, src.A, dstColor.R, dstColor.A)),
+						Clamp01(BlendValue(blend.ColorOp, blend.SrcColor, blend.DstColor, src.G, src.A, dstColor.G, dstColor.A)),
+						Clamp01(BlendValue(blend.ColorOp, blend.SrcColor, blend.DstColor, src.B, src.A, dstColor.B, dstColor.A)),
+						Clamp01(BlendValue(blend.AlphaOp, blend.SrcAlpha, blend.DstAlpha, src.A, src.A, dstColor.A, dstColor.A))
+					};
+				}
+
+				if (coverage == 0xF)
+				{
+					Pack(src).Store(dst);
+				}
+				else
+				{
+					const I4 laneBits(1, 2, 4, 8);
+					const I4 laneMask = (laneBits & I4(static_cast<i32>(coverage))).Equals(laneBits);
+					Select(laneMask, Pack(src), dstPacked).Store(dst);
+				}
+			}
+		};
+
+		bool operator==(const BlendStateDesc& a, const BlendStateDesc& b)
+		{
+			return a.SrcColor == b.SrcColor && a.DstColor == b.DstColor && a.SrcAlpha == b.SrcAlpha && a.DstAlpha == b.DstAlpha &&
+				a.ColorOp == b.ColorOp && a.AlphaOp == b.AlphaOp;
+		}
+
+		bool operator==(const RasterState& a, const RasterState& b)
+		{
+			return a.Texture == b.Texture && a.Program == b.Program &&
+				a.BlendEnabled == b.BlendEnabled && (!a.BlendEnabled || a.Blend == b.Blend) &&
+				a.FontType == b.FontType && a.OutlineColor == b.OutlineColor &&
+				a.ClipRect.X == b.ClipRect.X && a.ClipRect.Y == b.ClipRect.Y && a.ClipRect.Width == b.ClipRect.Width && a.ClipRect.Height == b.ClipRect.Height;
+		}
+	}
+
+	struct Rasterizer::Impl
+	{
+		ivec2 Size{};
+		size_t Pitch{};
+		std::vector<u32> Pixels;
+
+		i32 TileCountX{};
+		i32 TileCountY{};
+		std::vector<std::vector<u32>> TileBins;
+		std::vector<u32> ActiveTiles;
+
+		std::vector<TriangleSetup> Triangles;
+		std::vector<RasterState> States;
+		bool LastStateUsed{};
+
+		RasterStats Stats{};
+
+		std::unique_ptr<ThreadPool> Pool;
+
+		void Resize(ivec2 size)
+		{
+			Size = glm::max(size, ivec2(0));
+			// NOTE: Pixels are processed in aligned groups of four, padding the rows keeps the last group of every row inside the buffer
+			Pitch = (static_cast<size_t>(Size.x) + 3) & ~static_cast<size_t>(3);
+			Pixels.assign(Pitch * Size.y, 0);
+
+			TileCountX = (Size.x + TileSize - 1) >> TileSizeShift;
+			TileCountY = (Size.y + TileSize - 1) >> TileSizeShift;
+			TileBins.clear();
+			TileBins.resize(static_cast<size_t>(TileCountX) * TileCountY);
+
+			DropPendingTriangles();
+		}
+
+		void DropPendingTriangles()
+		{
+			for (u32 tileIndex : ActiveTiles)
+			{
+				TileBins[tileIndex].clear();
+			}
+
+			ActiveTiles.clear();
+			Triangles.clear();
+
+			if (!States.empty())
+			{
+				// NOTE: The current state stays set for upcoming triangles
+				States.erase(States.begin(), States.end() - 1);
+			}
+			LastStateUsed = false;
+		}
+
+		void Clear(u32 packedColor)
+		{
+			DropPendingTriangles();
+			std::fill(Pixels.begin(), Pixels.end(), packedColor);
+		}
+
+		void SetState(const RasterState& state)
+		{
+			if (!States.empty() && States.back() == state)
+			{
+				return;
+			}
+
+			if (!States.empty() && !LastStateUsed)
+			{
+				States.back() = state;
+			}
+			else
+			{
+				States.push_back(state);
+			}
+
+			LastStateUsed = false;
+		}
+
+		void PushTriangle(const RasterVertex& v0, const RasterVertex& v1, const RasterVertex& v2)
+		{
+			Stats.Triangles++;
+
+			if (States.empty())
+			{
+				return;
+			}
+
+			const RasterState& state = States.back();
+			const i32 clipMinX = std::max(state.ClipRect.X, 0);
+			const i32 clipMinY = std::max(state.ClipRect.Y, 0);
+			const i32 clipMaxX = std::min(state.ClipRect.X + state.ClipRect.Width, Size.x);
+			const i32 clipMaxY = std::min(state.ClipRect.Y + state.ClipRect.Height, Size.y);
+
+			if (clipMinX >= clipMaxX || clipMinY >= clipMaxY)
+			{
+				return;
+			}
+
+			std::array<const RasterVertex*, 3> vertices{ &v0, &v1, &v2 };
+			std::array<i32, 3> fixedX{}, fixedY{};
+
+			for (size_t i = 0; i < 3; i++)
+			{
+				const vec2 position = vertices[i]->Position;
+
+				// NOTE: Also rejects NaNs
+				if (!(std::abs(position.x) <= GuardBand && std::abs(position.y) <= GuardBand))
+				{
+					return;
+				}
+
+				fixedX[i] = static_cast<i32>(std::lround(position.x * SubpixelScale));
+				fixedY[i] = static_cast<i32>(std::lround(position.y * SubpixelScale));
+			}
+
+			i64 area = static_cast<i64>(fixedX[1] - fixedX[0]) * (fixedY[2] - fixedY[0]) - static_cast<i64>(fixedY[1] - fixedY[0]) * (fixedX[2] - fixedX[0]);
+			if (area == 0)
+			{
+				return;
+			}
+
+			// NOTE: Nothing is culled, both windings are brought to the same orientation instead
+			if (area < 0)
+			{
+				std::swap(vertices[1], vertices[2]);
+				std::swap(fixedX[1], fixedX[2]);
+				std::swap(fixedY[1], fixedY[2]);
+				area = -area;
+			}
+
+			TriangleSetup tri{};
+
+			// NOTE: Covered pixel centers, a center at 'p' subpixels belongs to pixel (p - SubpixelHalf) / SubpixelScale
+			const i32 minFixedX = std::min({ fixedX[0], fixedX[1], fixedX[2] });
+			const i32 minFixedY = std::min({ fixedY[0], fixedY[1], fixedY[2] });
+			const i32 maxFixedX = std::max({ fixedX[0], fixedX[1], fixedX[2] });
+			const i32 maxFixedY = std::max({ fixedY[0], fixedY[1], fixedY[2] });
+
+			tri.MinX = std::max((minFixedX - SubpixelHalf + SubpixelScale - 1) >> SubpixelBits, clipMinX);
+			tri.MinY = std::max((minFixedY - SubpixelHalf + SubpixelScale - 1) >> SubpixelBits, clipMinY);
+			tri.MaxX = std::min(((maxFixedX - SubpixelHalf) >> SubpixelBits) + 1, clipMaxX);
+			tri.MaxY = std::min(((maxFixedY - SubpixelHalf) >> SubpixelBits) + 1, clipMaxY);
+
+			if (tri.MinX >= tri.MaxX || tri.MinY >= tri.MaxY)
+			{
+				return;
+			}
+
+			for (size_t edge = 0; edge < 3; edge++)
+			{
+				const size_t from = (edge + 1) % 3;
+				const size_t to = (edge + 2) % 3;
+
+				const i64 a = static_cast<i64>(fixedY[from]) - fixedY[to];
+				const i64 b = static_cast<i64>(fixedX[to]) - fixedX[from];
+				const i64 c = -(a * fixedX[from] + b * fixedY[from]);
+
+				// NOTE: Top-left fill rule, pixel centers exactly on an edge only belong to the triangle if it's a top or a left edge
+				const bool topLeft = (a > 0) || (a == 0 && b > 0);
+
+				tri.EdgeOrigin[edge] = a * SubpixelHalf + b * SubpixelHalf + c + (topLeft ? 0 : -1);
+				tri.EdgeStepX[edge] = static_cast<i32>(a * SubpixelScale);
+				tri.EdgeStepY[edge] = static_cast<i32>(b * SubpixelScale);
+			}
+
+			const vec2 p0 = vec2(fixedX[0], fixedY[0]) / static_cast<f32>(SubpixelScale);
+			const vec2 d1 = vec2(fixedX[1], fixedY[1]) / static_cast<f32>(SubpixelScale) - p0;
+			const vec2 d2 = vec2(fixedX[2], fixedY[2]) / static_cast<f32>(SubpixelScale) - p0;
+			const f32 inverseArea = static_cast<f32>(SubpixelScale * SubpixelScale) / static_cast<f32>(area);
+
+			auto setupPlane = [&](AttribPlane plane, f32 f0, f32 f1, f32 f2)
+			{
+				const f32 delta1 = f1 - f0;
+				const f32 delta2 = f2 - f0;
+
+				const f32 stepX = (delta1 * d2.y - delta2 * d1.y) * inverseArea;
+				const f32 stepY = (delta2 * d1.x - delta1 * d2.x) * inverseArea;
+
+				tri.Planes[plane] = vec3(stepX, stepY, f0 + stepX * (0.5f - p0.x) + stepY * (0.5f - p0.y));
+			};
+
+			setupPlane(AttribPlane_U, vertices[0]->TexCoord.x, vertices[1]->TexCoord.x, vertices[2]->TexCoord.x);
+			setupPlane(AttribPlane_V, vertices[0]->TexCoord.y, vertices[1]->TexCoord.y, vertices[2]->TexCoord.y);
+			setupPlane(AttribPlane_R, vertices[0]->Color.r, vertices[1]->Color.r, vertices[2]->Color.r);
+			setupPlane(AttribPlane_G, vertices[0]->Color.g, vertices[1]->Color.g, vertices[2]->Color.g);
+			setupPlane(AttribPlane_B, vertices[0]->Color.b, vertices[1]->Color.b, vertices[2]->Color.b);
+			setupPlane(AttribPlane_A, vertices[0]->Color.a, vertices[1]->Color.a, vertices[2]->Color.a);
+
+			tri.StateIndex = static_cast<u32>(States.size() - 1);
+
+			const u32 triangleIndex = static_cast<u32>(Triangles.size());
+			bool binned = false;
+
+			for (i32 tileY = tri.MinY >> TileSizeShift; tileY <= ((tri.MaxY - 1) >> TileSizeShift); tileY++)
+			{
+				for (i32 tileX = tri.MinX >> TileSizeShift; tileX <= ((tri.MaxX - 1) >> TileSizeShift); tileX++)
+				{
+					const i32 minX = std::max(tileX << TileSizeShift, tri.MinX);
+					const i32 minY = std::max(tileY << TileSizeShift, tri.MinY);
+					const i32 maxX = std::min((tileX + 1) << TileSizeShift, tri.MaxX) - 1;
+					const i32 maxY = std::min((tileY + 1) << TileSizeShift, tri.MaxY) - 1;
+
+					// NOTE: Skips tiles that are entirely outside of one edge, tested at the corner that's furthest inside of it
+					bool outside = false;
+					for (size_t edge = 0; edge < 3 && !outside; edge++)
+					{
+						const i64 x = (tri.EdgeStepX[edge] > 0) ? maxX : minX;
+						const i64 y = (tri.EdgeStepY[edge] > 0) ? maxY : minY;
+						outside = (tri.EdgeOrigin[edge] + tri.EdgeStepX[edge] * x + tri.EdgeStepY[edge] * y) < 0;
+					}
+
+					if (outside)
+					{
+						continue;
+					}
+
+					const u32 tileIndex = static_cast<u32>(tileY * TileCountX + tileX);
+					std::vector<u32>& bin = TileBins[tileIndex];
+					if (bin.empty())
+					{
+						ActiveTiles.push_back(tileIndex);
+					}
+
+					bin.push_back(triangleIndex);
+					Stats.TileBins++;
+					binned = true;
+				}
+			}
+
+			if (binned)
+			{
+				Triangles.push_back(tri);
+				LastStateUsed = true;
+			}
+		}
+
+		void DrawTriangle(const TriangleSetup& tri, i32 tileMinX, i32 tileMinY, i32 tileMaxX, i32 tileMaxY)
+		{
+			const i32 minX = std::max(tri.MinX, tileMinX);
+			const i32 minY = std::max(tri.MinY, tileMinY);
+			const i32 maxX = std::min(tri.MaxX, tileMaxX);
+			const i32 maxY = std::min(tri.MaxY, tileMaxY);
+
+			if (minX >= maxX || minY >= maxY)
+			{
+				return;
+			}
+
+			const FragmentContext fragment(States[tri.StateIndex]);
+			switch (fragment.Sampling)
+			{
+			case SampleMode::None:
+				DrawTriangle<SampleMode::None>(tri, fragment, minX, minY, maxX, maxY);
+				break;
+			case SampleMode::Solid:
+				DrawTriangle<SampleMode::Solid>(tri, fragment, minX, minY, maxX, maxY);
+				break;
+			case SampleMode::Nearest:
+				DrawTriangle<SampleMode::Nearest>(tri, fragment, minX, minY, maxX, maxY);
+				break;
+			case SampleMode::Bilinear:
+				DrawTriangle<SampleMode::Bilinear>(tri, fragment, minX, minY, maxX, maxY);
+				break;
+			}
+		}
+
+		template <SampleMode Mode>
+		void DrawTriangle(const TriangleSetup& tri, const FragmentContext& fragment, i32 minX, i32 minY, i32 maxX, i32 maxY)
+		{
+			switch (fragment.Blending)
+			{
+			case BlendMode::Disabled:
+				DrawTriangle<Mode, BlendMode::Disabled>(tri, fragment, minX, minY, maxX, maxY);
+				break;
+			case BlendMode::Alpha:
+				DrawTriangle<Mode, BlendMode::Alpha>(tri, fragment, minX, minY, maxX, maxY);
+				break;
+			case BlendMode::Generic:
+				DrawTriangle<Mode, BlendMode::Generic>(tri, fragment, minX, minY, maxX, maxY);
+				break;
+			}
+		}
+
+		// NOTE: Every sampling and blending combination gets its own loop, so the per pixel work has no branches left in it
+		template <SampleMode Mode, BlendMode Blend>
+		void DrawTriangle(const TriangleSetup& tri, const FragmentContext& fragment, i32 minX, i32 minY, i32 maxX, i32 maxY)
+		{
+			std::array<I4, 3> edgeGroupStep{};
+			std::array<I4, 3> edgeLaneOffset{};
+			std::array<f64, 3> edgeInverseStepX{};
+			for (size_t edge = 0; edge < 3; edge++)
+			{
+				const i32 step = tri.EdgeStepX[edge];
+				edgeGroupStep[edge] = I4(step * 4);
+				edgeLaneOffset[edge] = I4(0, step, step * 2, step * 3);
+				edgeInverseStepX[edge] = (step != 0) ? 1.0 / step : 0.0;
+			}
+
+			std::array<F4, AttribPlane_Count> planeGroupStep{};
+			std::array<F4, AttribPlane_Count> planeLaneOffset{};
+			for (size_t plane = 0; plane < AttribPlane_Count; plane++)
+			{
+				const f32 step = tri.Planes[plane].x;
+				planeGroupStep[plane] = F4(step * 4.0f);
+				planeLaneOffset[plane] = F4(0.0f, step, step * 2.0f, step * 3.0f);
+			}
+
+			for (i32 y = minY; y < maxY; y++)
+			{
+				// NOTE: Narrows the row down to the span between the edges, so the groups on either side of the triangle aren't visited at all.
+				//		 The crossings are only estimated (and widened by a pixel), the edge tests below decide the actual coverage
+				std::array<i64, 3> rowStart{};
+				i32 spanMinX = minX;
+				i32 spanMaxX = maxX;
+				for (size_t edge = 0; edge < 3; edge++)
+				{
+					rowStart[edge] = tri.EdgeOrigin[edge] + static_cast<i64>(tri.EdgeStepX[edge]) * minX + static_cast<i64>(tri.EdgeStepY[edge]) * y;
+
+					if (tri.EdgeStepX[edge] == 0)
+					{
+						spanMaxX = (rowStart[edge] < 0) ? spanMinX : spanMaxX;
+						continue;
+					}
+
+					const f64 crossing = std::clamp(static_cast<f64>(-rowStart[edge]) * edgeInverseStepX[edge], -1.0, static_cast<f64>(TileSize + 1));
+					if (tri.EdgeStepX[edge] > 0)
+						spanMinX = std::max(spanMinX, minX + static_cast<i32>(std::floor(crossing)) - 1);
+					else
+						spanMaxX = std::min(spanMaxX, minX + static_cast<i32>(std::ceil(crossing)) + 2);
+				}
+
+				if (spanMinX >= spanMaxX)
+				{
+					continue;
+				}
+
+				const i32 groupMinX = spanMinX & ~3;
+
+				std::array<I4, 3> edges{};
+				for (size_t edge = 0; edge < 3; edge++)
+				{
+					const i64 groupStart = rowStart[edge] + static_cast<i64>(tri.EdgeStepX[edge]) * (groupMinX - minX);
+					edges[edge] = I4(static_cast<i32>(std::clamp(groupStart, -EdgeClamp, EdgeClamp))) + edgeLaneOffset[edge];
+				}
+
+				std::array<F4, AttribPlane_Count> attribs{};
+				for (size_t plane = 0; plane < AttribPlane_Count; plane++)
+				{
+					const vec3& p = tri.Planes[plane];
+					attribs[plane] = F4(p.z + p.x * groupMinX + p.y * y) + planeLaneOffset[plane];
+				}
+
+				u32* row = &Pixels[static_cast<size_t>(y) * Pitch];
+				for (i32 x = groupMinX; x < spanMaxX; x += 4)
+				{
+					u32 coverage = ~(edges[0] | edges[1] | edges[2]).SignBits() & 0xF;
+
+					if (x < minX || x + 4 > maxX)
+					{
+						const i32 first = std::max(minX - x, 0);
+						const i32 end = std::min(maxX - x, 4);
+						coverage &= ((1u << end) - 1) & ~((1u << first) - 1);
+					}
+
+					if (coverage != 0)
+					{
+						fragment.ShadeAndWrite<Mode, Blend>(&row[x], coverage, attribs);
+					}
+
+					for (size_t edge = 0; edge < 3; edge++)
+					{
+						edges[edge] = edges[edge] + edgeGroupStep[edge];
+					}
+
+					for (size_t plane = 0; plane < AttribPlane_Count; plane++)
+					{
+						attribs[plane] = attribs[plane] + planeGroupStep[plane];
+					}
+				}
+			}
+		}
+
+		void DrawTile(u32 tileIndex)
+		{
+			const i32 tileMinX = static_cast<i32>(tileIndex % TileCountX) << TileSizeShift;
+			const i32 tileMinY = static_cast<i32>(tileIndex / TileCountX) << TileSizeShift;
+			const i32 tileMaxX = std::min(tileMinX + TileSize, Size.x);
+			const i32 tileMaxY = std::min(tileMinY + TileSize, Size.y);
+
+			for (u32 triangleIndex : TileBins[tileIndex])
+			{
+				DrawTriangle(Triangles[triangleIndex], tileMinX, tileMinY, tileMaxX, tileMaxY);
+			}
+		}
+
+		void Flush()
+		{
+			if (Triangles.empty())
+			{
+				DropPendingTriangles();
+				return;
+			}
+
+			const u64 startTicks = SDL_GetPerformanceCounter();
+
+			if (ActiveTiles.size() > 1)
+			{
+				if (Pool == nullptr)
+				{
+					Pool = std::make_unique<ThreadPool>();
+				}
+
+				Pool->ParallelFor(ActiveTiles.size(), [this](size_t i) { DrawTile(ActiveTiles[i]); });
+			}
+			else
+			{
+				DrawTile(ActiveTiles[0]);
+			}
+
+			DropPendingTriangles();
+
+			Stats.Flushes++;
+			Stats.RasterizeTime_ms += static_cast<f64>(SDL_GetPerformanceCounter() - startTicks) * 1000.0 / static_cast<f64>(SDL_GetPerformanceFrequency());
+		}
+	};
+
+	Rasterizer::Rasterizer() : impl(std::make_unique<Impl>())
+	{
+	}
+
+	Rasterizer::~Rasterizer()
+	{
+	}
+
+	void Rasterizer::Resize(ivec2 size)
+	{
+		impl->Resize(size);
+	}
+
+	ivec2 Rasterizer::GetSize() const
+	{
+		return impl->Size;
+	}
+
+	const u32* Rasterizer::GetPixels() const
+	{
+		return impl->Pixels.data();
+	}
+
+	size_t Rasterizer::GetPitch() const
+	{
+		return impl->Pitch;
+	}
+
+	void Rasterizer::Clear(u32 packedColor)
+	{
+		impl->Clear(packedColor);
+	}
+
+	void Rasterizer::SetState(const RasterState& state)
+	{
+		impl->SetState(state);
+	}
+
+	void Rasterizer::PushTriangle(const RasterVertex& v0, const RasterVertex& v1, const RasterVertex& v2)
+	{
+		impl->PushTriangle(v0, v1, v2);
+	}
+
+	bool Rasterizer::HasPendingTriangles() const
+	{
+		return !impl->Triangles.empty();
+	}
+
+	void Rasterizer::Flush()
+	{
+		impl->Flush();
+	}
+
+	RasterStats Rasterizer::GetStats() const
+	{
+		return impl->Stats;
+	}
+
+	void Rasterizer::ResetStats()
+	{
+		impl->Stats = {};
+	}
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include "Common/Types.h"
+#include "Common/Rect.h"
+#include "Rendering/State.h"
+#include "SoftwareShader.h"
+#include <memory>
+
+namespace Starshine::Rendering::Software
+{
+	struct SoftwareTexture;
+
+	// NOTE: Output of the vertex stage, the position is in framebuffer pixels
+	struct RasterVertex
+	{
+		vec2 Position{};
+		vec2 TexCoord{};
+		vec4 Color{};
+	};
+
+	// NOTE: Everything the fragment stage of a triangle depends on. Triangles pushed in a row with the same state share one copy
+	struct RasterState
+	{
+		const SoftwareTexture* Texture{};
+		FragmentProgram Program{};
+
+		bool BlendEnabled{};
+		BlendStateDesc Blend{};
+
+		i32 FontType{};
+		vec4 OutlineColor{};
+
+		// NOTE: Viewport clipped to the framebuffer, nothing outside of it is written
+		Rectangle ClipRect{};
+	};
+
+	struct RasterStats
+	{
+		u32 Triangles{};
+		u32 TileBins{};
+		u32 Flushes{};
+		f64 RasterizeTime_ms{};
+	};
+
+	// NOTE: Tile based triangle rasterizer. Triangles are set up and binned to 64x64 pixel tiles as they are pushed,
+	//		 Flush() then draws the tiles in parallel with every tile drawing its own triangles in the order they were pushed.
+	//		 Pixels are tested and shaded four at a time with SSE2 where it's available
+	class Rasterizer : NonCopyable
+	{
+	public:
+		Rasterizer();
+		~Rasterizer();
+
+	public:
+		// NOTE: Drops pending triangles, the new framebuffer is cleared to transparent black
+		void Resize(ivec2 size);
+		ivec2 GetSize() const;
+
+		// NOTE: Packed RGBA8 (R in the lowest byte), rows are GetPitch() pixels apart
+		const u32* GetPixels() const;
+		size_t GetPitch() const;
+
+	public:
+		// NOTE: Clears the whole framebuffer, triangles that are still pending would be overwritten anyway so they are dropped
+		void Clear(u32 packedColor);
+
+		void SetState(const RasterState& state);
+		void PushTriangle(const RasterVertex& v0, const RasterVertex& v1, const RasterVertex& v2);
+
+		bool HasPendingTriangles() const;
+		void Flush();
+
+	public:
+		RasterStats GetStats() const;
+		void ResetStats();
+
+	private:
+		struct Impl;
+		std::unique_ptr<Impl> impl;
+	};
+}
@@ -0,0 +1,41 @@
+#include "SoftwareShader.h"
+#include "Common/Logging/Logging.h"
+
+namespace Starshine::Rendering::Software
+{
+	constexpr const char* LogName = "SoftwareShader";
+
+	SoftwareShader::SoftwareShader(SoftwareDevice& device, std::string_view vsName, std::string_view fsName)
+		: deviceRef(device)
+	{
+		if (vsName == "VS_Test")
+		{
+			Vertex = VertexProgram::Passthrough;
+		}
+		else
+		{
+			Vertex = VertexProgram::Transform;
+			if (vsName != "VS_SpriteDefault" && vsName != "VS_MatrixTransform")
+			{
+				LogWarn(LogName, "No built-in vertex program for \"%.*s\", using the transform program", static_cast<int>(vsName.size()), vsName.data());
+			}
+		}
+
+		if (fsName == "FS_Font")
+		{
+			Fragment = FragmentProgram::Font;
+		}
+		else if (fsName == "FS_Test")
+		{
+			Fragment = FragmentProgram::VertexColor;
+		}
+		else
+		{
+			Fragment = FragmentProgram::TextureColor;
+			if (fsName != "FS_SpriteDefault")
+			{
+				LogWarn(LogName, "No built-in fragment program for \"%.*s\", using the texture color program", static_cast<int>(fsName.size()), fsName.data());
+			}
+		}
+	}
+}
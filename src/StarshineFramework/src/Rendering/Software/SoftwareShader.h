@@ -0,0 +1,43 @@
+#pragma once
+#include "Rendering/Shader.h"
+#include "SoftwareDevice.h"
+
+namespace Starshine::Rendering::Software
+{
+	// NOTE: The software device can't run compiled shader bytecode, every shader the renderers use has a built-in counterpart instead.
+	//		 Shaders are created from their names (e.g. "VS_SpriteDefault"), see Utilities::LoadShader
+	enum class VertexProgram : u8
+	{
+		// NOTE: Position is multiplied by the matrix in vertex uniform buffer 0 (VS_SpriteDefault, VS_MatrixTransform)
+		Transform,
+		// NOTE: Position is already in clip space (VS_Test)
+		Passthrough,
+
+		Count
+	};
+
+	enum class FragmentProgram : u8
+	{
+		// NOTE: Texel * vertex color (FS_SpriteDefault). Like the font program, it samples the texture slot in the triangle's TEXCOORD1
+		TextureColor,
+		// NOTE: Vertex color only (FS_Test)
+		VertexColor,
+		// NOTE: Depends on the font type in fragment uniform buffer 0 (FS_Font)
+		Font,
+
+		Count
+	};
+
+	struct SoftwareShader : public Shader
+	{
+	public:
+		SoftwareShader(SoftwareDevice& device, std::string_view vsName, std::string_view fsName);
+		~SoftwareShader() override = default;
+
+	public:
+		VertexProgram Vertex{};
+		FragmentProgram Fragment{};
+
+		SoftwareDevice& deviceRef;
+	};
+}
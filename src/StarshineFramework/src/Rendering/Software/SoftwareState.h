@@ -0,0 +1,17 @@
+#pragma once
+#include "Rendering/State.h"
+#include "SoftwareDevice.h"
+
+namespace Starshine::Rendering::Software
+{
+	// NOTE: Blending is evaluated from the description by the rasterizer, there is nothing to create up front
+	struct SoftwareBlendState : public BlendState
+	{
+	public:
+		SoftwareBlendState(SoftwareDevice& device, const BlendStateDesc& desc) : BlendState(desc), deviceRef(device) {}
+		~SoftwareBlendState() override = default;
+
+	public:
+		SoftwareDevice& deviceRef;
+	};
+}
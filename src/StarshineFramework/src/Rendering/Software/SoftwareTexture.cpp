@@ -0,0 +1,68 @@
+#include "SoftwareTexture.h"
+
+namespace Starshine::Rendering::Software
+{
+	namespace
+	{
+		void ConvertTexels(u32* dst, size_t dstPitch, const u8* src, size_t srcPitch, i32 width, i32 height, Graphics::TextureFormat format)
+		{
+			for (i32 y = 0; y < height; y++)
+			{
+				const u8* srcRow = &src[y * srcPitch];
+				u32* dstRow = &dst[y * dstPitch];
+
+				switch (format)
+				{
+				case Graphics::TextureFormat::RGBA8:
+					SDL_memcpy(dstRow, srcRow, width * sizeof(u32));
+					break;
+				case Graphics::TextureFormat::RG8:
+					for (i32 x = 0; x < width; x++)
+					{
+						dstRow[x] = srcRow[x * 2] | (srcRow[x * 2 + 1] << 8) | 0xFF000000;
+					}
+					break;
+				case Graphics::TextureFormat::R8:
+					for (i32 x = 0; x < width; x++)
+					{
+						dstRow[x] = srcRow[x] | 0xFF000000;
+					}
+					break;
+				}
+			}
+		}
+	}
+
+	SoftwareTexture::SoftwareTexture(SoftwareDevice& device, Graphics::Texture* texture)
+		: deviceRef(device), ParentTexture(texture)
+	{
+		Size = texture->GetSize();
+		Flags = texture->GetFlags();
+
+		const Graphics::TextureFormat texFormat = texture->GetFormat();
+		const size_t srcPitch = static_cast<size_t>(Size.x) * Graphics::TexturePixelSizes[static_cast<size_t>(texFormat)];
+
+		Texels = std::make_unique<u32[]>(static_cast<size_t>(Size.x) * Size.y);
+		ConvertTexels(Texels.get(), Size.x, texture->GetData(), srcPitch, Size.x, Size.y, texFormat);
+	}
+
+	SoftwareTexture::~SoftwareTexture()
+	{
+		// NOTE: Queued triangles sample the texels directly, they have to be drawn before the texels go away
+		deviceRef.FlushDraws();
+	}
+
+	void SoftwareTexture::SetData(const void* source, i32 x, i32 y, i32 width, i32 height)
+	{
+		const bool dynamic = ParentTexture->GPUTexture.Dynamic;
+		const Graphics::TextureFormat texFormat = ParentTexture->GetFormat();
+
+		if (dynamic && (x + width) <= Size.x && (y + height) <= Size.y)
+		{
+			deviceRef.FlushDraws();
+
+			const size_t srcPitch = static_cast<size_t>(Size.x) * Graphics::TexturePixelSizes[static_cast<size_t>(texFormat)];
+			ConvertTexels(&Texels[static_cast<size_t>(y) * Size.x + x], Size.x, reinterpret_cast<const u8*>(source), srcPitch, width, height, texFormat);
+		}
+	}
+}
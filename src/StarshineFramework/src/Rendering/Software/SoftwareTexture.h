@@ -0,0 +1,28 @@
+#pragma once
+#include "Rendering/Texture.h"
+#include "SoftwareDevice.h"
+#include <memory>
+
+namespace Starshine::Rendering::Software
+{
+	// NOTE: Texels are kept expanded to packed RGBA8 (R in the lowest byte) whatever the source format is,
+	//		 R8 and RG8 textures read back missing channels as 0 and alpha as 1 like they do on the GPU
+	struct SoftwareTexture : public Texture
+	{
+	public:
+		SoftwareTexture(SoftwareDevice& device, Graphics::Texture* texture);
+		~SoftwareTexture() override;
+
+	public:
+		void SetData(const void* source, i32 x, i32 y, i32 width, i32 height);
+
+	public:
+		ivec2 Size{};
+		Graphics::TextureFlags Flags{};
+		std::unique_ptr<u32[]> Texels{};
+
+		SoftwareDevice& deviceRef;
+
+		Graphics::Texture* ParentTexture{};
+	};
+}
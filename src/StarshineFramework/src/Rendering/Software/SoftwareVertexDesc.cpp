@@ -0,0 +1,61 @@
+#include "SoftwareVertexDesc.h"
+#include "Common/MathExt.h"
+
+namespace Starshine::Rendering::Software
+{
+	SoftwareVertexDesc::SoftwareVertexDesc(SoftwareDevice& device, const VertexAttrib* attribs, size_t attribCount)
+		: deviceRef(device)
+	{
+		for (size_t i = 0; i < attribCount; i++)
+		{
+			const VertexAttrib* stAttrib = &attribs[i];
+
+			if (stAttrib->Index < MaxAttribIndices)
+			{
+				SoftwareVertexAttrib& attrib = Attribs[static_cast<size_t>(stAttrib->Type)][stAttrib->Index];
+				attrib.Enabled = true;
+				attrib.Format = stAttrib->Format;
+				attrib.Offset = stAttrib->Offset;
+			}
+
+			VertexStride = MathExtensions::Max(VertexStride, stAttrib->VertexSize);
+		}
+	}
+
+	vec4 SoftwareVertexDesc::Fetch(const u8* vertex, VertexAttribType type, u32 index) const
+	{
+		vec4 result{ 0.0f, 0.0f, 0.0f, 1.0f };
+		if (index >= MaxAttribIndices)
+		{
+			return result;
+		}
+
+		const SoftwareVertexAttrib& attrib = Attribs[static_cast<size_t>(type)][index];
+		if (!attrib.Enabled)
+		{
+			return result;
+		}
+
+		const u8* data = &vertex[attrib.Offset];
+		switch (attrib.Format)
+		{
+		case VertexAttribFormat::Float1:
+		case VertexAttribFormat::Float2:
+		case VertexAttribFormat::Float3:
+		case VertexAttribFormat::Float4:
+		{
+			const size_t componentCount = static_cast<size_t>(attrib.Format) - static_cast<size_t>(VertexAttribFormat::Float1) + 1;
+			SDL_memcpy(&result[0], data, componentCount * sizeof(f32));
+			break;
+		}
+		case VertexAttribFormat::UnsignedByte4:
+			result = vec4(data[0], data[1], data[2], data[3]);
+			break;
+		case VertexAttribFormat::UnsignedByte4Norm:
+			result = vec4(data[0], data[1], data[2], data[3]) / 255.0f;
+			break;
+		}
+
+		return result;
+	}
+}
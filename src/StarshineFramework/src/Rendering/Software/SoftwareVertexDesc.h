@@ -0,0 +1,34 @@
+#pragma once
+#include "Rendering/VertexDesc.h"
+#include "SoftwareDevice.h"
+#include <array>
+
+namespace Starshine::Rendering::Software
+{
+	struct SoftwareVertexAttrib
+	{
+		bool Enabled{};
+		VertexAttribFormat Format{};
+		u32 Offset{};
+	};
+
+	struct SoftwareVertexDesc : public VertexDesc
+	{
+	public:
+		SoftwareVertexDesc(SoftwareDevice& device, const VertexAttrib* attribs, size_t attribCount);
+		~SoftwareVertexDesc() override = default;
+
+	public:
+		// NOTE: Missing components and attributes default to (0, 0, 0, 1), same as the input assembler
+		vec4 Fetch(const u8* vertex, VertexAttribType type, u32 index = 0) const;
+
+	public:
+		// NOTE: The built-in programs read up to TEXCOORD1 (the sprite texture slot), higher indices are ignored
+		static constexpr u32 MaxAttribIndices = 2;
+
+		u32 VertexStride{};
+		std::array<std::array<SoftwareVertexAttrib, MaxAttribIndices>, EnumCount<VertexAttribType>()> Attribs{};
+
+		SoftwareDevice& deviceRef;
+	};
+}
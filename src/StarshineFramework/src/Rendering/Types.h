@@ -5,8 +5,12 @@ namespace Starshine::Rendering
 {
 	enum class DeviceType : i32
 	{
-		OpenGL, // TODO: Implement
+		OpenGL,
 		D3D11,
+		// NOTE: Rasterizes on the CPU, doesn't need a GPU or even a window
+		Software,
+		// NOTE: Executes nothing, only counts and records the commands
+		Null,
 
 		Count
 	};
@@ -97,6 +101,8 @@ namespace Starshine::Rendering
 	constexpr std::array<const char*, EnumCount<DeviceType>()> DeviceTypeNames =
 	{
 		"OpenGL",
-		"D3D11"
+		"D3D11",
+		"Software",
+		"Null"
 	};
 }
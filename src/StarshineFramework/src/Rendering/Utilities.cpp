@@ -1,5 +1,6 @@
 #include "Utilities.h"
 #include "IO/Path/File.h"
+#include "IO/Path/Path.h"
 #include "IO/Xml.h"
 #include "Misc/ImageHelper.h"
 
@@ -10,7 +11,7 @@ namespace Starshine::Rendering
 
 	namespace Utilities
 	{
-		bool LoadShader(std::string_view vsPath, std::string_view fsPath, std::unique_ptr<Shader>& shader)
+		static bool CreateShaderFromFiles(std::string_view vsPath, std::string_view fsPath, std::unique_ptr<Shader>& shader)
 		{
 			if (!File::Exists(vsPath) || !File::Exists(fsPath)) { return false; }
 
@@ -27,6 +28,56 @@ namespace Starshine::Rendering
 			return Rendering::GetDevice()->CreateShader(vsData.get(), vsSize, fsData.get(), fsSize, shader);
 		}
 
+		static std::string GetGLSLShaderPath(std::string_view shaderPath)
+		{
+			const std::string glslDirectory = Path::Append(Path::GetDirectoryPath(Path::GetDirectoryPath(shaderPath)), "gl");
+			return Path::Append(glslDirectory, std::string(Path::GetFileName(shaderPath, false)) + ".glsl");
+		}
+
+		// NOTE: GLSL has no #include, so the code shared by the fragment shaders is inserted right after their #version line.
+		//		 The #line directive keeps the compiler's line numbers matching the fragment shader's file
+		static bool CreateGLSLShaderFromFiles(std::string_view vsPath, std::string_view fsPath, std::unique_ptr<Shader>& shader)
+		{
+			const std::string commonPath = Path::Append(Path::GetDirectoryPath(fsPath), "SpriteTextures.glsl");
+			if (!File::Exists(vsPath) || !File::Exists(fsPath) || !File::Exists(commonPath)) { return false; }
+
+			const std::string vsSource = File::ReadAllText(vsPath);
+			const std::string fsSource = File::ReadAllText(fsPath);
+			const std::string commonSource = File::ReadAllText(commonPath);
+
+			const size_t versionLineEnd = fsSource.find('\n');
+			if (vsSource.empty() || fsSource.compare(0, 8, "#version") != 0 || versionLineEnd == std::string::npos) { return false; }
+
+			std::string combinedSource{};
+			combinedSource.reserve(fsSource.size() + commonSource.size() + 16);
+			combinedSource.append(fsSource, 0, versionLineEnd + 1);
+			combinedSource.append(commonSource);
+			combinedSource.append("\n#line 2\n");
+			combinedSource.append(fsSource, versionLineEnd + 1, std::string::npos);
+
+			return Rendering::GetDevice()->CreateShader(vsSource.data(), vsSource.size(), combinedSource.data(), combinedSource.size(), shader);
+		}
+
+		bool LoadShader(std::string_view vsPath, std::string_view fsPath, std::unique_ptr<Shader>& shader)
+		{
+			if (Rendering::GetDeviceType() == DeviceType::Software)
+			{
+				// NOTE: The software device has built-in programs for the shaders instead of bytecode, it picks them by the file names
+				const std::string_view vsName = Path::GetFileName(vsPath, false);
+				const std::string_view fsName = Path::GetFileName(fsPath, false);
+				return Rendering::GetDevice()->CreateShader(vsName.data(), vsName.size(), fsName.data(), fsName.size(), shader);
+			}
+
+			if (Rendering::GetDeviceType() == DeviceType::OpenGL)
+			{
+				// NOTE: The GLSL ports are in a "gl" directory next to the compiled ones,
+				//		 e.g. "shaders/d3d11/VS_SpriteDefault.cso" -> "shaders/gl/VS_SpriteDefault.glsl"
+				return CreateGLSLShaderFromFiles(GetGLSLShaderPath(vsPath), GetGLSLShaderPath(fsPath), shader);
+			}
+
+			return CreateShaderFromFiles(vsPath, fsPath, shader);
+		}
+
 		void EnsureTextureIsUploaded(Graphics::Texture* texture)
 		{
 			if (texture->GPUTexture.Resource == nullptr)
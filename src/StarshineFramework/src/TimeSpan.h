@@ -34,19 +34,19 @@ namespace Starshine
 		TimeSpan TimeSinceLaunch{};
 	};
 
-	inline TimeSpan& operator+(const TimeSpan& a, const TimeSpan& b)
+	inline TimeSpan operator+(const TimeSpan& a, const TimeSpan& b)
 	{
 		TimeSpan result{ a.Microseconds + b.Microseconds };
 		return result;
 	};
 
-	inline TimeSpan& operator-(const TimeSpan& a, const TimeSpan& b)
+	inline TimeSpan operator-(const TimeSpan& a, const TimeSpan& b)
 	{
 		TimeSpan result{ a.Microseconds - b.Microseconds };
 		return result;
 	};
 
-	inline TimeSpan& operator-(const TimeSpan& value)
+	inline TimeSpan operator-(const TimeSpan& value)
 	{
 		TimeSpan result = TimeSpan(-value.Microseconds);
 		return result;
@@ -0,0 +1,25 @@
+#pragma once
+#include "Types.h"
+
+namespace Starshine::Hashing
+{
+	// NOTE: 64-bit FNV-1a, fast enough to fingerprint whole files while loading but not meant for anything security related
+	constexpr u64 FNV1aOffsetBasis = 0xCBF29CE484222325;
+	constexpr u64 FNV1aPrime = 0x00000100000001B3;
+
+	constexpr u64 FNV1a64(const u8* data, size_t size, u64 hash = FNV1aOffsetBasis)
+	{
+		for (size_t i = 0; i < size; i++)
+		{
+			hash ^= static_cast<u64>(data[i]);
+			hash *= FNV1aPrime;
+		}
+
+		return hash;
+	}
+
+	inline u64 FNV1a64(const void* data, size_t size, u64 hash = FNV1aOffsetBasis)
+	{
+		return FNV1a64(static_cast<const u8*>(data), size, hash);
+	}
+}
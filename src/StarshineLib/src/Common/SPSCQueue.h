@@ -0,0 +1,81 @@
+#pragma once
+#include "Types.h"
+#include "MathExt.h"
+#include <atomic>
+#include <array>
+
+namespace Starshine
+{
+	// NOTE: Fixed-size, lock-free, single-producer/single-consumer queue.
+	//		 Push() must only be called from one thread and Pop()/Peek() only from one other thread.
+	template <typename T, size_t Capacity>
+	class SPSCQueue : NonCopyable
+	{
+		static_assert(Capacity > 0 && MathExtensions::IsPowerOf2(Capacity), "Capacity must be a power of 2");
+
+	public:
+		SPSCQueue() = default;
+		~SPSCQueue() = default;
+
+	public:
+		bool Push(const T& item)
+		{
+			const size_t writePos = writeIndex.load(std::memory_order_relaxed);
+			if (writePos - readIndex.load(std::memory_order_acquire) >= Capacity)
+			{
+				return false;
+			}
+
+			items[writePos & IndexMask] = item;
+			writeIndex.store(writePos + 1, std::memory_order_release);
+			return true;
+		}
+
+		bool Pop(T& item)
+		{
+			const size_t readPos = readIndex.load(std::memory_order_relaxed);
+			if (readPos == writeIndex.load(std::memory_order_acquire))
+			{
+				return false;
+			}
+
+			item = items[readPos & IndexMask];
+			readIndex.store(readPos + 1, std::memory_order_release);
+			return true;
+		}
+
+		// NOTE: Copies the next item without removing it
+		bool Peek(T& item) const
+		{
+			const size_t readPos = readIndex.load(std::memory_order_relaxed);
+			if (readPos == writeIndex.load(std::memory_order_acquire))
+			{
+				return false;
+			}
+
+			item = items[readPos & IndexMask];
+			return true;
+		}
+
+		// NOTE: Safe to call from either thread, the result is only an estimate while the other thread is active
+		size_t GetSize() const
+		{
+			return writeIndex.load(std::memory_order_acquire) - readIndex.load(std::memory_order_acquire);
+		}
+
+		bool IsEmpty() const { return GetSize() == 0; }
+
+		// NOTE: On the producer thread a false result is guaranteed to hold, the consumer can only make more room
+		bool IsFull() const { return GetSize() >= Capacity; }
+		static constexpr size_t GetCapacity() { return Capacity; }
+
+	private:
+		static constexpr size_t IndexMask = Capacity - 1;
+		static constexpr size_t CacheLineSize = 64;
+
+		// NOTE: Both indices only ever increase, their difference is the amount of queued items
+		alignas(CacheLineSize) std::atomic<size_t> writeIndex{};
+		alignas(CacheLineSize) std::atomic<size_t> readIndex{};
+		alignas(CacheLineSize) std::array<T, Capacity> items{};
+	};
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include "Types.h"
+#include "MathExt.h"
+#include <atomic>
+#include <memory>
+#include <string.h>
+
+namespace Starshine
+{
+	// NOTE: Lock-free, single-producer/single-consumer ring buffer for bulk transfers of trivially copyable data.
+	//		 Write() and GetFreeSpace() belong to the producer thread, Read(), GetAvailable() and DiscardUntil() to the consumer thread.
+	template <typename T>
+	class SPSCRingBuffer : NonCopyable
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+	public:
+		SPSCRingBuffer(size_t minCapacity)
+		{
+			capacity = MathExtensions::IsPowerOf2(minCapacity) ? minCapacity : MathExtensions::NearestPowerOf2(minCapacity);
+			items = std::make_unique<T[]>(capacity);
+		}
+
+		~SPSCRingBuffer() = default;
+
+	public:
+		size_t Write(const T* src, size_t count)
+		{
+			const size_t writePos = writeIndex.load(std::memory_order_relaxed);
+			const size_t freeSpace = capacity - (writePos - readIndex.load(std::memory_order_acquire));
+			const size_t writeCount = (count < freeSpace) ? count : freeSpace;
+
+			CopyWrapped(writePos, src, writeCount);
+			writeIndex.store(writePos + writeCount, std::memory_order_release);
+			return writeCount;
+		}
+
+		size_t Read(T* dst, size_t count)
+		{
+			const size_t readPos = readIndex.load(std::memory_order_relaxed);
+			const size_t available = writeIndex.load(std::memory_order_acquire) - readPos;
+			const size_t readCount = (count < available) ? count : available;
+
+			const size_t start = readPos & (capacity - 1);
+			const size_t firstPart = (readCount < capacity - start) ? readCount : capacity - start;
+
+			memcpy(dst, &items[start], firstPart * sizeof(T));
+			memcpy(&dst[firstPart], &items[0], (readCount - firstPart) * sizeof(T));
+
+			readIndex.store(readPos + readCount, std::memory_order_release);
+			return readCount;
+		}
+
+		// NOTE: Drops everything that has been written before the producer's write index was 'index'
+		void DiscardUntil(size_t index)
+		{
+			const size_t readPos = readIndex.load(std::memory_order_relaxed);
+			if (static_cast<std::make_signed_t<size_t>>(index - readPos) > 0)
+			{
+				readIndex.store(index, std::memory_order_release);
+			}
+		}
+
+		size_t GetAvailable() const { return writeIndex.load(std::memory_order_acquire) - readIndex.load(std::memory_order_relaxed); }
+		size_t GetFreeSpace() const { return capacity - (writeIndex.load(std::memory_order_relaxed) - readIndex.load(std::memory_order_acquire)); }
+
+		size_t GetWriteIndex() const { return writeIndex.load(std::memory_order_acquire); }
+		size_t GetCapacity() const { return capacity; }
+
+	private:
+		void CopyWrapped(size_t writePos, const T* src, size_t count)
+		{
+			const size_t start = writePos & (capacity - 1);
+			const size_t firstPart = (count < capacity - start) ? count : capacity - start;
+
+			memcpy(&items[start], src, firstPart * sizeof(T));
+			memcpy(&items[0], &src[firstPart], (count - firstPart) * sizeof(T));
+		}
+
+	private:
+		static constexpr size_t CacheLineSize = 64;
+
+		alignas(CacheLineSize) std::atomic<size_t> writeIndex{};
+		alignas(CacheLineSize) std::atomic<size_t> readIndex{};
+
+		size_t capacity{};
+		std::unique_ptr<T[]> items{};
+	};
+}
@@ -0,0 +1,150 @@
+#include "ThreadPool.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Starshine
+{
+	struct ThreadPool::Impl
+	{
+		std::vector<std::thread> workers;
+
+		// NOTE: Only one batch runs at a time
+		std::mutex batchMutex;
+
+		std::mutex stateMutex;
+		std::condition_variable batchStarted;
+		std::condition_variable batchFinished;
+
+		// NOTE: Guarded by 'stateMutex', a new generation wakes up the workers
+		const std::function<void(size_t)>* task{};
+		size_t taskCount{};
+		u64 generation{};
+		size_t busyWorkers{};
+		bool stopping{};
+
+		std::atomic<size_t> nextTask{};
+
+		void RunTasks(const std::function<void(size_t)>& batchTask, size_t count)
+		{
+			for (size_t i = nextTask.fetch_add(1, std::memory_order_relaxed); i < count; i = nextTask.fetch_add(1, std::memory_order_relaxed))
+			{
+				batchTask(i);
+			}
+		}
+
+		void WorkerLoop()
+		{
+			u64 handledGeneration = 0;
+
+			while (true)
+			{
+				const std::function<void(size_t)>* batchTask = nullptr;
+				size_t count = 0;
+
+				{
+					std::unique_lock<std::mutex> lock(stateMutex);
+					batchStarted.wait(lock, [&]() { return stopping || generation != handledGeneration; });
+
+					if (stopping)
+					{
+						return;
+					}
+
+					handledGeneration = generation;
+
+					// NOTE: Woke up after the batch has already been finished by the others
+					if (task == nullptr)
+					{
+						continue;
+					}
+
+					batchTask = task;
+					count = taskCount;
+					busyWorkers++;
+				}
+
+				RunTasks(*batchTask, count);
+
+				{
+					std::lock_guard<std::mutex> lock(stateMutex);
+					if (--busyWorkers == 0)
+					{
+						batchFinished.notify_all();
+					}
+				}
+			}
+		}
+	};
+
+	ThreadPool::ThreadPool(size_t workerCount) : impl(std::make_unique<Impl>())
+	{
+		impl->workers.reserve(workerCount);
+		for (size_t i = 0; i < workerCount; i++)
+		{
+			impl->workers.emplace_back([this]() { impl->WorkerLoop(); });
+		}
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(impl->stateMutex);
+			impl->stopping = true;
+		}
+
+		impl->batchStarted.notify_all();
+		for (auto& worker : impl->workers)
+		{
+			worker.join();
+		}
+	}
+
+	void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)>& task)
+	{
+		if (count == 0)
+		{
+			return;
+		}
+
+		if (impl->workers.empty() || count == 1)
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				task(i);
+			}
+			return;
+		}
+
+		std::lock_guard<std::mutex> batchLock(impl->batchMutex);
+
+		{
+			std::lock_guard<std::mutex> lock(impl->stateMutex);
+			impl->task = &task;
+			impl->taskCount = count;
+			impl->nextTask.store(0, std::memory_order_relaxed);
+			impl->generation++;
+		}
+
+		impl->batchStarted.notify_all();
+		impl->RunTasks(task, count);
+
+		// NOTE: Workers that woke up late find no tasks left, but the batch has to outlive every worker that is still looking at it
+		std::unique_lock<std::mutex> lock(impl->stateMutex);
+		impl->batchFinished.wait(lock, [this]() { return impl->busyWorkers == 0; });
+		impl->task = nullptr;
+	}
+
+	size_t ThreadPool::GetWorkerCount() const
+	{
+		return impl->workers.size();
+	}
+
+	size_t ThreadPool::GetDefaultWorkerCount()
+	{
+		const size_t hardwareThreads = static_cast<size_t>(std::thread::hardware_concurrency());
+		return (hardwareThreads > 1) ? hardwareThreads - 1 : 0;
+	}
+}
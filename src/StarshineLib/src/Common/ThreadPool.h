@@ -0,0 +1,29 @@
+#pragma once
+#include "Types.h"
+#include <functional>
+#include <memory>
+
+namespace Starshine
+{
+	// NOTE: Fixed set of worker threads for batches of independent tasks.
+	//		 The calling thread works on the batch as well and ParallelFor() only returns once every task has finished.
+	class ThreadPool : NonCopyable
+	{
+	public:
+		explicit ThreadPool(size_t workerCount = GetDefaultWorkerCount());
+		~ThreadPool();
+
+	public:
+		// NOTE: Calls 'task(i)' once for every 'i' in [0; count). Batches from different threads are run one after another
+		void ParallelFor(size_t count, const std::function<void(size_t)>& task);
+
+		size_t GetWorkerCount() const;
+
+		// NOTE: One worker per hardware thread, minus the calling thread
+		static size_t GetDefaultWorkerCount();
+
+	private:
+		struct Impl;
+		std::unique_ptr<Impl> impl;
+	};
+}
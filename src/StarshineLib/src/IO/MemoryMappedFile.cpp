@@ -0,0 +1,163 @@
+#include "MemoryMappedFile.h"
+#include <utility>
+
+#if defined (_WIN32)
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Starshine::IO
+{
+	MemoryMappedFile::MemoryMappedFile(MemoryMappedFile&& other)
+	{
+		*this = std::move(other);
+	}
+
+	MemoryMappedFile::~MemoryMappedFile()
+	{
+		Close();
+	}
+
+	MemoryMappedFile& MemoryMappedFile::operator=(MemoryMappedFile&& other)
+	{
+		if (this != &other)
+		{
+			Close();
+
+			data = std::exchange(other.data, nullptr);
+			size = std::exchange(other.size, 0);
+			fileHandle = std::exchange(other.fileHandle, nullptr);
+			mappingHandle = std::exchange(other.mappingHandle, nullptr);
+		}
+		return *this;
+	}
+
+	bool MemoryMappedFile::OpenRead(std::string_view filePath)
+	{
+		Close();
+
+#if defined (_WIN32)
+		HANDLE file = CreateFileA(filePath.data(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+
+		LARGE_INTEGER fileSize{};
+		if (GetFileSizeEx(file, &fileSize) == FALSE || fileSize.QuadPart <= 0)
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (mapping == NULL)
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (view == NULL)
+		{
+			CloseHandle(mapping);
+			CloseHandle(file);
+			return false;
+		}
+
+		data = static_cast<const u8*>(view);
+		size = static_cast<size_t>(fileSize.QuadPart);
+		fileHandle = file;
+		mappingHandle = mapping;
+		return true;
+#else
+		// NOTE: The mapping stays valid after the descriptor has been closed
+		int file = open(std::string(filePath).c_str(), O_RDONLY);
+		if (file < 0)
+		{
+			return false;
+		}
+
+		struct stat fileInfo {};
+		if (fstat(file, &fileInfo) != 0 || fileInfo.st_size <= 0)
+		{
+			close(file);
+			return false;
+		}
+
+		void* view = mmap(nullptr, static_cast<size_t>(fileInfo.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+		close(file);
+
+		if (view == MAP_FAILED)
+		{
+			return false;
+		}
+
+		data = static_cast<const u8*>(view);
+		size = static_cast<size_t>(fileInfo.st_size);
+		return true;
+#endif
+	}
+
+	void MemoryMappedFile::Close()
+	{
+		if (data == nullptr)
+		{
+			return;
+		}
+
+#if defined (_WIN32)
+		UnmapViewOfFile(data);
+		CloseHandle(static_cast<HANDLE>(mappingHandle));
+		CloseHandle(static_cast<HANDLE>(fileHandle));
+#else
+		munmap(const_cast<u8*>(data), size);
+#endif
+
+		data = nullptr;
+		size = 0;
+		fileHandle = nullptr;
+		mappingHandle = nullptr;
+	}
+
+	bool MemoryMappedFile::IsOpen() const
+	{
+		return data != nullptr;
+	}
+
+	const u8* MemoryMappedFile::GetData() const
+	{
+		return data;
+	}
+
+	size_t MemoryMappedFile::GetSize() const
+	{
+		return size;
+	}
+
+	void MemoryMappedFile::Prefetch(size_t offset, size_t prefetchSize) const
+	{
+		if (data == nullptr || offset >= size)
+		{
+			return;
+		}
+
+		prefetchSize = (prefetchSize < size - offset) ? prefetchSize : size - offset;
+
+#if defined (_WIN32)
+		WIN32_MEMORY_RANGE_ENTRY range{};
+		range.VirtualAddress = const_cast<u8*>(&data[offset]);
+		range.NumberOfBytes = prefetchSize;
+		PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+		// NOTE: madvise() needs a page aligned address
+		const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+		const size_t alignedOffset = offset - (offset % pageSize);
+		madvise(const_cast<u8*>(&data[alignedOffset]), prefetchSize + (offset - alignedOffset), MADV_WILLNEED);
+#endif
+	}
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include "Common/Types.h"
+
+namespace Starshine::IO
+{
+	// NOTE: Read-only view of a whole file mapped into the address space.
+	//		 Pages are loaded by the OS on first access, so opening is cheap and untouched parts of the file never occupy memory.
+	class MemoryMappedFile final : NonCopyable
+	{
+	public:
+		MemoryMappedFile() = default;
+		MemoryMappedFile(MemoryMappedFile&& other);
+		~MemoryMappedFile();
+
+		MemoryMappedFile& operator=(MemoryMappedFile&& other);
+
+	public:
+		bool OpenRead(std::string_view filePath);
+		void Close();
+
+		bool IsOpen() const;
+
+		const u8* GetData() const;
+		size_t GetSize() const;
+
+		// NOTE: Asks the OS to start reading the range in the background, so that touching it later doesn't block on the disk
+		void Prefetch(size_t offset, size_t prefetchSize) const;
+
+	private:
+		const u8* data{};
+		size_t size{};
+
+		void* fileHandle{};
+		void* mappingHandle{};
+	};
+}
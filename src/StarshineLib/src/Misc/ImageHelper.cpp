@@ -9,6 +9,10 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
+#define STBI_WRITE_NO_STDIO
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
 using namespace Starshine::IO;
 using namespace Starshine::Graphics;
 
@@ -48,6 +52,12 @@ namespace Starshine::Misc
 
 			constexpr stbi_io_callbacks STBICallbacks_IStream{ STBIRead_IStream, STBISkip_IStream, STBIEndOfFile_IStream };
 
+			void STBIWrite_IStream(void* streamPtr, void* data, int size)
+			{
+				IStream* stream = static_cast<IStream*>(streamPtr);
+				stream->WriteBuffer(data, static_cast<size_t>(size));
+			}
+
 			size_t ConvertRGBAData(const u8* rgbaData, size_t rgbaDataSize, u8* outputData, Graphics::TextureFormat targetFormat)
 			{
 				if (targetFormat == TextureFormat::RGBA8)
@@ -211,5 +221,18 @@ namespace Starshine::Misc
 
 			return true;
 		}
+
+		bool WritePNGFile(std::string_view filePath, ivec2 size, const u8* rgbaData)
+		{
+			if (rgbaData == nullptr || size.x <= 0 || size.y <= 0)
+				return false;
+
+			FileStream fileStream = File::CreateWrite(filePath);
+			if (!fileStream.IsOpen())
+				return false;
+
+			constexpr int rgbaPixelSize = 4;
+			return stbi_write_png_to_func(Detail::STBIWrite_IStream, &fileStream, size.x, size.y, rgbaPixelSize, rgbaData, size.x * rgbaPixelSize) != 0;
+		}
 	}
 }
@@ -15,5 +15,8 @@ namespace Starshine::Misc
 		bool ReadImageFile(const void* fileData, size_t fileSize, std::unique_ptr<Graphics::Texture>& outTexture, Graphics::TextureFormat targetFormat);
 		bool ReadImageFile(std::string_view filePath, std::unique_ptr<Graphics::Texture>& outTexture,
 			Graphics::TextureFormat targetFormat = Graphics::TextureFormat::RGBA8);
+
+		// NOTE: Writes tightly packed RGBA8 rows (top to bottom) as a PNG file
+		bool WritePNGFile(std::string_view filePath, ivec2 size, const u8* rgbaData);
 	}
 }